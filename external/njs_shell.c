@@ -33,6 +33,10 @@
 #endif
 
 
+/* The profiling timer period in microseconds. */
+#define NJS_PROFILE_PERIOD  1000
+
+
 typedef struct {
     uint8_t                 disassemble;
     uint8_t                 denormals;
@@ -52,6 +56,8 @@ typedef struct {
     int                     stack_size;
 
     char                    *file;
+    char                    *bytecode;
+    char                    *profile;
     njs_str_t               command;
     size_t                  n_paths;
     njs_str_t               *paths;
@@ -176,6 +182,8 @@ typedef struct {
 
     njs_arr_t               *rejected_promises;
 
+    njs_profile_t           *profile;
+
     njs_bool_t              suppress_stdout;
     njs_bool_t              interactive;
     njs_bool_t              module;
@@ -221,6 +229,10 @@ static njs_int_t njs_console_init(njs_opts_t *opts, njs_console_t *console);
 static njs_int_t njs_externals_init(njs_vm_t *vm);
 static njs_engine_t *njs_create_engine(njs_opts_t *opts);
 static njs_int_t njs_process_file(njs_opts_t *opts);
+static njs_int_t njs_process_bytecode(njs_opts_t *opts);
+static njs_int_t njs_profile_start(njs_console_t *console);
+static njs_int_t njs_profile_write(njs_opts_t *opts, njs_console_t *console);
+static void njs_profile_handler(int signo);
 static njs_int_t njs_process_script(njs_engine_t *engine,
     njs_console_t *console, njs_str_t *script);
 
@@ -413,6 +425,13 @@ njs_main(njs_opts_t *opts)
     njs_int_t     ret;
     njs_engine_t  *engine;
 
+    if (opts->bytecode != NULL
+        && (opts->file == NULL || opts->command.length != 0))
+    {
+        njs_stderror("option \"-b\" requires a script file\n");
+        return NJS_ERROR;
+    }
+
     if (opts->file == NULL) {
         if (opts->command.length != 0) {
             opts->file = (char *) "string";
@@ -436,6 +455,13 @@ njs_main(njs_opts_t *opts)
         return NJS_ERROR;
     }
 
+    if (opts->profile != NULL) {
+        ret = njs_profile_start(&njs_console);
+        if (ret != NJS_OK) {
+            return NJS_ERROR;
+        }
+    }
+
 #if (!defined NJS_FUZZER_TARGET && defined NJS_HAVE_READLINE)
 
     if (opts->interactive) {
@@ -454,10 +480,19 @@ njs_main(njs_opts_t *opts)
         ret = njs_process_script(engine, &njs_console, &opts->command);
         engine->destroy(engine);
 
+    } else if (opts->bytecode != NULL) {
+        ret = njs_process_bytecode(opts);
+
     } else {
         ret = njs_process_file(opts);
     }
 
+    if (njs_console.profile != NULL
+        && njs_profile_write(opts, &njs_console) != NJS_OK)
+    {
+        ret = NJS_ERROR;
+    }
+
     return ret;
 }
 
@@ -520,6 +555,7 @@ njs_options_parse(njs_opts_t *opts, int argc, char **argv)
         "\n"
         "Options:\n"
         "  -a                print AST.\n"
+        "  -b <file>         compile script as module into bytecode file.\n"
         "  -c                specify the command to execute.\n"
         "  -d                print disassembled code.\n"
         "  -e <code>         set failure exit code.\n"
@@ -536,6 +572,8 @@ njs_options_parse(njs_opts_t *opts, int argc, char **argv)
         "  -o                enable opcode debug.\n"
 #endif
         "  -p <path>         set path prefix for modules.\n"
+        "  -P <file>         write CPU profile into file as folded stacks,\n"
+        "                    or as pprof profile if file ends with \".pb\".\n"
         "  -q                disable interactive introduction prompt.\n"
         "  -r                ignore unhandled promise rejection.\n"
         "  -s                sandbox mode.\n"
@@ -615,6 +653,15 @@ njs_options_parse(njs_opts_t *opts, int argc, char **argv)
             opts->ast = 1;
             break;
 
+        case 'b':
+            if (++i < argc) {
+                opts->bytecode = argv[i];
+                break;
+            }
+
+            njs_stderror("option \"-b\" requires argument\n");
+            return NJS_ERROR;
+
         case 'c':
             opts->interactive = 0;
 
@@ -695,6 +742,15 @@ njs_options_parse(njs_opts_t *opts, int argc, char **argv)
             njs_stderror("option \"-p\" requires directory name\n");
             return NJS_ERROR;
 
+        case 'P':
+            if (++i < argc) {
+                opts->profile = argv[i];
+                break;
+            }
+
+            njs_stderror("option \"-P\" requires argument\n");
+            return NJS_ERROR;
+
         case 'q':
             opts->quiet = 1;
             break;
@@ -764,6 +820,11 @@ done:
             return NJS_ERROR;
         }
 
+        if (opts->profile != NULL) {
+            njs_stderror("option \"-P\" is not supported for quickjs\n");
+            return NJS_ERROR;
+        }
+
         if (opts->sandbox) {
             njs_stderror("option \"-s\" is not supported for quickjs\n");
             return NJS_ERROR;
@@ -1257,6 +1318,50 @@ njs_console_set_cwd(njs_console_t *console, njs_str_t *file)
 }
 
 
+/*
+ * Bytecode of a module is looked up in a file next to the module source
+ * with the ".njsb" suffix appended, see "njs -b".  The bytecode which does
+ * not match the source is ignored.
+ */
+
+static njs_int_t
+njs_module_bytecode(njs_vm_t *vm, njs_console_t *console,
+    njs_module_info_t *info, njs_str_t *text, njs_mod_t **module)
+{
+    int        fd;
+    char       path[NJS_MAX_PATH + 1];
+    njs_int_t  ret;
+    njs_str_t  bytecode;
+
+    if (info->file.length + njs_length(".njsb") > NJS_MAX_PATH) {
+        return NJS_DECLINED;
+    }
+
+    memcpy(njs_cpymem(path, info->file.start, info->file.length), ".njsb",
+           njs_length(".njsb") + 1);
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NJS_DECLINED;
+    }
+
+    ret = njs_module_read(console->engine->pool, fd, &bytecode);
+
+    (void) close(fd);
+
+    if (ret != NJS_OK) {
+        return NJS_DECLINED;
+    }
+
+    ret = njs_vm_module_from_bytecode(vm, &info->file, text, &bytecode,
+                                      module);
+
+    njs_mp_free(console->engine->pool, bytecode.start);
+
+    return ret;
+}
+
+
 static njs_mod_t *
 njs_module_loader(njs_vm_t *vm, njs_external_ptr_t external, njs_str_t *name)
 {
@@ -1298,10 +1403,17 @@ njs_module_loader(njs_vm_t *vm, njs_external_ptr_t external, njs_str_t *name)
         return NULL;
     }
 
-    start = text.start;
+    ret = njs_module_bytecode(vm, console, &info, &text, &module);
 
-    module = njs_vm_compile_module(vm, &info.file, &start,
-                                   &text.start[text.length]);
+    if (ret == NJS_DECLINED) {
+        start = text.start;
+
+        module = njs_vm_compile_module(vm, &info.file, &start,
+                                       &text.start[text.length]);
+
+    } else if (ret != NJS_OK) {
+        module = NULL;
+    }
 
     njs_mp_free(console->engine->pool, console->cwd.start);
     console->cwd = prev_cwd;
@@ -1355,6 +1467,10 @@ njs_engine_njs_init(njs_engine_t *engine, njs_opts_t *opts)
         return NJS_ERROR;
     }
 
+    if (njs_console.profile != NULL) {
+        njs_vm_profile(vm, njs_console.profile);
+    }
+
     if (opts->unhandled_rejection) {
         njs_vm_set_rejection_tracker(vm, njs_rejection_tracker,
                                      njs_vm_external_ptr(vm));
@@ -3433,6 +3549,192 @@ done:
 }
 
 
+/*
+ * The module source is compiled as is, without the shebang stripping,
+ * as the module loader validates the bytecode against the whole file.
+ */
+
+static njs_int_t
+njs_process_bytecode(njs_opts_t *opts)
+{
+    int           fd;
+    u_char        *start;
+    ssize_t       n;
+    njs_vm_t      *vm;
+    njs_int_t     ret;
+    njs_str_t     source, bytecode, name;
+    njs_mod_t     *module;
+    njs_engine_t  *engine;
+
+    engine = NULL;
+    source.start = NULL;
+
+    if (opts->engine != NJS_ENGINE_NJS) {
+        njs_stderror("bytecode is supported by the njs engine only\n");
+        return NJS_ERROR;
+    }
+
+    ret = njs_read_file(opts, &source);
+    if (ret != NJS_OK) {
+        goto done;
+    }
+
+    engine = njs_create_engine(opts);
+    if (engine == NULL) {
+        ret = NJS_ERROR;
+        goto done;
+    }
+
+    vm = engine->u.njs.vm;
+
+    name.start = (u_char *) opts->file;
+    name.length = njs_strlen(opts->file);
+
+    start = source.start;
+
+    module = njs_vm_compile_module(vm, &name, &start,
+                                   source.start + source.length);
+    if (module == NULL) {
+        engine->output(engine, NJS_ERROR);
+        ret = NJS_ERROR;
+        goto done;
+    }
+
+    ret = njs_vm_module_bytecode(vm, module, &source, &bytecode);
+    if (ret != NJS_OK) {
+        engine->output(engine, NJS_ERROR);
+        goto done;
+    }
+
+    fd = open(opts->bytecode, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+        njs_stderror("failed to open file: '%s' (%s)\n",
+                     opts->bytecode, strerror(errno));
+        ret = NJS_ERROR;
+        goto done;
+    }
+
+    n = write(fd, bytecode.start, bytecode.length);
+
+    (void) close(fd);
+
+    if (n < 0 || (size_t) n != bytecode.length) {
+        njs_stderror("failed to write file: '%s' (%s)\n",
+                     opts->bytecode, (n < 0) ? strerror(errno) : "short write");
+        ret = NJS_ERROR;
+        goto done;
+    }
+
+    ret = NJS_OK;
+
+done:
+
+    if (engine != NULL) {
+        engine->destroy(engine);
+    }
+
+    if (source.start != NULL) {
+        free(source.start);
+    }
+
+    return ret;
+}
+
+
+static njs_int_t
+njs_profile_start(njs_console_t *console)
+{
+    struct sigaction  sa;
+    struct itimerval  itv;
+
+    console->profile = njs_profile_create(NJS_PROFILE_PERIOD);
+    if (console->profile == NULL) {
+        njs_stderror("failed to create profile\n");
+        return NJS_ERROR;
+    }
+
+    njs_memzero(&sa, sizeof(struct sigaction));
+    sa.sa_handler = njs_profile_handler;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+
+    itv.it_interval.tv_sec = 0;
+    itv.it_interval.tv_usec = NJS_PROFILE_PERIOD;
+    itv.it_value = itv.it_interval;
+
+    if (sigaction(SIGPROF, &sa, NULL) == -1
+        || setitimer(ITIMER_PROF, &itv, NULL) == -1)
+    {
+        njs_stderror("failed to start profiling timer (%s)\n",
+                     strerror(errno));
+        return NJS_ERROR;
+    }
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_profile_write(njs_opts_t *opts, njs_console_t *console)
+{
+    int                   fd;
+    size_t                len;
+    ssize_t               n;
+    njs_int_t             ret;
+    njs_str_t             out;
+    struct itimerval      itv;
+    njs_profile_format_t  format;
+
+    njs_memzero(&itv, sizeof(struct itimerval));
+    (void) setitimer(ITIMER_PROF, &itv, NULL);
+
+    len = njs_strlen(opts->profile);
+
+    format = (len > 3 && memcmp(opts->profile + len - 3, ".pb", 3) == 0)
+             ? NJS_PROFILE_PPROF : NJS_PROFILE_FOLDED;
+
+    ret = NJS_ERROR;
+
+    if (njs_profile_dump(console->profile, format, &out) != NJS_OK) {
+        njs_stderror("failed to dump profile\n");
+        goto done;
+    }
+
+    fd = open(opts->profile, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+        njs_stderror("failed to open file: '%s' (%s)\n",
+                     opts->profile, strerror(errno));
+        goto done;
+    }
+
+    n = write(fd, out.start, out.length);
+
+    (void) close(fd);
+
+    if (n < 0 || (size_t) n != out.length) {
+        njs_stderror("failed to write file: '%s' (%s)\n",
+                     opts->profile, (n < 0) ? strerror(errno) : "short write");
+        goto done;
+    }
+
+    ret = NJS_OK;
+
+done:
+
+    njs_profile_destroy(console->profile);
+    console->profile = NULL;
+
+    return ret;
+}
+
+
+static void
+njs_profile_handler(int signo)
+{
+    njs_profile_tick();
+}
+
+
 static njs_int_t
 njs_process_script(njs_engine_t *engine, njs_console_t *console,
     njs_str_t *script)
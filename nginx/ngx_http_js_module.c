@@ -136,6 +136,8 @@ struct ngx_http_js_ctx_s {
     void                  *body_read_event;
 
     ngx_js_form_t         *request_form;
+
+    ngx_event_t            gc_event;
 };
 
 
@@ -192,6 +194,7 @@ static ngx_int_t ngx_http_js_variable_var(ngx_http_request_t *r,
     ngx_http_variable_value_t *v, uintptr_t data);
 static ngx_int_t ngx_http_js_init_vm(ngx_http_request_t *r, njs_int_t proto_id);
 static void ngx_http_js_cleanup_ctx(void *data);
+static void ngx_http_js_gc_handler(ngx_event_t *ev);
 static void ngx_http_js_body_read_abort(ngx_http_js_ctx_t *ctx);
 static ngx_int_t ngx_http_js_collect_body(ngx_http_request_t *r,
     ngx_http_js_ctx_t *ctx);
@@ -517,6 +520,7 @@ static void ngx_http_js_periodic_destroy(ngx_http_request_t *r,
 static njs_int_t ngx_js_http_init(njs_vm_t *vm);
 static ngx_int_t ngx_http_js_init(ngx_conf_t *cf);
 static ngx_int_t ngx_http_js_init_worker(ngx_cycle_t *cycle);
+static void ngx_http_js_exit_worker(ngx_cycle_t *cycle);
 static char *ngx_http_js_periodic(ngx_conf_t *cf, ngx_command_t *cmd,
     void *conf);
 static char *ngx_http_js_set(ngx_conf_t *cf, ngx_command_t *cmd, void *conf);
@@ -585,6 +589,20 @@ static ngx_command_t  ngx_http_js_commands[] = {
       offsetof(ngx_http_js_loc_conf_t, reuse_max_size),
       NULL },
 
+    { ngx_string("js_context_arena"),
+      NGX_HTTP_MAIN_CONF|NGX_HTTP_SRV_CONF|NGX_HTTP_LOC_CONF|NGX_CONF_FLAG,
+      ngx_conf_set_flag_slot,
+      NGX_HTTP_LOC_CONF_OFFSET,
+      offsetof(ngx_http_js_loc_conf_t, arena),
+      NULL },
+
+    { ngx_string("js_gc"),
+      NGX_HTTP_MAIN_CONF|NGX_HTTP_SRV_CONF|NGX_HTTP_LOC_CONF|NGX_CONF_FLAG,
+      ngx_conf_set_flag_slot,
+      NGX_HTTP_LOC_CONF_OFFSET,
+      offsetof(ngx_http_js_loc_conf_t, gc),
+      NULL },
+
     { ngx_string("js_import"),
       NGX_HTTP_MAIN_CONF|NGX_HTTP_SRV_CONF|NGX_HTTP_LOC_CONF|NGX_CONF_TAKE13,
       ngx_js_import,
@@ -722,6 +740,13 @@ static ngx_command_t  ngx_http_js_commands[] = {
       0,
       NULL },
 
+    { ngx_string("js_profile"),
+      NGX_HTTP_MAIN_CONF|NGX_CONF_1MORE,
+      ngx_js_profile,
+      NGX_HTTP_MAIN_CONF_OFFSET,
+      0,
+      NULL },
+
     { ngx_string("js_fetch_keepalive"),
       NGX_HTTP_MAIN_CONF|NGX_HTTP_SRV_CONF|NGX_HTTP_LOC_CONF|NGX_CONF_TAKE1,
       ngx_conf_set_num_slot,
@@ -787,7 +812,7 @@ ngx_module_t  ngx_http_js_core_module = {
     ngx_js_core_commands,              /* module directives */
     NGX_CORE_MODULE,                   /* module type */
     NULL,                              /* init master */
-    NULL,                              /* init module */
+    ngx_js_preload_cache_prune,        /* init module */
     NULL,                              /* init process */
     NULL,                              /* init thread */
     NULL,                              /* exit thread */
@@ -822,7 +847,7 @@ ngx_module_t  ngx_http_js_module = {
     ngx_http_js_init_worker,       /* init process */
     NULL,                          /* init thread */
     NULL,                          /* exit thread */
-    NULL,                          /* exit process */
+    ngx_http_js_exit_worker,       /* exit process */
     NULL,                          /* exit master */
     NGX_MODULE_V1_PADDING
 };
@@ -2037,6 +2062,8 @@ ngx_http_js_body_filter(ngx_http_request_t *r, ngx_chain_t *in)
         rc = NGX_OK;
     }
 
+    ngx_js_gc((ngx_js_ctx_t *) ctx, sizeof(ngx_http_js_ctx_t), &ctx->gc_event);
+
     return rc;
 }
 
@@ -2047,6 +2074,7 @@ ngx_http_js_variable_set(ngx_http_request_t *r, ngx_http_variable_value_t *v,
 {
     ngx_js_set_t *vdata = (ngx_js_set_t *) data;
 
+    u_char             *p;
     ngx_int_t           rc;
     njs_int_t           pending;
     ngx_str_t          *fname, value;
@@ -2092,6 +2120,18 @@ ngx_http_js_variable_set(ngx_http_request_t *r, ngx_http_variable_value_t *v,
         return NGX_ERROR;
     }
 
+    if (ctx->conf->gc && value.len != 0) {
+        /* The collector does not see the variable values. */
+
+        p = ngx_pnalloc(r->pool, value.len);
+        if (p == NULL) {
+            return NGX_ERROR;
+        }
+
+        ngx_memcpy(p, value.data, value.len);
+        value.data = p;
+    }
+
     v->len = value.len;
     v->valid = 1;
     v->no_cacheable = vdata->flags & NGX_NJS_VAR_NOCACHE;
@@ -2152,6 +2192,10 @@ ngx_http_js_init_vm(ngx_http_request_t *r, njs_int_t proto_id)
 
         ngx_js_ctx_init((ngx_js_ctx_t *) ctx, r->connection->log);
 
+        ctx->gc_event.handler = ngx_http_js_gc_handler;
+        ctx->gc_event.data = ctx;
+        ctx->gc_event.log = r->connection->log;
+
         ngx_http_set_ctx(r, ctx, ngx_http_js_module);
     }
 
@@ -2213,12 +2257,27 @@ ngx_http_js_cleanup_ctx(void *data)
      */
     r->pool = ngx_create_pool(128, ctx->log);
 
+    if (ctx->gc_event.posted) {
+        ngx_delete_posted_event(&ctx->gc_event);
+    }
+
     ngx_js_ctx_destroy((ngx_js_ctx_t *) ctx);
 
     ngx_destroy_pool(r->pool);
 }
 
 
+static void
+ngx_http_js_gc_handler(ngx_event_t *ev)
+{
+    ngx_http_js_ctx_t  *ctx;
+
+    ctx = ev->data;
+
+    ngx_js_gc((ngx_js_ctx_t *) ctx, sizeof(ngx_http_js_ctx_t), ev);
+}
+
+
 static njs_int_t
 ngx_http_js_ext_keys_header(njs_vm_t *vm, njs_value_t *value, njs_value_t *keys,
     ngx_list_t *headers)
@@ -5962,6 +6021,8 @@ ngx_http_js_resolver_timeout(ngx_http_request_t *r)
 static void
 ngx_http_js_event_finalize(ngx_http_request_t *r, ngx_int_t rc)
 {
+    ngx_http_js_ctx_t  *ctx;
+
     ngx_log_debug1(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
                    "http js event finalize rc: %i", rc);
 
@@ -5975,6 +6036,13 @@ ngx_http_js_event_finalize(ngx_http_request_t *r, ngx_int_t rc)
         return;
     }
 
+    ctx = ngx_http_get_module_ctx(r, ngx_http_js_module);
+
+    if (ctx != NULL) {
+        ngx_js_gc((ngx_js_ctx_t *) ctx, sizeof(ngx_http_js_ctx_t),
+                  &ctx->gc_event);
+    }
+
     if (rc == NGX_OK) {
         ngx_http_post_request(r, NULL);
     }
@@ -9601,6 +9669,10 @@ ngx_http_js_init_conf_vm(ngx_conf_t *cf, ngx_js_loc_conf_t *conf)
         options.u.njs.metas = &ngx_http_js_metas;
         options.u.njs.addons = njs_http_js_addon_modules;
         options.clone = ngx_engine_njs_clone;
+
+        if (jmcf->profile != NULL) {
+            options.profile = jmcf->profile->profile;
+        }
     }
 
 #if (NJS_HAVE_QUICKJS)
@@ -9702,10 +9774,35 @@ ngx_http_js_init_worker(ngx_cycle_t *cycle)
         return NGX_ERROR;
     }
 
+    if (ngx_js_profile_init_worker(cycle, jmcf) != NGX_OK) {
+        return NGX_ERROR;
+    }
+
     return NGX_OK;
 }
 
 
+static void
+ngx_http_js_exit_worker(ngx_cycle_t *cycle)
+{
+    ngx_js_main_conf_t  *jmcf;
+
+    if ((ngx_process != NGX_PROCESS_WORKER)
+        && ngx_process != NGX_PROCESS_SINGLE)
+    {
+        return;
+    }
+
+    jmcf = ngx_http_cycle_get_module_main_conf(cycle, ngx_http_js_module);
+
+    if (jmcf == NULL) {
+        return;
+    }
+
+    ngx_js_profile_exit_worker(cycle, jmcf);
+}
+
+
 static char *
 ngx_http_js_periodic(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 {
@@ -10121,6 +10218,7 @@ ngx_http_js_create_main_conf(ngx_conf_t *cf)
      *
      *     jmcf->dicts = NULL;
      *     jmcf->periodics = NULL;
+     *     jmcf->profile = NULL;
      */
 
     return jmcf;
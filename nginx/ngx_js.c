@@ -41,10 +41,32 @@ typedef struct {
 } njs_module_info_t;
 
 
+typedef struct ngx_js_preload_cache_s  ngx_js_preload_cache_t;
+
+struct ngx_js_preload_cache_s {
+    ngx_js_preload_cache_t  *next;
+    ngx_uint_t               generation;
+    ngx_str_t                ident;
+    ngx_str_t                stamp;
+    njs_str_t                data;
+};
+
+
 #if (NGX_DEBUG)
 static ngx_uint_t  ngx_js_engine_id;
 #endif
 
+/*
+ * The parsed JSON of preloaded objects kept by the master process
+ * across configuration reloads, see njs_vm_globals_cache().  An entry
+ * is stamped with the generation of the configuration which last used
+ * it, the entries not used by a successfully loaded configuration are
+ * freed by ngx_js_preload_cache_prune().
+ */
+static ngx_js_preload_cache_t  *ngx_js_preload_cache;
+static ngx_cycle_t             *ngx_js_preload_cycle;
+static ngx_uint_t               ngx_js_preload_generation;
+
 static ngx_int_t ngx_engine_njs_init(ngx_engine_t *engine,
     ngx_engine_opts_t *opts);
 static ngx_int_t ngx_engine_njs_compile(ngx_js_loc_conf_t *conf, ngx_log_t *log,
@@ -56,9 +78,14 @@ static ngx_int_t ngx_engine_njs_pending(ngx_engine_t *engine);
 static ngx_int_t ngx_engine_njs_string(ngx_engine_t *e,
     njs_opaque_value_t *value, ngx_str_t *str);
 static void ngx_njs_clear_events(ngx_js_ctx_t *ctx);
+static void ngx_js_cleanup_reuse_vm(void *data);
 static void ngx_engine_njs_destroy(ngx_engine_t *e, ngx_js_ctx_t *ctx,
     ngx_js_loc_conf_t *conf);
 static ngx_int_t ngx_js_init_preload_vm(njs_vm_t *vm, ngx_js_loc_conf_t *conf);
+static ngx_int_t ngx_js_preload_cache_key(ngx_pool_t *pool,
+    ngx_js_loc_conf_t *conf, ngx_str_t *ident, ngx_str_t *stamp);
+static void ngx_js_preload_cache_update(njs_vm_t *vm, ngx_str_t *ident,
+    ngx_str_t *stamp);
 static ngx_int_t ngx_js_integer_in_range(double num);
 static intptr_t ngx_js_event_rbtree_compare(njs_rbtree_node_t *node1,
     njs_rbtree_node_t *node2);
@@ -167,9 +194,13 @@ static njs_mod_t *ngx_js_module_loader(njs_vm_t *vm,
 static njs_int_t ngx_js_module_lookup(ngx_js_loc_conf_t *conf,
     njs_module_info_t *info);
 static njs_int_t ngx_js_module_read(njs_mp_t *mp, int fd, njs_str_t *text);
+static njs_int_t ngx_js_module_bytecode(njs_vm_t *vm, njs_module_info_t *info,
+    time_t mtime, njs_str_t *text, njs_mod_t **module);
 static njs_int_t ngx_js_set_cwd(njs_mp_t *mp, ngx_js_loc_conf_t *conf,
     njs_str_t *path);
 static void ngx_js_cleanup_vm(void *data);
+static void ngx_js_profile_cleanup(void *data);
+static void ngx_js_profile_handler(int signo);
 
 static njs_int_t ngx_js_core_init(njs_vm_t *vm);
 static uint64_t ngx_js_monotonic_time(void);
@@ -613,6 +644,7 @@ ngx_engine_njs_init(ngx_engine_t *engine, ngx_engine_opts_t *opts)
     vm_options.argv = ngx_argv;
     vm_options.argc = ngx_argc;
     vm_options.init = 1;
+    vm_options.arena = ngx_js_conf_arena(opts->conf);
 
     vm_options.file.start = njs_mp_alloc(engine->pool, opts->file.length);
     if (vm_options.file.start == NULL) {
@@ -628,6 +660,10 @@ ngx_engine_njs_init(ngx_engine_t *engine, ngx_engine_opts_t *opts)
 
     njs_vm_set_rejection_tracker(vm, ngx_js_rejection_tracker, NULL);
 
+    if (opts->profile != NULL) {
+        njs_vm_profile(vm, opts->profile);
+    }
+
     rc = ngx_js_set_cwd(njs_vm_memory_pool(vm), opts->conf, &vm_options.file);
     if (rc != NGX_OK) {
         njs_vm_destroy(vm);
@@ -768,6 +804,21 @@ ngx_njs_clone(ngx_js_ctx_t *ctx, ngx_js_loc_conf_t *cf, void *external)
     ngx_engine_t        *engine;
     njs_opaque_value_t   retval;
 
+    if (cf->reuse_queue != NULL) {
+        engine = ngx_js_queue_pop(cf->reuse_queue);
+        if (engine != NULL) {
+            ngx_log_debug1(NGX_LOG_DEBUG_HTTP, ctx->log, 0,
+                           "js reused vm: %p", engine->u.njs.vm);
+
+            if (njs_vm_reset(engine->u.njs.vm, external) == NJS_OK) {
+                ctx->conf = cf;
+                return engine;
+            }
+
+            njs_vm_destroy(engine->u.njs.vm);
+        }
+    }
+
     vm = njs_vm_clone(cf->engine->u.njs.vm, external);
     if (vm == NULL) {
         return NULL;
@@ -793,6 +844,15 @@ ngx_njs_clone(ngx_js_ctx_t *ctx, ngx_js_loc_conf_t *cf, void *external)
         goto failed;
     }
 
+    /*
+     * The externals created by the module code are kept when the clone
+     * is reused, the ones created for a request become stale.
+     */
+
+    if (cf->reuse != 0 && njs_vm_reset(vm, external) != NJS_OK) {
+        engine->u.njs.noreuse = 1;
+    }
+
     return engine;
 
 failed:
@@ -900,11 +960,35 @@ ngx_njs_clear_events(ngx_js_ctx_t *ctx)
 }
 
 
+static void
+ngx_js_cleanup_reuse_vm(void *data)
+{
+    ngx_engine_t  *engine;
+
+    ngx_js_queue_t  *reuse = data;
+
+    for ( ;; ) {
+        engine = ngx_js_queue_pop(reuse);
+        if (engine == NULL) {
+            break;
+        }
+
+        njs_vm_destroy(engine->u.njs.vm);
+    }
+}
+
+
 static void
 ngx_engine_njs_destroy(ngx_engine_t *e, ngx_js_ctx_t *ctx,
     ngx_js_loc_conf_t *conf)
 {
-    njs_int_t  ret;
+    njs_int_t            ret;
+    njs_str_t            root;
+    ngx_uint_t           reusable;
+    njs_mp_stat_t        stat;
+    ngx_pool_cleanup_t  *cln;
+
+    reusable = 0;
 
     if (ctx != NULL) {
         ret = njs_vm_call_exit_hook(e->u.njs.vm);
@@ -912,15 +996,75 @@ ngx_engine_njs_destroy(ngx_engine_t *e, ngx_js_ctx_t *ctx,
             ngx_js_log_exception(e->u.njs.vm, ctx->log, "exit hook exception");
         }
 
-        (void) ngx_njs_execute_pending_jobs(e->u.njs.vm, ctx->log);
+        reusable = (ngx_njs_execute_pending_jobs(e->u.njs.vm, ctx->log)
+                    == NGX_OK);
 
         ngx_njs_clear_events(ctx);
 
         if (ngx_js_unhandled_rejection(ctx)) {
             ngx_js_log_exception(e->u.njs.vm, ctx->log, "unhandled rejection");
         }
+
+        if (njs_value_is_external(njs_value_arg(&ctx->args[0]),
+                                  NJS_PROTO_ID_ANY))
+        {
+            njs_value_external_detach(njs_value_arg(&ctx->args[0]));
+        }
     }
 
+    if (conf != NULL && conf->reuse != 0 && reusable && !e->u.njs.noreuse) {
+        if (conf->reuse_queue == NULL) {
+            conf->reuse_queue = ngx_js_queue_create(ngx_cycle->pool,
+                                                    conf->reuse);
+            if (conf->reuse_queue == NULL) {
+                goto destroy;
+            }
+
+            cln = ngx_pool_cleanup_add(ngx_cycle->pool, 0);
+            if (cln == NULL) {
+                goto destroy;
+            }
+
+            cln->handler = ngx_js_cleanup_reuse_vm;
+            cln->data = conf->reuse_queue;
+        }
+
+        /*
+         * The engine structure is allocated from the VM pool,
+         * nothing else refers to it while the VM waits in the queue.
+         */
+
+        if (conf->gc == 1 && njs_vm_gc_pending(e->u.njs.vm)) {
+            root.start = (u_char *) e;
+            root.length = sizeof(ngx_engine_t);
+
+            (void) njs_vm_gc(e->u.njs.vm, &root, 1);
+        }
+
+        /*
+         * The memory of an arena pool is released only with the VM,
+         * so the size check also bounds the number of reuses of a clone.
+         */
+
+        njs_mp_stat(njs_vm_memory_pool(e->u.njs.vm), &stat);
+
+        if (stat.used > conf->reuse_max_size) {
+            ngx_log_debug1(NGX_LOG_DEBUG_HTTP, ctx->log, 0,
+                           "js vm memory usage %uz exceeds "
+                           "\"js_context_reuse_max_size\", not reusing it",
+                           stat.used);
+            goto destroy;
+        }
+
+        if (ngx_js_queue_push(conf->reuse_queue, e) != NGX_OK) {
+            goto destroy;
+        }
+
+        return;
+    }
+
+destroy:
+
     njs_vm_destroy(e->u.njs.vm);
 
     /*
@@ -2718,6 +2862,55 @@ ngx_js_ctx_destroy(ngx_js_ctx_t *ctx)
 }
 
 
+/*
+ * A collection step scans about this amount of the VM memory, the next
+ * step is made by the "ev" event after the other events are handled.
+ */
+
+#define NGX_JS_GC_STEP  (256 * 1024)
+
+
+void
+ngx_js_gc(ngx_js_ctx_t *ctx, size_t size, ngx_event_t *ev)
+{
+    njs_vm_t   *vm;
+    njs_int_t   rc;
+    njs_str_t   root;
+
+    if (ctx->engine->type != NGX_ENGINE_NJS
+        || !ctx->conf->gc
+        || ngx_js_ctx_pending(ctx))
+    {
+        return;
+    }
+
+    vm = ctx->engine->u.njs.vm;
+
+    if (!njs_vm_gc_pending(vm)) {
+        return;
+    }
+
+    /*
+     * The context keeps the VM values of the handlers, all the other
+     * host memory referred to by the VM is outside of the VM pool.
+     */
+
+    root.start = (u_char *) ctx;
+    root.length = size;
+
+    rc = njs_vm_gc_step(vm, &root, 1, NGX_JS_GC_STEP);
+
+    if (rc == NJS_AGAIN) {
+        ngx_post_event(ev, &ngx_posted_next_events);
+        return;
+    }
+
+    if (rc == NJS_ERROR) {
+        ngx_log_error(NGX_LOG_ERR, ctx->log, 0, "js garbage collection failed");
+    }
+}
+
+
 static njs_int_t
 ngx_js_core_init(njs_vm_t *vm)
 {
@@ -3830,15 +4023,220 @@ ngx_js_fetch_proxy(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 }
 
 
+char *
+ngx_js_profile(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
+{
+    ngx_js_main_conf_t  *jmcf = conf;
+
+    ngx_str_t           *value, s;
+    ngx_uint_t           i;
+    ngx_js_profile_t    *profile;
+    ngx_pool_cleanup_t  *cln;
+
+    if (jmcf->profile != NULL) {
+        return "is duplicate";
+    }
+
+    profile = ngx_pcalloc(cf->pool, sizeof(ngx_js_profile_t));
+    if (profile == NULL) {
+        return NGX_CONF_ERROR;
+    }
+
+    value = cf->args->elts;
+
+    profile->path = value[1];
+    profile->interval = 10;
+    profile->format = NJS_PROFILE_FOLDED;
+
+    if (ngx_conf_full_name(cf->cycle, &profile->path, 0) != NGX_OK) {
+        return NGX_CONF_ERROR;
+    }
+
+    for (i = 2; i < cf->args->nelts; i++) {
+
+        if (ngx_strncmp(value[i].data, "interval=", 9) == 0) {
+
+            s.data = value[i].data + 9;
+            s.len = value[i].len - 9;
+
+            profile->interval = ngx_parse_time(&s, 0);
+            if (profile->interval == (ngx_msec_t) NGX_ERROR
+                || profile->interval == 0)
+            {
+                ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                                   "invalid interval value \"%V\"", &value[i]);
+                return NGX_CONF_ERROR;
+            }
+
+            continue;
+        }
+
+        if (ngx_strncmp(value[i].data, "format=", 7) == 0) {
+
+            if (ngx_strcmp(&value[i].data[7], "folded") == 0) {
+                profile->format = NJS_PROFILE_FOLDED;
+
+            } else if (ngx_strcmp(&value[i].data[7], "pprof") == 0) {
+                profile->format = NJS_PROFILE_PPROF;
+
+            } else {
+                ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                                   "invalid profile format \"%s\"",
+                                   &value[i].data[7]);
+                return NGX_CONF_ERROR;
+            }
+
+            continue;
+        }
+
+        ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                           "invalid parameter \"%V\"", &value[i]);
+        return NGX_CONF_ERROR;
+    }
+
+    cln = ngx_pool_cleanup_add(cf->pool, 0);
+    if (cln == NULL) {
+        return NGX_CONF_ERROR;
+    }
+
+    profile->profile = njs_profile_create(profile->interval * 1000);
+    if (profile->profile == NULL) {
+        return NGX_CONF_ERROR;
+    }
+
+    cln->handler = ngx_js_profile_cleanup;
+    cln->data = profile->profile;
+
+    jmcf->profile = profile;
+
+    return NGX_CONF_OK;
+}
+
+
+static void
+ngx_js_profile_cleanup(void *data)
+{
+    njs_profile_destroy(data);
+}
+
+
+static void
+ngx_js_profile_handler(int signo)
+{
+    njs_profile_tick();
+}
+
+
+ngx_int_t
+ngx_js_profile_init_worker(ngx_cycle_t *cycle, ngx_js_main_conf_t *jmcf)
+{
+    struct sigaction   sa;
+    struct itimerval   itv;
+    ngx_js_profile_t  *profile;
+
+    profile = jmcf->profile;
+
+    if (profile == NULL) {
+        return NGX_OK;
+    }
+
+    ngx_memzero(&sa, sizeof(struct sigaction));
+    sa.sa_handler = ngx_js_profile_handler;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+
+    if (sigaction(SIGPROF, &sa, NULL) == -1) {
+        ngx_log_error(NGX_LOG_ALERT, cycle->log, ngx_errno,
+                      "sigaction(SIGPROF) failed");
+        return NGX_ERROR;
+    }
+
+    itv.it_interval.tv_sec = profile->interval / 1000;
+    itv.it_interval.tv_usec = (profile->interval % 1000) * 1000;
+    itv.it_value = itv.it_interval;
+
+    if (setitimer(ITIMER_PROF, &itv, NULL) == -1) {
+        ngx_log_error(NGX_LOG_ALERT, cycle->log, ngx_errno,
+                      "setitimer(ITIMER_PROF) failed");
+        return NGX_ERROR;
+    }
+
+    return NGX_OK;
+}
+
+
+void
+ngx_js_profile_exit_worker(ngx_cycle_t *cycle, ngx_js_main_conf_t *jmcf)
+{
+    u_char            *name;
+    ssize_t            n;
+    ngx_fd_t           fd;
+    njs_str_t          out;
+    struct itimerval   itv;
+    ngx_js_profile_t  *profile;
+
+    profile = jmcf->profile;
+
+    if (profile == NULL) {
+        return;
+    }
+
+    ngx_memzero(&itv, sizeof(struct itimerval));
+    (void) setitimer(ITIMER_PROF, &itv, NULL);
+
+    if (njs_profile_dump(profile->profile, profile->format, &out) != NJS_OK) {
+        ngx_log_error(NGX_LOG_ALERT, cycle->log, 0,
+                      "js profile \"%V\" dump failed", &profile->path);
+        return;
+    }
+
+    /* Each worker writes its own profile suffixed with its pid. */
+
+    name = ngx_alloc(profile->path.len + NGX_INT64_LEN + 2, cycle->log);
+    if (name == NULL) {
+        return;
+    }
+
+    (void) ngx_sprintf(name, "%V.%P%Z", &profile->path, ngx_pid);
+
+    fd = ngx_open_file(name, NGX_FILE_WRONLY, NGX_FILE_TRUNCATE,
+                       NGX_FILE_DEFAULT_ACCESS);
+    if (fd == NGX_INVALID_FILE) {
+        ngx_log_error(NGX_LOG_ALERT, cycle->log, ngx_errno,
+                      ngx_open_file_n " \"%s\" failed", name);
+        goto done;
+    }
+
+    n = ngx_write_fd(fd, out.start, out.length);
+    if (n != (ssize_t) out.length) {
+        ngx_log_error(NGX_LOG_ALERT, cycle->log, ngx_errno,
+                      ngx_write_fd_n " \"%s\" failed", name);
+    }
+
+    if (ngx_close_file(fd) == NGX_FILE_ERROR) {
+        ngx_log_error(NGX_LOG_ALERT, cycle->log, ngx_errno,
+                      ngx_close_file_n " \"%s\" failed", name);
+    }
+
+done:
+
+    ngx_free(name);
+}
+
+
 static ngx_int_t
 ngx_js_init_preload_vm(njs_vm_t *vm, ngx_js_loc_conf_t *conf)
 {
-    u_char               *p, *start;
-    size_t                size;
-    njs_int_t             ret;
-    ngx_uint_t            i;
-    njs_opaque_value_t    retval;
-    ngx_js_named_path_t  *preload;
+    u_char                  *p, *start;
+    size_t                   size;
+    njs_int_t                ret;
+    ngx_int_t                rc;
+    ngx_str_t                ident, stamp;
+    ngx_uint_t               i;
+    ngx_pool_t              *pool;
+    njs_opaque_value_t       retval;
+    ngx_js_named_path_t     *preload;
+    ngx_js_preload_cache_t  *cache;
 
     njs_str_t str = njs_str(
         "import __fs from 'fs';"
@@ -3862,6 +4260,42 @@ ngx_js_init_preload_vm(njs_vm_t *vm, ngx_js_loc_conf_t *conf)
            "Object.setPrototypeOf,__fs.readFileSync);\n"
     );
 
+    pool = ngx_create_pool(NGX_DEFAULT_POOL_SIZE, ngx_cycle->log);
+    if (pool == NULL) {
+        return NGX_ERROR;
+    }
+
+    rc = ngx_js_preload_cache_key(pool, conf, &ident, &stamp);
+
+    if (rc == NGX_OK) {
+        for (cache = ngx_js_preload_cache; cache != NULL; cache = cache->next) {
+            if (cache->ident.len != ident.len
+                || ngx_memcmp(cache->ident.data, ident.data, ident.len) != 0)
+            {
+                continue;
+            }
+
+            cache->generation = ngx_js_preload_generation;
+
+            if (cache->stamp.len != stamp.len
+                || ngx_memcmp(cache->stamp.data, stamp.data, stamp.len) != 0)
+            {
+                break;
+            }
+
+            ret = njs_vm_globals_cache_restore(vm, &cache->data);
+            if (ret == NJS_ERROR) {
+                goto failed;
+            }
+
+            if (ret == NJS_OK) {
+                goto done;
+            }
+
+            break;
+        }
+    }
+
     size = str.length;
 
     preload = conf->preload_objects->elts;
@@ -3874,7 +4308,7 @@ ngx_js_init_preload_vm(njs_vm_t *vm, ngx_js_loc_conf_t *conf)
 
     start = njs_mp_alloc(njs_vm_memory_pool(vm), size);
     if (start == NULL) {
-        return NGX_ERROR;
+        goto failed;
     }
 
     p = ngx_cpymem(start, str.start, str.length);
@@ -3892,19 +4326,188 @@ ngx_js_init_preload_vm(njs_vm_t *vm, ngx_js_loc_conf_t *conf)
 
     ret = njs_vm_compile(vm, &start,  start + size);
     if (ret != NJS_OK) {
-        return NGX_ERROR;
+        goto failed;
     }
 
     ret = njs_vm_start(vm, njs_value_arg(&retval));
     if (ret != NJS_OK) {
-        return NGX_ERROR;
+        goto failed;
     }
 
-    ret = njs_vm_reuse(vm);
-    if (ret != NJS_OK) {
+    if (rc == NGX_OK) {
+        ngx_js_preload_cache_update(vm, &ident, &stamp);
+    }
+
+done:
+
+    ngx_destroy_pool(pool);
+
+    return (njs_vm_reuse(vm) == NJS_OK) ? NGX_OK : NGX_ERROR;
+
+failed:
+
+    ngx_destroy_pool(pool);
+
+    return NGX_ERROR;
+}
+
+
+/*
+ * The preloaded objects are identified by their names and paths,
+ * and are valid while the files are not changed.
+ */
+
+static ngx_int_t
+ngx_js_preload_cache_key(ngx_pool_t *pool, ngx_js_loc_conf_t *conf,
+    ngx_str_t *ident, ngx_str_t *stamp)
+{
+    u_char               *p, *s, *path;
+    size_t                size;
+    ngx_uint_t            i;
+    ngx_str_t            *prefix;
+    ngx_file_info_t       fi;
+    ngx_js_named_path_t  *preload;
+
+    prefix = &ngx_cycle->conf_prefix;
+    preload = conf->preload_objects->elts;
+
+    size = 0;
+
+    for (i = 0; i < conf->preload_objects->nelts; i++) {
+        size += preload[i].name.len + prefix->len + preload[i].path.len + 2;
+    }
+
+    ident->data = ngx_pnalloc(pool, size);
+    stamp->data = ngx_pnalloc(pool, conf->preload_objects->nelts
+                                    * (NGX_TIME_T_LEN + NGX_OFF_T_LEN
+                                       + NGX_INT64_LEN + 3));
+    if (ident->data == NULL || stamp->data == NULL) {
         return NGX_ERROR;
     }
 
+    p = ident->data;
+    s = stamp->data;
+
+    for (i = 0; i < conf->preload_objects->nelts; i++) {
+        p = ngx_cpymem(p, preload[i].name.data, preload[i].name.len);
+        *p++ = '\0';
+
+        path = p;
+
+        if (preload[i].path.data[0] != '/') {
+            p = ngx_cpymem(p, prefix->data, prefix->len);
+        }
+
+        p = ngx_cpymem(p, preload[i].path.data, preload[i].path.len);
+        *p++ = '\0';
+
+        if (ngx_file_info(path, &fi) == NGX_FILE_ERROR) {
+            return NGX_DECLINED;
+        }
+
+        s = ngx_sprintf(s, "%T %O %uL\n", ngx_file_mtime(&fi),
+                        ngx_file_size(&fi),
+                        (uint64_t) ngx_file_uniq(&fi));
+    }
+
+    ident->len = p - ident->data;
+    stamp->len = s - stamp->data;
+
+    return NGX_OK;
+}
+
+
+static void
+ngx_js_preload_cache_update(njs_vm_t *vm, ngx_str_t *ident, ngx_str_t *stamp)
+{
+    u_char                  *p;
+    njs_str_t                data;
+    ngx_js_preload_cache_t  *cache;
+
+    if (njs_vm_globals_cache(vm, &data) != NJS_OK) {
+        return;
+    }
+
+    p = ngx_alloc(stamp->len + data.length, ngx_cycle->log);
+    if (p == NULL) {
+        goto done;
+    }
+
+    for (cache = ngx_js_preload_cache; cache != NULL; cache = cache->next) {
+        if (cache->ident.len == ident->len
+            && ngx_memcmp(cache->ident.data, ident->data, ident->len) == 0)
+        {
+            ngx_free(cache->stamp.data);
+            break;
+        }
+    }
+
+    if (cache == NULL) {
+        cache = ngx_alloc(sizeof(ngx_js_preload_cache_t) + ident->len,
+                          ngx_cycle->log);
+        if (cache == NULL) {
+            ngx_free(p);
+            goto done;
+        }
+
+        cache->ident.data = (u_char *) &cache[1];
+        cache->ident.len = ident->len;
+        ngx_memcpy(cache->ident.data, ident->data, ident->len);
+
+        cache->next = ngx_js_preload_cache;
+        ngx_js_preload_cache = cache;
+    }
+
+    /* The stamp and the data share a single allocation. */
+
+    cache->generation = ngx_js_preload_generation;
+    cache->stamp.data = p;
+    cache->stamp.len = stamp->len;
+    cache->data.start = ngx_cpymem(p, stamp->data, stamp->len);
+    cache->data.length = data.length;
+
+    ngx_memcpy(cache->data.start, data.start, data.length);
+
+done:
+
+    njs_mp_free(njs_vm_memory_pool(vm), data.start);
+}
+
+
+ngx_int_t
+ngx_js_preload_cache_prune(ngx_cycle_t *cycle)
+{
+    ngx_js_preload_cache_t  *cache, **prev;
+
+    /* Both the http and the stream core modules call the handler. */
+
+    if (ngx_js_preload_cycle == cycle) {
+        return NGX_OK;
+    }
+
+    ngx_js_preload_cycle = cycle;
+
+    prev = &ngx_js_preload_cache;
+
+    for (cache = ngx_js_preload_cache; cache != NULL; cache = *prev) {
+        if (cache->generation == ngx_js_preload_generation) {
+            prev = &cache->next;
+            continue;
+        }
+
+        ngx_log_debug1(NGX_LOG_DEBUG_CORE, cycle->log, 0,
+                       "js preload cache free: \"%V\"", &cache->ident);
+
+        *prev = cache->next;
+
+        ngx_free(cache->stamp.data);
+        ngx_free(cache);
+    }
+
+    /* The next configuration cycle starts a new generation. */
+
+    ngx_js_preload_generation++;
+
     return NGX_OK;
 }
 
@@ -3945,6 +4548,7 @@ ngx_js_merge_vm(ngx_conf_t *cf, ngx_js_loc_conf_t *conf,
 
     if (conf->imports == NGX_CONF_UNSET_PTR
         && conf->type == prev->type
+        && ngx_js_conf_arena(conf) == ngx_js_conf_arena(prev)
         && conf->paths == NGX_CONF_UNSET_PTR
         && conf->preload_objects == NGX_CONF_UNSET_PTR)
     {
@@ -4328,14 +4932,66 @@ ngx_js_set_cwd(njs_mp_t *mp, ngx_js_loc_conf_t *conf, njs_str_t *path)
 }
 
 
+/*
+ * Bytecode of a module produced by "njs -b" is looked up in a file next to
+ * the module source with the ".njsb" suffix appended.  The bytecode older
+ * than the source or not matching it is ignored.
+ */
+
+static njs_int_t
+ngx_js_module_bytecode(njs_vm_t *vm, njs_module_info_t *info, time_t mtime,
+    njs_str_t *text, njs_mod_t **module)
+{
+    int           fd;
+    char          path[NGX_MAX_PATH + 1];
+    njs_int_t     ret;
+    njs_str_t     bytecode;
+    struct stat   sb;
+
+    if (info->file.length + njs_length(".njsb") > NGX_MAX_PATH) {
+        return NJS_DECLINED;
+    }
+
+    ngx_memcpy(ngx_cpymem(path, info->file.start, info->file.length),
+               ".njsb", njs_length(".njsb") + 1);
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NJS_DECLINED;
+    }
+
+    if (fstat(fd, &sb) == -1 || sb.st_mtime < mtime) {
+        (void) close(fd);
+        return NJS_DECLINED;
+    }
+
+    ret = ngx_js_module_read(njs_vm_memory_pool(vm), fd, &bytecode);
+
+    (void) close(fd);
+
+    if (ret != NJS_OK) {
+        return NJS_DECLINED;
+    }
+
+    ret = njs_vm_module_from_bytecode(vm, &info->file, text, &bytecode,
+                                      module);
+
+    njs_mp_free(njs_vm_memory_pool(vm), bytecode.start);
+
+    return ret;
+}
+
+
 static njs_mod_t *
 ngx_js_module_loader(njs_vm_t *vm, njs_external_ptr_t external, njs_str_t *name)
 {
     u_char             *start;
+    time_t              mtime;
     njs_int_t           ret;
     njs_str_t           text;
     ngx_str_t           prev_cwd;
     njs_mod_t          *module;
+    struct stat         sb;
     ngx_js_loc_conf_t  *conf;
     njs_module_info_t   info;
 
@@ -4356,6 +5012,8 @@ ngx_js_module_loader(njs_vm_t *vm, njs_external_ptr_t external, njs_str_t *name)
         return NULL;
     }
 
+    mtime = (fstat(info.fd, &sb) != -1) ? sb.st_mtime : 0;
+
     ret = ngx_js_module_read(njs_vm_memory_pool(vm), info.fd, &text);
 
     (void) close(info.fd);
@@ -4374,10 +5032,17 @@ ngx_js_module_loader(njs_vm_t *vm, njs_external_ptr_t external, njs_str_t *name)
         return NULL;
     }
 
-    start = text.start;
+    ret = ngx_js_module_bytecode(vm, &info, mtime, &text, &module);
+
+    if (ret == NJS_DECLINED) {
+        start = text.start;
 
-    module = njs_vm_compile_module(vm, &info.file, &start,
-                                   &text.start[text.length]);
+        module = njs_vm_compile_module(vm, &info.file, &start,
+                                       &text.start[text.length]);
+
+    } else if (ret != NJS_OK) {
+        module = NULL;
+    }
 
     njs_mp_free(njs_vm_memory_pool(vm), conf->cwd.data);
     conf->cwd = prev_cwd;
@@ -4529,6 +5194,8 @@ ngx_js_create_conf(ngx_conf_t *cf, size_t size)
     conf->preload_objects = NGX_CONF_UNSET_PTR;
 
     conf->reuse = NGX_CONF_UNSET_SIZE;
+    conf->gc = NGX_CONF_UNSET;
+    conf->arena = NGX_CONF_UNSET;
     conf->reuse_max_size = NGX_CONF_UNSET_SIZE;
     conf->buffer_size = NGX_CONF_UNSET_SIZE;
     conf->max_response_body_size = NGX_CONF_UNSET_SIZE;
@@ -4642,7 +5309,10 @@ ngx_js_merge_conf(ngx_conf_t *cf, void *parent, void *child,
     ngx_js_merge_conftime_loc_conf(conf, prev);
 
     ngx_conf_merge_msec_value(conf->timeout, prev->timeout, 60000);
-    ngx_conf_merge_size_value(conf->reuse, prev->reuse, 128);
+    ngx_conf_merge_size_value(conf->reuse, prev->reuse,
+                              (conf->type == NGX_ENGINE_NJS) ? 0 : 128);
+    ngx_conf_merge_value(conf->gc, prev->gc, 0);
+    ngx_conf_merge_value(conf->arena, prev->arena, 0);
     ngx_conf_merge_size_value(conf->reuse_max_size, prev->reuse_max_size,
                               4 * 1024 * 1024);
     ngx_conf_merge_size_value(conf->buffer_size, prev->buffer_size, 16384);
@@ -125,9 +125,18 @@ typedef struct {
 } ngx_js_queue_t;
 
 
+typedef struct {
+    njs_profile_t         *profile;
+    ngx_str_t              path;
+    ngx_msec_t             interval;
+    njs_profile_format_t   format;
+} ngx_js_profile_t;
+
+
 #define NGX_JS_COMMON_MAIN_CONF                                               \
     ngx_js_dict_t         *dicts;                                             \
-    ngx_array_t           *periodics                                          \
+    ngx_array_t           *periodics;                                         \
+    ngx_js_profile_t      *profile                                            \
 
 
 #define _NGX_JS_COMMON_LOC_CONF                                               \
@@ -136,6 +145,8 @@ typedef struct {
     ngx_uint_t             reuse;                                             \
     size_t                 reuse_max_size;                                    \
     ngx_js_queue_t        *reuse_queue;                                       \
+    ngx_flag_t             gc;                                                \
+    ngx_flag_t             arena;                                             \
     ngx_str_t              cwd;                                               \
     ngx_array_t           *imports;                                           \
     ngx_array_t           *paths;                                             \
@@ -162,6 +173,11 @@ typedef struct {
                                             ngx_url_t **url_out,              \
                                             ngx_str_t *auth_out)
 
+/* The clones of a VM use arena pools, which cannot be collected. */
+
+#define ngx_js_conf_arena(conf)                                               \
+     ((conf)->arena == 1 && (conf)->gc != 1)
+
 #define ngx_js_conf_dynamic_proxy(conf)                                       \
      ((conf)->eval_proxy_url != NULL)
 
@@ -258,6 +274,7 @@ typedef struct ngx_engine_opts_s {
     njs_str_t                   file;
     ngx_js_core_conf_t         *core_conf;
     ngx_js_loc_conf_t          *conf;
+    njs_profile_t              *profile;
     ngx_engine_t             *(*clone)(ngx_js_ctx_t *ctx,
                                         ngx_js_loc_conf_t *cf, njs_int_t pr_id,
                                         void *external);
@@ -276,6 +293,8 @@ struct ngx_engine_s {
     union {
         struct {
             njs_vm_t           *vm;
+            /* The externals of the first request cannot be made stale. */
+            unsigned            noreuse:1;
         } njs;
 #if (NJS_HAVE_QUICKJS)
         struct {
@@ -359,6 +378,7 @@ void ngx_js_ctx_init(ngx_js_ctx_t *ctx, ngx_log_t *log);
 
 
 void ngx_js_ctx_destroy(ngx_js_ctx_t *ctx);
+void ngx_js_gc(ngx_js_ctx_t *ctx, size_t size, ngx_event_t *ev);
 ngx_int_t ngx_js_call(njs_vm_t *vm, njs_function_t *func,
     njs_opaque_value_t *args, njs_uint_t nargs);
 ngx_int_t ngx_js_log_exception(njs_vm_t *vm, ngx_log_t *log, const char *txt);
@@ -461,6 +481,7 @@ char * ngx_js_preload_object(ngx_conf_t *cf, ngx_command_t *cmd, void *conf);
 char * ngx_js_fetch_proxy(ngx_conf_t *cf, ngx_command_t *cmd, void *conf);
 ngx_int_t ngx_js_parse_proxy_url(ngx_pool_t *pool, ngx_log_t *log,
     ngx_str_t *url_str, ngx_url_t **url_out, ngx_str_t *auth_header_out);
+ngx_int_t ngx_js_preload_cache_prune(ngx_cycle_t *cycle);
 ngx_int_t ngx_js_merge_vm(ngx_conf_t *cf, ngx_js_loc_conf_t *conf,
     ngx_js_loc_conf_t *prev,
     ngx_int_t (*init_vm)(ngx_conf_t *cf, ngx_js_loc_conf_t *conf));
@@ -471,6 +492,10 @@ char * ngx_js_merge_conf(ngx_conf_t *cf, void *parent, void *child,
    ngx_int_t (*init_vm)(ngx_conf_t *cf, ngx_js_loc_conf_t *conf));
 char *ngx_js_shared_dict_zone(ngx_conf_t *cf, ngx_command_t *cmd, void *conf,
     void *tag);
+char *ngx_js_profile(ngx_conf_t *cf, ngx_command_t *cmd, void *conf);
+ngx_int_t ngx_js_profile_init_worker(ngx_cycle_t *cycle,
+    ngx_js_main_conf_t *jmcf);
+void ngx_js_profile_exit_worker(ngx_cycle_t *cycle, ngx_js_main_conf_t *jmcf);
 
 void *ngx_js_core_create_conf(ngx_cycle_t *cycle);
 char *ngx_js_core_load_native_module(ngx_conf_t *cf, ngx_command_t *cmd,
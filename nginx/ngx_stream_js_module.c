@@ -75,6 +75,7 @@ struct ngx_stream_js_ctx_s {
     unsigned                filter:1;
     unsigned                in_progress:1;
     ngx_js_periodic_t      *periodic;
+    ngx_event_t             gc_event;
 };
 
 
@@ -116,6 +117,7 @@ static ngx_int_t ngx_stream_js_init_vm(ngx_stream_session_t *s,
 static ngx_int_t ngx_stream_js_pending_events(ngx_stream_js_ctx_t *ctx);
 static void ngx_stream_js_drop_events(ngx_stream_js_ctx_t *ctx);
 static void ngx_stream_js_cleanup(void *data);
+static void ngx_stream_js_gc_handler(ngx_event_t *ev);
 static ngx_int_t ngx_stream_js_run_event(ngx_stream_session_t *s,
     ngx_stream_js_ctx_t *ctx, ngx_stream_js_ev_t *event,
     ngx_uint_t from_upstream);
@@ -218,6 +220,7 @@ static void ngx_stream_js_periodic_destroy(ngx_stream_session_t *s,
 static njs_int_t ngx_js_stream_init(njs_vm_t *vm);
 static ngx_int_t ngx_stream_js_init(ngx_conf_t *cf);
 static ngx_int_t ngx_stream_js_init_worker(ngx_cycle_t *cycle);
+static void ngx_stream_js_exit_worker(ngx_cycle_t *cycle);
 static char *ngx_stream_js_periodic(ngx_conf_t *cf, ngx_command_t *cmd,
     void *conf);
 static char *ngx_stream_js_set(ngx_conf_t *cf, ngx_command_t *cmd,
@@ -279,6 +282,20 @@ static ngx_command_t  ngx_stream_js_commands[] = {
       offsetof(ngx_stream_js_srv_conf_t, reuse_max_size),
       NULL },
 
+    { ngx_string("js_context_arena"),
+      NGX_STREAM_MAIN_CONF|NGX_STREAM_SRV_CONF|NGX_CONF_FLAG,
+      ngx_conf_set_flag_slot,
+      NGX_STREAM_SRV_CONF_OFFSET,
+      offsetof(ngx_stream_js_srv_conf_t, arena),
+      NULL },
+
+    { ngx_string("js_gc"),
+      NGX_STREAM_MAIN_CONF|NGX_STREAM_SRV_CONF|NGX_CONF_FLAG,
+      ngx_conf_set_flag_slot,
+      NGX_STREAM_SRV_CONF_OFFSET,
+      offsetof(ngx_stream_js_srv_conf_t, gc),
+      NULL },
+
     { ngx_string("js_import"),
       NGX_STREAM_MAIN_CONF|NGX_STREAM_SRV_CONF|NGX_CONF_TAKE13,
       ngx_js_import,
@@ -437,6 +454,13 @@ static ngx_command_t  ngx_stream_js_commands[] = {
       0,
       NULL },
 
+    { ngx_string("js_profile"),
+      NGX_STREAM_MAIN_CONF|NGX_CONF_1MORE,
+      ngx_js_profile,
+      NGX_STREAM_MAIN_CONF_OFFSET,
+      0,
+      NULL },
+
     { ngx_string("js_fetch_proxy"),
       NGX_STREAM_MAIN_CONF|NGX_STREAM_SRV_CONF|NGX_CONF_TAKE1,
       ngx_stream_js_fetch_proxy,
@@ -474,7 +498,7 @@ ngx_module_t  ngx_stream_js_core_module = {
     ngx_js_core_commands,              /* module directives */
     NGX_CORE_MODULE,                   /* module type */
     NULL,                              /* init master */
-    NULL,                              /* init module */
+    ngx_js_preload_cache_prune,        /* init module */
     NULL,                              /* init process */
     NULL,                              /* init thread */
     NULL,                              /* exit thread */
@@ -506,7 +530,7 @@ ngx_module_t  ngx_stream_js_module = {
     ngx_stream_js_init_worker,      /* init process */
     NULL,                           /* init thread */
     NULL,                           /* exit thread */
-    NULL,                           /* exit process */
+    ngx_stream_js_exit_worker,      /* exit process */
     NULL,                           /* exit master */
     NGX_MODULE_V1_PADDING
 };
@@ -1004,6 +1028,9 @@ ngx_stream_js_phase_handler(ngx_stream_session_t *s, ngx_str_t *name)
     ngx_log_debug1(NGX_LOG_DEBUG_STREAM, ctx->log, 0, "stream js phase rc: %i",
                    rc);
 
+    ngx_js_gc((ngx_js_ctx_t *) ctx, sizeof(ngx_stream_js_ctx_t),
+              &ctx->gc_event);
+
     return rc;
 }
 
@@ -1066,7 +1093,12 @@ ngx_stream_js_body_filter(ngx_stream_session_t *s, ngx_chain_t *in,
     ctx->buf = NULL;
     *ctx->last_out = NULL;
 
-    return ngx_stream_js_next_filter(s, ctx, out, from_upstream);
+    rc = ngx_stream_js_next_filter(s, ctx, out, from_upstream);
+
+    ngx_js_gc((ngx_js_ctx_t *) ctx, sizeof(ngx_stream_js_ctx_t),
+              &ctx->gc_event);
+
+    return rc;
 }
 
 
@@ -1109,6 +1141,7 @@ ngx_stream_js_variable_set(ngx_stream_session_t *s,
 {
     ngx_js_set_t *vdata = (ngx_js_set_t *) data;
 
+    u_char               *p;
     ngx_int_t             rc;
     njs_int_t             pending;
     ngx_str_t            *fname, value;
@@ -1154,6 +1187,18 @@ ngx_stream_js_variable_set(ngx_stream_session_t *s,
         return NGX_ERROR;
     }
 
+    if (ctx->conf->gc && value.len != 0) {
+        /* The collector does not see the variable values. */
+
+        p = ngx_pnalloc(s->connection->pool, value.len);
+        if (p == NULL) {
+            return NGX_ERROR;
+        }
+
+        ngx_memcpy(p, value.data, value.len);
+        value.data = p;
+    }
+
     v->len = value.len;
     v->valid = 1;
     v->no_cacheable = vdata->flags & NGX_NJS_VAR_NOCACHE;
@@ -1214,6 +1259,10 @@ ngx_stream_js_init_vm(ngx_stream_session_t *s, njs_int_t proto_id)
 
         ngx_js_ctx_init((ngx_js_ctx_t *) ctx, s->connection->log);
 
+        ctx->gc_event.handler = ngx_stream_js_gc_handler;
+        ctx->gc_event.data = ctx;
+        ctx->gc_event.log = s->connection->log;
+
         ngx_stream_set_ctx(s, ctx, ngx_stream_js_module);
     }
 
@@ -1292,10 +1341,25 @@ ngx_stream_js_cleanup(void *data)
     ngx_log_debug1(NGX_LOG_DEBUG_STREAM, ctx->log, 0,
                    "stream js vm destroy: %p", ctx->engine);
 
+    if (ctx->gc_event.posted) {
+        ngx_delete_posted_event(&ctx->gc_event);
+    }
+
     ngx_js_ctx_destroy((ngx_js_ctx_t *) ctx);
 }
 
 
+static void
+ngx_stream_js_gc_handler(ngx_event_t *ev)
+{
+    ngx_stream_js_ctx_t  *ctx;
+
+    ctx = ev->data;
+
+    ngx_js_gc((ngx_js_ctx_t *) ctx, sizeof(ngx_stream_js_ctx_t), ev);
+}
+
+
 static ngx_int_t
 ngx_stream_js_run_event(ngx_stream_session_t *s, ngx_stream_js_ctx_t *ctx,
     ngx_stream_js_ev_t *event, ngx_uint_t from_upstream)
@@ -1631,6 +1695,7 @@ static njs_int_t
 ngx_stream_js_ext_send(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
     njs_index_t from_upstream, njs_value_t *retval)
 {
+    u_char                *p;
     unsigned               last_buf, flush;
     njs_str_t              buffer;
     ngx_buf_t             *b;
@@ -1720,6 +1785,19 @@ ngx_stream_js_ext_send(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
     b->sync = (buffer.length ? 0 : 1);
     b->tag = (ngx_buf_tag_t) &ngx_stream_js_module;
 
+    if (ctx->conf->gc && buffer.length != 0) {
+        /* The collector does not see the busy buffers. */
+
+        p = ngx_pnalloc(c->pool, buffer.length);
+        if (p == NULL) {
+            njs_vm_memory_error(vm);
+            return NJS_ERROR;
+        }
+
+        ngx_memcpy(p, buffer.start, buffer.length);
+        buffer.start = p;
+    }
+
     b->start = buffer.start;
     b->end = buffer.start + buffer.length;
     b->pos = b->start;
@@ -3218,6 +3296,10 @@ ngx_stream_js_init_conf_vm(ngx_conf_t *cf, ngx_js_loc_conf_t *conf)
         options.u.njs.metas = &ngx_stream_js_metas;
         options.u.njs.addons = njs_stream_js_addon_modules;
         options.clone = ngx_engine_njs_clone;
+
+        if (jmcf->profile != NULL) {
+            options.profile = jmcf->profile->profile;
+        }
     }
 
 #if (NJS_HAVE_QUICKJS)
@@ -3526,10 +3608,35 @@ ngx_stream_js_init_worker(ngx_cycle_t *cycle)
         return NGX_ERROR;
     }
 
+    if (ngx_js_profile_init_worker(cycle, jmcf) != NGX_OK) {
+        return NGX_ERROR;
+    }
+
     return NGX_OK;
 }
 
 
+static void
+ngx_stream_js_exit_worker(ngx_cycle_t *cycle)
+{
+    ngx_js_main_conf_t  *jmcf;
+
+    if ((ngx_process != NGX_PROCESS_WORKER)
+        && ngx_process != NGX_PROCESS_SINGLE)
+    {
+        return;
+    }
+
+    jmcf = ngx_stream_cycle_get_module_main_conf(cycle, ngx_stream_js_module);
+
+    if (jmcf == NULL) {
+        return;
+    }
+
+    ngx_js_profile_exit_worker(cycle, jmcf);
+}
+
+
 static char *
 ngx_stream_js_periodic(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 {
@@ -3799,6 +3906,7 @@ ngx_stream_js_create_main_conf(ngx_conf_t *cf)
      *
      *     jmcf->dicts = NULL;
      *     jmcf->periodics = NULL;
+     *     jmcf->profile = NULL;
      */
 
     return jmcf;
@@ -0,0 +1,119 @@
+#!/usr/bin/perl
+
+# (C) F5, Inc.
+
+# Tests for njs VM reuse with js_context_reuse.  The global state is kept,
+# the request objects of the previous requests and the objects nested
+# in them are detached.
+
+###############################################################################
+
+use warnings;
+use strict;
+
+use Test::More;
+
+BEGIN { use FindBin; chdir($FindBin::Bin); }
+
+use lib 'lib';
+use Test::Nginx;
+
+###############################################################################
+
+select STDERR; $| = 1;
+select STDOUT; $| = 1;
+
+my $t = Test::Nginx->new()->has(qw/http/)
+	->write_file_expand('nginx.conf', <<'EOF');
+
+%%TEST_GLOBALS%%
+
+daemon off;
+worker_processes 1;
+
+events {
+}
+
+http {
+    %%TEST_GLOBALS_HTTP%%
+
+    js_engine njs;
+
+    js_import test.js;
+
+    server {
+        listen       127.0.0.1:8080;
+        server_name  localhost;
+
+        location /reuse {
+            js_context_reuse 4;
+            js_content test.content;
+        }
+
+        location /escape {
+            js_context_reuse 4;
+            js_content test.escape;
+        }
+
+        location /noreuse {
+            js_content test.content;
+        }
+
+        location /small {
+            js_context_reuse 4;
+            js_context_reuse_max_size 1k;
+            js_content test.content;
+        }
+    }
+}
+
+EOF
+
+$t->write_file('test.js', <<'EOF');
+    var visits = 0;
+    var prev;
+    var escaped;
+
+    function content(r) {
+        var stale = (prev !== undefined) ? String(prev.uri) : '-';
+
+        visits++;
+        prev = r;
+
+        r.return(200, `visits:${visits}:${stale}`);
+    }
+
+    function escape(r) {
+        var stale = '-';
+
+        if (escaped !== undefined) {
+            stale = `${escaped.hin.host}:${escaped.hout.foo}:`
+                    + `${escaped.vars.uri}`;
+        }
+
+        r.headersOut.foo = 'bar';
+
+        escaped = { hin: r.headersIn, hout: r.headersOut,
+                    vars: r.variables };
+
+        r.return(200, `escape:${stale}`);
+    }
+
+    export default { content, escape };
+
+EOF
+
+$t->try_run('no njs available')->plan(7);
+
+###############################################################################
+
+like(http_get('/reuse'), qr/visits:1:-$/, 'first request');
+like(http_get('/reuse'), qr/visits:2:undefined$/, 'reused vm');
+like(http_get('/escape'), qr/escape:-$/, 'headers escape');
+like(http_get('/escape'), qr/escape:undefined:undefined:undefined$/,
+	'escaped headers detached');
+like(http_get('/noreuse'), qr/visits:1:-$/, 'no reuse by default');
+like(http_get('/small'), qr/visits:1:-$/, 'max size first');
+like(http_get('/small'), qr/visits:1:-$/, 'max size exceeded');
+
+###############################################################################
@@ -0,0 +1,170 @@
+#!/usr/bin/perl
+
+# (C) F5, Inc.
+
+# Tests for js_gc and js_context_arena directives in http njs module.
+
+###############################################################################
+
+use warnings;
+use strict;
+
+use Test::More;
+
+BEGIN { use FindBin; chdir($FindBin::Bin); }
+
+use lib 'lib';
+use Test::Nginx;
+
+###############################################################################
+
+select STDERR; $| = 1;
+select STDOUT; $| = 1;
+
+my $t = Test::Nginx->new()->has(qw/http proxy/)
+	->write_file_expand('nginx.conf', <<'EOF');
+
+%%TEST_GLOBALS%%
+
+daemon off;
+
+events {
+}
+
+http {
+    %%TEST_GLOBALS_HTTP%%
+
+    js_import test.js;
+
+    js_gc on;
+
+    js_set $v test.v;
+
+    server {
+        listen       127.0.0.1:8080;
+        server_name  localhost;
+
+        location /set {
+            return 200 $v;
+        }
+
+        location /async {
+            js_content test.async;
+        }
+
+        location /filter {
+            proxy_buffering off;
+            js_header_filter test.clear_content_length;
+            js_body_filter test.filter;
+            proxy_pass http://127.0.0.1:8080/source;
+        }
+
+        location /source {
+            js_content test.source;
+        }
+
+        location /arena {
+            js_gc             off;
+            js_context_arena  on;
+            js_content        test.arena;
+        }
+    }
+}
+
+EOF
+
+$t->write_file('test.js', <<EOF);
+    var max = 0;
+
+    function garbage(n) {
+        var a = [];
+
+        for (var i = 0; i < n; i++) {
+            a.push({i: i, s: 'x'.repeat(64) + i});
+        }
+
+        return a;
+    }
+
+    function v(r) {
+        return garbage(50000).length + garbage(10)[9].s.slice(-1);
+    }
+
+    function async(r) {
+        var n = 0;
+
+        function next() {
+            garbage(10000);
+
+            if (++n == 20) {
+                r.return(200, 'done:' + n);
+                return;
+            }
+
+            setTimeout(next, 5);
+        }
+
+        next();
+    }
+
+    function source(r) {
+        var n = 0;
+
+        r.status = 200;
+        r.sendHeader();
+
+        function next() {
+            r.send('x');
+
+            if (++n == 40) {
+                r.finish();
+                return;
+            }
+
+            setTimeout(next, 10);
+        }
+
+        next();
+    }
+
+    function clear_content_length(r) {
+        delete r.headersOut['Content-Length'];
+    }
+
+    function filter(r, data, flags) {
+        max = Math.max(max, njs.memoryStats.size);
+
+        garbage(10000);
+
+        if (flags.last) {
+            r.sendBuffer(data.toUpperCase());
+            r.sendBuffer((max < 16 * 1024 * 1024) ? ':bounded'
+                                                  : ':grown to ' + max,
+                         flags);
+            return;
+        }
+
+        r.sendBuffer(data.toUpperCase(), flags);
+    }
+
+    function arena(r) {
+        r.return(200, String(garbage(1000).length));
+    }
+
+    export default {v, async, source, clear_content_length, filter, arena};
+EOF
+
+$t->try_run('no js_gc')->plan(4);
+
+###############################################################################
+
+like(http_get('/set'), qr/500009$/, 'gc js_set');
+like(http_get('/async'), qr/done:20$/, 'gc async');
+
+# each chunk of a long response leaves megabytes of garbage
+
+like(http_get('/filter'), qr/X{40}:bounded/, 'gc long body filter');
+
+like(http_get('/arena'), qr/1000$/, 'arena');
+
+###############################################################################
@@ -0,0 +1,88 @@
+#!/usr/bin/perl
+
+# (C) F5, Inc.
+
+# Tests for js_profile directive.
+
+###############################################################################
+
+use warnings;
+use strict;
+
+use Test::More;
+
+BEGIN { use FindBin; chdir($FindBin::Bin); }
+
+use lib 'lib';
+use Test::Nginx;
+
+###############################################################################
+
+select STDERR; $| = 1;
+select STDOUT; $| = 1;
+
+my $t = Test::Nginx->new()->has(qw/http/)
+	->write_file_expand('nginx.conf', <<'EOF');
+
+%%TEST_GLOBALS%%
+
+daemon off;
+
+events {
+}
+
+http {
+    %%TEST_GLOBALS_HTTP%%
+
+    js_import test.js;
+
+    js_profile profile interval=1ms;
+
+    server {
+        listen       127.0.0.1:8080;
+        server_name  localhost;
+
+        location /busy {
+            js_content test.busy;
+        }
+    }
+}
+
+EOF
+
+$t->write_file('test.js', <<'EOF');
+    function spin(ms) {
+        var end = Date.now() + ms;
+        var n = 0;
+
+        while (Date.now() < end) {
+            n++;
+        }
+
+        return n;
+    }
+
+    function busy(r) {
+        r.return(200, spin(300) > 0 ? 'SUCCESS' : 'FAIL');
+    }
+
+    export default { busy };
+EOF
+
+$t->try_run('no js_profile');
+
+$t->plan(2);
+
+###############################################################################
+
+like(http_get('/busy'), qr/SUCCESS/, 'busy');
+
+$t->stop();
+
+my ($file) = glob($t->testdir() . '/profile.*');
+$file =~ s!.*/!! if defined $file;
+
+like(defined $file ? $t->read_file($file) : '',
+	qr/busy \([^)]*test\.js:\d+\);spin \([^)]*test\.js:\d+\)/, 'profile');
+
+###############################################################################
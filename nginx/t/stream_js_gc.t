@@ -0,0 +1,157 @@
+#!/usr/bin/perl
+
+# (C) F5, Inc.
+
+# Tests for js_gc and js_context_arena directives in stream njs module.
+
+###############################################################################
+
+use warnings;
+use strict;
+
+use Test::More;
+
+BEGIN { use FindBin; chdir($FindBin::Bin); }
+
+use lib 'lib';
+use Test::Nginx;
+use Test::Nginx::Stream qw/ stream /;
+
+###############################################################################
+
+select STDERR; $| = 1;
+select STDOUT; $| = 1;
+
+my $t = Test::Nginx->new()->has(qw/stream stream_return/)
+	->write_file_expand('nginx.conf', <<'EOF');
+
+%%TEST_GLOBALS%%
+
+daemon off;
+
+events {
+}
+
+stream {
+    %%TEST_GLOBALS_STREAM%%
+
+    js_import test.js;
+
+    js_gc on;
+
+    js_var $res;
+
+    server {
+        listen      127.0.0.1:8081;
+        js_access   test.access;
+        js_set      $v test.v;
+        return      $res:$v;
+    }
+
+    server {
+        listen      127.0.0.1:8082;
+        js_filter   test.filter;
+        proxy_pass  127.0.0.1:8090;
+    }
+
+    server {
+        listen      127.0.0.1:8083;
+        js_preread  test.session;
+        return      $res;
+    }
+
+    server {
+        listen      127.0.0.1:8084;
+        js_gc             off;
+        js_context_arena  on;
+        js_set            $a test.arena;
+        return            $a;
+    }
+
+    server {
+        listen      127.0.0.1:8090;
+        return      abc;
+    }
+}
+
+EOF
+
+$t->write_file('test.js', <<EOF);
+    var kept = [];
+
+    function garbage(n) {
+        var a = [];
+
+        for (var i = 0; i < n; i++) {
+            a.push({i: i, s: 'x'.repeat(64) + i});
+        }
+
+        return a;
+    }
+
+    function access(s) {
+        for (var i = 0; i < 20; i++) {
+            kept.push(garbage(10000)[9999].s.slice(-4));
+        }
+
+        s.variables.res = kept.length + kept[19];
+        s.allow();
+    }
+
+    function v(s) {
+        return garbage(50000).length + kept[0];
+    }
+
+    function filter(s) {
+        s.on('download', function (data, flags) {
+            garbage(50000);
+            s.send(data.toUpperCase(), flags);
+        });
+    }
+
+    function session(s) {
+        var max = 0;
+
+        s.on('upload', function (data, flags) {
+            max = Math.max(max, njs.memoryStats.size);
+
+            garbage(10000);
+
+            if (data.endsWith('end')) {
+                s.variables.res = (max < 16 * 1024 * 1024)
+                                  ? 'bounded:' + (data.length - 3)
+                                  : 'grown to ' + max;
+                s.done();
+            }
+        });
+    }
+
+    function arena(s) {
+        return garbage(1000).length;
+    }
+
+    export default {access, v, filter, session, arena};
+EOF
+
+$t->try_run('no js_gc')->plan(4);
+
+###############################################################################
+
+is(stream('127.0.0.1:' . port(8081))->read(), '209999:500009999',
+	'gc access');
+is(stream('127.0.0.1:' . port(8082))->io('###'), 'ABC', 'gc filter');
+
+# each chunk of a long session leaves megabytes of garbage
+
+my $s = stream('127.0.0.1:' . port(8083));
+
+for (1 .. 40) {
+	$s->write('x');
+	select undef, undef, undef, 0.02;
+}
+
+is($s->io('end'), 'bounded:40', 'gc long session');
+
+is(stream('127.0.0.1:' . port(8084))->read(), '1000', 'arena');
+
+###############################################################################
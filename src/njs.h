@@ -32,6 +32,7 @@ typedef struct njs_mod_s              njs_mod_t;
 typedef union  njs_value_s            njs_value_t;
 typedef struct njs_function_s         njs_function_t;
 typedef struct njs_vm_shared_s        njs_vm_shared_t;
+typedef struct njs_profile_s          njs_profile_t;
 typedef struct njs_object_init_s      njs_object_init_t;
 typedef struct njs_object_prop_s      njs_object_prop_t;
 typedef struct njs_promise_data_s     njs_promise_data_t;
@@ -44,8 +45,10 @@ typedef struct njs_external_s         njs_external_t;
  * sizeof(njs_opaque_value_t) == sizeof(njs_value_t).
  */
 
-typedef struct {
+typedef union {
     uint32_t                        filler[4];
+    /* Keeps the value pointer aligned for the njs_vm_gc() scan. */
+    void                            *align;
 } njs_opaque_value_t;
 
 /* sizeof(njs_value_t) is 16 bytes. */
@@ -145,6 +148,12 @@ typedef enum {
 } njs_promise_type_t;
 
 
+typedef enum {
+    NJS_PROFILE_FOLDED = 0,
+    NJS_PROFILE_PPROF,
+} njs_profile_format_t;
+
+
 typedef enum {
 #define njs_object_enum_kind(flags) (flags & 7)
     NJS_ENUM_KEYS = 1,
@@ -270,6 +279,9 @@ typedef struct {
  *   - Function constructors.
  * module        - ES6 "module" mode. Script mode is default.
  * ast           - print AST.
+ * arena         - clones allocate memory from a bump pointer arena which
+ *   is released only when the clone is destroyed.  The garbage collection
+ *   is not available in clones.
  */
     uint8_t                         interactive;     /* 1 bit */
     uint8_t                         trailer;         /* 1 bit */
@@ -281,6 +293,7 @@ typedef struct {
     uint8_t                         unsafe;          /* 1 bit */
     uint8_t                         module;          /* 1 bit */
     uint8_t                         ast;             /* 1 bit */
+    uint8_t                         arena;           /* 1 bit */
 #ifdef NJS_DEBUG_OPCODE
     uint8_t                         opcode_debug;    /* 1 bit */
 #endif
@@ -321,8 +334,73 @@ NJS_EXPORT njs_mod_t *njs_vm_add_module(njs_vm_t *vm, njs_str_t *name,
 /* Input must be null-terminated. */
 NJS_EXPORT njs_mod_t *njs_vm_compile_module(njs_vm_t *vm, njs_str_t *name,
     u_char **start, u_char *end);
+/*
+ * Serializes the compiled module into a bytecode cache bound to the module
+ * source.  A cache which does not match the source or the njs build is
+ * declined by njs_vm_module_from_bytecode() with NJS_DECLINED.
+ */
+NJS_EXPORT njs_int_t njs_vm_module_bytecode(njs_vm_t *vm, njs_mod_t *module,
+    const njs_str_t *source, njs_str_t *bytecode);
+NJS_EXPORT njs_int_t njs_vm_module_from_bytecode(njs_vm_t *vm, njs_str_t *name,
+    const njs_str_t *source, const njs_str_t *bytecode, njs_mod_t **module);
 NJS_EXPORT njs_int_t njs_vm_reuse(njs_vm_t *vm);
+/*
+ * Serializes the data of the global object properties created after
+ * the VM creation, such as preloaded JSON objects: primitive values and
+ * the plain objects and arrays reachable from them.  Functions and other
+ * objects are rejected.  njs_vm_globals_cache_restore() returns
+ * NJS_DECLINED for a cache made by another njs build or a damaged one.
+ */
+NJS_EXPORT njs_int_t njs_vm_globals_cache(njs_vm_t *vm, njs_str_t *cache);
+NJS_EXPORT njs_int_t njs_vm_globals_cache_restore(njs_vm_t *vm,
+    const njs_str_t *cache);
 NJS_EXPORT njs_vm_t *njs_vm_clone(njs_vm_t *vm, njs_external_ptr_t external);
+/*
+ * Prepares a clone which has finished its work to be used again with
+ * another external instead of creating a new clone.  The global state of
+ * the clone is kept, the exit hook is removed.  The externals the clone
+ * created since the previous njs_vm_reset() become stale: njs_vm_external()
+ * returns NULL for them and for the objects nested in them, the ones
+ * created before the first call are kept.  A host reusing the clones calls
+ * it once after njs_vm_start() of a new clone, so the externals of its
+ * first request are not kept.  NJS_DECLINED is returned while the clone
+ * runs or has pending jobs and when the clone was reset too many times.
+ */
+NJS_EXPORT njs_int_t njs_vm_reset(njs_vm_t *vm, njs_external_ptr_t external);
+
+/*
+ * Garbage collection of the VM memory.  njs_vm_gc() frees the memory not
+ * reachable from the VM and from the "roots" memory ranges, which must
+ * cover all the values and the pointers to the VM memory kept by the host.
+ * It returns NJS_DECLINED while the VM is running and for the clones with
+ * the "arena" option.  njs_vm_gc_step() does the same in steps scanning
+ * about "size" bytes each, it returns NJS_AGAIN until the collection is
+ * finished.  The host must not change the VM values between the steps
+ * other than the roots, running the VM abandons the collection.
+ * njs_vm_gc_pending() tells whether the VM memory has grown enough since
+ * the last collection or a collection is in progress.
+ */
+NJS_EXPORT njs_int_t njs_vm_gc(njs_vm_t *vm, njs_str_t *roots,
+    njs_uint_t nroots);
+NJS_EXPORT njs_int_t njs_vm_gc_step(njs_vm_t *vm, njs_str_t *roots,
+    njs_uint_t nroots, size_t size);
+NJS_EXPORT njs_bool_t njs_vm_gc_pending(njs_vm_t *vm);
+
+/*
+ * Sampling profiler.  njs_profile_tick() is async-signal-safe and is meant
+ * to be called by a timer signal handler every "period" microseconds,
+ * the VMs the profile is attached to, and their clones, record the JS call
+ * stack at the next backward jump or call.  Lines are known with
+ * the backtrace option.  The dump is valid until the next dump or
+ * njs_profile_destroy().
+ */
+NJS_EXPORT njs_profile_t *njs_profile_create(njs_uint_t period);
+NJS_EXPORT void njs_profile_destroy(njs_profile_t *profile);
+NJS_EXPORT void njs_vm_profile(njs_vm_t *vm, njs_profile_t *profile);
+NJS_EXPORT void njs_profile_tick(void);
+NJS_EXPORT njs_uint_t njs_profile_samples(njs_profile_t *profile);
+NJS_EXPORT njs_int_t njs_profile_dump(njs_profile_t *profile,
+    njs_profile_format_t format, njs_str_t *dst);
 
 NJS_EXPORT njs_int_t njs_vm_enqueue_job(njs_vm_t *vm, njs_function_t *function,
     const njs_value_t *args, njs_uint_t nargs);
@@ -395,6 +473,7 @@ NJS_EXPORT njs_function_t *njs_vm_function_alloc(njs_vm_t *vm,
     njs_function_native_t native, njs_bool_t shared, njs_bool_t ctor);
 
 NJS_EXPORT void njs_disassembler(njs_vm_t *vm);
+NJS_EXPORT size_t njs_vm_code_size(njs_vm_t *vm);
 
 NJS_EXPORT njs_int_t njs_vm_bind(njs_vm_t *vm, const njs_str_t *var_name,
     const njs_value_t *value, njs_bool_t shared);
@@ -421,7 +500,10 @@ NJS_EXPORT njs_external_ptr_t njs_vm_external_ptr(njs_vm_t *vm);
 NJS_EXPORT njs_int_t njs_value_to_integer(njs_vm_t *vm, njs_value_t *value,
     int64_t *dst);
 
-/*  Gets string value, no copy. */
+/*
+ * Gets string value, no copy.  A rope is flattened, the string is empty
+ * if there is no memory for that, njs_vm_value_string() reports the error.
+ */
 NJS_EXPORT void njs_value_string_get(njs_vm_t *vm, njs_value_t *value,
     njs_str_t *dst);
 NJS_EXPORT njs_int_t njs_vm_value_string_create(njs_vm_t *vm,
@@ -485,6 +567,8 @@ NJS_EXPORT void njs_value_function_set(njs_value_t *value,
     njs_function_t *function);
 NJS_EXPORT void njs_value_external_set(njs_value_t *value,
     njs_external_ptr_t external);
+/* njs_vm_external() does not return the external of a detached value. */
+NJS_EXPORT void njs_value_external_detach(njs_value_t *value);
 
 NJS_EXPORT uint8_t njs_value_bool(const njs_value_t *value);
 NJS_EXPORT double njs_value_number(const njs_value_t *value);
@@ -818,6 +818,10 @@ njs_array_prototype_slice_copy(njs_vm_t *vm, njs_value_t *this,
                 this = njs_object_value(this);
             }
 
+            if (njs_slow_path(njs_string_flatten(vm, this) != NJS_OK)) {
+                return NJS_ERROR;
+            }
+
             string_slice.start = start;
             string_slice.length = length;
             string_slice.string_length = njs_string_prop(vm, &string, this);
@@ -1684,13 +1688,30 @@ njs_array_prototype_join(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
     NJS_CHB_MP_INIT_MAX(&chain, njs_vm_memory_pool(vm), NJS_STRING_MAX_LENGTH);
 
     for (i = 0; i < len; i++) {
-        ret = njs_value_property_i64(vm, this, i, value);
-        if (njs_slow_path(ret == NJS_ERROR)) {
-            return ret;
+        if (njs_fast_path(njs_is_fast_array(this)
+                          && i < njs_array_len(this)
+                          && njs_is_valid(&njs_array_start(this)[i])))
+        {
+            /* A copy, toString() of an element may resize the array. */
+            njs_value_assign(value, &njs_array_start(this)[i]);
+
+        } else {
+            ret = njs_value_property_i64(vm, this, i, value);
+            if (njs_slow_path(ret == NJS_ERROR)) {
+                return ret;
+            }
         }
 
         if (!njs_is_null_or_undefined(value)) {
-            if (!njs_is_string(value)) {
+            if (njs_is_number(value)) {
+                ret = njs_number_to_chain(vm, &chain, njs_number(value));
+                if (njs_slow_path(ret < NJS_OK)) {
+                    return ret;
+                }
+
+                length += ret;
+
+            } else if (!njs_is_string(value)) {
                 ret = njs_value_to_chain(vm, &chain, value);
                 if (njs_slow_path(ret < NJS_OK)) {
                     return ret;
@@ -1699,6 +1720,10 @@ njs_array_prototype_join(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
                 length += ret;
 
             } else {
+                if (njs_slow_path(njs_string_flatten(vm, value) != NJS_OK)) {
+                    return NJS_ERROR;
+                }
+
                 (void) njs_string_prop(vm, &string, value);
                 length += string.length;
                 njs_chb_append(&chain, string.start, string.size);
@@ -2186,6 +2211,59 @@ njs_array_handler_index_of(njs_vm_t *vm, njs_iterator_args_t *args,
 }
 
 
+/*
+ * Arrays do not record the kind of their elements, so the search compares
+ * the elements as it reads them and stops at the first hole.
+ */
+
+static njs_int_t
+njs_array_number_index(njs_iterator_args_t *args, njs_bool_t same_zero,
+    njs_value_t *retval)
+{
+    double       num, n;
+    int64_t      i, to;
+    njs_array_t  *array;
+    njs_value_t  *start;
+
+    array = njs_array(njs_value_arg(&args->value));
+    num = njs_number(njs_value_arg(&args->argument));
+
+    start = array->start;
+    to = njs_min(args->to, array->length);
+
+    for (i = args->from; i < to; i++) {
+        if (njs_fast_path(njs_is_number(&start[i]))) {
+            n = njs_number(&start[i]);
+
+            if (n == num || (same_zero && isnan(n) && isnan(num))) {
+                if (same_zero) {
+                    njs_set_true(retval);
+
+                } else {
+                    njs_set_number(retval, i);
+                }
+
+                return NJS_DONE;
+            }
+
+            continue;
+        }
+
+        if (njs_slow_path(!njs_is_valid(&start[i]))) {
+            break;
+        }
+    }
+
+    if (i == args->to) {
+        return NJS_OK;
+    }
+
+    args->from = i;
+
+    return NJS_DECLINED;
+}
+
+
 static njs_int_t
 njs_array_handler_for_each(njs_vm_t *vm, njs_iterator_args_t *args,
     njs_value_t *entry, int64_t n, njs_value_t *retval)
@@ -2427,6 +2505,23 @@ njs_array_prototype_iterator(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
             }
         }
 
+        if (njs_is_fast_array(njs_value_arg(&iargs.value))
+            && njs_is_number(njs_value_arg(&iargs.argument)))
+        {
+            ret = njs_array_number_index(&iargs,
+                               njs_array_type(magic) == NJS_ARRAY_INCLUDES,
+                               retval);
+            if (ret == NJS_DONE) {
+                return NJS_OK;
+            }
+
+            if (ret == NJS_OK) {
+                goto done;
+            }
+
+            /* A hole or a shrunk array, the rest is looked up generically. */
+        }
+
         break;
 
     case NJS_ARRAY_FOR_EACH:
@@ -2734,6 +2829,108 @@ exception:
 }
 
 
+/*
+ * The sorted values are checked on every sort, the array does not record
+ * the kind of its elements.  The pass costs less than creating a string
+ * for each element.
+ */
+
+static njs_bool_t
+njs_array_slots_int32(njs_array_sort_slot_t *slots, int64_t nslots)
+{
+    double                 num;
+    njs_array_sort_slot_t  *p, *end;
+
+    end = slots + nslots;
+
+    for (p = slots; p < end; p++) {
+        if (!njs_is_number(&p->value)) {
+            return 0;
+        }
+
+        num = njs_number(&p->value);
+
+        if (!(num >= INT32_MIN && num <= INT32_MAX && num == (int32_t) num)) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+njs_inline uint32_t
+njs_array_decimal_digits(uint32_t n)
+{
+    uint32_t  digits;
+
+    digits = 1;
+
+    while (n >= 10) {
+        n /= 10;
+        digits++;
+    }
+
+    return digits;
+}
+
+
+/*
+ * Compares the decimal representations of int32 numbers the way
+ * the default comparator compares their strings, without creating them.
+ */
+
+static int
+njs_array_compare_int32(const void *a, const void *b, void *c)
+{
+    int32_t                x, y;
+    uint32_t               ux, uy, dx, dy;
+    uint64_t               sx, sy;
+    njs_array_sort_slot_t  *aslot, *bslot;
+
+    aslot = (njs_array_sort_slot_t *) a;
+    bslot = (njs_array_sort_slot_t *) b;
+
+    x = (int32_t) njs_number(&aslot->value);
+    y = (int32_t) njs_number(&bslot->value);
+
+    if (x == y) {
+        /* Ensures stable sorting, -0 and 0 are both "0". */
+        return (aslot->pos > bslot->pos) - (aslot->pos < bslot->pos);
+    }
+
+    if ((x < 0) != (y < 0)) {
+        /* "-" precedes digits. */
+        return (x < 0) ? -1 : 1;
+    }
+
+    ux = (x < 0) ? 0 - (uint32_t) x : (uint32_t) x;
+    uy = (y < 0) ? 0 - (uint32_t) y : (uint32_t) y;
+
+    dx = njs_array_decimal_digits(ux);
+    dy = njs_array_decimal_digits(uy);
+
+    sx = ux;
+    sy = uy;
+
+    for ( /* void */ ; dx < dy; dx++) {
+        sx *= 10;
+    }
+
+    for ( /* void */ ; dy < dx; dy++) {
+        sy *= 10;
+    }
+
+    if (sx != sy) {
+        return (sx > sy) - (sx < sy);
+    }
+
+    /* One is a prefix of the other, the shorter string is less. */
+
+    return (ux > uy) - (ux < uy);
+}
+
+
 static njs_array_sort_slot_t *
 njs_sort_indexed_properties(njs_vm_t *vm, njs_value_t *obj, int64_t length,
     njs_function_t *compare, njs_bool_t skip_holes, int64_t *nslots,
@@ -2768,9 +2965,18 @@ njs_sort_indexed_properties(njs_vm_t *vm, njs_value_t *obj, int64_t length,
         p = slots;
 
         for (i = 0; i < length; i++) {
-            ret = njs_value_property_i64(vm, obj, i, &p->value);
-            if (njs_slow_path(ret == NJS_ERROR)) {
-                goto exception;
+            if (njs_fast_path(njs_is_fast_array(obj)
+                              && i < njs_array_len(obj)
+                              && njs_is_valid(&njs_array_start(obj)[i])))
+            {
+                njs_value_assign(&p->value, &njs_array_start(obj)[i]);
+                ret = NJS_OK;
+
+            } else {
+                ret = njs_value_property_i64(vm, obj, i, &p->value);
+                if (njs_slow_path(ret == NJS_ERROR)) {
+                    goto exception;
+                }
             }
 
             if (ret == NJS_DECLINED && skip_holes) {
@@ -2885,6 +3091,14 @@ njs_sort_indexed_properties(njs_vm_t *vm, njs_value_t *obj, int64_t length,
         }
     }
 
+    if (compare == NULL && njs_array_slots_int32(slots, *nslots)) {
+        njs_qsort(slots, *nslots, sizeof(njs_array_sort_slot_t),
+                  njs_array_compare_int32, NULL);
+
+        ret = NJS_OK;
+        goto exception;
+    }
+
     strings = njs_arr_init(vm->mem_pool, &ctx.strings, NULL, *nslots + 1,
                            sizeof(njs_value_t));
     if (njs_slow_path(strings == NULL)) {
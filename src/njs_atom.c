@@ -11,6 +11,8 @@
 #define njs_atom_string_key(hash)  ((hash) & 0x7FFFFFFF)
 
 static njs_int_t njs_lexer_hash_test(njs_flathsh_query_t *fhq, void *data);
+static const njs_value_t *njs_atom_predefined_find(const u_char *key,
+    size_t size, uint32_t hash);
 
 
 const njs_value_t njs_atom[] = {
@@ -34,6 +36,14 @@ const njs_value_t njs_atom[] = {
 };
 
 
+/*
+ * The predefined atoms are not inserted into the atom hash,
+ * they are found with the generated perfect hash.
+ */
+
+#include <njs_atom_hash.h>
+
+
 const njs_flathsh_proto_t  njs_lexer_hash_proto
     njs_aligned(64) =
 {
@@ -67,12 +77,42 @@ njs_lexer_hash_test(njs_flathsh_query_t *fhq, void *data)
 }
 
 
-njs_value_t *
+static const njs_value_t *
+njs_atom_predefined_find(const u_char *key, size_t size, uint32_t hash)
+{
+    njs_uint_t         n;
+    const njs_value_t  *value;
+
+    n = njs_atom_hash_slots[njs_atom_hash_slot(hash)];
+
+    if (n == NJS_ATOM_SIZE) {
+        return NULL;
+    }
+
+    value = &njs_atom[n];
+
+    if (value->string.data->size != size
+        || memcmp(value->string.data->start, key, size) != 0)
+    {
+        return NULL;
+    }
+
+    return value;
+}
+
+
+const njs_value_t *
 njs_atom_find(njs_vm_t *vm, u_char *key, size_t size, uint32_t hash)
 {
     njs_int_t            ret;
+    const njs_value_t    *value;
     njs_flathsh_query_t  fhq;
 
+    value = njs_atom_predefined_find(key, size, hash);
+    if (value != NULL) {
+        return value;
+    }
+
     fhq.key.start = key;
     fhq.key.length = size;
     fhq.key_hash = njs_atom_string_key(hash);
@@ -168,54 +208,32 @@ njs_atom_symbol_add(njs_vm_t *vm, njs_value_t *value)
 uint32_t
 njs_atom_hash_init(njs_vm_t *vm)
 {
-    u_char               *start;
-    size_t               len;
-    njs_int_t            ret;
-    njs_uint_t           n;
-    const njs_value_t    *value, *values;
-    njs_flathsh_query_t  fhq;
-
-    values = &njs_atom[0];
-
-    njs_flathsh_init(&vm->atom_hash_shared);
+#if (NJS_DEBUG)
+    u_char             *start;
+    size_t             size;
+    njs_uint_t         n;
+    const njs_value_t  *value;
 
-    fhq.replace = 0;
-    fhq.proto = &njs_lexer_hash_proto;
-    fhq.pool = vm->mem_pool;
+    /* njs_atom_hash.h is to be regenerated after njs_atom_defs.h changes. */
 
     for (n = 0; n < NJS_ATOM_SIZE; n++) {
-        value = &values[n];
-
-        if (value->type == NJS_SYMBOL) {
-            fhq.key_hash = njs_atom_symbol_key(value->string.atom_id);
-
-            ret = njs_flathsh_unique_insert(&vm->atom_hash_shared,
-                                            &fhq);
-            if (njs_slow_path(ret != NJS_OK)) {
-                njs_internal_error(vm, "flathsh insert/replace failed");
-                return 0xffffffff;
-            }
-        }
+        value = &njs_atom[n];
 
         if (value->type == NJS_STRING) {
             start = value->string.data->start;
-            len = value->string.data->length;
-
-            fhq.key_hash = njs_atom_string_key(njs_djb_hash(start, len));
-            fhq.key.length = len;
-            fhq.key.start = start;
+            size = value->string.data->size;
 
-            ret = njs_flathsh_insert(&vm->atom_hash_shared, &fhq);
-            if (njs_slow_path(ret != NJS_OK)) {
-                njs_internal_error(vm, "flathsh insert/replace failed");
-                return 0xffffffff;
-            }
+            njs_assert(njs_atom_predefined_find(start, size,
+                                                njs_djb_hash(start, size))
+                       == value);
         }
-
-        *njs_prop_value(fhq.value) = *value;
     }
+#endif
+
+    njs_flathsh_init(&vm->atom_hash_shared);
 
     vm->atom_hash_current = &vm->atom_hash_shared;
+    vm->shared_atom_count = NJS_ATOM_SIZE;
 
     return NJS_ATOM_SIZE;
 }
@@ -234,6 +252,13 @@ njs_atom_atomize_key(njs_vm_t *vm, njs_value_t *value)
 
     switch (value->type) {
     case NJS_STRING:
+        if (njs_slow_path(njs_string_is_rope(value->string.data))) {
+            value->string.data = njs_string_flat(vm, value->string.data);
+            if (njs_slow_path(value->string.data == NULL)) {
+                return NJS_ERROR;
+            }
+        }
+
         num = njs_key_to_index(value);
         u32 = (uint32_t) num;
 
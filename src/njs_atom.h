@@ -19,9 +19,12 @@ enum {
 };
 
 
+extern const njs_value_t  njs_atom[];
+
+
 uint32_t njs_atom_hash_init(njs_vm_t *vm);
 njs_int_t njs_atom_symbol_add(njs_vm_t *vm, njs_value_t *value);
-njs_value_t *njs_atom_find(njs_vm_t *vm, u_char *key, size_t size,
+const njs_value_t *njs_atom_find(njs_vm_t *vm, u_char *key, size_t size,
     uint32_t hash);
 njs_value_t *njs_atom_add(njs_vm_t *vm, njs_value_t *value, uint32_t hash);
 
@@ -49,8 +52,21 @@ njs_atom_to_value(njs_vm_t *vm, njs_value_t *dst, uint32_t atom_id)
         return NJS_OK;
     }
 
+    if (atom_id < NJS_ATOM_SIZE) {
+        *dst = njs_atom[atom_id];
+        return NJS_OK;
+    }
+
+    /*
+     * The atoms added to a parent VM are numbered from NJS_ATOM_SIZE,
+     * the atoms added to a clone from shared_atom_count.  A parent VM
+     * has no separate current hash, so its shared_atom_count is
+     * NJS_ATOM_SIZE.
+     */
+
     if (atom_id < vm->shared_atom_count) {
         h = vm->atom_hash_shared.slot;
+        atom_id -= NJS_ATOM_SIZE;
 
         njs_assert(atom_id < h->elts_count);
 
@@ -0,0 +1,353 @@
+
+/*
+ * Copyright (C) F5, Inc.
+ *
+ * Do not edit, generated by: utils/atom_hash.py.
+ */
+
+
+#ifndef _NJS_ATOM_HASH_H_INCLUDED_
+#define _NJS_ATOM_HASH_H_INCLUDED_
+
+
+#define NJS_ATOM_HASH_BITS     10
+#define NJS_ATOM_HASH_BUCKETS  256
+
+
+#define njs_atom_hash_slot(hash)                                              \
+    ((uint32_t) (((hash)                                                      \
+                  ^ njs_atom_hash_displace[(hash)                             \
+                                           & (NJS_ATOM_HASH_BUCKETS - 1)])    \
+                 * 0x9e3779b1) >> (32 - NJS_ATOM_HASH_BITS))
+
+
+static const uint16_t  njs_atom_hash_displace[256] = {
+    1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 2, 2, 0, 0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0,
+    0, 1, 1, 1, 0, 2, 0, 0, 0, 0, 0, 5, 0, 0, 0, 1, 2, 0, 0, 1, 0, 0, 0, 2, 0,
+    2, 1, 0, 0, 0, 0, 0, 0, 0, 3, 4, 0, 0, 0, 1, 3, 0, 1, 2, 1, 0, 0, 0, 2, 0,
+    0, 0, 0, 0, 3, 0, 7, 0, 0, 2, 0, 0, 0, 2, 0, 0, 0, 1, 1, 2, 0, 0, 0, 4, 2,
+    0, 0, 0, 2, 0, 0, 0, 1, 4, 1, 0, 0, 0, 1, 8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 1, 0, 2, 1, 0, 1, 2, 0, 0, 0, 2, 0, 1, 1, 3, 0, 0, 0, 1, 1,
+    0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 2, 4, 1, 2, 0, 3, 2, 0, 0, 1,
+    0, 4, 0, 0, 0, 2, 1, 0, 0, 1, 0, 0, 2, 0, 0, 0, 0, 1, 1, 5, 2, 0, 0, 0, 0,
+    1, 0, 3, 0, 0, 1, 3, 2, 0, 0, 2, 0, 0, 1, 0, 0, 10, 3, 0, 0, 0, 0, 4, 2, 0,
+    0, 0, 3, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 1, 0, 0, 3, 6, 0, 0, 1, 1, 0,
+    0, 0, 0, 1, 0, 8,
+};
+
+
+static const uint16_t  njs_atom_hash_slots[1024] = {
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_floor, NJS_ATOM_STRING_yield, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_create, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_getFullYear, NJS_ATOM_STRING_errors, NJS_ATOM_STRING_atob,
+    NJS_ATOM_STRING__Setter_, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_setMinutes, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_setFloat32, NJS_ATOM_SIZE, NJS_ATOM_STRING_empty,
+    NJS_ATOM_STRING__object_String_, NJS_ATOM_SIZE, NJS_ATOM_STRING_fileName,
+    NJS_ATOM_STRING_trimStart, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_arguments, NJS_ATOM_STRING_swap16, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_splice, NJS_ATOM_SIZE, NJS_ATOM_STRING_Int32Array,
+    NJS_ATOM_STRING_swap64, NJS_ATOM_STRING_readDoubleBE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_clz32,
+    NJS_ATOM_STRING__object_Function_, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_writeUInt32LE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_acosh, NJS_ATOM_STRING_globalThis,
+    NJS_ATOM_STRING_toPrimitive, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_setTime, NJS_ATOM_STRING_toLocaleTimeString, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_writeDoubleBE, NJS_ATOM_SIZE, NJS_ATOM_STRING_extends,
+    NJS_ATOM_STRING_charAt, NJS_ATOM_STRING_value, NJS_ATOM_STRING_await,
+    NJS_ATOM_STRING_toString, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_isFinite, NJS_ATOM_STRING_getInt32,
+    NJS_ATOM_STRING_copyWithin, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_true, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_readIntLE, NJS_ATOM_SIZE, NJS_ATOM_STRING_Uint8Array,
+    NJS_ATOM_STRING_lineNumber, NJS_ATOM_STRING_fround, NJS_ATOM_STRING_flags,
+    NJS_ATOM_STRING_All_promises_were_rejected, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_abs, NJS_ATOM_STRING_sticky, NJS_ATOM_STRING_getTime,
+    NJS_ATOM_STRING_status, NJS_ATOM_STRING_keys, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_setUTCMinutes, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_Error, NJS_ATOM_SIZE, NJS_ATOM_STRING_all, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_Int16Array, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_meta, NJS_ATOM_STRING_prototype, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_getUint8,
+    NJS_ATOM_STRING_some, NJS_ATOM_STRING_replace, NJS_ATOM_STRING_URIError,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING__object_Object_,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_encodeInto, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_round,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_toDateString,
+    NJS_ATOM_STRING_toSpliced, NJS_ATOM_STRING_for, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_toSorted,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_hasInstance, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING__object_Undefined_, NJS_ATOM_STRING__object_Arguments_,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_string, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_species, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_getUTCMonth, NJS_ATOM_SIZE, NJS_ATOM_STRING_isSafeInteger,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_isBuffer, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_isExtensible, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING___proto__, NJS_ATOM_STRING_fatal, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_log2, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_try, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_on,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_case, NJS_ATOM_STRING_concat, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_isConcatSpreadable, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_typeof,
+    NJS_ATOM_STRING_ArrayBuffer, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_Number, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_external, NJS_ATOM_STRING_getTimezoneOffset, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_next, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_writeUIntBE,
+    NJS_ATOM_STRING_decode, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_env, NJS_ATOM_SIZE, NJS_ATOM_STRING_MAX_LENGTH,
+    NJS_ATOM_STRING_MAX_STRING_LENGTH, NJS_ATOM_SIZE, NJS_ATOM_STRING_indexOf,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING__Infinity,
+    NJS_ATOM_STRING_getOwnPropertyDescriptor, NJS_ATOM_STRING_toStringTag,
+    NJS_ATOM_STRING_kill, NJS_ATOM_SIZE, NJS_ATOM_STRING_toPrecision,
+    NJS_ATOM_STRING_else, NJS_ATOM_SIZE, NJS_ATOM_STRING_Math, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_null, NJS_ATOM_STRING_writeDoubleLE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_call, NJS_ATOM_SIZE, NJS_ATOM_STRING_getInt16,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_test,
+    NJS_ATOM_STRING_Float64Array, NJS_ATOM_SIZE, NJS_ATOM_STRING__object_Date_,
+    NJS_ATOM_STRING_substring, NJS_ATOM_STRING_getUTCDay,
+    NJS_ATOM_STRING_setUint16, NJS_ATOM_STRING_enum,
+    NJS_ATOM_STRING_Invalid_Date, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_min, NJS_ATOM_STRING_stream, NJS_ATOM_STRING_then,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_lastIndex, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_isInteger, NJS_ATOM_STRING_engine,
+    NJS_ATOM_STRING_TextDecoder, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_getSeconds, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_export, NJS_ATOM_SIZE, NJS_ATOM_STRING_toLocaleDateString,
+    NJS_ATOM_STRING_MIN_SAFE_INTEGER, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_target, NJS_ATOM_STRING_setDate, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_now, NJS_ATOM_STRING_static, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_reverse,
+    NJS_ATOM_STRING_getInt8, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_InternalError, NJS_ATOM_STRING_decodeURI, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_done, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_filter, NJS_ATOM_STRING_reject,
+    NJS_ATOM_STRING_readDoubleLE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_POSITIVE_INFINITY, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_caller, NJS_ATOM_STRING_acos,
+    NJS_ATOM_STRING_MAX_SAFE_INTEGER, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING__object_Number_, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_is, NJS_ATOM_SIZE, NJS_ATOM_STRING_Boolean,
+    NJS_ATOM_STRING_getDay, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_replaceAll, NJS_ATOM_SIZE, NJS_ATOM_STRING_unscopables,
+    NJS_ATOM_STRING_do, NJS_ATOM_SIZE, NJS_ATOM_STRING_apply, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_setPrototypeOf, NJS_ATOM_STRING_ignoreCase, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_anonymous, NJS_ATOM_STRING_if, NJS_ATOM_STRING_sort,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_imul, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_cluster_size, NJS_ATOM_STRING_trim,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_readFloatLE, NJS_ATOM_STRING_catch,
+    NJS_ATOM_STRING_padEnd, NJS_ATOM_STRING_readInt8, NJS_ATOM_STRING_encoding,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_readUInt16LE,
+    NJS_ATOM_STRING_require, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_getOwnPropertySymbols, NJS_ATOM_STRING_lastIndexOf,
+    NJS_ATOM_STRING_Object, NJS_ATOM_SIZE, NJS_ATOM_STRING_input, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_public, NJS_ATOM_SIZE, NJS_ATOM_STRING_allocUnsafeSlow,
+    NJS_ATOM_STRING_writeInt32LE, NJS_ATOM_SIZE, NJS_ATOM_STRING_number,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_trunc, NJS_ATOM_STRING_race, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_LOG10E, NJS_ATOM_STRING_in, NJS_ATOM_STRING_isFrozen,
+    NJS_ATOM_STRING_sin, NJS_ATOM_SIZE, NJS_ATOM_STRING_allocUnsafe,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_writeFloatLE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_sqrt, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_isArray,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_shift, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_setSeconds, NJS_ATOM_STRING_name,
+    NJS_ATOM_STRING_private, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_join, NJS_ATOM_SIZE, NJS_ATOM_STRING_equals,
+    NJS_ATOM_STRING_log1p, NJS_ATOM_STRING_setUTCDate, NJS_ATOM_STRING_random,
+    NJS_ATOM_STRING_PI, NJS_ATOM_STRING_decodeURIComponent, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_iterator, NJS_ATOM_SIZE, NJS_ATOM_STRING_writeUInt16LE,
+    NJS_ATOM_STRING_Infinity, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_with, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_getFloat32,
+    NJS_ATOM_STRING_every, NJS_ATOM_STRING_encode, NJS_ATOM_STRING_LN2,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_message, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_isEncoding, NJS_ATOM_SIZE, NJS_ATOM_STRING_from,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_symbol, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_argv, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_SyntaxError, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_getUTCFullYear, NJS_ATOM_STRING_toExponential,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_delete,
+    NJS_ATOM_STRING_setInt8, NJS_ATOM_SIZE, NJS_ATOM_STRING_hasOwnProperty,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_isPrototypeOf, NJS_ATOM_STRING_import,
+    NJS_ATOM_STRING_index, NJS_ATOM_STRING_bind, NJS_ATOM_STRING_fromCodePoint,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_writeInt16LE, NJS_ATOM_STRING_get,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_reason,
+    NJS_ATOM_STRING_padStart, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_written, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_UTC,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_asinh, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_Function, NJS_ATOM_SIZE, NJS_ATOM_STRING_getMinutes,
+    NJS_ATOM_STRING_keyFor, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_slice, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_groups, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_parseInt, NJS_ATOM_SIZE, NJS_ATOM_STRING_configurable,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_SQRT1_2,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_readUIntBE, NJS_ATOM_STRING_encodeURI,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_exec, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_pow, NJS_ATOM_STRING_writeIntBE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_SQRT2, NJS_ATOM_STRING_JSON,
+    NJS_ATOM_STRING_fill, NJS_ATOM_STRING_LOG2E, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_readUInt16BE, NJS_ATOM_STRING_findIndex,
+    NJS_ATOM_STRING_String, NJS_ATOM_SIZE, NJS_ATOM_STRING_LN10,
+    NJS_ATOM_STRING_expm1, NJS_ATOM_SIZE, NJS_ATOM_STRING_finally,
+    NJS_ATOM_STRING_const, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_unknown, NJS_ATOM_SIZE, NJS_ATOM_STRING_preventExtensions,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_atan2, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_writeInt16BE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_defineProperty, NJS_ATOM_STRING_getUTCMinutes,
+    NJS_ATOM_STRING_toLocaleString, NJS_ATOM_STRING_tanh,
+    NJS_ATOM_STRING_EPSILON, NJS_ATOM_SIZE, NJS_ATOM_STRING_void,
+    NJS_ATOM_STRING__object_Null_, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_setUTCHours, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_alloc, NJS_ATOM_STRING_sinh, NJS_ATOM_STRING_version_number,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_Buffer,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_ReferenceError, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_values, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_search, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_cbrt,
+    NJS_ATOM_STRING_writeFloatBE, NJS_ATOM_SIZE, NJS_ATOM_STRING_codePointAt,
+    NJS_ATOM_STRING_pid, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_writeInt8, NJS_ATOM_SIZE, NJS_ATOM_STRING_ppid,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_setUint8, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_setUTCMonth,
+    NJS_ATOM_STRING_writeUInt16BE, NJS_ATOM_STRING_getDate, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_byteLength, NJS_ATOM_SIZE, NJS_ATOM_STRING_parse,
+    NJS_ATOM_STRING_enumerable, NJS_ATOM_STRING_unshift, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_E, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_asin,
+    NJS_ATOM_STRING_MemoryError, NJS_ATOM_STRING__object_Error_,
+    NJS_ATOM_STRING_setUTCFullYear, NJS_ATOM_SIZE, NJS_ATOM_STRING_Int8Array,
+    NJS_ATOM_STRING_while, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_setFullYear, NJS_ATOM_STRING_fulfilled,
+    NJS_ATOM_STRING_setFloat64, NJS_ATOM_SIZE, NJS_ATOM_STRING_toUpperCase,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_global,
+    NJS_ATOM_STRING_getFloat64, NJS_ATOM_STRING__Getter_, NJS_ATOM_STRING_map,
+    NJS_ATOM_STRING_return, NJS_ATOM_STRING_of, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_startsWith, NJS_ATOM_STRING__object_Array_, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_class, NJS_ATOM_SIZE, NJS_ATOM_STRING_isNaN, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_length, NJS_ATOM_SIZE, NJS_ATOM_STRING_cos,
+    NJS_ATOM_STRING_spec_EMPTY_REGEXP, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_writeIntLE, NJS_ATOM_STRING_usec, NJS_ATOM_STRING_protected,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_setInt16, NJS_ATOM_STRING_var,
+    NJS_ATOM_STRING_pop, NJS_ATOM_STRING_freeze, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_getHours, NJS_ATOM_SIZE, NJS_ATOM_STRING_Symbol,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_ignoreBOM, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_subarray, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_toISOString, NJS_ATOM_SIZE, NJS_ATOM_STRING__262,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_writeUIntLE,
+    NJS_ATOM_STRING_hypot, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING__object_Boolean_, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING__object_RegExp_, NJS_ATOM_STRING_valueOf, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_toReversed, NJS_ATOM_STRING_getOwnPropertyDescriptors,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_trimEnd, NJS_ATOM_STRING_max,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_toJSON, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_constructor, NJS_ATOM_SIZE, NJS_ATOM_STRING_setUint32,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_Uint16Array,
+    NJS_ATOM_STRING_sign, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_false,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_readInt16LE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_getUTCHours, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_Float32Array, NJS_ATOM_STRING_memoryStats,
+    NJS_ATOM_STRING_undefined, NJS_ATOM_SIZE, NJS_ATOM_STRING_compare,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_MIN_VALUE, NJS_ATOM_STRING_process,
+    NJS_ATOM_STRING_reduceRight, NJS_ATOM_STRING_callee, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_setUTCMilliseconds,
+    NJS_ATOM_STRING_AsyncFunction, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_hasOwn, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_assign, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_utf_8, NJS_ATOM_STRING_eval, NJS_ATOM_STRING_implements,
+    NJS_ATOM_STRING_setMonth, NJS_ATOM_SIZE, NJS_ATOM_STRING_object,
+    NJS_ATOM_STRING_debugger, NJS_ATOM_SIZE, NJS_ATOM_STRING_forEach,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_njs, NJS_ATOM_SIZE, NJS_ATOM_STRING_reduce,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_propertyIsEnumerable,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_async, NJS_ATOM_SIZE, NJS_ATOM_STRING_split,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_buffer, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_charCodeAt, NJS_ATOM_SIZE, NJS_ATOM_STRING_getUTCDate,
+    NJS_ATOM_STRING_getUTCSeconds, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_data, NJS_ATOM_SIZE, NJS_ATOM_STRING__Getter_Setter_,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_tan, NJS_ATOM_STRING_atanh,
+    NJS_ATOM_STRING_instanceof, NJS_ATOM_STRING_MAX_VALUE,
+    NJS_ATOM_STRING_setUTCSeconds, NJS_ATOM_STRING_entries,
+    NJS_ATOM_STRING_dump, NJS_ATOM_STRING_size, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_endsWith, NJS_ATOM_STRING_Date, NJS_ATOM_STRING_toFixed,
+    NJS_ATOM_STRING_switch, NJS_ATOM_STRING_continue, NJS_ATOM_STRING_nblocks,
+    NJS_ATOM_STRING_Array_Iterator, NJS_ATOM_STRING_isView, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_readInt32LE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_setHours, NJS_ATOM_STRING_writable,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_exp, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_NEGATIVE_INFINITY, NJS_ATOM_STRING_substr,
+    NJS_ATOM_STRING_toUTCString, NJS_ATOM_STRING_interface,
+    NJS_ATOM_STRING_setMilliseconds, NJS_ATOM_STRING_let, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_readUInt32BE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_ceil, NJS_ATOM_STRING_AggregateError,
+    NJS_ATOM_STRING_TypeError, NJS_ATOM_SIZE, NJS_ATOM_STRING_log,
+    NJS_ATOM_STRING_setInt32, NJS_ATOM_SIZE, NJS_ATOM_STRING_resolve,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_readIntBE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_write, NJS_ATOM_SIZE, NJS_ATOM_STRING_read, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_getOwnPropertyNames,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_writeInt32BE, NJS_ATOM_STRING_asyncIterator,
+    NJS_ATOM_STRING_boolean, NJS_ATOM_STRING_times, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_stringify, NJS_ATOM_STRING_new, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_readInt16BE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_readUIntLE, NJS_ATOM_STRING_readUInt8, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_encodeURIComponent,
+    NJS_ATOM_STRING_TextEncoder, NJS_ATOM_STRING_parseFloat, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_break, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_set, NJS_ATOM_STRING_copy,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_function,
+    NJS_ATOM_STRING_swap32, NJS_ATOM_SIZE, NJS_ATOM_STRING_version,
+    NJS_ATOM_STRING_this, NJS_ATOM_STRING_atan, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_toLowerCase, NJS_ATOM_STRING_source,
+    NJS_ATOM_STRING_includes, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_page_size, NJS_ATOM_STRING_super,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_RangeError, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_BYTES_PER_ELEMENT, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_getUTCMilliseconds, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_allSettled,
+    NJS_ATOM_STRING_matchAll, NJS_ATOM_SIZE, NJS_ATOM_STRING_find,
+    NJS_ATOM_STRING_Uint8ClampedArray, NJS_ATOM_STRING_seal,
+    NJS_ATOM_STRING_DataView, NJS_ATOM_SIZE, NJS_ATOM_STRING_readFloatBE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_EvalError, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_getPrototypeOf, NJS_ATOM_SIZE, NJS_ATOM_STRING_btoa,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_description,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_package, NJS_ATOM_STRING_getMilliseconds,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_readUInt32LE, NJS_ATOM_STRING_byteOffset, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_repeat, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_writeUInt8, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_Promise, NJS_ATOM_SIZE, NJS_ATOM_STRING_writeUInt32BE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_Array, NJS_ATOM_STRING_match,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_type,
+    NJS_ATOM_STRING_readInt32BE, NJS_ATOM_STRING_any, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_getUint16, NJS_ATOM_STRING_isSealed,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_Uint32Array, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_log10, NJS_ATOM_SIZE, NJS_ATOM_STRING_RegExp, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_STRING_fromCharCode, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_toTimeString, NJS_ATOM_STRING_rejected,
+    NJS_ATOM_STRING_default, NJS_ATOM_STRING_defineProperties, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_NaN,
+    NJS_ATOM_STRING_TypedArray, NJS_ATOM_STRING_cosh, NJS_ATOM_STRING_getUint32,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_STRING_throw, NJS_ATOM_SIZE,
+    NJS_ATOM_STRING_getMonth, NJS_ATOM_SIZE, NJS_ATOM_STRING_multiline,
+    NJS_ATOM_STRING_push, NJS_ATOM_STRING_stack, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+    NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE, NJS_ATOM_SIZE,
+};
+
+
+#endif /* _NJS_ATOM_HASH_H_INCLUDED_ */
@@ -595,6 +595,10 @@ njs_buffer_byte_length(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
             return NJS_ERROR;
         }
 
+        if (njs_slow_path(njs_string_flatten(vm, value) != NJS_OK)) {
+            return NJS_ERROR;
+        }
+
         size = njs_buffer_decode_string_length(vm, value, encoding);
 
         njs_set_number(retval, size);
@@ -2422,7 +2426,9 @@ njs_buffer_encoding(njs_vm_t *vm, njs_value_t *value, njs_bool_t throw)
         return &njs_buffer_encodings[0];
     }
 
-    njs_string_get(vm, value, &name);
+    if (njs_slow_path(njs_string_get_checked(vm, value, &name) != NJS_OK)) {
+        return NULL;
+    }
 
     for (encoding = &njs_buffer_encodings[0];
          encoding->name.length != 0;
@@ -2449,6 +2455,10 @@ njs_buffer_decode_string(njs_vm_t *vm, const njs_value_t *value,
     njs_str_t          str;
     njs_string_prop_t  string;
 
+    if (njs_slow_path(njs_string_flatten(vm, value) != NJS_OK)) {
+        return NJS_ERROR;
+    }
+
     (void) njs_string_prop(vm, &string, value);
 
     str.start = string.start;
@@ -16,12 +16,41 @@ typedef struct {
 } njs_signal_entry_t;
 
 
+typedef struct {
+    njs_flathsh_t   array_instance_hash;
+    njs_flathsh_t   string_instance_hash;
+    njs_flathsh_t   function_instance_hash;
+    njs_flathsh_t   async_function_instance_hash;
+    njs_flathsh_t   arrow_instance_hash;
+    njs_flathsh_t   arguments_object_instance_hash;
+    njs_flathsh_t   regexp_instance_hash;
+
+    njs_flathsh_t   objects[NJS_OBJECT_MAX];
+    njs_flathsh_t   prototypes[NJS_OBJ_TYPE_MAX];
+    njs_flathsh_t   constructors[NJS_OBJ_TYPE_MAX];
+} njs_builtin_hashes_t;
+
+
+typedef struct {
+    uint16_t        hash_size;
+    uint16_t        items;
+    uint16_t        cells;
+    uint16_t        elts;
+} njs_builtin_layout_t;
+
+
+#include <njs_builtin_hash.h>
+
+
 static njs_int_t njs_global_this_prop_handler(njs_vm_t *vm,
     njs_object_prop_t *self, uint32_t atom_id, njs_value_t *global,
     njs_value_t *setval, njs_value_t *retval);
 
 static njs_int_t njs_env_hash_init(njs_vm_t *vm, njs_flathsh_t *hash,
     char **environment);
+static njs_int_t njs_builtin_hashes_create(njs_vm_t *vm);
+static njs_int_t njs_builtin_hash_create(njs_mp_t *mp, njs_flathsh_t *hash,
+    const njs_object_init_t *init, const njs_builtin_layout_t *layout);
 
 
 static const njs_object_init_t  njs_global_this_init;
@@ -93,6 +122,19 @@ static const njs_object_type_init_t *const
 };
 
 
+/*
+ * The property hashes of the built-in objects refer only to static data,
+ * so they are created by the first VM and shared by all the VMs of the
+ * process.  A shared hash is never changed, an object copies it before
+ * the first change.  The hash cells and the element chains are generated
+ * by utils/atom_hash.py into njs_builtin_hash.h, so creating a hash only
+ * copies the property descriptors.
+ */
+
+static njs_mp_t              *njs_builtin_mp;
+static njs_builtin_hashes_t  njs_builtin_hashes;
+
+
 /* P1990 signals from `man 7 signal` are supported */
 static njs_signal_entry_t njs_signals_table[] = {
     { njs_str("ABRT"), SIGABRT },
@@ -118,11 +160,146 @@ static njs_signal_entry_t njs_signals_table[] = {
 };
 
 
-njs_inline njs_int_t
-njs_object_hash_init(njs_vm_t *vm, njs_flathsh_t *hash,
-    const njs_object_init_t *init)
+static njs_int_t
+njs_builtin_hashes_create(njs_vm_t *vm)
+{
+    njs_mp_t              *mp;
+    njs_int_t             ret;
+    njs_uint_t            i;
+    njs_builtin_hashes_t  *h;
+
+    static const struct {
+        njs_flathsh_t            *hash;
+        const njs_object_init_t  *init;
+    } instances[] = {
+        { &njs_builtin_hashes.array_instance_hash,
+          &njs_array_instance_init },
+        { &njs_builtin_hashes.string_instance_hash,
+          &njs_string_instance_init },
+        { &njs_builtin_hashes.function_instance_hash,
+          &njs_function_instance_init },
+        { &njs_builtin_hashes.async_function_instance_hash,
+          &njs_async_function_instance_init },
+        { &njs_builtin_hashes.arrow_instance_hash,
+          &njs_arrow_instance_init },
+        { &njs_builtin_hashes.arguments_object_instance_hash,
+          &njs_arguments_object_instance_init },
+        { &njs_builtin_hashes.regexp_instance_hash,
+          &njs_regexp_instance_init },
+    };
+
+    if (njs_builtin_mp != NULL) {
+        return NJS_OK;
+    }
+
+    mp = njs_mp_fast_create(2 * njs_pagesize(), 128, 512, 16);
+    if (njs_slow_path(mp == NULL)) {
+        goto memory_error;
+    }
+
+    h = &njs_builtin_hashes;
+
+    njs_memzero(h, sizeof(njs_builtin_hashes_t));
+
+    for (i = 0; i < njs_nitems(instances); i++) {
+        ret = njs_builtin_hash_create(mp, instances[i].hash,
+                                      instances[i].init,
+                                      &njs_builtin_instance_layouts[i]);
+        if (njs_slow_path(ret != NJS_OK)) {
+            goto failed;
+        }
+    }
+
+    /* The global object hash is copied by each VM, see njs_vm_bind(). */
+
+    for (i = 0; njs_object_init[i] != NULL; i++) {
+        ret = njs_builtin_hash_create(mp, &h->objects[i], njs_object_init[i],
+                                      &njs_builtin_object_layouts[i]);
+        if (njs_slow_path(ret != NJS_OK)) {
+            goto failed;
+        }
+    }
+
+    for (i = NJS_OBJ_TYPE_OBJECT; i < NJS_OBJ_TYPE_MAX; i++) {
+        ret = njs_builtin_hash_create(mp, &h->prototypes[i],
+                                      njs_object_type_init[i]->prototype_props,
+                                      &njs_builtin_prototype_layouts[i]);
+        if (njs_slow_path(ret != NJS_OK)) {
+            goto failed;
+        }
+
+        ret = njs_builtin_hash_create(mp, &h->constructors[i],
+                                    njs_object_type_init[i]->constructor_props,
+                                    &njs_builtin_constructor_layouts[i]);
+        if (njs_slow_path(ret != NJS_OK)) {
+            goto failed;
+        }
+    }
+
+    njs_builtin_mp = mp;
+
+    return NJS_OK;
+
+failed:
+
+    njs_mp_destroy(mp);
+
+memory_error:
+
+    njs_memory_error(vm);
+
+    return NJS_ERROR;
+}
+
+
+static njs_int_t
+njs_builtin_hash_create(njs_mp_t *mp, njs_flathsh_t *hash,
+    const njs_object_init_t *init, const njs_builtin_layout_t *layout)
 {
-    return njs_object_hash_create(vm, hash, init->properties, init->items);
+    njs_uint_t           n;
+    njs_object_prop_t    *prop;
+    njs_flathsh_descr_t  *h;
+    njs_flathsh_query_t  fhq;
+
+    if (init == NULL || init->items == 0) {
+        return NJS_OK;
+    }
+
+    /*
+     * njs_builtin_hash.h is to be regenerated after the property tables
+     * or njs_atom_defs.h change.
+     */
+
+    njs_assert(layout->items == init->items);
+
+    fhq.proto = &njs_object_hash_proto;
+    fhq.pool = mp;
+
+    h = njs_flathsh_prebuilt(&fhq, &njs_builtin_hash_cells[layout->cells],
+                             layout->hash_size, init->items);
+    if (njs_slow_path(h == NULL)) {
+        return NJS_ERROR;
+    }
+
+    hash->slot = h;
+
+    prop = (njs_object_prop_t *) njs_hash_elts(h);
+
+    for (n = 0; n < init->items; n++) {
+        prop[n] = init->properties[n].desc;
+        prop[n].next_elt = njs_builtin_hash_next[layout->elts + n];
+    }
+
+#if (NJS_DEBUG)
+    for (n = 0; n < init->items; n++) {
+        fhq.key_hash = prop[n].atom_id;
+
+        njs_assert(njs_flathsh_unique_find(hash, &fhq) == NJS_OK
+                   && fhq.value == &prop[n]);
+    }
+#endif
+
+    return NJS_OK;
 }
 
 
@@ -136,7 +313,7 @@ njs_builtin_objects_create(njs_vm_t *vm)
     njs_vm_shared_t            *shared;
     njs_regexp_pattern_t       *pattern;
     njs_object_prototype_t     *prototype;
-    const njs_object_init_t    *obj, **p;
+    njs_flathsh_query_t        fhq;
 
     shared = njs_mp_zalloc(vm->mem_pool, sizeof(njs_vm_shared_t));
     if (njs_slow_path(shared == NULL)) {
@@ -148,7 +325,9 @@ njs_builtin_objects_create(njs_vm_t *vm)
     njs_flathsh_init(&shared->values_hash);
 
     vm->atom_id_generator = njs_atom_hash_init(vm);
-    if (njs_slow_path(vm->atom_id_generator == 0xffffffff)) {
+
+    ret = njs_builtin_hashes_create(vm);
+    if (njs_slow_path(ret != NJS_OK)) {
         return NJS_ERROR;
     }
 
@@ -160,57 +339,21 @@ njs_builtin_objects_create(njs_vm_t *vm)
 
     shared->empty_regexp_pattern = pattern;
 
-    ret = njs_object_hash_init(vm, &shared->array_instance_hash,
-                               &njs_array_instance_init);
-    if (njs_slow_path(ret != NJS_OK)) {
-        return NJS_ERROR;
-    }
-
-    ret = njs_object_hash_init(vm, &shared->string_instance_hash,
-                               &njs_string_instance_init);
-    if (njs_slow_path(ret != NJS_OK)) {
-        return NJS_ERROR;
-    }
-
-    ret = njs_object_hash_init(vm, &shared->function_instance_hash,
-                               &njs_function_instance_init);
-    if (njs_slow_path(ret != NJS_OK)) {
-        return NJS_ERROR;
-    }
-
-    ret = njs_object_hash_init(vm, &shared->async_function_instance_hash,
-                               &njs_async_function_instance_init);
-    if (njs_slow_path(ret != NJS_OK)) {
-        return NJS_ERROR;
-    }
-
-    ret = njs_object_hash_init(vm, &shared->arrow_instance_hash,
-                               &njs_arrow_instance_init);
-    if (njs_slow_path(ret != NJS_OK)) {
-        return NJS_ERROR;
-    }
-
-    ret = njs_object_hash_init(vm, &shared->arguments_object_instance_hash,
-                               &njs_arguments_object_instance_init);
-    if (njs_slow_path(ret != NJS_OK)) {
-        return NJS_ERROR;
-    }
-
-    ret = njs_object_hash_init(vm, &shared->regexp_instance_hash,
-                               &njs_regexp_instance_init);
-    if (njs_slow_path(ret != NJS_OK)) {
-        return NJS_ERROR;
-    }
+    shared->array_instance_hash = njs_builtin_hashes.array_instance_hash;
+    shared->string_instance_hash = njs_builtin_hashes.string_instance_hash;
+    shared->function_instance_hash =
+                                njs_builtin_hashes.function_instance_hash;
+    shared->async_function_instance_hash =
+                          njs_builtin_hashes.async_function_instance_hash;
+    shared->arrow_instance_hash = njs_builtin_hashes.arrow_instance_hash;
+    shared->arguments_object_instance_hash =
+                        njs_builtin_hashes.arguments_object_instance_hash;
+    shared->regexp_instance_hash = njs_builtin_hashes.regexp_instance_hash;
 
     object = shared->objects;
 
-    for (p = njs_object_init; *p != NULL; p++) {
-        obj = *p;
-
-        ret = njs_object_hash_init(vm, &object->shared_hash, obj);
-        if (njs_slow_path(ret != NJS_OK)) {
-            return NJS_ERROR;
-        }
+    for (i = 0; njs_object_init[i] != NULL; i++) {
+        object->shared_hash = njs_builtin_hashes.objects[i];
 
         object->type = NJS_OBJECT;
         object->shared = 1;
@@ -219,6 +362,19 @@ njs_builtin_objects_create(njs_vm_t *vm)
         object++;
     }
 
+    /* njs_vm_bind() changes the global object hash in place. */
+
+    fhq.proto = &njs_object_hash_proto;
+    fhq.pool = vm->mem_pool;
+
+    object = &shared->objects[NJS_OBJECT_THIS];
+
+    object->shared_hash.slot = njs_flathsh_copy(&object->shared_hash, &fhq);
+    if (njs_slow_path(object->shared_hash.slot == NULL)) {
+        njs_memory_error(vm);
+        return NJS_ERROR;
+    }
+
     ret = njs_env_hash_init(vm, &shared->env_hash, environ);
     if (njs_slow_path(ret != NJS_OK)) {
         return NJS_ERROR;
@@ -246,11 +402,7 @@ njs_builtin_objects_create(njs_vm_t *vm)
             njs_set_empty_string(vm, &prototype->object_value.value);
         }
 
-        ret = njs_object_hash_init(vm, &prototype->object.shared_hash,
-                                   njs_object_type_init[i]->prototype_props);
-        if (njs_slow_path(ret != NJS_OK)) {
-            return NJS_ERROR;
-        }
+        prototype->object.shared_hash = njs_builtin_hashes.prototypes[i];
 
         prototype->object.extensible = 1;
     }
@@ -269,11 +421,7 @@ njs_builtin_objects_create(njs_vm_t *vm)
         *constructor = njs_object_type_init[i]->constructor;
         constructor->object.shared = 0;
 
-        ret = njs_object_hash_init(vm, &constructor->object.shared_hash,
-                                   njs_object_type_init[i]->constructor_props);
-        if (njs_slow_path(ret != NJS_OK)) {
-            return NJS_ERROR;
-        }
+        constructor->object.shared_hash = njs_builtin_hashes.constructors[i];
     }
 
     shared->global_slots.prop_handler = njs_global_this_prop_handler;
@@ -351,7 +499,9 @@ njs_ext_on(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
         return NJS_ERROR;
     }
 
-    njs_string_get(vm, value, &type);
+    if (njs_slow_path(njs_string_get_checked(vm, value, &type) != NJS_OK)) {
+        return NJS_ERROR;
+    }
 
     i = 0;
     n = sizeof(hooks) / sizeof(hooks[0]);
@@ -1089,7 +1239,9 @@ njs_ext_process_kill(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
         signal = njs_value_number(arg);
 
     } else if (njs_value_is_string(arg)) {
-        njs_string_get(vm, arg, &str);
+        if (njs_slow_path(njs_string_get_checked(vm, arg, &str) != NJS_OK)) {
+            return NJS_ERROR;
+        }
 
         if (str.length < 3 || memcmp(str.start, "SIG", 3) != 0) {
             njs_vm_type_error(vm, "\"signal\" unknown value: \"%V\"", &str);
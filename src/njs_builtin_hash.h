@@ -0,0 +1,201 @@
+
+/*
+ * Copyright (C) F5, Inc.
+ *
+ * Do not edit, generated by: utils/atom_hash.py.
+ */
+
+
+#ifndef _NJS_BUILTIN_HASH_H_INCLUDED_
+#define _NJS_BUILTIN_HASH_H_INCLUDED_
+
+
+static const uint32_t  njs_builtin_hash_cells[955] = {
+    1, 1, 0, 1, 3, 2, 0, 2, 0, 2, 1, 1, 20, 55, 30, 29, 54, 43, 44, 0, 0, 46,
+    53, 52, 48, 0, 0, 25, 42, 4, 0, 57, 22, 0, 16, 0, 0, 0, 0, 0, 0, 8, 0, 23,
+    7, 51, 35, 37, 36, 5, 45, 39, 38, 50, 49, 0, 0, 47, 28, 0, 31, 41, 0, 27, 2,
+    26, 10, 58, 0, 24, 40, 32, 34, 33, 0, 56, 20, 54, 29, 28, 53, 42, 43, 0, 0,
+    45, 52, 51, 47, 0, 0, 24, 41, 4, 0, 56, 22, 0, 16, 0, 0, 0, 0, 0, 0, 8, 0,
+    23, 7, 50, 34, 36, 35, 5, 44, 38, 37, 49, 48, 0, 0, 46, 27, 0, 30, 40, 0,
+    26, 2, 25, 10, 57, 0, 15, 39, 31, 33, 32, 0, 55, 4, 3, 0, 1, 6, 2, 7, 0, 0,
+    0, 5, 1, 6, 4, 2, 0, 0, 0, 0, 0, 0, 0, 0, 34, 33, 0, 0, 19, 37, 31, 30, 29,
+    0, 0, 0, 0, 43, 42, 26, 17, 16, 15, 0, 25, 14, 13, 3, 0, 0, 0, 0, 0, 41, 23,
+    0, 12, 11, 10, 0, 36, 2, 40, 39, 38, 0, 0, 0, 35, 0, 0, 0, 0, 0, 0, 44, 0,
+    0, 0, 22, 21, 2, 3, 0, 1, 5, 4, 2, 3, 7, 0, 0, 6, 4, 31, 2, 30, 29, 28, 0,
+    0, 0, 0, 0, 17, 0, 22, 0, 0, 0, 1, 16, 0, 0, 21, 20, 14, 0, 0, 11, 0, 0, 10,
+    9, 8, 7, 0, 0, 0, 0, 0, 27, 6, 13, 26, 25, 24, 0, 19, 0, 0, 23, 0, 33, 0,
+    18, 0, 32, 0, 0, 0, 0, 34, 0, 0, 0, 0, 0, 4, 2, 3, 0, 4, 2, 3, 0, 0, 6, 7,
+    0, 6, 3, 4, 5, 0, 7, 0, 0, 5, 16, 0, 6, 28, 12, 0, 18, 27, 26, 7, 0, 0, 17,
+    0, 30, 29, 23, 4, 0, 0, 0, 0, 0, 0, 24, 31, 21, 22, 0, 19, 0, 8, 3, 2, 0, 7,
+    0, 5, 2, 1, 7, 8, 1, 9, 5, 12, 10, 0, 11, 0, 0, 0, 4, 0, 0, 0, 32, 30, 13,
+    26, 38, 44, 0, 0, 40, 24, 28, 8, 12, 11, 22, 14, 5, 0, 20, 18, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0,
+    35, 43, 37, 46, 39, 45, 41, 0, 27, 17, 31, 34, 23, 42, 36, 0, 0, 3, 2, 4, 0,
+    5, 0, 0, 2, 1, 4, 0, 15, 19, 17, 0, 0, 21, 20, 0, 0, 0, 7, 11, 9, 0, 0, 13,
+    12, 3, 1, 0, 0, 6, 10, 14, 18, 16, 0, 0, 0, 0, 0, 0, 0, 3, 5, 0, 4, 0, 2, 0,
+    0, 4, 3, 0, 43, 2, 0, 0, 42, 0, 0, 0, 0, 0, 0, 53, 0, 0, 0, 0, 0, 46, 0, 0,
+    0, 52, 51, 50, 16, 4, 10, 48, 28, 30, 24, 40, 32, 34, 21, 27, 29, 23, 25,
+    45, 44, 47, 49, 37, 38, 0, 39, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 1, 0, 2, 7, 31, 2, 0, 30, 29, 0, 0, 0, 24, 0, 20, 0, 23, 0, 0, 5, 6, 19,
+    0, 0, 22, 21, 16, 0, 0, 13, 0, 28, 12, 11, 10, 17, 0, 0, 0, 0, 0, 0, 9, 15,
+    27, 26, 25, 0, 0, 0, 0, 0, 0, 32, 1, 0, 0, 0, 0, 0, 0, 0, 33, 0, 0, 0, 0, 1,
+    2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 0, 5, 1, 6, 0, 3, 0, 0,
+    0, 3, 1, 2, 0, 3, 0, 1, 0, 3, 1, 2, 0, 3, 1, 2, 0, 3, 1, 2, 0, 3, 1, 2, 0,
+    3, 1, 2, 0, 3, 1, 2, 0, 21, 0, 2, 14, 13, 23, 11, 10, 0, 0, 18, 0, 0, 3, 0,
+    0, 24, 6, 0, 0, 5, 0, 9, 8, 16, 19, 22, 0, 15, 0, 17, 6, 1, 0, 2, 4, 5, 3,
+    0, 0, 2, 3, 1, 12, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 4, 0, 10, 3, 0, 0, 9, 11,
+    0, 0, 8, 17, 16, 0, 5, 0, 14, 0, 15, 13, 0, 0, 0, 17, 8, 0, 15, 0, 16, 0,
+    10, 13, 0, 0, 0, 3, 7, 0, 12, 0, 0, 0, 0, 5, 18, 9, 0, 6, 0, 0, 4, 0, 0, 4,
+    1, 0, 2, 0, 0, 3, 5, 0, 1, 3, 2, 0, 1, 3, 2, 0, 1, 3, 2, 6, 1, 0, 2, 0, 0,
+    4, 5, 8, 1, 7, 2, 5, 0, 10, 0, 0, 0, 0, 0, 9, 0, 4, 0, 0, 5, 0, 2, 0, 0, 4,
+    0, 0, 1, 3, 2, 0, 1, 3, 2, 0, 1, 3, 2, 0, 7, 12, 6, 11, 8, 0, 0, 0, 0, 0, 0,
+    10, 0, 3, 0, 5, 1, 0, 2, 6, 0, 4, 0, 0, 1, 3, 4, 0, 2, 3, 4, 0, 1, 3, 4, 0,
+    1, 3, 4, 0, 1, 3, 4, 0, 1, 3, 4, 0, 1, 3, 4, 0, 1, 3, 4, 0, 1, 3, 4, 0, 1,
+    3, 2, 0, 1, 3, 2, 0, 1, 3, 2, 0, 1, 3, 2, 0, 1, 3, 2, 0, 1, 3, 2, 0, 1, 3,
+    2, 0, 1, 3, 2, 0, 1, 3, 2, 0, 1, 3, 2,
+};
+
+
+static const uint16_t  njs_builtin_hash_next[716] = {
+    0, 0, 0, 0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 6, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 13, 0, 0, 15, 19, 0, 3, 0, 0, 0, 21, 0, 0, 0, 18, 0, 0, 0,
+    0, 14, 12, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 11, 0, 17, 9, 0, 0, 1, 0,
+    0, 0, 0, 0, 0, 0, 6, 0, 0, 0, 0, 0, 0, 0, 0, 0, 13, 0, 0, 19, 0, 3, 0, 0, 0,
+    21, 0, 0, 0, 18, 0, 0, 0, 0, 14, 12, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    11, 0, 17, 9, 0, 0, 0, 0, 0, 5, 0, 0, 0, 0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 4, 5, 0, 0, 0, 0, 0, 9, 0, 0, 0, 0, 6, 0, 0, 0, 0, 7, 0, 18, 8,
+    20, 1, 28, 32, 0, 27, 0, 24, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 15, 0, 0, 5, 12, 0, 0, 0,
+    3, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 5, 0, 0, 0, 2, 1, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 10, 3, 0, 13, 0, 9, 0, 0, 14, 8, 20,
+    15, 11, 0, 2, 0, 25, 0, 0, 0, 0, 4, 0, 6, 1, 0, 0, 0, 0, 0, 2, 3, 0, 0, 0,
+    0, 0, 6, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 10, 0, 0, 0, 6, 0, 0,
+    0, 0, 9, 0, 0, 0, 7, 0, 4, 25, 19, 0, 29, 0, 21, 3, 0, 16, 0, 0, 15, 0, 0,
+    0, 33, 0, 0, 1, 0, 0, 0, 0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 5, 8,
+    0, 0, 0, 0, 2, 0, 0, 0, 0, 1, 0, 0, 0, 0, 2, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 11, 12, 17, 13, 18, 15, 5, 6, 7, 8, 19, 3,
+    20, 9, 0, 0, 0, 0, 0, 26, 0, 0, 41, 33, 31, 0, 35, 22, 36, 14, 0, 0, 0, 0,
+    0, 1, 0, 0, 0, 0, 0, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 0, 0, 18, 0,
+    0, 8, 14, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 2, 0, 4, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 0, 0,
+    7, 0, 1, 0, 0, 12, 20, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+    0, 0, 0, 0, 0, 0, 7, 6, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 1, 11, 0, 0, 14, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 0, 0, 0, 0, 0, 3,
+    0, 0, 0, 0, 0, 6, 0, 0, 0, 3, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    2, 1, 4, 5, 0, 9, 0, 0, 0, 0, 3, 0, 0, 0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 2,
+    0, 0, 0, 2, 0, 0, 0, 2, 0, 0, 0, 2, 0, 0, 0, 2, 0, 0, 0, 2, 0, 0, 0, 2, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0,
+};
+
+
+static const njs_builtin_layout_t  njs_builtin_instance_layouts[7] = {
+    { 1, 1, 0, 0 },             /* njs_array_instance_init */
+    { 1, 1, 1, 1 },             /* njs_string_instance_init */
+    { 4, 3, 2, 2 },             /* njs_function_instance_init */
+    { 2, 2, 6, 5 },             /* njs_async_function_instance_init */
+    { 2, 2, 8, 7 },             /* njs_arrow_instance_init */
+    { 1, 1, 10, 9 },            /* njs_arguments_object_instance_init */
+    { 1, 1, 11, 10 },           /* njs_regexp_instance_init */
+};
+
+
+static const njs_builtin_layout_t  njs_builtin_object_layouts[5] = {
+#ifdef NJS_TEST262
+    { 64, 58, 12, 11 },         /* njs_global_this_init */
+#else
+    { 64, 57, 76, 69 },         /* njs_global_this_init */
+#endif
+    { 8, 7, 140, 126 },         /* njs_njs_object_init */
+    { 8, 6, 148, 133 },         /* njs_process_object_init */
+    { 64, 44, 156, 139 },       /* njs_math_object_init */
+    { 4, 3, 220, 183 },         /* njs_json_object_init */
+};
+
+
+static const njs_builtin_layout_t  njs_builtin_prototype_layouts[38] = {
+    { 8, 7, 224, 186 },         /* njs_object_prototype_init */
+    { 64, 34, 232, 193 },       /* njs_array_prototype_init */
+    { 4, 4, 296, 227 },         /* njs_boolean_prototype_init */
+    { 8, 7, 300, 231 },         /* njs_number_prototype_init */
+    { 8, 7, 308, 238 },         /* njs_symbol_prototype_init */
+    { 32, 31, 316, 245 },       /* njs_string_prototype_init */
+    { 8, 8, 348, 276 },         /* njs_function_prototype_init */
+    { 2, 2, 356, 284 },         /* njs_async_prototype_init */
+    { 16, 12, 358, 286 },       /* njs_regexp_prototype_init */
+    { 64, 46, 374, 298 },       /* njs_date_prototype_init */
+    { 8, 5, 438, 344 },         /* njs_promise_prototype_init */
+    { 4, 4, 446, 349 },         /* njs_array_buffer_prototype_init */
+    { 32, 21, 450, 353 },       /* njs_data_view_prototype_init */
+    { 8, 5, 482, 374 },         /* njs_text_decoder_init */
+    { 4, 4, 490, 379 },         /* njs_text_encoder_init */
+    { 64, 53, 494, 383 },       /* njs_buffer_prototype_init */
+    { 1, 1, 558, 436 },         /* njs_iterator_prototype_init */
+    { 2, 2, 559, 437 },         /* njs_array_iterator_prototype_init */
+    { 64, 33, 561, 439 },       /* njs_typed_array_prototype_init */
+    { 2, 2, 625, 472 },         /* njs_typed_array_u8_prototype_init */
+    { 2, 2, 627, 474 },         /* njs_typed_array_u8c_prototype_init */
+    { 2, 2, 629, 476 },         /* njs_typed_array_i8_prototype_init */
+    { 2, 2, 631, 478 },         /* njs_typed_array_u16_prototype_init */
+    { 2, 2, 633, 480 },         /* njs_typed_array_i16_prototype_init */
+    { 2, 2, 635, 482 },         /* njs_typed_array_u32_prototype_init */
+    { 2, 2, 637, 484 },         /* njs_typed_array_i32_prototype_init */
+    { 2, 2, 639, 486 },         /* njs_typed_array_f32_prototype_init */
+    { 2, 2, 641, 488 },         /* njs_typed_array_f64_prototype_init */
+    { 8, 6, 643, 490 },         /* njs_error_prototype_init */
+    { 4, 3, 651, 496 },         /* njs_eval_error_prototype_init */
+    { 4, 3, 655, 499 },         /* njs_internal_error_prototype_init */
+    { 4, 3, 659, 502 },         /* njs_range_error_prototype_init */
+    { 4, 3, 663, 505 },         /* njs_reference_error_prototype_init */
+    { 4, 3, 667, 508 },         /* njs_syntax_error_prototype_init */
+    { 4, 3, 671, 511 },         /* njs_type_error_prototype_init */
+    { 4, 3, 675, 514 },         /* njs_uri_error_prototype_init */
+    { 4, 3, 655, 499 },         /* njs_internal_error_prototype_init */
+    { 4, 3, 679, 517 },         /* njs_aggregate_error_prototype_init */
+};
+
+
+static const njs_builtin_layout_t  njs_builtin_constructor_layouts[38] = {
+    { 32, 24, 683, 520 },       /* njs_object_constructor_init */
+    { 8, 6, 715, 544 },         /* njs_array_constructor_init */
+    { 4, 3, 723, 550 },         /* njs_boolean_constructor_init */
+    { 32, 17, 727, 553 },       /* njs_number_constructor_init */
+    { 32, 18, 759, 570 },       /* njs_symbol_constructor_init */
+    { 8, 5, 791, 588 },         /* njs_string_constructor_init */
+    { 4, 3, 799, 593 },         /* njs_function_constructor_init */
+    { 4, 3, 803, 596 },         /* njs_async_constructor_init */
+    { 4, 3, 807, 599 },         /* njs_regexp_constructor_init */
+    { 8, 6, 811, 602 },         /* njs_date_constructor_init */
+    { 16, 10, 819, 608 },       /* njs_promise_constructor_init */
+    { 8, 5, 835, 618 },         /* njs_array_buffer_constructor_init */
+    { 4, 3, 843, 623 },         /* njs_data_view_constructor_init */
+    { 4, 3, 847, 626 },         /* njs_text_decoder_constructor_init */
+    { 4, 3, 851, 629 },         /* njs_text_encoder_constructor_init */
+    { 16, 12, 855, 632 },       /* njs_buffer_constructor_init */
+    { 0, 0, 0, 0 },             /* none */
+    { 0, 0, 0, 0 },             /* none */
+    { 8, 6, 871, 644 },         /* njs_typed_array_constructor_init */
+    { 4, 4, 879, 650 },         /* njs_typed_array_u8_constructor_init */
+    { 4, 4, 883, 654 },         /* njs_typed_array_u8c_constructor_init */
+    { 4, 4, 887, 658 },         /* njs_typed_array_i8_constructor_init */
+    { 4, 4, 891, 662 },         /* njs_typed_array_u16_constructor_init */
+    { 4, 4, 895, 666 },         /* njs_typed_array_i16_constructor_init */
+    { 4, 4, 899, 670 },         /* njs_typed_array_u32_constructor_init */
+    { 4, 4, 903, 674 },         /* njs_typed_array_i32_constructor_init */
+    { 4, 4, 907, 678 },         /* njs_typed_array_f32_constructor_init */
+    { 4, 4, 911, 682 },         /* njs_typed_array_f64_constructor_init */
+    { 4, 3, 915, 686 },         /* njs_error_constructor_init */
+    { 4, 3, 919, 689 },         /* njs_eval_error_constructor_init */
+    { 4, 3, 923, 692 },         /* njs_internal_error_constructor_init */
+    { 4, 3, 927, 695 },         /* njs_range_error_constructor_init */
+    { 4, 3, 931, 698 },         /* njs_reference_error_constructor_init */
+    { 4, 3, 935, 701 },         /* njs_syntax_error_constructor_init */
+    { 4, 3, 939, 704 },         /* njs_type_error_constructor_init */
+    { 4, 3, 943, 707 },         /* njs_uri_error_constructor_init */
+    { 4, 3, 947, 710 },         /* njs_memory_error_constructor_init */
+    { 4, 3, 951, 713 },         /* njs_aggregate_error_constructor_init */
+};
+
+
+#endif /* _NJS_BUILTIN_HASH_H_INCLUDED_ */
@@ -0,0 +1,1424 @@
+
+/*
+ * Copyright (C) NGINX, Inc.
+ */
+
+
+#include <njs_main.h>
+
+
+/*
+ * A bytecode cache holds the code of a compiled module function and
+ * of all the functions defined in the module.  The code is stored as is,
+ * except for the operands and fields which depend on the state of the VM:
+ *   constant operands refer to the constant table of the cache;
+ *   FUNCTION instructions refer to lambdas by their numbers;
+ *   regexps, object literal templates, error names and imported modules are
+ *   stored in records which follow the code in instruction order;
+ *   property inline caches are cleared.
+ *
+ * The loader resolves these references against the loading VM.  A cache is
+ * valid only for the njs build which produced it and for the same module
+ * source, otherwise it is declined.  The checksum protects against damaged
+ * files, it is not a security boundary.
+ *
+ * Layout:
+ *   header
+ *   uint32 nconstants, constant values
+ *   uint32 nlambdas, lambda records:
+ *     uint32 nargs, nlocal, self, flags, nclosures, closures
+ *     value name, str code name
+ *     uint32 size, code
+ *     uint32 nlines, lines
+ *     records of instructions
+ */
+
+
+#define NJS_BYTECODE_MAGIC       0x42534a4e    /* "NJSB" */
+#define NJS_BYTECODE_VERSION     3
+
+#define NJS_BYTECODE_CTOR        1
+#define NJS_BYTECODE_REST        2
+
+
+typedef struct {
+    uint32_t                     magic;
+    uint32_t                     version;
+    uint32_t                     njs_version;
+    uint32_t                     layout;
+    uint32_t                     source_size;
+    uint32_t                     source_hash;
+    uint32_t                     size;
+    uint32_t                     hash;
+} njs_bytecode_header_t;
+
+
+enum {
+    NJS_BYTECODE_PLAIN = 0,
+    NJS_BYTECODE_FUNCTION,
+    NJS_BYTECODE_REGEXP,
+    NJS_BYTECODE_OBJECT,
+    NJS_BYTECODE_ERROR,
+    NJS_BYTECODE_IMPORT,
+};
+
+
+typedef struct {
+    uint8_t                      size;
+    uint8_t                      type;
+    uint8_t                      cache;
+    uint8_t                      operands[3];
+} njs_bytecode_layout_t;
+
+
+typedef struct {
+    njs_vm_t                     *vm;
+    njs_arr_t                    *lambdas;
+    njs_chb_t                    values;
+    uint32_t                     nconstants;
+    uint32_t                     nstatic;
+    uint32_t                     *constants;
+} njs_bytecode_writer_t;
+
+
+typedef struct {
+    njs_vm_t                     *vm;
+    u_char                       *pos;
+    u_char                       *end;
+    njs_str_t                    file;
+    uint32_t                     nconstants;
+    njs_index_t                  *constants;
+    uint32_t                     nlambdas;
+    njs_function_lambda_t        *lambdas;
+} njs_bytecode_reader_t;
+
+
+static njs_int_t njs_bytecode_lambda_write(njs_bytecode_writer_t *wr,
+    njs_chb_t *chain, njs_function_lambda_t *lambda);
+static njs_int_t njs_bytecode_operand_write(njs_bytecode_writer_t *wr,
+    njs_vmcode_index_t *operand);
+static uint32_t njs_bytecode_lambda_ref(njs_bytecode_writer_t *wr,
+    njs_function_lambda_t *lambda);
+static njs_int_t njs_bytecode_template_write(njs_vm_t *vm, njs_chb_t *chain,
+    njs_flathsh_t *props);
+static njs_int_t njs_bytecode_value_write(njs_vm_t *vm, njs_chb_t *chain,
+    njs_value_t *value);
+static njs_vm_code_t *njs_bytecode_code_find(njs_vm_t *vm, u_char *start);
+static njs_int_t njs_bytecode_lambda_read(njs_bytecode_reader_t *rd,
+    njs_function_lambda_t *lambda);
+static njs_int_t njs_bytecode_code_link(njs_bytecode_reader_t *rd,
+    u_char *start, u_char *end);
+static njs_int_t njs_bytecode_template_read(njs_bytecode_reader_t *rd,
+    njs_flathsh_t *props);
+static njs_int_t njs_bytecode_value_read(njs_bytecode_reader_t *rd,
+    njs_value_t *value);
+static njs_int_t njs_bytecode_str_read(njs_bytecode_reader_t *rd,
+    njs_str_t *str);
+static njs_int_t njs_bytecode_read(njs_bytecode_reader_t *rd, void *dst,
+    size_t size);
+static uint32_t njs_bytecode_layout_hash(void);
+
+
+#define njs_bytecode_u32_write(chain, u32)                                    \
+    do {                                                                      \
+        uint32_t  _u32 = (u32);                                               \
+        njs_chb_append(chain, &_u32, sizeof(uint32_t));                       \
+    } while (0)
+
+
+#define njs_bytecode_str_write(chain, str)                                    \
+    do {                                                                      \
+        njs_bytecode_u32_write(chain, (str)->length);                         \
+        njs_chb_append(chain, (str)->start, (str)->length);                   \
+    } while (0)
+
+
+#define njs_bytecode_u32_read(rd, u32)                                        \
+    njs_bytecode_read(rd, u32, sizeof(uint32_t))
+
+
+#define njs_bytecode_op(t)                                                    \
+    { sizeof(t), NJS_BYTECODE_PLAIN, 0, { 0, 0, 0 } }
+
+#define njs_bytecode_op1(t, a)                                                \
+    { sizeof(t), NJS_BYTECODE_PLAIN, 0, { offsetof(t, a), 0, 0 } }
+
+#define njs_bytecode_op2(t, a, b)                                             \
+    { sizeof(t), NJS_BYTECODE_PLAIN, 0,                                       \
+      { offsetof(t, a), offsetof(t, b), 0 } }
+
+#define njs_bytecode_op3(t, a, b, c)                                          \
+    { sizeof(t), NJS_BYTECODE_PLAIN, 0,                                       \
+      { offsetof(t, a), offsetof(t, b), offsetof(t, c) } }
+
+#define njs_bytecode_cached(t, a, b, c)                                       \
+    { sizeof(t), NJS_BYTECODE_PLAIN, offsetof(t, cache),                      \
+      { offsetof(t, a), offsetof(t, b), offsetof(t, c) } }
+
+#define njs_bytecode_special(t, type, a)                                      \
+    { sizeof(t), type, 0, { offsetof(t, a), 0, 0 } }
+
+
+/* Instruction sizes and offsets of operands which may be constants. */
+
+static const njs_bytecode_layout_t  njs_bytecode_layouts[NJS_VMCODES] = {
+
+    [NJS_VMCODE_PUT_ARG] = njs_bytecode_op1(njs_vmcode_1addr_t, index),
+    [NJS_VMCODE_STOP] = njs_bytecode_op1(njs_vmcode_stop_t, retval),
+    [NJS_VMCODE_JUMP] = njs_bytecode_op(njs_vmcode_jump_t),
+
+    [NJS_VMCODE_PROPERTY_ATOM_SET] =
+        njs_bytecode_cached(njs_vmcode_prop_set_t, value, object, property),
+    [NJS_VMCODE_PROPERTY_SET] =
+        njs_bytecode_cached(njs_vmcode_prop_set_t, value, object, property),
+    [NJS_VMCODE_PROPERTY_ACCESSOR] =
+        njs_bytecode_op3(njs_vmcode_prop_accessor_t, value, object, property),
+
+    [NJS_VMCODE_IF_TRUE_JUMP] = njs_bytecode_op1(njs_vmcode_cond_jump_t, cond),
+    [NJS_VMCODE_IF_FALSE_JUMP] = njs_bytecode_op1(njs_vmcode_cond_jump_t, cond),
+
+    [NJS_VMCODE_IF_EQUAL_JUMP] =
+        njs_bytecode_op2(njs_vmcode_equal_jump_t, value1, value2),
+    [NJS_VMCODE_IF_NOT_EQUAL_JUMP] =
+        njs_bytecode_op2(njs_vmcode_equal_jump_t, value1, value2),
+    [NJS_VMCODE_IF_LESS_JUMP] =
+        njs_bytecode_op2(njs_vmcode_equal_jump_t, value1, value2),
+    [NJS_VMCODE_IF_GREATER_JUMP] =
+        njs_bytecode_op2(njs_vmcode_equal_jump_t, value1, value2),
+    [NJS_VMCODE_IF_LESS_OR_EQUAL_JUMP] =
+        njs_bytecode_op2(njs_vmcode_equal_jump_t, value1, value2),
+    [NJS_VMCODE_IF_GREATER_OR_EQUAL_JUMP] =
+        njs_bytecode_op2(njs_vmcode_equal_jump_t, value1, value2),
+    [NJS_VMCODE_IF_NOT_LESS_JUMP] =
+        njs_bytecode_op2(njs_vmcode_equal_jump_t, value1, value2),
+    [NJS_VMCODE_IF_NOT_GREATER_JUMP] =
+        njs_bytecode_op2(njs_vmcode_equal_jump_t, value1, value2),
+    [NJS_VMCODE_IF_NOT_LESS_OR_EQUAL_JUMP] =
+        njs_bytecode_op2(njs_vmcode_equal_jump_t, value1, value2),
+    [NJS_VMCODE_IF_NOT_GREATER_OR_EQUAL_JUMP] =
+        njs_bytecode_op2(njs_vmcode_equal_jump_t, value1, value2),
+
+    [NJS_VMCODE_PROPERTY_INIT] =
+        njs_bytecode_op3(njs_vmcode_prop_init_t, value, object, property),
+    [NJS_VMCODE_RETURN] = njs_bytecode_op1(njs_vmcode_return_t, retval),
+
+    [NJS_VMCODE_FUNCTION_FRAME] =
+        njs_bytecode_op1(njs_vmcode_function_frame_t, name),
+    [NJS_VMCODE_METHOD_FRAME] =
+        njs_bytecode_op2(njs_vmcode_method_frame_t, function, this_object),
+    [NJS_VMCODE_METHOD_ATOM_FRAME] =
+        njs_bytecode_cached(njs_vmcode_atom_frame_t, function, this_object,
+                            property),
+    [NJS_VMCODE_FUNCTION_CALL] =
+        njs_bytecode_op1(njs_vmcode_function_call_t, retval),
+
+    [NJS_VMCODE_PROPERTY_NEXT] =
+        njs_bytecode_op3(njs_vmcode_prop_next_t, retval, object, next),
+    [NJS_VMCODE_ARGUMENTS] = njs_bytecode_op1(njs_vmcode_arguments_t, dst),
+    [NJS_VMCODE_PROTO_INIT] =
+        njs_bytecode_op3(njs_vmcode_prop_init_t, value, object, property),
+    [NJS_VMCODE_TO_PROPERTY_KEY] =
+        njs_bytecode_op2(njs_vmcode_2addr_t, dst, src),
+    [NJS_VMCODE_TO_PROPERTY_KEY_CHK] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+    [NJS_VMCODE_SET_FUNCTION_NAME] =
+        njs_bytecode_op2(njs_vmcode_2addr_t, dst, src),
+    [NJS_VMCODE_IMPORT] =
+        njs_bytecode_special(njs_vmcode_import_t, NJS_BYTECODE_IMPORT, retval),
+    [NJS_VMCODE_AWAIT] = njs_bytecode_op1(njs_vmcode_await_t, retval),
+
+    [NJS_VMCODE_TRY_START] =
+        njs_bytecode_op2(njs_vmcode_try_start_t, exception_value, exit_value),
+    [NJS_VMCODE_THROW] = njs_bytecode_op1(njs_vmcode_throw_t, retval),
+    [NJS_VMCODE_TRY_BREAK] =
+        njs_bytecode_op1(njs_vmcode_try_trampoline_t, exit_value),
+    [NJS_VMCODE_TRY_CONTINUE] =
+        njs_bytecode_op1(njs_vmcode_try_trampoline_t, exit_value),
+    [NJS_VMCODE_TRY_END] = njs_bytecode_op(njs_vmcode_try_end_t),
+    [NJS_VMCODE_CATCH] = njs_bytecode_op1(njs_vmcode_catch_t, exception),
+    [NJS_VMCODE_FINALLY] =
+        njs_bytecode_op2(njs_vmcode_finally_t, retval, exit_value),
+
+    [NJS_VMCODE_LET] = njs_bytecode_op1(njs_vmcode_variable_t, dst),
+    [NJS_VMCODE_LET_UPDATE] = njs_bytecode_op1(njs_vmcode_variable_t, dst),
+    [NJS_VMCODE_LET_LOCAL] = njs_bytecode_op1(njs_vmcode_variable_t, dst),
+    [NJS_VMCODE_INITIALIZATION_TEST] =
+        njs_bytecode_op1(njs_vmcode_variable_t, dst),
+    [NJS_VMCODE_NOT_INITIALIZED] =
+        njs_bytecode_op1(njs_vmcode_variable_t, dst),
+    [NJS_VMCODE_ASSIGNMENT_ERROR] =
+        njs_bytecode_op1(njs_vmcode_variable_t, dst),
+    [NJS_VMCODE_ERROR] =
+        { sizeof(njs_vmcode_error_t), NJS_BYTECODE_ERROR, 0, { 0, 0, 0 } },
+
+    [NJS_VMCODE_MOVE] = njs_bytecode_op2(njs_vmcode_move_t, dst, src),
+    [NJS_VMCODE_PROPERTY_ATOM_GET] =
+        njs_bytecode_cached(njs_vmcode_prop_get_t, value, object, property),
+    [NJS_VMCODE_PROPERTY_GET] =
+        njs_bytecode_cached(njs_vmcode_prop_get_t, value, object, property),
+
+    [NJS_VMCODE_INCREMENT] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+    [NJS_VMCODE_POST_INCREMENT] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+    [NJS_VMCODE_DECREMENT] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+    [NJS_VMCODE_POST_DECREMENT] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+
+    [NJS_VMCODE_TRY_RETURN] =
+        njs_bytecode_op2(njs_vmcode_try_return_t, save, retval),
+    [NJS_VMCODE_GLOBAL_GET] =
+        njs_bytecode_cached(njs_vmcode_prop_get_t, value, object, property),
+
+    [NJS_VMCODE_LESS] = njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+    [NJS_VMCODE_GREATER] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+    [NJS_VMCODE_LESS_OR_EQUAL] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+    [NJS_VMCODE_GREATER_OR_EQUAL] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+    [NJS_VMCODE_ADDITION] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+    [NJS_VMCODE_EQUAL] = njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+    [NJS_VMCODE_NOT_EQUAL] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+    [NJS_VMCODE_SUBTRACTION] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+    [NJS_VMCODE_MULTIPLICATION] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+    [NJS_VMCODE_EXPONENTIATION] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+    [NJS_VMCODE_DIVISION] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+    [NJS_VMCODE_REMAINDER] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+    [NJS_VMCODE_BITWISE_AND] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+    [NJS_VMCODE_BITWISE_OR] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+    [NJS_VMCODE_BITWISE_XOR] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+    [NJS_VMCODE_LEFT_SHIFT] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+    [NJS_VMCODE_RIGHT_SHIFT] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+    [NJS_VMCODE_UNSIGNED_RIGHT_SHIFT] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+
+    [NJS_VMCODE_TEMPLATE_LITERAL] =
+        njs_bytecode_op1(njs_vmcode_template_literal_t, retval),
+    [NJS_VMCODE_PROPERTY_IN] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+    [NJS_VMCODE_PROPERTY_DELETE] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+    [NJS_VMCODE_PROPERTY_FOREACH] =
+        njs_bytecode_op2(njs_vmcode_prop_foreach_t, next, object),
+    [NJS_VMCODE_STRICT_EQUAL] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+    [NJS_VMCODE_STRICT_NOT_EQUAL] =
+        njs_bytecode_op3(njs_vmcode_3addr_t, dst, src1, src2),
+
+    [NJS_VMCODE_TEST_IF_TRUE] =
+        njs_bytecode_op2(njs_vmcode_test_jump_t, retval, value),
+    [NJS_VMCODE_TEST_IF_FALSE] =
+        njs_bytecode_op2(njs_vmcode_test_jump_t, retval, value),
+    [NJS_VMCODE_COALESCE] =
+        njs_bytecode_op2(njs_vmcode_test_jump_t, retval, value),
+    [NJS_VMCODE_OPTIONAL_CHAIN] =
+        njs_bytecode_op2(njs_vmcode_test_jump_t, retval, value),
+
+    [NJS_VMCODE_UNARY_PLUS] = njs_bytecode_op2(njs_vmcode_2addr_t, dst, src),
+    [NJS_VMCODE_UNARY_NEGATION] =
+        njs_bytecode_op2(njs_vmcode_2addr_t, dst, src),
+    [NJS_VMCODE_BITWISE_NOT] = njs_bytecode_op2(njs_vmcode_2addr_t, dst, src),
+    [NJS_VMCODE_LOGICAL_NOT] = njs_bytecode_op2(njs_vmcode_2addr_t, dst, src),
+
+    [NJS_VMCODE_OBJECT] =
+        njs_bytecode_special(njs_vmcode_object_t, NJS_BYTECODE_OBJECT, retval),
+    [NJS_VMCODE_ARRAY] = njs_bytecode_op1(njs_vmcode_array_t, retval),
+    [NJS_VMCODE_FUNCTION] =
+        njs_bytecode_special(njs_vmcode_function_t, NJS_BYTECODE_FUNCTION,
+                             retval),
+    [NJS_VMCODE_REGEXP] =
+        njs_bytecode_special(njs_vmcode_regexp_t, NJS_BYTECODE_REGEXP, retval),
+    [NJS_VMCODE_INSTANCE_OF] =
+        njs_bytecode_op3(njs_vmcode_instance_of_t, value, constructor, object),
+
+    [NJS_VMCODE_TYPEOF] = njs_bytecode_op2(njs_vmcode_2addr_t, dst, src),
+    [NJS_VMCODE_VOID] = njs_bytecode_op2(njs_vmcode_2addr_t, dst, src),
+    [NJS_VMCODE_DELETE] = njs_bytecode_op2(njs_vmcode_2addr_t, dst, src),
+    [NJS_VMCODE_DEBUGGER] = njs_bytecode_op1(njs_vmcode_debugger_t, retval),
+};
+
+
+njs_int_t
+njs_vm_module_bytecode(njs_vm_t *vm, njs_mod_t *module,
+    const njs_str_t *source, njs_str_t *bytecode)
+{
+    u_char                 *p, *start;
+    size_t                 size;
+    int64_t                values_size, body_size;
+    uint32_t               u32;
+    njs_int_t              ret;
+    njs_uint_t             n;
+    njs_chb_t              body;
+    njs_bytecode_header_t  header;
+    njs_bytecode_writer_t  wr;
+    njs_function_lambda_t  *lambda, **item;
+
+    if (module->function.native || module->function.u.lambda == NULL) {
+        njs_type_error(vm, "module \"%V\" has no bytecode", &module->name);
+        return NJS_ERROR;
+    }
+
+    ret = NJS_ERROR;
+
+    wr.vm = vm;
+    wr.nconstants = 0;
+    wr.nstatic = (vm->scope_absolute != NULL) ? vm->scope_absolute->items : 0;
+
+    NJS_CHB_MP_INIT(&wr.values, vm->mem_pool);
+    NJS_CHB_MP_INIT(&body, vm->mem_pool);
+
+    wr.constants = njs_mp_zalloc(vm->mem_pool,
+                                 (wr.nstatic + 1) * sizeof(uint32_t));
+    wr.lambdas = njs_arr_create(vm->mem_pool, 4,
+                                sizeof(njs_function_lambda_t *));
+
+    if (njs_slow_path(wr.constants == NULL || wr.lambdas == NULL)) {
+        njs_memory_error(vm);
+        goto done;
+    }
+
+    (void) njs_bytecode_lambda_ref(&wr, module->function.u.lambda);
+
+    /* Lambdas found in the code are appended to the list while writing. */
+
+    for (n = 0; n < wr.lambdas->items; n++) {
+        item = njs_arr_item(wr.lambdas, n);
+        lambda = *item;
+
+        ret = njs_bytecode_lambda_write(&wr, &body, lambda);
+        if (njs_slow_path(ret != NJS_OK)) {
+            goto done;
+        }
+    }
+
+    ret = NJS_ERROR;
+
+    values_size = njs_chb_size(&wr.values);
+    body_size = njs_chb_size(&body);
+
+    if (njs_slow_path(values_size < 0 || body_size < 0)) {
+        njs_memory_error(vm);
+        goto done;
+    }
+
+    size = sizeof(njs_bytecode_header_t) + 2 * sizeof(uint32_t)
+           + values_size + body_size;
+
+    if (njs_slow_path(size > UINT32_MAX)) {
+        njs_range_error(vm, "bytecode size limit exceeded");
+        goto done;
+    }
+
+    start = njs_mp_alloc(vm->mem_pool, size);
+    if (njs_slow_path(start == NULL)) {
+        njs_memory_error(vm);
+        goto done;
+    }
+
+    p = start + sizeof(njs_bytecode_header_t);
+
+    p = njs_cpymem(p, &wr.nconstants, sizeof(uint32_t));
+    njs_chb_join_to(&wr.values, p);
+    p += values_size;
+
+    u32 = wr.lambdas->items;
+    p = njs_cpymem(p, &u32, sizeof(uint32_t));
+    njs_chb_join_to(&body, p);
+
+    header.magic = NJS_BYTECODE_MAGIC;
+    header.version = NJS_BYTECODE_VERSION;
+    header.njs_version = NJS_VERSION_NUMBER;
+    header.layout = njs_bytecode_layout_hash();
+    header.source_size = source->length;
+    header.source_hash = njs_djb_hash(source->start, source->length);
+    header.size = size - sizeof(njs_bytecode_header_t);
+    header.hash = njs_djb_hash(start + sizeof(njs_bytecode_header_t),
+                               header.size);
+
+    memcpy(start, &header, sizeof(njs_bytecode_header_t));
+
+    bytecode->start = start;
+    bytecode->length = size;
+
+    ret = NJS_OK;
+
+done:
+
+    njs_chb_destroy(&wr.values);
+    njs_chb_destroy(&body);
+
+    if (wr.constants != NULL) {
+        njs_mp_free(vm->mem_pool, wr.constants);
+    }
+
+    if (wr.lambdas != NULL) {
+        njs_arr_destroy(wr.lambdas);
+    }
+
+    return ret;
+}
+
+
+static njs_int_t
+njs_bytecode_lambda_write(njs_bytecode_writer_t *wr, njs_chb_t *chain,
+    njs_function_lambda_t *lambda)
+{
+    u_char                       *p, *end, *code;
+    size_t                       size;
+    uint32_t                     flags, *slot;
+    njs_vm_t                     *vm;
+    njs_int_t                    ret;
+    njs_str_t                    str;
+    njs_uint_t                   i, n;
+    njs_chb_t                    records;
+    njs_vm_code_t                *vm_code;
+    njs_vmcode_t                 operation;
+    njs_vmcode_error_t           *error;
+    njs_vmcode_import_t          *import;
+    njs_vmcode_object_t          *object;
+    njs_vmcode_regexp_t          *regexp;
+    njs_regexp_pattern_t         *pattern;
+    njs_vmcode_function_t        *function;
+    const njs_bytecode_layout_t  *layout;
+
+    vm = wr->vm;
+
+    vm_code = njs_bytecode_code_find(vm, lambda->start);
+    if (njs_slow_path(vm_code == NULL)) {
+        njs_internal_error(vm, "function code is not found");
+        return NJS_ERROR;
+    }
+
+    size = vm_code->end - vm_code->start;
+
+    code = njs_mp_alloc(vm->mem_pool, size);
+    if (njs_slow_path(code == NULL)) {
+        njs_memory_error(vm);
+        return NJS_ERROR;
+    }
+
+    memcpy(code, vm_code->start, size);
+
+    NJS_CHB_MP_INIT(&records, vm->mem_pool);
+
+    ret = NJS_ERROR;
+
+    p = code;
+    end = code + size;
+
+    while (p < end) {
+        operation = *(njs_vmcode_t *) p;
+
+        if (njs_slow_path(operation >= NJS_VMCODES
+                          || njs_bytecode_layouts[operation].size == 0
+                          || njs_bytecode_layouts[operation].size > end - p))
+        {
+            njs_internal_error(vm, "unexpected instruction %d", operation);
+            goto done;
+        }
+
+        layout = &njs_bytecode_layouts[operation];
+
+        for (i = 0; i < 3 && layout->operands[i] != 0; i++) {
+            ret = njs_bytecode_operand_write(wr, (njs_vmcode_index_t *)
+                                                 (p + layout->operands[i]));
+            if (njs_slow_path(ret != NJS_OK)) {
+                goto done;
+            }
+        }
+
+        ret = NJS_ERROR;
+
+        if (layout->cache != 0) {
+            /* Cache slots are renumbered by the loading VM. */
+
+            slot = (uint32_t *) (p + layout->cache);
+            *slot = (*slot != 0);
+        }
+
+        switch (layout->type) {
+        case NJS_BYTECODE_FUNCTION:
+            function = (njs_vmcode_function_t *) p;
+
+            n = njs_bytecode_lambda_ref(wr, function->lambda);
+            if (njs_slow_path(n == (uint32_t) -1)) {
+                njs_memory_error(vm);
+                goto done;
+            }
+
+            function->lambda = (njs_function_lambda_t *) (uintptr_t) n;
+            break;
+
+        case NJS_BYTECODE_REGEXP:
+            regexp = (njs_vmcode_regexp_t *) p;
+            pattern = regexp->pattern;
+
+            flags = (pattern->global ? NJS_REGEX_GLOBAL : 0)
+                    | (pattern->ignore_case ? NJS_REGEX_IGNORE_CASE : 0)
+                    | (pattern->multiline ? NJS_REGEX_MULTILINE : 0)
+                    | (pattern->sticky ? NJS_REGEX_STICKY : 0);
+
+            str.start = pattern->source;
+            str.length = njs_strlen(pattern->source);
+
+            njs_bytecode_u32_write(&records, flags);
+            njs_bytecode_str_write(&records, &str);
+
+            regexp->pattern = NULL;
+            break;
+
+        case NJS_BYTECODE_OBJECT:
+            object = (njs_vmcode_object_t *) p;
+
+            if (njs_bytecode_template_write(vm, &records, &object->props)
+                != NJS_OK)
+            {
+                goto done;
+            }
+
+            njs_memzero(&object->props, sizeof(njs_flathsh_t));
+            break;
+
+        case NJS_BYTECODE_ERROR:
+            error = (njs_vmcode_error_t *) p;
+
+            njs_bytecode_str_write(&records, &error->u.name);
+
+            njs_memzero(&error->u, sizeof(error->u));
+            break;
+
+        case NJS_BYTECODE_IMPORT:
+            import = (njs_vmcode_import_t *) p;
+
+            njs_bytecode_str_write(&records, &import->module->name);
+
+            import->module = NULL;
+            break;
+
+        default:
+            break;
+        }
+
+        p += layout->size;
+    }
+
+    flags = (lambda->ctor ? NJS_BYTECODE_CTOR : 0)
+            | (lambda->rest_parameters ? NJS_BYTECODE_REST : 0);
+
+    njs_bytecode_u32_write(chain, lambda->nargs);
+    njs_bytecode_u32_write(chain, lambda->nlocal);
+    njs_bytecode_u32_write(chain, lambda->self);
+    njs_bytecode_u32_write(chain, flags);
+    njs_bytecode_u32_write(chain, lambda->nclosures);
+
+    for (i = 0; i < lambda->nclosures; i++) {
+        njs_bytecode_u32_write(chain, lambda->closures[i]);
+    }
+
+    ret = njs_bytecode_value_write(vm, chain, &lambda->name);
+    if (njs_slow_path(ret != NJS_OK)) {
+        goto done;
+    }
+
+    njs_bytecode_str_write(chain, &vm_code->name);
+
+    njs_bytecode_u32_write(chain, size);
+    njs_chb_append(chain, code, size);
+
+    n = (vm_code->lines != NULL) ? vm_code->lines->items : 0;
+
+    njs_bytecode_u32_write(chain, n);
+
+    if (n != 0) {
+        njs_chb_append(chain, vm_code->lines->start,
+                       n * sizeof(njs_vm_line_num_t));
+    }
+
+    ret = njs_chb_join(&records, &str);
+    if (njs_slow_path(ret == NJS_ERROR)) {
+        njs_memory_error(vm);
+        goto done;
+    }
+
+    if (ret == NJS_OK) {
+        njs_chb_append_str(chain, &str);
+        njs_mp_free(vm->mem_pool, str.start);
+    }
+
+    ret = NJS_OK;
+
+done:
+
+    njs_chb_destroy(&records);
+    njs_mp_free(vm->mem_pool, code);
+
+    return ret;
+}
+
+
+static njs_int_t
+njs_bytecode_operand_write(njs_bytecode_writer_t *wr,
+    njs_vmcode_index_t *operand)
+{
+    uint32_t     slot, *number;
+    njs_int_t    ret;
+    njs_value_t  **values;
+
+    if (njs_scope_index_type(*operand) != NJS_LEVEL_STATIC) {
+        return NJS_OK;
+    }
+
+    slot = njs_scope_index_value(*operand);
+
+    if (njs_slow_path(slot >= wr->nstatic)) {
+        njs_internal_error(wr->vm, "unexpected constant operand");
+        return NJS_ERROR;
+    }
+
+    number = &wr->constants[slot];
+
+    if (*number == 0) {
+        values = wr->vm->scope_absolute->start;
+
+        ret = njs_bytecode_value_write(wr->vm, &wr->values, values[slot]);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return ret;
+        }
+
+        *number = ++wr->nconstants;
+    }
+
+    *operand = ((*number - 1) << NJS_SCOPE_VALUE_OFFSET)
+               | (NJS_LEVEL_STATIC << NJS_SCOPE_TYPE_OFFSET)
+               | njs_scope_index_var(*operand);
+
+    return NJS_OK;
+}
+
+
+static uint32_t
+njs_bytecode_lambda_ref(njs_bytecode_writer_t *wr,
+    njs_function_lambda_t *lambda)
+{
+    njs_uint_t             n;
+    njs_function_lambda_t  **item;
+
+    item = wr->lambdas->start;
+
+    for (n = 0; n < wr->lambdas->items; n++) {
+        if (item[n] == lambda) {
+            return n;
+        }
+    }
+
+    item = njs_arr_add(wr->lambdas);
+    if (njs_slow_path(item == NULL)) {
+        return (uint32_t) -1;
+    }
+
+    *item = lambda;
+
+    return n;
+}
+
+
+static njs_int_t
+njs_bytecode_template_write(njs_vm_t *vm, njs_chb_t *chain,
+    njs_flathsh_t *props)
+{
+    uint32_t            n;
+    njs_int_t           ret;
+    njs_value_t         key;
+    njs_flathsh_elt_t   *elt;
+    njs_flathsh_each_t  fhe;
+
+    n = 0;
+
+    njs_flathsh_each_init(&fhe, &njs_object_hash_proto);
+
+    while (njs_flathsh_each(props, &fhe) != NULL) {
+        n++;
+    }
+
+    njs_bytecode_u32_write(chain, n);
+
+    njs_flathsh_each_init(&fhe, &njs_object_hash_proto);
+
+    for ( ;; ) {
+        elt = njs_flathsh_each(props, &fhe);
+        if (elt == NULL) {
+            break;
+        }
+
+        ret = njs_atom_to_value(vm, &key, elt->key_hash);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return NJS_ERROR;
+        }
+
+        ret = njs_bytecode_value_write(vm, chain, &key);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return NJS_ERROR;
+        }
+    }
+
+    return NJS_OK;
+}
+
+
+/*
+ * A value is stored as its type, an atom flag and either the string
+ * bytes or the value itself.  Atoms are VM specific, so values with
+ * atoms are atomized again when loaded.
+ */
+
+static njs_int_t
+njs_bytecode_value_write(njs_vm_t *vm, njs_chb_t *chain, njs_value_t *value)
+{
+    u_char     head[2];
+    njs_str_t  str;
+
+    head[0] = value->type;
+    head[1] = (value->atom_id != NJS_ATOM_STRING_unknown);
+
+    switch (value->type) {
+    case NJS_STRING:
+        njs_chb_append(chain, head, sizeof(head));
+
+        njs_string_get(vm, value, &str);
+        njs_bytecode_str_write(chain, &str);
+        break;
+
+    case NJS_NULL:
+    case NJS_UNDEFINED:
+    case NJS_BOOLEAN:
+    case NJS_NUMBER:
+        njs_chb_append(chain, head, sizeof(head));
+        njs_chb_append(chain, value, sizeof(njs_value_t));
+        break;
+
+    default:
+        njs_internal_error(vm, "unexpected constant value");
+        return NJS_ERROR;
+    }
+
+    return NJS_OK;
+}
+
+
+static njs_vm_code_t *
+njs_bytecode_code_find(njs_vm_t *vm, u_char *start)
+{
+    njs_uint_t     n;
+    njs_vm_code_t  *code;
+
+    if (vm->codes == NULL) {
+        return NULL;
+    }
+
+    code = vm->codes->start;
+
+    for (n = 0; n < vm->codes->items; n++) {
+        if (code[n].start == start) {
+            return &code[n];
+        }
+    }
+
+    return NULL;
+}
+
+
+njs_int_t
+njs_vm_module_from_bytecode(njs_vm_t *vm, njs_str_t *name,
+    const njs_str_t *source, const njs_str_t *bytecode, njs_mod_t **module)
+{
+    uint32_t               n, ncodes;
+    njs_int_t              ret;
+    njs_mod_t              *mod;
+    njs_value_t            value;
+    njs_bytecode_header_t  header;
+    njs_bytecode_reader_t  rd;
+
+    mod = njs_module_find(vm, name, 1);
+    if (mod != NULL) {
+        *module = mod;
+        return NJS_OK;
+    }
+
+    if (bytecode->length < sizeof(njs_bytecode_header_t)) {
+        return NJS_DECLINED;
+    }
+
+    memcpy(&header, bytecode->start, sizeof(njs_bytecode_header_t));
+
+    if (header.magic != NJS_BYTECODE_MAGIC
+        || header.version != NJS_BYTECODE_VERSION
+        || header.njs_version != NJS_VERSION_NUMBER
+        || header.layout != njs_bytecode_layout_hash()
+        || header.source_size != source->length
+        || header.source_hash != njs_djb_hash(source->start, source->length)
+        || header.size != bytecode->length - sizeof(njs_bytecode_header_t))
+    {
+        return NJS_DECLINED;
+    }
+
+    rd.vm = vm;
+    rd.pos = bytecode->start + sizeof(njs_bytecode_header_t);
+    rd.end = bytecode->start + bytecode->length;
+
+    if (header.hash != njs_djb_hash(rd.pos, header.size)) {
+        return NJS_DECLINED;
+    }
+
+    ret = njs_name_copy(vm, &rd.file, name);
+    if (njs_slow_path(ret != NJS_OK)) {
+        njs_memory_error(vm);
+        return NJS_ERROR;
+    }
+
+    ncodes = (vm->codes != NULL) ? vm->codes->items : 0;
+
+    ret = njs_bytecode_u32_read(&rd, &rd.nconstants);
+    if (ret != NJS_OK) {
+        goto fail;
+    }
+
+    if (rd.nconstants > (size_t) (rd.end - rd.pos)) {
+        ret = NJS_DECLINED;
+        goto fail;
+    }
+
+    rd.constants = njs_mp_alloc(vm->mem_pool,
+                                (rd.nconstants + 1) * sizeof(njs_index_t));
+    if (njs_slow_path(rd.constants == NULL)) {
+        njs_memory_error(vm);
+        return NJS_ERROR;
+    }
+
+    for (n = 0; n < rd.nconstants; n++) {
+        ret = njs_bytecode_value_read(&rd, &value);
+        if (ret != NJS_OK) {
+            goto fail;
+        }
+
+        rd.constants[n] = njs_scope_global_index(vm, &value, 0);
+        if (njs_slow_path(rd.constants[n] == NJS_INDEX_ERROR)) {
+            ret = NJS_ERROR;
+            goto fail;
+        }
+    }
+
+    ret = njs_bytecode_u32_read(&rd, &rd.nlambdas);
+    if (ret != NJS_OK) {
+        goto fail;
+    }
+
+    if (rd.nlambdas == 0 || rd.nlambdas > (size_t) (rd.end - rd.pos)) {
+        ret = NJS_DECLINED;
+        goto fail;
+    }
+
+    /*
+     * As with compilation from source, the module is registered before
+     * its imports are loaded, so cyclic imports find it.  A cache which
+     * passed the checksum and still does not link is an error from now on,
+     * a fallback to the source would find the registered empty module.
+     */
+
+    mod = njs_module_add(vm, name, NULL);
+    if (njs_slow_path(mod == NULL)) {
+        ret = NJS_ERROR;
+        goto fail;
+    }
+
+    rd.lambdas = njs_mp_zalloc(vm->mem_pool,
+                               rd.nlambdas * sizeof(njs_function_lambda_t));
+    if (njs_slow_path(rd.lambdas == NULL)) {
+        njs_memory_error(vm);
+        ret = NJS_ERROR;
+        goto fail;
+    }
+
+    for (n = 0; n < rd.nlambdas; n++) {
+        ret = njs_bytecode_lambda_read(&rd, &rd.lambdas[n]);
+        if (ret != NJS_OK) {
+            goto invalid;
+        }
+    }
+
+    if (rd.pos != rd.end) {
+        ret = NJS_DECLINED;
+        goto invalid;
+    }
+
+    mod->function.u.lambda = &rd.lambdas[0];
+
+    *module = mod;
+
+    return NJS_OK;
+
+invalid:
+
+    if (ret == NJS_DECLINED) {
+        njs_internal_error(vm, "invalid bytecode of module \"%V\"", name);
+        ret = NJS_ERROR;
+    }
+
+fail:
+
+    if (vm->codes != NULL) {
+        vm->codes->items = ncodes;
+    }
+
+    return ret;
+}
+
+
+static njs_int_t
+njs_bytecode_lambda_read(njs_bytecode_reader_t *rd,
+    njs_function_lambda_t *lambda)
+{
+    u_char             *code;
+    uint32_t           u32, flags, size, nlines;
+    njs_vm_t           *vm;
+    njs_int_t          ret;
+    njs_str_t          name;
+    njs_uint_t         n;
+    njs_vm_code_t      *vm_code;
+    njs_vm_line_num_t  *lines;
+
+    vm = rd->vm;
+
+    if (njs_bytecode_u32_read(rd, &lambda->nargs) != NJS_OK
+        || njs_bytecode_u32_read(rd, &lambda->nlocal) != NJS_OK
+        || njs_bytecode_u32_read(rd, &u32) != NJS_OK
+        || njs_bytecode_u32_read(rd, &flags) != NJS_OK
+        || njs_bytecode_u32_read(rd, &lambda->nclosures) != NJS_OK)
+    {
+        return NJS_DECLINED;
+    }
+
+    lambda->self = u32;
+    lambda->ctor = ((flags & NJS_BYTECODE_CTOR) != 0);
+    lambda->rest_parameters = ((flags & NJS_BYTECODE_REST) != 0);
+
+    if (lambda->nclosures > (size_t) (rd->end - rd->pos) / sizeof(uint32_t)) {
+        return NJS_DECLINED;
+    }
+
+    if (lambda->nclosures != 0) {
+        lambda->closures = njs_mp_alloc(vm->mem_pool,
+                                      lambda->nclosures * sizeof(njs_index_t));
+        if (njs_slow_path(lambda->closures == NULL)) {
+            njs_memory_error(vm);
+            return NJS_ERROR;
+        }
+
+        for (n = 0; n < lambda->nclosures; n++) {
+            (void) njs_bytecode_u32_read(rd, &u32);
+            lambda->closures[n] = u32;
+        }
+    }
+
+    ret = njs_bytecode_value_read(rd, &lambda->name);
+    if (ret != NJS_OK) {
+        return ret;
+    }
+
+    ret = njs_bytecode_str_read(rd, &name);
+    if (ret != NJS_OK) {
+        return ret;
+    }
+
+    if (njs_bytecode_u32_read(rd, &size) != NJS_OK
+        || size > (size_t) (rd->end - rd->pos))
+    {
+        return NJS_DECLINED;
+    }
+
+    code = njs_mp_alloc(vm->mem_pool, size);
+    if (njs_slow_path(code == NULL)) {
+        njs_memory_error(vm);
+        return NJS_ERROR;
+    }
+
+    (void) njs_bytecode_read(rd, code, size);
+
+    lambda->start = code;
+
+    if (vm->codes == NULL) {
+        vm->codes = njs_arr_create(vm->mem_pool, 4, sizeof(njs_vm_code_t));
+        if (njs_slow_path(vm->codes == NULL)) {
+            njs_memory_error(vm);
+            return NJS_ERROR;
+        }
+    }
+
+    vm_code = njs_arr_add(vm->codes);
+    if (njs_slow_path(vm_code == NULL)) {
+        njs_memory_error(vm);
+        return NJS_ERROR;
+    }
+
+    vm_code->start = code;
+    vm_code->end = code + size;
+    vm_code->file = rd->file;
+    vm_code->lines = NULL;
+
+    ret = njs_name_copy(vm, &vm_code->name, &name);
+    if (njs_slow_path(ret != NJS_OK)) {
+        njs_memory_error(vm);
+        return NJS_ERROR;
+    }
+
+    if (njs_bytecode_u32_read(rd, &nlines) != NJS_OK
+        || nlines > (size_t) (rd->end - rd->pos) / sizeof(njs_vm_line_num_t))
+    {
+        return NJS_DECLINED;
+    }
+
+    if (nlines != 0 && vm->options.backtrace) {
+        vm_code->lines = njs_arr_create(vm->mem_pool, nlines,
+                                        sizeof(njs_vm_line_num_t));
+        if (njs_slow_path(vm_code->lines == NULL)) {
+            njs_memory_error(vm);
+            return NJS_ERROR;
+        }
+
+        lines = njs_arr_add_multiple(vm_code->lines, nlines);
+        if (njs_slow_path(lines == NULL)) {
+            njs_memory_error(vm);
+            return NJS_ERROR;
+        }
+
+        memcpy(lines, rd->pos, nlines * sizeof(njs_vm_line_num_t));
+    }
+
+    rd->pos += nlines * sizeof(njs_vm_line_num_t);
+
+    return njs_bytecode_code_link(rd, code, code + size);
+}
+
+
+static njs_int_t
+njs_bytecode_code_link(njs_bytecode_reader_t *rd, u_char *start, u_char *end)
+{
+    u_char                       *p;
+    uint32_t                     n, flags, *slot;
+    njs_vm_t                     *vm;
+    njs_int_t                    ret;
+    njs_str_t                    str;
+    njs_mod_t                    *module;
+    njs_uint_t                   i;
+    njs_vmcode_t                 operation;
+    njs_vmcode_index_t           *operand;
+    njs_vmcode_error_t           *error;
+    njs_vmcode_import_t          *import;
+    njs_vmcode_object_t          *object;
+    njs_vmcode_regexp_t          *regexp;
+    njs_vmcode_function_t        *function;
+    const njs_bytecode_layout_t  *layout;
+
+    vm = rd->vm;
+
+    p = start;
+
+    while (p < end) {
+        operation = *(njs_vmcode_t *) p;
+
+        if (operation >= NJS_VMCODES
+            || njs_bytecode_layouts[operation].size == 0
+            || njs_bytecode_layouts[operation].size > end - p)
+        {
+            return NJS_DECLINED;
+        }
+
+        layout = &njs_bytecode_layouts[operation];
+
+        for (i = 0; i < 3 && layout->operands[i] != 0; i++) {
+            operand = (njs_vmcode_index_t *) (p + layout->operands[i]);
+
+            if (njs_scope_index_type(*operand) == NJS_LEVEL_STATIC) {
+                n = njs_scope_index_value(*operand);
+
+                if (n >= rd->nconstants) {
+                    return NJS_DECLINED;
+                }
+
+                *operand = rd->constants[n];
+            }
+        }
+
+        if (layout->cache != 0) {
+            slot = (uint32_t *) (p + layout->cache);
+
+            if (*slot != 0) {
+                *slot = ++vm->prop_cache_slots;
+            }
+        }
+
+        switch (layout->type) {
+        case NJS_BYTECODE_FUNCTION:
+            function = (njs_vmcode_function_t *) p;
+
+            n = (uintptr_t) function->lambda;
+
+            if (n >= rd->nlambdas) {
+                return NJS_DECLINED;
+            }
+
+            function->lambda = &rd->lambdas[n];
+            break;
+
+        case NJS_BYTECODE_REGEXP:
+            regexp = (njs_vmcode_regexp_t *) p;
+
+            if (njs_bytecode_u32_read(rd, &flags) != NJS_OK
+                || njs_bytecode_str_read(rd, &str) != NJS_OK)
+            {
+                return NJS_DECLINED;
+            }
+
+            regexp->pattern = njs_regexp_pattern_create(vm, str.start,
+                                                        str.length, flags);
+            if (njs_slow_path(regexp->pattern == NULL)) {
+                return NJS_ERROR;
+            }
+
+            break;
+
+        case NJS_BYTECODE_OBJECT:
+            object = (njs_vmcode_object_t *) p;
+
+            ret = njs_bytecode_template_read(rd, &object->props);
+            if (ret != NJS_OK) {
+                return ret;
+            }
+
+            break;
+
+        case NJS_BYTECODE_ERROR:
+            error = (njs_vmcode_error_t *) p;
+
+            if (njs_bytecode_str_read(rd, &str) != NJS_OK) {
+                return NJS_DECLINED;
+            }
+
+            ret = njs_name_copy(vm, &error->u.name, &str);
+            if (njs_slow_path(ret != NJS_OK)) {
+                njs_memory_error(vm);
+                return NJS_ERROR;
+            }
+
+            break;
+
+        case NJS_BYTECODE_IMPORT:
+            import = (njs_vmcode_import_t *) p;
+
+            if (njs_bytecode_str_read(rd, &str) != NJS_OK) {
+                return NJS_DECLINED;
+            }
+
+            module = njs_module_find(vm, &str, 1);
+
+            if (module == NULL) {
+                if (vm->module_loader == NULL) {
+                    njs_reference_error(vm, "Cannot load module \"%V\"", &str);
+                    return NJS_ERROR;
+                }
+
+                module = vm->module_loader(vm, vm->module_loader_opaque, &str);
+                if (module == NULL) {
+                    if (!njs_is_valid(&vm->exception)) {
+                        njs_reference_error(vm, "Cannot load module \"%V\"",
+                                            &str);
+                    }
+
+                    return NJS_ERROR;
+                }
+            }
+
+            import->module = module;
+            break;
+
+        default:
+            break;
+        }
+
+        p += layout->size;
+    }
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_bytecode_template_read(njs_bytecode_reader_t *rd, njs_flathsh_t *props)
+{
+    uint32_t             n;
+    njs_int_t            ret;
+    njs_value_t          key;
+    njs_object_prop_t    *prop;
+    njs_flathsh_query_t  fhq;
+
+    if (njs_bytecode_u32_read(rd, &n) != NJS_OK) {
+        return NJS_DECLINED;
+    }
+
+    fhq.replace = 0;
+    fhq.pool = rd->vm->mem_pool;
+    fhq.proto = &njs_object_hash_proto;
+
+    while (n-- != 0) {
+        ret = njs_bytecode_value_read(rd, &key);
+        if (ret != NJS_OK) {
+            return ret;
+        }
+
+        if (!njs_is_string(&key) || key.atom_id == NJS_ATOM_STRING_unknown) {
+            return NJS_DECLINED;
+        }
+
+        fhq.key_hash = key.atom_id;
+
+        ret = njs_flathsh_unique_insert(props, &fhq);
+        if (njs_slow_path(ret == NJS_ERROR)) {
+            njs_memory_error(rd->vm);
+            return NJS_ERROR;
+        }
+
+        if (ret == NJS_DECLINED) {
+            return NJS_DECLINED;
+        }
+
+        prop = fhq.value;
+
+        prop->type = NJS_PROPERTY;
+        prop->enumerable = 1;
+        prop->configurable = 1;
+        prop->writable = 1;
+        njs_set_invalid(njs_prop_value(prop));
+    }
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_bytecode_value_read(njs_bytecode_reader_t *rd, njs_value_t *value)
+{
+    u_char     head[2];
+    njs_int_t  ret;
+    njs_str_t  str;
+
+    if (njs_bytecode_read(rd, head, sizeof(head)) != NJS_OK) {
+        return NJS_DECLINED;
+    }
+
+    switch (head[0]) {
+    case NJS_STRING:
+        if (njs_bytecode_str_read(rd, &str) != NJS_OK) {
+            return NJS_DECLINED;
+        }
+
+        ret = njs_string_create(rd->vm, value, str.start, str.length);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return NJS_ERROR;
+        }
+
+        break;
+
+    case NJS_NULL:
+    case NJS_UNDEFINED:
+    case NJS_BOOLEAN:
+    case NJS_NUMBER:
+        if (njs_bytecode_read(rd, value, sizeof(njs_value_t)) != NJS_OK
+            || value->type != head[0])
+        {
+            return NJS_DECLINED;
+        }
+
+        break;
+
+    default:
+        return NJS_DECLINED;
+    }
+
+    value->atom_id = NJS_ATOM_STRING_unknown;
+
+    if (head[1]) {
+        ret = njs_atom_atomize_key(rd->vm, value);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return NJS_ERROR;
+        }
+    }
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_bytecode_str_read(njs_bytecode_reader_t *rd, njs_str_t *str)
+{
+    uint32_t  length;
+
+    if (njs_bytecode_u32_read(rd, &length) != NJS_OK
+        || length > (size_t) (rd->end - rd->pos))
+    {
+        return NJS_DECLINED;
+    }
+
+    str->start = rd->pos;
+    str->length = length;
+
+    rd->pos += length;
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_bytecode_read(njs_bytecode_reader_t *rd, void *dst, size_t size)
+{
+    if (njs_slow_path(size > (size_t) (rd->end - rd->pos))) {
+        return NJS_DECLINED;
+    }
+
+    memcpy(dst, rd->pos, size);
+    rd->pos += size;
+
+    return NJS_OK;
+}
+
+
+/*
+ * The hash of the instruction layouts and of the value size
+ * identifies the bytecode format of the build.
+ */
+
+static uint32_t
+njs_bytecode_layout_hash(void)
+{
+    return njs_djb_hash(njs_bytecode_layouts, sizeof(njs_bytecode_layouts))
+           ^ (uint32_t) (sizeof(njs_value_t) << 16 | sizeof(void *));
+}
+
+
+size_t
+njs_bytecode_instruction_size(njs_vmcode_t code)
+{
+    return (code < NJS_VMCODES) ? njs_bytecode_layouts[code].size : 0;
+}
@@ -113,9 +113,7 @@ njs_chb_utf8_length(njs_chb_t *chain)
         size = njs_chb_node_size(n);
         p_end = p + size;
 
-        while (p < p_end && *p < 0x80) {
-              p++;
-        }
+        p += njs_utf8_ascii_size(p, p_end);
 
         if (p != p_end) {
             break;
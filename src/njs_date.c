@@ -423,6 +423,10 @@ njs_date_constructor(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
             time = njs_date(&args[1])->time;
 
         } else if (njs_is_string(&args[1])) {
+            if (njs_slow_path(njs_string_flatten(vm, &args[1]) != NJS_OK)) {
+                return NJS_ERROR;
+            }
+
             time = njs_date_string_parse(vm, &args[1]);
 
         } else {
@@ -493,11 +497,9 @@ njs_date_parse(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
     njs_int_t  ret;
 
     if (nargs > 1) {
-        if (njs_slow_path(!njs_is_string(&args[1]))) {
-            ret = njs_value_to_string(vm, &args[1], &args[1]);
-            if (njs_slow_path(ret != NJS_OK)) {
-                return ret;
-            }
+        ret = njs_value_to_string(vm, &args[1], &args[1]);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return ret;
         }
 
         time = njs_date_string_parse(vm, &args[1]);
@@ -12,177 +12,209 @@ typedef struct {
     njs_vmcode_t               operation;
     size_t                     size;
     njs_str_t                  name;
+    njs_uint_t                 operands;
 } njs_code_name_t;
 
 
+static njs_code_name_t  cmp_jump_names[] = {
+
+    { NJS_VMCODE_IF_EQUAL_JUMP, sizeof(njs_vmcode_equal_jump_t),
+          njs_str("JUMP IF EQUAL    "), 0 },
+    { NJS_VMCODE_IF_NOT_EQUAL_JUMP, sizeof(njs_vmcode_equal_jump_t),
+          njs_str("JUMP IF NOT EQUAL"), 0 },
+    { NJS_VMCODE_IF_LESS_JUMP, sizeof(njs_vmcode_equal_jump_t),
+          njs_str("JUMP IF LT       "), 0 },
+    { NJS_VMCODE_IF_GREATER_JUMP, sizeof(njs_vmcode_equal_jump_t),
+          njs_str("JUMP IF GT       "), 0 },
+    { NJS_VMCODE_IF_LESS_OR_EQUAL_JUMP, sizeof(njs_vmcode_equal_jump_t),
+          njs_str("JUMP IF LE       "), 0 },
+    { NJS_VMCODE_IF_GREATER_OR_EQUAL_JUMP, sizeof(njs_vmcode_equal_jump_t),
+          njs_str("JUMP IF GE       "), 0 },
+    { NJS_VMCODE_IF_NOT_LESS_JUMP, sizeof(njs_vmcode_equal_jump_t),
+          njs_str("JUMP IF NOT LT   "), 0 },
+    { NJS_VMCODE_IF_NOT_GREATER_JUMP, sizeof(njs_vmcode_equal_jump_t),
+          njs_str("JUMP IF NOT GT   "), 0 },
+    { NJS_VMCODE_IF_NOT_LESS_OR_EQUAL_JUMP, sizeof(njs_vmcode_equal_jump_t),
+          njs_str("JUMP IF NOT LE   "), 0 },
+    { NJS_VMCODE_IF_NOT_GREATER_OR_EQUAL_JUMP, sizeof(njs_vmcode_equal_jump_t),
+          njs_str("JUMP IF NOT GE   "), 0 },
+};
+
+
 static njs_code_name_t  code_names[] = {
 
     { NJS_VMCODE_PUT_ARG, sizeof(njs_vmcode_1addr_t),
-          njs_str("PUT ARG         ") },
+          njs_str("PUT ARG         "), 1 },
     { NJS_VMCODE_OBJECT, sizeof(njs_vmcode_object_t),
-          njs_str("OBJECT          ") },
+          njs_str("OBJECT          "), 1 },
     { NJS_VMCODE_FUNCTION, sizeof(njs_vmcode_function_t),
-          njs_str("FUNCTION        ") },
+          njs_str("FUNCTION        "), 1 },
     { NJS_VMCODE_ARGUMENTS, sizeof(njs_vmcode_arguments_t),
-          njs_str("ARGUMENTS       ") },
+          njs_str("ARGUMENTS       "), 1 },
     { NJS_VMCODE_REGEXP, sizeof(njs_vmcode_regexp_t),
-          njs_str("REGEXP          ") },
+          njs_str("REGEXP          "), 1 },
     { NJS_VMCODE_TEMPLATE_LITERAL, sizeof(njs_vmcode_template_literal_t),
-          njs_str("TEMPLATE LITERAL") },
+          njs_str("TEMPLATE LITERAL"), 1 },
 
     { NJS_VMCODE_PROPERTY_GET, sizeof(njs_vmcode_prop_get_t),
-          njs_str("PROP GET        ") },
+          njs_str("PROP GET        "), 3 },
     { NJS_VMCODE_PROPERTY_ATOM_GET, sizeof(njs_vmcode_prop_get_t),
-          njs_str("PROP ATOM GET   ") },
+          njs_str("PROP ATOM GET   "), 3 },
     { NJS_VMCODE_GLOBAL_GET, sizeof(njs_vmcode_prop_get_t),
-          njs_str("GLOBAL GET      ") },
-    { NJS_VMCODE_PROPERTY_INIT, sizeof(njs_vmcode_prop_set_t),
-          njs_str("PROP INIT       ") },
-    { NJS_VMCODE_PROTO_INIT, sizeof(njs_vmcode_prop_set_t),
-          njs_str("PROTO INIT      ") },
+          njs_str("GLOBAL GET      "), 3 },
+    { NJS_VMCODE_PROPERTY_INIT, sizeof(njs_vmcode_prop_init_t),
+          njs_str("PROP INIT       "), 3 },
+    { NJS_VMCODE_PROTO_INIT, sizeof(njs_vmcode_prop_init_t),
+          njs_str("PROTO INIT      "), 3 },
     { NJS_VMCODE_PROPERTY_SET, sizeof(njs_vmcode_prop_set_t),
-          njs_str("PROP SET        ") },
+          njs_str("PROP SET        "), 3 },
     { NJS_VMCODE_PROPERTY_ATOM_SET, sizeof(njs_vmcode_prop_set_t),
-          njs_str("PROP ATOM SET   ") },
+          njs_str("PROP ATOM SET   "), 3 },
     { NJS_VMCODE_PROPERTY_IN, sizeof(njs_vmcode_3addr_t),
-          njs_str("PROP IN         ") },
+          njs_str("PROP IN         "), 3 },
     { NJS_VMCODE_PROPERTY_DELETE, sizeof(njs_vmcode_3addr_t),
-          njs_str("PROP DELETE     ") },
+          njs_str("PROP DELETE     "), 3 },
     { NJS_VMCODE_INSTANCE_OF, sizeof(njs_vmcode_instance_of_t),
-          njs_str("INSTANCE OF     ") },
+          njs_str("INSTANCE OF     "), 3 },
 
     { NJS_VMCODE_FUNCTION_CALL, sizeof(njs_vmcode_function_call_t),
-          njs_str("FUNCTION CALL   ") },
+          njs_str("FUNCTION CALL   "), 1 },
     { NJS_VMCODE_METHOD_FRAME, sizeof(njs_vmcode_method_frame_t),
-          njs_str("METHOD FRAME    ") },
+          njs_str("METHOD FRAME    "), 0 },
     { NJS_VMCODE_RETURN, sizeof(njs_vmcode_return_t),
-          njs_str("RETURN          ") },
+          njs_str("RETURN          "), 1 },
     { NJS_VMCODE_STOP, sizeof(njs_vmcode_stop_t),
-          njs_str("STOP            ") },
+          njs_str("STOP            "), 1 },
 
     { NJS_VMCODE_INCREMENT, sizeof(njs_vmcode_3addr_t),
-          njs_str("INC             ") },
+          njs_str("INC             "), 3 },
     { NJS_VMCODE_DECREMENT, sizeof(njs_vmcode_3addr_t),
-          njs_str("DEC             ") },
+          njs_str("DEC             "), 3 },
     { NJS_VMCODE_POST_INCREMENT, sizeof(njs_vmcode_3addr_t),
-          njs_str("POST INC        ") },
+          njs_str("POST INC        "), 3 },
     { NJS_VMCODE_POST_DECREMENT, sizeof(njs_vmcode_3addr_t),
-          njs_str("POST DEC        ") },
+          njs_str("POST DEC        "), 3 },
 
     { NJS_VMCODE_DELETE, sizeof(njs_vmcode_2addr_t),
-          njs_str("DELETE          ") },
+          njs_str("DELETE          "), 2 },
     { NJS_VMCODE_VOID, sizeof(njs_vmcode_2addr_t),
-          njs_str("VOID            ") },
+          njs_str("VOID            "), 2 },
     { NJS_VMCODE_TYPEOF, sizeof(njs_vmcode_2addr_t),
-          njs_str("TYPEOF          ") },
+          njs_str("TYPEOF          "), 2 },
     { NJS_VMCODE_TO_PROPERTY_KEY, sizeof(njs_vmcode_2addr_t),
-          njs_str("TO PROP KEY     ") },
+          njs_str("TO PROP KEY     "), 2 },
     { NJS_VMCODE_TO_PROPERTY_KEY_CHK, sizeof(njs_vmcode_3addr_t),
-          njs_str("TO PROP KEY CHK ") },
+          njs_str("TO PROP KEY CHK "), 3 },
     { NJS_VMCODE_SET_FUNCTION_NAME, sizeof(njs_vmcode_2addr_t),
-          njs_str("SET FUNC NAME   ") },
+          njs_str("SET FUNC NAME   "), 2 },
 
     { NJS_VMCODE_UNARY_PLUS, sizeof(njs_vmcode_2addr_t),
-          njs_str("PLUS            ") },
+          njs_str("PLUS            "), 2 },
     { NJS_VMCODE_UNARY_NEGATION, sizeof(njs_vmcode_2addr_t),
-          njs_str("NEGATION        ") },
+          njs_str("NEGATION        "), 2 },
 
     { NJS_VMCODE_ADDITION, sizeof(njs_vmcode_3addr_t),
-          njs_str("ADD             ") },
+          njs_str("ADD             "), 3 },
     { NJS_VMCODE_SUBTRACTION, sizeof(njs_vmcode_3addr_t),
-          njs_str("SUBTRACT        ") },
+          njs_str("SUBTRACT        "), 3 },
     { NJS_VMCODE_MULTIPLICATION, sizeof(njs_vmcode_3addr_t),
-          njs_str("MULTIPLY        ") },
+          njs_str("MULTIPLY        "), 3 },
     { NJS_VMCODE_EXPONENTIATION, sizeof(njs_vmcode_3addr_t),
-          njs_str("POWER           ") },
+          njs_str("POWER           "), 3 },
     { NJS_VMCODE_DIVISION, sizeof(njs_vmcode_3addr_t),
-          njs_str("DIVIDE          ") },
+          njs_str("DIVIDE          "), 3 },
     { NJS_VMCODE_REMAINDER, sizeof(njs_vmcode_3addr_t),
-          njs_str("REMAINDER       ") },
+          njs_str("REMAINDER       "), 3 },
 
     { NJS_VMCODE_LEFT_SHIFT, sizeof(njs_vmcode_3addr_t),
-          njs_str("LEFT SHIFT      ") },
+          njs_str("LEFT SHIFT      "), 3 },
     { NJS_VMCODE_RIGHT_SHIFT, sizeof(njs_vmcode_3addr_t),
-          njs_str("RIGHT SHIFT     ") },
+          njs_str("RIGHT SHIFT     "), 3 },
     { NJS_VMCODE_UNSIGNED_RIGHT_SHIFT, sizeof(njs_vmcode_3addr_t),
-          njs_str("USGN RIGHT SHIFT") },
+          njs_str("USGN RIGHT SHIFT"), 3 },
 
     { NJS_VMCODE_LOGICAL_NOT, sizeof(njs_vmcode_2addr_t),
-          njs_str("LOGICAL NOT     ") },
+          njs_str("LOGICAL NOT     "), 2 },
 
     { NJS_VMCODE_BITWISE_NOT, sizeof(njs_vmcode_2addr_t),
-          njs_str("BINARY NOT      ") },
+          njs_str("BINARY NOT      "), 2 },
     { NJS_VMCODE_BITWISE_AND, sizeof(njs_vmcode_3addr_t),
-          njs_str("BINARY AND      ") },
+          njs_str("BINARY AND      "), 3 },
     { NJS_VMCODE_BITWISE_XOR, sizeof(njs_vmcode_3addr_t),
-          njs_str("BINARY XOR      ") },
+          njs_str("BINARY XOR      "), 3 },
     { NJS_VMCODE_BITWISE_OR, sizeof(njs_vmcode_3addr_t),
-          njs_str("BINARY OR       ") },
+          njs_str("BINARY OR       "), 3 },
 
     { NJS_VMCODE_EQUAL, sizeof(njs_vmcode_3addr_t),
-          njs_str("EQUAL           ") },
+          njs_str("EQUAL           "), 3 },
     { NJS_VMCODE_NOT_EQUAL, sizeof(njs_vmcode_3addr_t),
-          njs_str("NOT EQUAL       ") },
+          njs_str("NOT EQUAL       "), 3 },
     { NJS_VMCODE_LESS, sizeof(njs_vmcode_3addr_t),
-          njs_str("LESS            ") },
+          njs_str("LESS            "), 3 },
     { NJS_VMCODE_LESS_OR_EQUAL, sizeof(njs_vmcode_3addr_t),
-          njs_str("LESS OR EQUAL   ") },
+          njs_str("LESS OR EQUAL   "), 3 },
     { NJS_VMCODE_GREATER, sizeof(njs_vmcode_3addr_t),
-          njs_str("GREATER         ") },
+          njs_str("GREATER         "), 3 },
     { NJS_VMCODE_GREATER_OR_EQUAL, sizeof(njs_vmcode_3addr_t),
-          njs_str("GREATER OR EQUAL") },
+          njs_str("GREATER OR EQUAL"), 3 },
 
     { NJS_VMCODE_STRICT_EQUAL, sizeof(njs_vmcode_3addr_t),
-          njs_str("STRICT EQUAL    ") },
+          njs_str("STRICT EQUAL    "), 3 },
     { NJS_VMCODE_STRICT_NOT_EQUAL, sizeof(njs_vmcode_3addr_t),
-          njs_str("STRICT NOT EQUAL") },
+          njs_str("STRICT NOT EQUAL"), 3 },
 
     { NJS_VMCODE_MOVE, sizeof(njs_vmcode_move_t),
-          njs_str("MOVE            ") },
+          njs_str("MOVE            "), 2 },
 
     { NJS_VMCODE_THROW, sizeof(njs_vmcode_throw_t),
-          njs_str("THROW           ") },
+          njs_str("THROW           "), 1 },
 
     { NJS_VMCODE_LET, sizeof(njs_vmcode_variable_t),
-          njs_str("LET             ") },
+          njs_str("LET             "), 1 },
 
     { NJS_VMCODE_LET_UPDATE, sizeof(njs_vmcode_variable_t),
-          njs_str("LET UPDATE      ") },
+          njs_str("LET UPDATE      "), 1 },
+
+    { NJS_VMCODE_LET_LOCAL, sizeof(njs_vmcode_variable_t),
+          njs_str("LET LOCAL       "), 1 },
 
     { NJS_VMCODE_INITIALIZATION_TEST, sizeof(njs_vmcode_variable_t),
-          njs_str("INIT TEST       ") },
+          njs_str("INIT TEST       "), 1 },
 
     { NJS_VMCODE_NOT_INITIALIZED, sizeof(njs_vmcode_variable_t),
-          njs_str("NOT INIT        ") },
+          njs_str("NOT INIT        "), 1 },
 
     { NJS_VMCODE_ASSIGNMENT_ERROR, sizeof(njs_vmcode_variable_t),
-          njs_str("ASSIGNMENT ERROR") },
+          njs_str("ASSIGNMENT ERROR"), 1 },
 
     { NJS_VMCODE_DEBUGGER, sizeof(njs_vmcode_debugger_t),
-          njs_str("DEBUGGER        ") },
+          njs_str("DEBUGGER        "), 1 },
 
     { NJS_VMCODE_AWAIT, sizeof(njs_vmcode_await_t),
-          njs_str("AWAIT           ") },
+          njs_str("AWAIT           "), 1 },
 };
 
 
 void
 njs_disassembler(njs_vm_t *vm)
 {
+    size_t         size;
     njs_uint_t     n;
     njs_vm_code_t  *code;
 
     code = vm->codes->start;
     n = vm->codes->items;
+    size = 0;
 
     while (n != 0) {
         njs_printf("%V:%V\n", &code->file, &code->name);
         njs_disassemble(code->start, code->end, -1, code->lines);
+        size += code->end - code->start;
         code++;
         n--;
     }
 
-    njs_printf("\n");
+    njs_printf("\ncode size: %uz bytes\n\n", size);
 }
 
 
@@ -212,6 +244,7 @@ njs_disassemble(u_char *start, u_char *end, njs_int_t count, njs_arr_t *lines)
     njs_vmcode_prop_next_t       *prop_next;
     njs_vmcode_try_return_t      *try_return;
     njs_vmcode_equal_jump_t      *equal;
+    njs_vmcode_atom_frame_t      *atom_frame;
     njs_vmcode_prop_foreach_t    *prop_foreach;
     njs_vmcode_method_frame_t    *method;
     njs_vmcode_prop_accessor_t   *prop_accessor;
@@ -277,17 +310,29 @@ njs_disassemble(u_char *start, u_char *end, njs_int_t count, njs_arr_t *lines)
             continue;
         }
 
-        if (operation == NJS_VMCODE_IF_EQUAL_JUMP) {
-            equal = (njs_vmcode_equal_jump_t *) p;
+        code_name = cmp_jump_names;
+        n = njs_nitems(cmp_jump_names);
+
+        do {
+            if (operation == code_name->operation) {
+                equal = (njs_vmcode_equal_jump_t *) p;
+
+                name = &code_name->name;
 
-            njs_printf("%5uD | %05uz JUMP IF EQUAL     %04Xz %04Xz %z\n",
-                       line, p - start, (size_t) equal->value1,
-                       (size_t) equal->value2, (size_t) equal->offset);
+                njs_printf("%5uD | %05uz %*s %04Xz %04Xz %z\n",
+                           line, p - start, name->length, name->start,
+                           (size_t) equal->value1, (size_t) equal->value2,
+                           (size_t) equal->offset);
 
-            p += sizeof(njs_vmcode_equal_jump_t);
+                p += code_name->size;
 
-            continue;
-        }
+                goto next;
+            }
+
+            code_name++;
+            n--;
+
+        } while (n != 0);
 
         if (operation == NJS_VMCODE_TEST_IF_TRUE) {
             test_jump = (njs_vmcode_test_jump_t *) p;
@@ -345,7 +390,8 @@ njs_disassemble(u_char *start, u_char *end, njs_int_t count, njs_arr_t *lines)
 
             njs_printf("%5uD | %05uz FUNCTION FRAME    %04Xz %uz%s\n",
                        line, p - start, (size_t) function->name,
-                       function->nargs, function->ctor ? " CTOR" : "");
+                       (size_t) function->nargs,
+                       function->ctor ? " CTOR" : "");
 
             p += sizeof(njs_vmcode_function_frame_t);
 
@@ -357,13 +403,29 @@ njs_disassemble(u_char *start, u_char *end, njs_int_t count, njs_arr_t *lines)
 
             njs_printf("%5uD | %05uz METHOD FRAME      %04Xz %04Xz %uz%s\n",
                        line, p - start, (size_t) method->function,
-                       (size_t) method->this_object, method->nargs,
+                       (size_t) method->this_object,
+                       (size_t) method->nargs,
                        method->ctor ? " CTOR" : "");
 
             p += sizeof(njs_vmcode_method_frame_t);
             continue;
         }
 
+        if (operation == NJS_VMCODE_METHOD_ATOM_FRAME) {
+            atom_frame = (njs_vmcode_atom_frame_t *) p;
+
+            njs_printf("%5uD | %05uz METHOD ATOM FRAME %04Xz %04Xz %04Xz "
+                       "%uz%s\n", line, p - start,
+                       (size_t) atom_frame->function,
+                       (size_t) atom_frame->this_object,
+                       (size_t) atom_frame->property,
+                       (size_t) atom_frame->nargs,
+                       atom_frame->ctor ? " CTOR" : "");
+
+            p += sizeof(njs_vmcode_atom_frame_t);
+            continue;
+        }
+
         if (operation == NJS_VMCODE_PROPERTY_FOREACH) {
             prop_foreach = (njs_vmcode_prop_foreach_t *) p;
 
@@ -535,22 +597,25 @@ njs_disassemble(u_char *start, u_char *end, njs_int_t count, njs_arr_t *lines)
             if (operation == code_name->operation) {
                 name = &code_name->name;
 
-                if (code_name->size == sizeof(njs_vmcode_3addr_t)) {
+                switch (code_name->operands) {
+                case 3:
                     code3 = (njs_vmcode_3addr_t *) p;
 
                     njs_printf("%5uD | %05uz %*s  %04Xz %04Xz %04Xz\n",
                                line, p - start, name->length, name->start,
                                (size_t) code3->dst, (size_t) code3->src1,
                                (size_t) code3->src2);
+                    break;
 
-                } else if (code_name->size == sizeof(njs_vmcode_2addr_t)) {
+                case 2:
                     code2 = (njs_vmcode_2addr_t *) p;
 
                     njs_printf("%5uD | %05uz %*s  %04Xz %04Xz\n",
                                line, p - start, name->length, name->start,
                                (size_t) code2->dst, (size_t) code2->src);
+                    break;
 
-                } else if (code_name->size == sizeof(njs_vmcode_1addr_t)) {
+                default:
                     code1 = (njs_vmcode_1addr_t *) p;
 
                     njs_printf("%5uD | %05uz %*s  %04Xz\n",
@@ -93,11 +93,9 @@ njs_text_encoder_encode(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
     if (nargs > 1) {
         input = njs_argument(args, 1);
 
-        if (njs_slow_path(!njs_is_string(input))) {
-            ret = njs_value_to_string(vm, input, input);
-            if (njs_slow_path(ret != NJS_OK)) {
-                return ret;
-            }
+        ret = njs_value_to_string(vm, input, input);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return ret;
         }
 
         (void) njs_string_prop(vm, &prop, input);
@@ -193,7 +191,9 @@ njs_text_encoder_encode_into(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
         return NJS_ERROR;
     }
 
-    njs_string_get(vm, input, &str);
+    if (njs_slow_path(njs_string_get_checked(vm, input, &str) != NJS_OK)) {
+        return NJS_ERROR;
+    }
 
     start = str.start;
     end = start + str.length;
@@ -357,11 +357,9 @@ njs_text_decoder_arg_encoding(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
 
     value = njs_argument(args, 1);
 
-    if (njs_slow_path(!njs_is_string(value))) {
-        ret = njs_value_to_string(vm, value, value);
-        if (njs_slow_path(ret != NJS_OK)) {
-            return ret;
-        }
+    ret = njs_value_to_string(vm, value, value);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return ret;
     }
 
     njs_string_get(vm, value, &str);
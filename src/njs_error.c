@@ -708,11 +708,9 @@ njs_error_to_string2(njs_vm_t *vm, njs_value_t *retval,
 
     name_value = &value1;
 
-    if (njs_slow_path(!njs_is_string(name_value))) {
-        ret = njs_value_to_string(vm, &value1, name_value);
-        if (njs_slow_path(ret != NJS_OK)) {
-            return ret;
-        }
+    ret = njs_value_to_string(vm, &value1, name_value);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return ret;
     }
 
     (void) njs_string_prop(vm, &name, name_value);
@@ -729,13 +727,9 @@ njs_error_to_string2(njs_vm_t *vm, njs_value_t *retval,
 
     message_value = &value2;
 
-    if (njs_slow_path(!njs_is_string(message_value))) {
-        ret = njs_value_to_string(vm, &value2, message_value);
-        if (njs_slow_path(ret != NJS_OK)) {
-            return ret;
-        }
-
-        message_value = &value2;
+    ret = njs_value_to_string(vm, &value2, message_value);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return ret;
     }
 
     (void) njs_string_prop(vm, &message, message_value);
@@ -820,8 +814,12 @@ njs_error_prototype_stack(njs_vm_t *vm, njs_object_prop_t *prop, uint32_t unused
             return ret;
         }
 
-        njs_string_get(vm, &msg_val, &msg);
-        njs_string_get(vm, stackval, &trace);
+        if (njs_slow_path(njs_string_get_checked(vm, &msg_val, &msg) != NJS_OK
+                          || njs_string_get_checked(vm, stackval, &trace)
+                             != NJS_OK))
+        {
+            return NJS_ERROR;
+        }
 
         length = msg.length + 1 + trace.length;
 
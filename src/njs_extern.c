@@ -8,6 +8,15 @@
 #include <njs_main.h>
 
 
+/*
+ * The generation 0 is given to the externals created before the first
+ * njs_vm_reset(), they are never stale.
+ */
+#define njs_external_stale(vm, value)                                         \
+    (njs_object_value(value)->data.magic16 != 0                               \
+     && njs_object_value(value)->data.magic16 != (vm)->external_generation)
+
+
 static njs_int_t njs_external_prop_handler(njs_vm_t *vm,
     njs_object_prop_t *self, uint32_t atom_id, njs_value_t *value,
     njs_value_t *setval, njs_value_t *retval);
@@ -219,6 +228,8 @@ njs_external_prop_handler(njs_vm_t *vm, njs_object_prop_t *self,
         external = njs_vm_external(vm, NJS_PROTO_ID_ANY, value);
 
         njs_set_data(&ov->value, external, njs_value_external_tag(value));
+        ov->value.data.magic16 = njs_object_value(value)->data.magic16;
+
         njs_set_object_value(retval, ov);
     }
 
@@ -405,6 +416,7 @@ njs_vm_external_create(njs_vm_t *vm, njs_value_t *value, njs_int_t proto_id,
 
     njs_set_object_value(value, ov);
     njs_set_data(&ov->value, external, njs_make_tag(proto_id));
+    ov->value.data.magic16 = vm->external_generation;
 
     return NJS_OK;
 }
@@ -416,6 +428,10 @@ njs_vm_external(njs_vm_t *vm, njs_int_t proto_id, const njs_value_t *value)
     njs_external_ptr_t  external;
 
     if (njs_fast_path(njs_is_object_data(value, njs_make_tag(proto_id)))) {
+        if (njs_slow_path(njs_external_stale(vm, value))) {
+            return NULL;
+        }
+
         external = njs_object_data(value);
         if (external == NULL) {
             external = vm->external;
@@ -156,6 +156,58 @@ njs_flathsh_destroy(njs_flathsh_t *fh, njs_flathsh_query_t *fhq)
 }
 
 
+/*
+ * Create a copy of a flat hash without deleted elements.  The copy has
+ * no spare elements, so it is allocated with a single exact-size chunk.
+ */
+njs_flathsh_descr_t *
+njs_flathsh_copy(const njs_flathsh_t *fh, njs_flathsh_query_t *fhq)
+{
+    void                 *chunk;
+    size_t               size, hash_size;
+    njs_flathsh_descr_t  *h, *src;
+
+    src = fh->slot;
+
+    njs_assert_msg(src->elts_deleted_count == 0,
+                   "flat hash with deleted elements cannot be copied");
+
+    hash_size = src->hash_mask + 1;
+    size = njs_flathsh_chunk_size(hash_size, src->elts_count);
+
+    chunk = njs_flathsh_malloc(fhq, size);
+    if (njs_slow_path(chunk == NULL)) {
+        return NULL;
+    }
+
+    memcpy(chunk, njs_flathsh_chunk(src), size);
+
+    h = njs_flathsh_descr(chunk, hash_size);
+    h->elts_size = src->elts_count;
+
+    return h;
+}
+
+
+njs_flathsh_descr_t *
+njs_flathsh_prebuilt(njs_flathsh_query_t *fhq, const uint32_t *cells,
+    size_t hash_size, size_t elts_count)
+{
+    njs_flathsh_descr_t  *h;
+
+    h = njs_flathsh_alloc(fhq, hash_size, elts_count);
+    if (njs_slow_path(h == NULL)) {
+        return NULL;
+    }
+
+    memcpy(njs_flathsh_chunk(h), cells, hash_size * sizeof(uint32_t));
+
+    h->elts_count = elts_count;
+
+    return h;
+}
+
+
 static njs_flathsh_descr_t *
 njs_flathsh_alloc(njs_flathsh_query_t *fhq, size_t hash_size, size_t elts_size)
 {
@@ -160,6 +160,14 @@ NJS_EXPORT njs_flathsh_elt_t *njs_flathsh_add_elt(njs_flathsh_t *fh,
     njs_flathsh_query_t *fhq);
 
 NJS_EXPORT njs_flathsh_descr_t *njs_flathsh_new(njs_flathsh_query_t *fhq);
+NJS_EXPORT njs_flathsh_descr_t *njs_flathsh_copy(const njs_flathsh_t *fh,
+    njs_flathsh_query_t *fhq);
+/*
+ * Create a full hash with the hash cells computed in advance.  The cells
+ * are given in the memory order, the elements are filled by the caller.
+ */
+NJS_EXPORT njs_flathsh_descr_t *njs_flathsh_prebuilt(njs_flathsh_query_t *fhq,
+    const uint32_t *cells, size_t hash_size, size_t elts_count);
 NJS_EXPORT void njs_flathsh_destroy(njs_flathsh_t *fh, njs_flathsh_query_t *fhq);
 
 
@@ -9,6 +9,7 @@
 
 
 static njs_int_t njs_function_native_call(njs_vm_t *vm, njs_value_t *retval);
+static njs_native_frame_t *njs_function_stack_chunk(njs_vm_t *vm, size_t size);
 
 
 njs_function_t *
@@ -473,6 +474,12 @@ njs_function_frame_alloc(njs_vm_t *vm, size_t size)
     size_t              spare_size, chunk_size;
     njs_native_frame_t  *frame;
 
+    /*
+     * The VM stack is not one contiguous region with a guard: it is a list
+     * of chunks, and every frame push still checks the space left in the
+     * top chunk and takes njs_function_stack_chunk() when it is exhausted.
+     */
+
     spare_size = vm->top_frame ? vm->top_frame->free_size : 0;
 
     if (njs_fast_path(size <= spare_size)) {
@@ -480,22 +487,13 @@ njs_function_frame_alloc(njs_vm_t *vm, size_t size)
         chunk_size = 0;
 
     } else {
-        spare_size = size + NJS_FRAME_SPARE_SIZE;
-        spare_size = njs_align_size(spare_size, NJS_FRAME_SPARE_SIZE);
-
-        if (spare_size > vm->spare_stack_size) {
-            njs_range_error(vm, "Maximum call stack size exceeded");
-            return NULL;
-        }
-
-        frame = njs_mp_align(vm->mem_pool, sizeof(njs_value_t), spare_size);
+        frame = njs_function_stack_chunk(vm, size);
         if (njs_slow_path(frame == NULL)) {
-            njs_memory_error(vm);
             return NULL;
         }
 
-        chunk_size = spare_size;
-        vm->spare_stack_size -= spare_size;
+        chunk_size = frame->size;
+        spare_size = chunk_size;
     }
 
     njs_memzero(frame, sizeof(njs_native_frame_t));
@@ -511,6 +509,61 @@ njs_function_frame_alloc(njs_vm_t *vm, size_t size)
 }
 
 
+/*
+ * Frames are pushed onto the free tail of the top frame's stack chunk.
+ * Chunks released by returning frames are kept by the VM and reused, so
+ * calls crossing a chunk boundary do not allocate on every call.
+ */
+
+static njs_native_frame_t *
+njs_function_stack_chunk(njs_vm_t *vm, size_t size)
+{
+    size_t              chunk_size;
+    njs_native_frame_t  *chunk, **next;
+
+    for (next = &vm->spare_stack; *next != NULL; next = &chunk->previous) {
+        chunk = *next;
+
+        if (chunk->size >= size) {
+            *next = chunk->previous;
+            return chunk;
+        }
+    }
+
+    chunk_size = size + NJS_FRAME_SPARE_SIZE;
+    chunk_size = njs_align_size(chunk_size, NJS_FRAME_SPARE_SIZE);
+
+    if (chunk_size > vm->spare_stack_size) {
+
+        /* Released chunks are too small, returning them to the budget. */
+
+        while (vm->spare_stack != NULL) {
+            chunk = vm->spare_stack;
+            vm->spare_stack = chunk->previous;
+
+            vm->spare_stack_size += chunk->size;
+            njs_mp_free(vm->mem_pool, chunk);
+        }
+
+        if (chunk_size > vm->spare_stack_size) {
+            njs_range_error(vm, "Maximum call stack size exceeded");
+            return NULL;
+        }
+    }
+
+    chunk = njs_mp_align(vm->mem_pool, sizeof(njs_value_t), chunk_size);
+    if (njs_slow_path(chunk == NULL)) {
+        njs_memory_error(vm);
+        return NULL;
+    }
+
+    chunk->size = chunk_size;
+    vm->spare_stack_size -= chunk_size;
+
+    return chunk;
+}
+
+
 njs_int_t
 njs_function_call2(njs_vm_t *vm, njs_function_t *function,
     const njs_value_t *this, const njs_value_t *args,
@@ -594,7 +647,12 @@ njs_function_lambda_call(njs_vm_t *vm, njs_value_t *retval, void *promise_cap)
 
     vm->active_frame = frame;
 
-    ret = njs_vmcode_interpreter(vm, lambda->start, retval, promise_cap, NULL);
+    if (njs_slow_path(njs_profile_pending)) {
+        njs_profile_sample(vm, lambda->start);
+    }
+
+    ret = njs_vmcode_interpreter(vm, njs_jit_enter(vm, lambda), retval,
+                                 promise_cap, NULL);
 
     /* Restore current level. */
     vm->levels[NJS_LEVEL_LOCAL] = cur_local;
@@ -608,6 +666,8 @@ njs_int_t
 njs_function_native_call(njs_vm_t *vm, njs_value_t *retval)
 {
     njs_int_t              ret;
+    njs_uint_t             i;
+    njs_value_t            *args;
     njs_function_t         *function;
     njs_native_frame_t     *native;
     njs_function_native_t  call;
@@ -615,6 +675,21 @@ njs_function_native_call(njs_vm_t *vm, njs_value_t *retval)
     native = vm->top_frame;
     function = native->function;
 
+    /*
+     * The native functions read the content of the string arguments
+     * directly, so the ropes among them are flattened here.
+     */
+
+    args = &native->arguments[-1];
+
+    for (i = 0; i < 1 /* this */ + native->nargs; i++) {
+        if (njs_slow_path(njs_is_rope(&args[i]))
+            && njs_string_flatten(vm, &args[i]) != NJS_OK)
+        {
+            return NJS_ERROR;
+        }
+    }
+
 #ifdef NJS_DEBUG_OPCODE
     njs_str_t              name;
     njs_value_t            fname, fobj;
@@ -635,8 +710,8 @@ njs_function_native_call(njs_vm_t *vm, njs_value_t *retval)
 
     call = function->u.native;
 
-    ret = call(vm, &native->arguments[-1], 1 /* this */ + native->nargs,
-               function->magic8, retval);
+    ret = call(vm, args, 1 /* this */ + native->nargs, function->magic8,
+               retval);
 
 #ifdef NJS_DEBUG_OPCODE
     if (vm->options.opcode_debug) {
@@ -662,6 +737,10 @@ njs_function_frame_invoke(njs_vm_t *vm, njs_value_t *retval)
 {
     njs_native_frame_t  *frame;
 
+    if (njs_slow_path(vm->gc != NULL)) {
+        njs_gc_abandon(vm);
+    }
+
     frame = vm->top_frame;
 
     if (njs_function_object_type(vm, frame->function)
@@ -683,8 +762,8 @@ void
 njs_function_frame_free(njs_vm_t *vm, njs_native_frame_t *native)
 {
     if (native->size != 0) {
-        vm->spare_stack_size += native->size;
-        njs_mp_free(vm->mem_pool, native);
+        native->previous = vm->spare_stack;
+        vm->spare_stack = native;
     }
 }
 
@@ -23,6 +23,16 @@ struct njs_function_lambda_s {
     njs_value_t                    name;
 
     u_char                         *start;
+
+#if (NJS_HAVE_JIT)
+    /*
+     * The lambda belongs to the VM which compiled the function, its clones
+     * share it, so the calls are counted and the native code is used
+     * by all of them.
+     */
+    uint32_t                       calls;
+    njs_jit_code_t                 *jit;
+#endif
 };
 
 
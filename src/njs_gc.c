@@ -0,0 +1,333 @@
+
+/*
+ * Copyright (C) NGINX, Inc.
+ */
+
+
+#include <njs_main.h>
+
+
+/*
+ * A mark and sweep garbage collector of the VM memory pool.
+ *
+ * The collector is conservative: every word of a reachable allocation
+ * which points inside of another allocation of the pool keeps the
+ * allocation alive.  The words are read at pointer size steps, so
+ * the pointers must be naturally aligned, as they are in njs_value_t and
+ * in njs_opaque_value_t.  The roots are the VM structure, the pool cleanup
+ * records and the memory ranges given by the host, which must cover all
+ * the VM values and the pointers to the VM memory the host keeps.
+ *
+ * Only the memory of the pool is scanned, so everything which refers to
+ * the VM memory must be allocated from the pool.  The tables the VM owns
+ * (see njs_gc_vm_roots()) are marked explicitly and are checked to be
+ * in the pool in the debug builds.  The memory of the VM a clone was
+ * created from is not scanned, it never refers to the clone memory.
+ *
+ * The marking is incremental: njs_vm_gc_step() scans a limited amount
+ * of memory and the collection continues with the next call.  The steps
+ * run only at safe points between calls into the VM, when no JS frame is
+ * active and the C stack holds no VM values.  The roots are scanned again
+ * at every step, so the host may change them between the steps.  Any
+ * other change of the VM memory may hide a live allocation behind
+ * the already scanned ones, so running the VM abandons the collection
+ * in progress, and the next collection is not split into steps to make
+ * sure it finishes.
+ */
+
+
+/* The pool size below which the collection is not pending. */
+#define NJS_GC_THRESHOLD  (1024 * 1024)
+
+#define NJS_GC_ALIGNMENT  sizeof(void *)
+
+
+struct njs_gc_s {
+    njs_mp_t    *mp;
+    njs_str_t   *stack;
+    njs_uint_t  items;
+    njs_uint_t  size;
+};
+
+
+static njs_int_t njs_gc_vm_roots(njs_gc_t *gc, njs_vm_t *vm);
+static njs_int_t njs_gc_root(njs_gc_t *gc, void *start, size_t size);
+static njs_int_t njs_gc_scan(njs_gc_t *gc, u_char *start, size_t size);
+static njs_int_t njs_gc_push(njs_gc_t *gc, u_char *start, size_t size);
+static void njs_gc_free(njs_vm_t *vm);
+
+
+njs_bool_t
+njs_vm_gc_pending(njs_vm_t *vm)
+{
+    return vm->gc != NULL
+           || (!njs_mp_is_arena(vm->mem_pool)
+               && njs_mp_size(vm->mem_pool)
+                  >= njs_max(vm->gc_threshold, NJS_GC_THRESHOLD));
+}
+
+
+njs_int_t
+njs_vm_gc(njs_vm_t *vm, njs_str_t *roots, njs_uint_t nroots)
+{
+    return njs_vm_gc_step(vm, roots, nroots, 0);
+}
+
+
+njs_int_t
+njs_vm_gc_step(njs_vm_t *vm, njs_str_t *roots, njs_uint_t nroots,
+    size_t size)
+{
+    size_t              scanned;
+    njs_gc_t            *gc;
+    njs_int_t           ret;
+    njs_str_t           range;
+    njs_uint_t          i;
+    njs_native_frame_t  *chunk;
+
+    if (njs_mp_is_arena(vm->mem_pool)
+        || (vm->top_frame != NULL && vm->top_frame->previous != NULL))
+    {
+        return NJS_DECLINED;
+    }
+
+    gc = vm->gc;
+
+    if (gc == NULL) {
+        /* Released stack chunks hold stale values of returned frames. */
+
+        while (vm->spare_stack != NULL) {
+            chunk = vm->spare_stack;
+            vm->spare_stack = chunk->previous;
+
+            vm->spare_stack_size += chunk->size;
+            njs_mp_free(vm->mem_pool, chunk);
+        }
+
+        gc = njs_zalloc(sizeof(njs_gc_t));
+        if (njs_slow_path(gc == NULL)) {
+            return NJS_ERROR;
+        }
+
+        gc->mp = vm->mem_pool;
+
+        vm->gc = gc;
+    }
+
+    if (vm->gc_abandoned) {
+        size = 0;
+    }
+
+    ret = njs_gc_vm_roots(gc, vm);
+    if (njs_slow_path(ret != NJS_OK)) {
+        goto fail;
+    }
+
+    for (i = 0; i < nroots; i++) {
+        ret = njs_gc_root(gc, roots[i].start, roots[i].length);
+        if (njs_slow_path(ret != NJS_OK)) {
+            goto fail;
+        }
+    }
+
+    scanned = 0;
+
+    while (gc->items != 0) {
+        if (size != 0 && scanned >= size) {
+            return NJS_AGAIN;
+        }
+
+        range = gc->stack[--gc->items];
+
+        ret = njs_gc_scan(gc, range.start, range.length);
+        if (njs_slow_path(ret != NJS_OK)) {
+            goto fail;
+        }
+
+        scanned += range.length;
+    }
+
+    njs_mp_sweep(gc->mp);
+
+    vm->gc_threshold = 2 * njs_mp_size(gc->mp);
+    vm->gc_abandoned = 0;
+
+    njs_gc_free(vm);
+
+    return NJS_OK;
+
+fail:
+
+    njs_mp_unmark(gc->mp);
+
+    njs_gc_free(vm);
+
+    return NJS_ERROR;
+}
+
+
+void
+njs_gc_abandon(njs_vm_t *vm)
+{
+    njs_mp_unmark(vm->gc->mp);
+
+    njs_gc_free(vm);
+
+    vm->gc_abandoned = 1;
+}
+
+
+static njs_int_t
+njs_gc_vm_roots(njs_gc_t *gc, njs_vm_t *vm)
+{
+    njs_int_t         ret;
+    njs_uint_t        i;
+    njs_mp_cleanup_t  *c;
+
+    /*
+     * The tables a VM owns, a clone included: the atoms created by it,
+     * the flat copies of the shared ropes, the global scope, the copies
+     * of the constructors and prototypes, the inline caches and the regex
+     * contexts.  The compiled code and the templates of the object literals
+     * in it belong to the VM which compiled it and are referred to from
+     * its "codes" array.
+     */
+
+    void  *tables[] = {
+        vm->atom_hash_current->slot,
+        vm->flat_ropes.slot,
+        vm->levels[NJS_LEVEL_GLOBAL],
+        vm->constructors,
+        vm->prop_caches,
+        vm->regex_generic_ctx,
+        vm->regex_compile_ctx,
+        vm->single_match_data,
+    };
+
+    ret = njs_gc_root(gc, vm, sizeof(njs_vm_t));
+    if (njs_slow_path(ret != NJS_OK)) {
+        return NJS_ERROR;
+    }
+
+    for (c = njs_mp_cleanups(gc->mp); c != NULL; c = c->next) {
+        ret = njs_gc_root(gc, c, sizeof(njs_mp_cleanup_t));
+        if (njs_slow_path(ret != NJS_OK)) {
+            return NJS_ERROR;
+        }
+    }
+
+    for (i = 0; i < njs_nitems(tables); i++) {
+        if (tables[i] == NULL) {
+            continue;
+        }
+
+        njs_assert_msg(njs_mp_contains(gc->mp, tables[i]),
+                       "gc: VM table %ui is outside of the pool", i);
+
+        ret = njs_gc_root(gc, tables[i], 0);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return NJS_ERROR;
+        }
+    }
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_gc_root(njs_gc_t *gc, void *start, size_t size)
+{
+    u_char  *p;
+    size_t  n;
+
+    /* A root inside of the pool keeps the whole allocation. */
+
+    p = njs_mp_mark(gc->mp, start, &n);
+
+    if (p != NULL && njs_gc_push(gc, p, n) != NJS_OK) {
+        return NJS_ERROR;
+    }
+
+    if (size == 0) {
+        return NJS_OK;
+    }
+
+    return njs_gc_push(gc, start, size);
+}
+
+
+static njs_int_t
+njs_gc_scan(njs_gc_t *gc, u_char *start, size_t size)
+{
+    u_char  *p, *end, *value;
+    size_t  n;
+
+    end = start + size;
+
+    for (p = njs_align_ptr(start, NJS_GC_ALIGNMENT);
+         p + sizeof(void *) <= end;
+         p += NJS_GC_ALIGNMENT)
+    {
+        memcpy(&value, p, sizeof(void *));
+
+        if (value == NULL) {
+            continue;
+        }
+
+        value = njs_mp_mark(gc->mp, value, &n);
+
+        if (value != NULL && njs_gc_push(gc, value, n) != NJS_OK) {
+            return NJS_ERROR;
+        }
+    }
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_gc_push(njs_gc_t *gc, u_char *start, size_t size)
+{
+    njs_str_t   *stack;
+    njs_uint_t  n;
+
+    if (gc->items == gc->size) {
+        n = (gc->size != 0) ? gc->size * 2 : 256;
+
+        stack = njs_malloc(n * sizeof(njs_str_t));
+        if (njs_slow_path(stack == NULL)) {
+            return NJS_ERROR;
+        }
+
+        if (gc->stack != NULL) {
+            memcpy(stack, gc->stack, gc->items * sizeof(njs_str_t));
+            njs_free(gc->stack);
+        }
+
+        gc->stack = stack;
+        gc->size = n;
+    }
+
+    gc->stack[gc->items].start = start;
+    gc->stack[gc->items].length = size;
+    gc->items++;
+
+    return NJS_OK;
+}
+
+
+static void
+njs_gc_free(njs_vm_t *vm)
+{
+    njs_gc_t  *gc;
+
+    gc = vm->gc;
+
+    if (gc->stack != NULL) {
+        njs_free(gc->stack);
+    }
+
+    njs_free(gc);
+
+    vm->gc = NULL;
+}
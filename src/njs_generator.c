@@ -33,7 +33,8 @@ typedef enum {
 struct njs_generator_patch_s {
     /*
      * The jump_offset field points to jump offset field which contains a small
-     * adjustment and the adjustment should be added as (njs_jump_off_t *)
+     * adjustment and the adjustment should be added as
+     * (njs_vmcode_offset_t *)
      * because pointer to u_char accesses only one byte so this does not
      * work on big endian platforms.
      */
@@ -225,6 +226,11 @@ static njs_int_t njs_generate_var_statement_after(njs_vm_t *vm,
     njs_generator_t *generator, njs_parser_node_t *node);
 static njs_int_t njs_generate_let(njs_vm_t *vm, njs_generator_t *generator,
     njs_parser_node_t *node, njs_variable_t *var);
+static njs_int_t njs_generate_cond_jump(njs_vm_t *vm,
+    njs_generator_t *generator, njs_vmcode_t opcode, njs_parser_node_t *cond,
+    njs_parser_node_t *node, njs_vmcode_jump_t **jump);
+static njs_vmcode_t njs_generate_cond_jump_opcode(njs_vmcode_t opcode,
+    njs_parser_node_t *cond);
 static njs_int_t njs_generate_if_statement(njs_vm_t *vm,
     njs_generator_t *generator, njs_parser_node_t *node);
 static njs_int_t njs_generate_if_statement_cond(njs_vm_t *vm,
@@ -279,8 +285,6 @@ static njs_int_t njs_generate_for_end(njs_vm_t *vm, njs_generator_t *generator,
     njs_parser_node_t *node);
 static njs_int_t njs_generate_for_let_update(njs_vm_t *vm,
     njs_generator_t *generator, njs_parser_node_t *node);
-static njs_int_t njs_generate_for_resolve_closure(njs_vm_t *vm,
-    njs_parser_node_t *node);
 static njs_int_t njs_generate_for_in_statement(njs_vm_t *vm,
     njs_generator_t *generator, njs_parser_node_t *node);
 static njs_int_t njs_generate_for_in_set_prop_block(njs_vm_t *vm,
@@ -358,6 +362,7 @@ static njs_index_t njs_generate_property_index(njs_vm_t *vm,
     njs_parser_node_t *object, njs_parser_node_t *property);
 static njs_vmcode_t njs_generate_property_get_opcode(njs_parser_node_t *node);
 static njs_vmcode_t njs_generate_property_set_opcode(njs_parser_node_t *node);
+static uint32_t njs_generate_prop_cache(njs_vm_t *vm, njs_vmcode_t opcode);
 static njs_int_t njs_generate_property_get(njs_vm_t *vm,
     njs_generator_t *generator, njs_parser_node_t *node, njs_index_t value,
     njs_index_t object, njs_index_t property);
@@ -388,6 +393,8 @@ static njs_int_t njs_generate_logical_assignment_end(njs_vm_t *vm,
     njs_generator_t *generator, njs_parser_node_t *node);
 static njs_int_t njs_generate_object(njs_vm_t *vm, njs_generator_t *generator,
     njs_parser_node_t *node);
+static njs_int_t njs_generate_object_template(njs_vm_t *vm,
+    njs_parser_node_t *node, njs_flathsh_t *props);
 static njs_int_t njs_generate_property_accessor(njs_vm_t *vm,
     njs_generator_t *generator, njs_parser_node_t *node);
 static njs_int_t njs_generate_property_accessor_end(njs_vm_t *vm,
@@ -470,6 +477,8 @@ static njs_int_t njs_generate_call_argument_expressions(njs_vm_t *vm,
     njs_generator_t *generator, njs_parser_node_t *node);
 static njs_int_t njs_generate_call_argument_expressions_after(njs_vm_t *vm,
     njs_generator_t *generator, njs_parser_node_t *node);
+static njs_int_t njs_generate_call_arguments_release(njs_vm_t *vm,
+    njs_generator_t *generator, njs_parser_node_t *arg);
 static njs_bool_t njs_generate_argument_aliases_mutable_slot(
     njs_parser_node_t *node);
 static njs_bool_t njs_generate_argument_index_is_mutable(njs_index_t index);
@@ -552,6 +561,7 @@ static njs_int_t njs_generate_index_release(njs_vm_t *vm,
                                                                               \
         generator->code_end += sizeof(type);                                  \
                                                                               \
+        njs_memzero(_code, sizeof(type));                                     \
         _code->code = _op;                                                    \
     } while (0)
 
@@ -573,6 +583,15 @@ static njs_int_t njs_generate_index_release(njs_vm_t *vm,
     } while (0)
 
 
+/*
+ * The last generated instruction supposing it has the given type,
+ * the caller must check the opcode and the operands.
+ */
+#define njs_generate_last_code(generator, type)                               \
+    (((size_t) (generator->code_end - generator->code_start) >= sizeof(type)) \
+     ? (type *) (generator->code_end - sizeof(type)) : NULL)
+
+
 #define njs_code_offset(generator, code)                                      \
     ((u_char *) code - generator->code_start)
 
@@ -582,7 +601,7 @@ static njs_int_t njs_generate_index_release(njs_vm_t *vm,
 
 
 #define njs_code_jump_ptr(generator, offset)                                  \
-    (njs_jump_off_t *) (generator->code_start + offset)
+    (njs_vmcode_offset_t *) (generator->code_start + offset)
 
 
 #define njs_code_offset_diff(generator, offset)                               \
@@ -959,6 +978,11 @@ njs_generate_reserve(njs_vm_t *vm, njs_generator_t *generator, size_t size)
     size = njs_max(generator->code_end - generator->code_start + size,
                    generator->code_size);
 
+    if (njs_slow_path(size > NJS_VMCODE_MAX_SIZE / 2)) {
+        njs_range_error(vm, "code size limit exceeded");
+        return NULL;
+    }
+
     if (size < 1024) {
         size *= 2;
 
@@ -1269,14 +1293,112 @@ njs_generate_let(njs_vm_t *vm, njs_generator_t *generator,
 {
     njs_vmcode_variable_t  *code;
 
+    /*
+     * A new binding is allocated only for a variable captured by closures,
+     * otherwise it is not observable and the frame slot is reused.
+     */
+
     njs_generate_code(generator, njs_vmcode_variable_t, code,
-                      NJS_VMCODE_LET, node);
+                      var->closure ? NJS_VMCODE_LET : NJS_VMCODE_LET_LOCAL,
+                      node);
     code->dst = var->index;
 
     return NJS_OK;
 }
 
 
+/*
+ * A conditional jump on the result of a comparison is fused with the
+ * comparison into a single compare-and-jump instruction if the
+ * comparison is the last generated instruction and its result is a
+ * temporary value.  Both encodings start with the opcode and the jump
+ * offset, so the jump is returned as njs_vmcode_jump_t.
+ */
+
+static njs_int_t
+njs_generate_cond_jump(njs_vm_t *vm, njs_generator_t *generator,
+    njs_vmcode_t opcode, njs_parser_node_t *cond, njs_parser_node_t *node,
+    njs_vmcode_jump_t **jump)
+{
+    njs_index_t              src1, src2;
+    njs_vmcode_t             fused;
+    njs_vmcode_3addr_t       *code;
+    njs_vmcode_cond_jump_t   *cond_jump;
+    njs_vmcode_equal_jump_t  *cmp_jump;
+
+    fused = njs_generate_cond_jump_opcode(opcode, cond);
+
+    if (fused != opcode && cond->temporary) {
+        code = njs_generate_last_code(generator, njs_vmcode_3addr_t);
+
+        if (code != NULL
+            && code->code == cond->u.operation
+            && code->dst == cond->index)
+        {
+            src1 = code->src1;
+            src2 = code->src2;
+
+            generator->code_end = (u_char *) code;
+
+            njs_generate_code(generator, njs_vmcode_equal_jump_t, cmp_jump,
+                              fused, cond);
+            cmp_jump->value1 = src1;
+            cmp_jump->value2 = src2;
+
+            *jump = (njs_vmcode_jump_t *) cmp_jump;
+
+            return NJS_OK;
+        }
+    }
+
+    njs_generate_code(generator, njs_vmcode_cond_jump_t, cond_jump,
+                      opcode, node);
+    cond_jump->cond = cond->index;
+
+    *jump = (njs_vmcode_jump_t *) cond_jump;
+
+    return NJS_OK;
+}
+
+
+static njs_vmcode_t
+njs_generate_cond_jump_opcode(njs_vmcode_t opcode, njs_parser_node_t *cond)
+{
+    njs_bool_t  jump_if_true;
+
+    jump_if_true = (opcode == NJS_VMCODE_IF_TRUE_JUMP);
+
+    switch (cond->token_type) {
+    case NJS_TOKEN_STRICT_EQUAL:
+        return jump_if_true ? NJS_VMCODE_IF_EQUAL_JUMP
+                            : NJS_VMCODE_IF_NOT_EQUAL_JUMP;
+
+    case NJS_TOKEN_STRICT_NOT_EQUAL:
+        return jump_if_true ? NJS_VMCODE_IF_NOT_EQUAL_JUMP
+                            : NJS_VMCODE_IF_EQUAL_JUMP;
+
+    case NJS_TOKEN_LESS:
+        return jump_if_true ? NJS_VMCODE_IF_LESS_JUMP
+                            : NJS_VMCODE_IF_NOT_LESS_JUMP;
+
+    case NJS_TOKEN_GREATER:
+        return jump_if_true ? NJS_VMCODE_IF_GREATER_JUMP
+                            : NJS_VMCODE_IF_NOT_GREATER_JUMP;
+
+    case NJS_TOKEN_LESS_OR_EQUAL:
+        return jump_if_true ? NJS_VMCODE_IF_LESS_OR_EQUAL_JUMP
+                            : NJS_VMCODE_IF_NOT_LESS_OR_EQUAL_JUMP;
+
+    case NJS_TOKEN_GREATER_OR_EQUAL:
+        return jump_if_true ? NJS_VMCODE_IF_GREATER_OR_EQUAL_JUMP
+                            : NJS_VMCODE_IF_NOT_GREATER_OR_EQUAL_JUMP;
+
+    default:
+        return opcode;
+    }
+}
+
+
 static njs_int_t
 njs_generate_if_statement(njs_vm_t *vm, njs_generator_t *generator,
     njs_parser_node_t *node)
@@ -1303,13 +1425,15 @@ static njs_int_t
 njs_generate_if_statement_cond(njs_vm_t *vm, njs_generator_t *generator,
     njs_parser_node_t *node)
 {
-    njs_int_t               ret;
-    njs_jump_off_t          jump_offset;
-    njs_vmcode_cond_jump_t  *cond_jump;
+    njs_int_t          ret;
+    njs_jump_off_t     jump_offset;
+    njs_vmcode_jump_t  *cond_jump;
 
-    njs_generate_code(generator, njs_vmcode_cond_jump_t, cond_jump,
-                      NJS_VMCODE_IF_FALSE_JUMP, node);
-    cond_jump->cond = node->left->index;
+    ret = njs_generate_cond_jump(vm, generator, NJS_VMCODE_IF_FALSE_JUMP,
+                                 node->left, node, &cond_jump);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return ret;
+    }
 
     ret = njs_generate_node_index_release(vm, generator, node->left);
     if (njs_slow_path(ret != NJS_OK)) {
@@ -1415,14 +1539,17 @@ static njs_int_t
 njs_generate_cond_expression_handler(njs_vm_t *vm, njs_generator_t *generator,
     njs_parser_node_t *node)
 {
-    njs_jump_off_t          jump_offset;
-    njs_vmcode_cond_jump_t  *cond_jump;
+    njs_int_t          ret;
+    njs_jump_off_t     jump_offset;
+    njs_vmcode_jump_t  *cond_jump;
 
-    njs_generate_code(generator, njs_vmcode_cond_jump_t, cond_jump,
-                      NJS_VMCODE_IF_FALSE_JUMP, node);
+    ret = njs_generate_cond_jump(vm, generator, NJS_VMCODE_IF_FALSE_JUMP,
+                                 node->left, node, &cond_jump);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return ret;
+    }
 
     jump_offset = njs_code_offset(generator, cond_jump);
-    cond_jump->cond = node->left->index;
 
     node->index = njs_generate_dest_index(vm, generator, node);
     if (njs_slow_path(node->index == NJS_INDEX_ERROR)) {
@@ -1809,16 +1936,19 @@ njs_generate_while_end(njs_vm_t *vm, njs_generator_t *generator,
     njs_parser_node_t *node)
 {
     njs_int_t                 ret;
-    njs_vmcode_cond_jump_t    *cond_jump;
+    njs_vmcode_jump_t         *cond_jump;
     njs_generator_loop_ctx_t  *ctx;
 
     ctx = generator->context;
 
-    njs_generate_code(generator, njs_vmcode_cond_jump_t, cond_jump,
-                      NJS_VMCODE_IF_TRUE_JUMP, node->right);
+    ret = njs_generate_cond_jump(vm, generator, NJS_VMCODE_IF_TRUE_JUMP,
+                                 node->right, node->right, &cond_jump);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return ret;
+    }
+
     cond_jump->offset = ctx->loop_offset - njs_code_offset(generator,
                                                            cond_jump);
-    cond_jump->cond = node->right->index;
 
     njs_generate_patch_block_exit(vm, generator);
 
@@ -1876,16 +2006,19 @@ njs_generate_do_while_end(njs_vm_t *vm, njs_generator_t *generator,
     njs_parser_node_t *node)
 {
     njs_int_t                 ret;
-    njs_vmcode_cond_jump_t    *cond_jump;
+    njs_vmcode_jump_t         *cond_jump;
     njs_generator_loop_ctx_t  *ctx;
 
     ctx = generator->context;
 
-    njs_generate_code(generator, njs_vmcode_cond_jump_t, cond_jump,
-                      NJS_VMCODE_IF_TRUE_JUMP, node->right);
+    ret = njs_generate_cond_jump(vm, generator, NJS_VMCODE_IF_TRUE_JUMP,
+                                 node->right, node->right, &cond_jump);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return ret;
+    }
+
     cond_jump->offset = ctx->loop_offset
                         - njs_code_offset(generator, cond_jump);
-    cond_jump->cond = node->right->index;
 
     njs_generate_patch_block_exit(vm, generator);
 
@@ -1939,16 +2072,6 @@ njs_generate_for_init(njs_vm_t *vm, njs_generator_t *generator,
 
     condition = node->right->left;
 
-    /*
-     * Closures can occur in conditional and loop updates.  This must be
-     * foreseen in order to generate optimized code for let updates.
-     */
-
-    ret = njs_generate_for_resolve_closure(vm, condition);
-    if (njs_slow_path(ret != NJS_OK)) {
-        return ret;
-    }
-
     ctx->jump_offset = 0;
 
     if (condition != NULL) {
@@ -1988,11 +2111,6 @@ njs_generate_for_body(njs_vm_t *vm, njs_generator_t *generator,
     init = node->left;
     update = node->right->right->right;
 
-    ret = njs_generate_for_resolve_closure(vm, update);
-    if (njs_slow_path(ret != NJS_OK)) {
-        return ret;
-    }
-
     ret = njs_generate_for_let_update(vm, generator, init);
     if (njs_slow_path(ret != NJS_OK)) {
         return ret;
@@ -2050,7 +2168,7 @@ njs_generate_for_end(njs_vm_t *vm, njs_generator_t *generator,
 {
     njs_int_t                 ret;
     njs_parser_node_t         *condition;
-    njs_vmcode_cond_jump_t    *cond_jump;
+    njs_vmcode_jump_t         *cond_jump;
     njs_generator_loop_ctx_t  *ctx;
 
     ctx = generator->context;
@@ -2058,11 +2176,14 @@ njs_generate_for_end(njs_vm_t *vm, njs_generator_t *generator,
     condition = node->right->left;
 
     if (condition != NULL) {
-        njs_generate_code(generator, njs_vmcode_cond_jump_t, cond_jump,
-                          NJS_VMCODE_IF_TRUE_JUMP, condition);
+        ret = njs_generate_cond_jump(vm, generator, NJS_VMCODE_IF_TRUE_JUMP,
+                                     condition, condition, &cond_jump);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return ret;
+        }
+
         cond_jump->offset = ctx->loop_offset
                             - njs_code_offset(generator, cond_jump);
-        cond_jump->cond = condition->index;
 
         njs_generate_patch_block_exit(vm, generator);
 
@@ -2116,37 +2237,6 @@ njs_generate_for_let_update(njs_vm_t *vm, njs_generator_t *generator,
 }
 
 
-static njs_int_t
-njs_generate_for_resolve_closure_cb(njs_vm_t *vm, njs_parser_node_t *node,
-    void *unused)
-{
-    njs_bool_t      closure;
-    njs_variable_t  *var;
-
-    if (node->token_type == NJS_TOKEN_NAME) {
-        var = njs_variable_resolve(vm, node);
-
-        if (njs_fast_path(var != NULL)) {
-            closure = njs_variable_closure_test(node->scope, var->scope);
-
-            if (closure) {
-                var->closure = 1;
-            }
-        }
-    }
-
-    return NJS_OK;
-}
-
-
-static njs_int_t
-njs_generate_for_resolve_closure(njs_vm_t *vm, njs_parser_node_t *node)
-{
-    return njs_parser_traverse(vm, node, NULL,
-                               njs_generate_for_resolve_closure_cb);
-}
-
-
 static njs_int_t
 njs_generate_for_in_name_assign(njs_vm_t *vm, njs_generator_t *generator,
     njs_parser_node_t *node)
@@ -2473,6 +2563,7 @@ njs_generate_for_in_set_prop_block(njs_vm_t *vm, njs_generator_t *generator,
 
     njs_generate_code(generator, njs_vmcode_prop_set_t, prop_set,
                       opcode, foreach);
+    prop_set->cache = njs_generate_prop_cache(vm, opcode);
     prop_set->object = foreach->left->left->index;
     prop_set->property = prop->index;
     prop_set->value = ctx->index_next_value;
@@ -3193,6 +3284,7 @@ njs_generate_global_property_set(njs_vm_t *vm, njs_generator_t *generator,
         njs_generate_code(generator, njs_vmcode_prop_set_t, prop_set,
                           NJS_VMCODE_PROPERTY_ATOM_SET, node_src);
 
+        prop_set->cache = njs_generate_prop_cache(vm, prop_set->code);
         prop_set->value = node_dst->index;
         prop_set->object = njs_scope_global_this_index();
 
@@ -3382,6 +3474,23 @@ njs_generate_property_set_opcode(njs_parser_node_t *node)
 }
 
 
+/* Instructions with an inline cache get a slot of the VM cache table. */
+
+static uint32_t
+njs_generate_prop_cache(njs_vm_t *vm, njs_vmcode_t opcode)
+{
+    switch (opcode) {
+    case NJS_VMCODE_PROPERTY_ATOM_GET:
+    case NJS_VMCODE_PROPERTY_ATOM_SET:
+    case NJS_VMCODE_METHOD_ATOM_FRAME:
+        return ++vm->prop_cache_slots;
+
+    default:
+        return 0;
+    }
+}
+
+
 static njs_int_t
 njs_generate_property_get(njs_vm_t *vm, njs_generator_t *generator,
     njs_parser_node_t *node, njs_index_t value, njs_index_t object,
@@ -3392,6 +3501,7 @@ njs_generate_property_get(njs_vm_t *vm, njs_generator_t *generator,
     njs_generate_code(generator, njs_vmcode_prop_get_t, prop_get,
                       njs_generate_property_get_opcode(node), node);
 
+    prop_get->cache = njs_generate_prop_cache(vm, prop_get->code);
     prop_get->value = value;
     prop_get->object = object;
     prop_get->property = property;
@@ -3410,6 +3520,7 @@ njs_generate_property_set(njs_vm_t *vm, njs_generator_t *generator,
     njs_generate_code(generator, njs_vmcode_prop_set_t, prop_set,
                       njs_generate_property_set_opcode(node), node);
 
+    prop_set->cache = njs_generate_prop_cache(vm, prop_set->code);
     prop_set->value = value;
     prop_set->object = object;
     prop_set->property = property;
@@ -3525,12 +3636,13 @@ static njs_int_t
 njs_generate_assignment_end(njs_vm_t *vm, njs_generator_t *generator,
     njs_parser_node_t *node)
 {
-    njs_int_t              ret;
-    njs_index_t            prop_index;
-    njs_vmcode_t           opcode;
-    njs_parser_node_t      *lvalue, *expr, *object, *property;
-    njs_vmcode_2addr_t     *set_function, *to_prop_key;
-    njs_vmcode_prop_set_t  *prop_set;
+    njs_int_t               ret;
+    njs_index_t             prop_index;
+    njs_vmcode_t            opcode;
+    njs_parser_node_t       *lvalue, *expr, *object, *property;
+    njs_vmcode_2addr_t      *set_function, *to_prop_key;
+    njs_vmcode_prop_set_t   *prop_set;
+    njs_vmcode_prop_init_t  *prop_init;
 
     lvalue = node->left;
     expr = node->right;
@@ -3573,13 +3685,18 @@ njs_generate_assignment_end(njs_vm_t *vm, njs_generator_t *generator,
             }
         }
 
-        njs_generate_code(generator, njs_vmcode_prop_set_t, prop_set,
-                          NJS_VMCODE_PROPERTY_INIT, expr);
-        break;
+        /* Fall through. */
 
     case NJS_TOKEN_PROTO_INIT:
-        njs_generate_code(generator, njs_vmcode_prop_set_t, prop_set,
-                          NJS_VMCODE_PROTO_INIT, expr);
+        opcode = (lvalue->token_type == NJS_TOKEN_PROPERTY_INIT)
+                 ? NJS_VMCODE_PROPERTY_INIT : NJS_VMCODE_PROTO_INIT;
+
+        njs_generate_code(generator, njs_vmcode_prop_init_t, prop_init, opcode,
+                          expr);
+
+        prop_init->value = expr->index;
+        prop_init->object = object->index;
+        prop_init->property = prop_index;
         break;
 
     default:
@@ -3587,11 +3704,12 @@ njs_generate_assignment_end(njs_vm_t *vm, njs_generator_t *generator,
 
         njs_generate_code(generator, njs_vmcode_prop_set_t, prop_set, opcode,
                           expr);
-    }
 
-    prop_set->value = expr->index;
-    prop_set->object = object->index;
-    prop_set->property = prop_index;
+        prop_set->cache = njs_generate_prop_cache(vm, opcode);
+        prop_set->value = expr->index;
+        prop_set->object = object->index;
+        prop_set->property = prop_index;
+    }
 
     if (prop_index != property->index) {
         ret = njs_generate_index_release(vm, generator, prop_index);
@@ -3944,6 +4062,7 @@ static njs_int_t
 njs_generate_object(njs_vm_t *vm, njs_generator_t *generator,
     njs_parser_node_t *node)
 {
+    njs_int_t            ret;
     njs_vmcode_object_t  *object;
 
     node->index = njs_generate_object_dest_index(vm, generator, node);
@@ -3955,6 +4074,11 @@ njs_generate_object(njs_vm_t *vm, njs_generator_t *generator,
                       NJS_VMCODE_OBJECT, node);
     object->retval = node->index;
 
+    ret = njs_generate_object_template(vm, node, &object->props);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return ret;
+    }
+
     /* Initialize object. */
 
     njs_generator_next(generator, njs_generate, node->left);
@@ -3965,6 +4089,113 @@ njs_generate_object(njs_vm_t *vm, njs_generator_t *generator,
 }
 
 
+/*
+ * The template of an object literal is a property hash with the literal's
+ * leading data properties which have constant keys.  Each evaluation of
+ * the literal starts with a copy of the template, so the following
+ * NJS_VMCODE_PROPERTY_INIT instructions find these properties and only
+ * replace their values instead of inserting them.
+ */
+
+static njs_int_t
+njs_generate_object_template(njs_vm_t *vm, njs_parser_node_t *node,
+    njs_flathsh_t *props)
+{
+    uint32_t             *atom_id;
+    njs_int_t            ret;
+    njs_arr_t            *keys;
+    njs_uint_t           n;
+    njs_object_prop_t    *prop;
+    njs_parser_node_t    *stmt, *assign, *key;
+    njs_flathsh_query_t  fhq;
+
+    keys = NULL;
+
+    /* Object literal statements are linked in reverse order. */
+
+    for (stmt = node->left; stmt != NULL; stmt = stmt->left) {
+        assign = stmt->right;
+
+        if (assign == NULL
+            || assign->token_type != NJS_TOKEN_ASSIGNMENT
+            || assign->left->token_type != NJS_TOKEN_PROPERTY_INIT)
+        {
+            goto reset;
+        }
+
+        key = assign->left->right;
+
+        if (key->token_type != NJS_TOKEN_STRING
+            || key->u.value.atom_id == NJS_ATOM_STRING_unknown
+            || njs_atom_is_number(key->u.value.atom_id))
+        {
+            goto reset;
+        }
+
+        if (keys == NULL) {
+            keys = njs_arr_create(vm->mem_pool, 4, sizeof(uint32_t));
+            if (njs_slow_path(keys == NULL)) {
+                njs_memory_error(vm);
+                return NJS_ERROR;
+            }
+        }
+
+        atom_id = njs_arr_add(keys);
+        if (njs_slow_path(atom_id == NULL)) {
+            njs_memory_error(vm);
+            return NJS_ERROR;
+        }
+
+        *atom_id = key->u.value.atom_id;
+
+        continue;
+
+    reset:
+
+        if (keys != NULL) {
+            keys->items = 0;
+        }
+    }
+
+    if (keys == NULL) {
+        return NJS_OK;
+    }
+
+    fhq.replace = 0;
+    fhq.pool = vm->mem_pool;
+    fhq.proto = &njs_object_hash_proto;
+
+    atom_id = keys->start;
+
+    for (n = keys->items; n != 0; n--) {
+        fhq.key_hash = atom_id[n - 1];
+
+        ret = njs_flathsh_unique_insert(props, &fhq);
+        if (njs_slow_path(ret == NJS_ERROR)) {
+            njs_memory_error(vm);
+            return NJS_ERROR;
+        }
+
+        if (ret == NJS_DECLINED) {
+            /* Duplicate keys keep the position of the first one. */
+            continue;
+        }
+
+        prop = fhq.value;
+
+        prop->type = NJS_PROPERTY;
+        prop->enumerable = 1;
+        prop->configurable = 1;
+        prop->writable = 1;
+        njs_set_invalid(njs_prop_value(prop));
+    }
+
+    njs_arr_destroy(keys);
+
+    return NJS_OK;
+}
+
+
 static njs_int_t
 njs_generate_property_accessor(njs_vm_t *vm, njs_generator_t *generator,
     njs_parser_node_t *node)
@@ -4475,25 +4706,37 @@ static njs_int_t
 njs_generate_3addr_operation_end(njs_vm_t *vm, njs_generator_t *generator,
     njs_parser_node_t *node)
 {
-    njs_bool_t          swap;
-    njs_vmcode_t        opcode;
-    njs_parser_node_t   *left, *right;
-    njs_vmcode_3addr_t  *code;
+    njs_bool_t             swap;
+    njs_vmcode_t           opcode;
+    njs_parser_node_t      *left, *right;
+    njs_vmcode_3addr_t     *code;
+    njs_vmcode_prop_get_t  *prop_get;
 
     left = node->left;
     right = node->right;
 
     if (node->u.operation == NJS_VMCODE_PROPERTY_GET
-        && (right->token_type == NJS_TOKEN_STRING
-            || (right->token_type == NJS_TOKEN_NUMBER
-                && right->u.value.atom_id != NJS_ATOM_STRING_unknown)))
+        || node->u.operation == NJS_VMCODE_PROPERTY_ATOM_GET)
     {
-        opcode = NJS_VMCODE_PROPERTY_ATOM_GET;
+        njs_generate_code(generator, njs_vmcode_prop_get_t, prop_get,
+                          njs_generate_property_get_opcode(right), node);
 
-    } else {
-        opcode = node->u.operation;
+        prop_get->cache = njs_generate_prop_cache(vm, prop_get->code);
+        prop_get->object = left->index;
+        prop_get->property = right->index;
+
+        node->index = njs_generate_dest_index(vm, generator, node);
+        if (njs_slow_path(node->index == NJS_INDEX_ERROR)) {
+            return node->index;
+        }
+
+        prop_get->value = node->index;
+
+        return njs_generator_stack_pop(vm, generator, generator->context);
     }
 
+    opcode = node->u.operation;
+
     njs_generate_code(generator, njs_vmcode_3addr_t, code,
                       opcode, node);
 
@@ -4741,6 +4984,7 @@ found:
     njs_generate_code(generator, njs_vmcode_prop_get_t, prop_get,
                       opcode, node);
 
+    prop_get->cache = njs_generate_prop_cache(vm, opcode);
     prop_get->value = index;
     prop_get->object = lvalue->left->index;
     prop_get->property = prop_index;
@@ -4761,6 +5005,7 @@ found:
     njs_generate_code(generator, njs_vmcode_prop_set_t, prop_set,
                       opcode, node);
 
+    prop_set->cache = njs_generate_prop_cache(vm, opcode);
     prop_set->value = index;
     prop_set->object = lvalue->left->index;
     prop_set->property = prop_index;
@@ -4885,6 +5130,7 @@ njs_generate_scope(njs_vm_t *vm, njs_generator_t *generator,
     njs_uint_t             index, n;
     njs_vm_code_t          *code;
     njs_declaration_t      *declr;
+    njs_vm_line_num_t      *ln;
     njs_vmcode_function_t  *fun;
 
     generator->code_size = 128;
@@ -4898,6 +5144,13 @@ njs_generate_scope(njs_vm_t *vm, njs_generator_t *generator,
     generator->code_start = p;
     generator->code_end = p;
 
+    if (generator->depth == 0) {
+        ret = njs_variable_escape(vm, scope->top);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return NULL;
+        }
+    }
+
     nargs = njs_generate_lambda_variables(vm, generator, scope->top);
     if (njs_slow_path(nargs < NJS_OK)) {
         return NULL;
@@ -4993,6 +5246,16 @@ njs_generate_scope(njs_vm_t *vm, njs_generator_t *generator,
 
         generator->code_start = code_start;
         generator->code_end = code_start + code_size + prelude;
+
+        code = njs_arr_item(vm->codes, index);
+
+        if (code->lines != NULL) {
+            ln = code->lines->start;
+
+            for (n = 0; n < code->lines->items; n++) {
+                ln[n].offset += prelude;
+            }
+        }
     }
 
     code = njs_arr_item(vm->codes, index);
@@ -5206,6 +5469,7 @@ static njs_int_t
 njs_generate_function_call_frame(njs_vm_t *vm, njs_generator_t *generator,
     njs_parser_node_t *node)
 {
+    njs_int_t                    ret;
     njs_uint_t                   nargs;
     njs_parser_node_t            *callee, *this_object;
     njs_parser_node_t            *arg;
@@ -5241,6 +5505,11 @@ njs_generate_function_call_frame(njs_vm_t *vm, njs_generator_t *generator,
         put_arg->index = arg->left->index;
     }
 
+    ret = njs_generate_call_arguments_release(vm, generator, node->right);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return ret;
+    }
+
     return njs_generate_function_call_end(vm, generator, node);
 }
 
@@ -5381,10 +5650,15 @@ static njs_int_t
 njs_generate_method_call_frame(njs_vm_t *vm, njs_generator_t *generator,
     njs_parser_node_t *node)
 {
+    uint32_t                   cache;
+    njs_int_t                  ret;
     njs_uint_t                 nargs;
+    njs_index_t                property;
     njs_parser_node_t          *arg;
     njs_parser_node_t          *prop;
     njs_vmcode_1addr_t         *put_arg;
+    njs_vmcode_prop_get_t      *prop_get;
+    njs_vmcode_atom_frame_t    *atom_frame;
     njs_vmcode_method_frame_t  *method_frame;
 
     prop = node->left;
@@ -5395,12 +5669,40 @@ njs_generate_method_call_frame(njs_vm_t *vm, njs_generator_t *generator,
         return NJS_ERROR;
     }
 
-    njs_generate_code(generator, njs_vmcode_method_frame_t, method_frame,
-                      NJS_VMCODE_METHOD_FRAME, node);
-    method_frame->ctor = node->ctor;
-    method_frame->function = prop->index;
-    method_frame->this_object = prop->left->index;
-    method_frame->nargs = nargs;
+    prop_get = njs_generate_last_code(generator, njs_vmcode_prop_get_t);
+
+    if (prop_get != NULL
+        && prop_get->code == NJS_VMCODE_PROPERTY_ATOM_GET
+        && prop_get->value == prop->index
+        && prop_get->object == prop->left->index)
+    {
+        /*
+         * The method lookup is the last generated instruction, so
+         * it is fused with the frame creation.
+         */
+
+        property = prop_get->property;
+        cache = prop_get->cache;
+
+        generator->code_end = (u_char *) prop_get;
+
+        njs_generate_code(generator, njs_vmcode_atom_frame_t, atom_frame,
+                          NJS_VMCODE_METHOD_ATOM_FRAME, node);
+        atom_frame->ctor = node->ctor;
+        atom_frame->function = prop->index;
+        atom_frame->this_object = prop->left->index;
+        atom_frame->property = property;
+        atom_frame->cache = cache;
+        atom_frame->nargs = nargs;
+
+    } else {
+        njs_generate_code(generator, njs_vmcode_method_frame_t, method_frame,
+                          NJS_VMCODE_METHOD_FRAME, node);
+        method_frame->ctor = node->ctor;
+        method_frame->function = prop->index;
+        method_frame->this_object = prop->left->index;
+        method_frame->nargs = nargs;
+    }
 
     for (arg = node->right; arg != NULL; arg = arg->right) {
         njs_generate_code(generator, njs_vmcode_1addr_t, put_arg,
@@ -5408,6 +5710,11 @@ njs_generate_method_call_frame(njs_vm_t *vm, njs_generator_t *generator,
         put_arg->index = arg->left->index;
     }
 
+    ret = njs_generate_call_arguments_release(vm, generator, node->right);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return ret;
+    }
+
     return njs_generate_method_call_end(vm, generator, node);
 }
 
@@ -5494,6 +5801,34 @@ njs_generate_call_argument_expressions_after(njs_vm_t *vm,
 }
 
 
+static njs_int_t
+njs_generate_call_arguments_release(njs_vm_t *vm, njs_generator_t *generator,
+    njs_parser_node_t *arg)
+{
+    njs_int_t  ret;
+
+    /*
+     * Argument values are copied into the new frame by PUT_ARG,
+     * so their temporaries are dead and can be reused by the call
+     * result and by the following expressions.  Only these temporaries
+     * are released here: there is no liveness analysis, so variables keep
+     * their own slots for the whole function even when their live ranges
+     * do not overlap.
+     */
+
+    while (arg != NULL) {
+        ret = njs_generate_node_index_release(vm, generator, arg->left);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return ret;
+        }
+
+        arg = arg->right;
+    }
+
+    return NJS_OK;
+}
+
+
 static njs_bool_t
 njs_generate_argument_aliases_mutable_slot(njs_parser_node_t *node)
 {
@@ -5766,7 +6101,7 @@ njs_generate_try_left(njs_vm_t *vm, njs_generator_t *generator,
                           NJS_VMCODE_TRY_BREAK, NULL);
         try_break->exit_value = exit_index;
 
-        try_break->offset = -sizeof(njs_vmcode_try_end_t);
+        try_break->offset = -(njs_jump_off_t) sizeof(njs_vmcode_try_end_t);
 
     } else {
         try_break = NULL;
@@ -5782,7 +6117,7 @@ njs_generate_try_left(njs_vm_t *vm, njs_generator_t *generator,
                           NJS_VMCODE_TRY_CONTINUE, NULL);
         try_continue->exit_value = exit_index;
 
-        try_continue->offset = -sizeof(njs_vmcode_try_end_t);
+        try_continue->offset = -(njs_jump_off_t) sizeof(njs_vmcode_try_end_t);
 
         if (try_break != NULL) {
             try_continue->offset -= sizeof(njs_vmcode_try_trampoline_t);
@@ -5993,7 +6328,7 @@ njs_generate_try_finally(njs_vm_t *vm, njs_generator_t *generator,
 
         try_break->exit_value = exit_index;
 
-        try_break->offset = -sizeof(njs_vmcode_try_end_t);
+        try_break->offset = -(njs_jump_off_t) sizeof(njs_vmcode_try_end_t);
 
     } else {
         try_break = NULL;
@@ -6011,7 +6346,7 @@ njs_generate_try_finally(njs_vm_t *vm, njs_generator_t *generator,
 
         try_continue->exit_value = exit_index;
 
-        try_continue->offset = -sizeof(njs_vmcode_try_end_t);
+        try_continue->offset = -(njs_jump_off_t) sizeof(njs_vmcode_try_end_t);
 
         if (try_break != NULL) {
             try_continue->offset -= sizeof(njs_vmcode_try_trampoline_t);
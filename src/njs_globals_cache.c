@@ -0,0 +1,787 @@
+/*
+ * Copyright (C) NGINX, Inc.
+ */
+
+
+#include <njs_main.h>
+
+
+/*
+ * A globals cache holds the data values of the global object properties
+ * created after the VM initialization, in practice the parsed JSON of
+ * the preloaded objects, so that a host can skip reading and parsing
+ * the files again.  It is not a snapshot of the VM heap: only plain
+ * objects, arrays and primitive values are stored, a global property
+ * holding a function or any other object makes njs_vm_globals_cache()
+ * fail.  Object references are stored as numbers in the object table
+ * and are relocated when the cache is restored, so shared and cyclic
+ * references are preserved.
+ *
+ * Layout:
+ *   header
+ *   uint32 nobjects, object table
+ *   global properties
+ *   object records: array elements, properties
+ */
+
+#define NJS_GCACHE_MAGIC         0x43474a4e    /* "NJGC" */
+#define NJS_GCACHE_VERSION       1
+
+
+typedef struct {
+    uint32_t                     magic;
+    uint32_t                     version;
+    uint32_t                     njs_version;
+    uint32_t                     layout;
+    uint32_t                     size;
+    uint32_t                     hash;
+} njs_gcache_header_t;
+
+
+typedef struct {
+    uint8_t                      type;
+    uint8_t                      proto;
+    uint8_t                      fast_array;
+    uint8_t                      extensible;
+    uint32_t                     length;
+} njs_gcache_object_t;
+
+
+enum {
+    NJS_GCACHE_HOLE = 0,
+    NJS_GCACHE_UNDEFINED,
+    NJS_GCACHE_NULL,
+    NJS_GCACHE_FALSE,
+    NJS_GCACHE_TRUE,
+    NJS_GCACHE_NUMBER,
+    NJS_GCACHE_STRING,
+    NJS_GCACHE_OBJECT,
+};
+
+
+enum {
+    NJS_GCACHE_PROTO_NULL = 0,
+    NJS_GCACHE_PROTO_OBJECT,
+    NJS_GCACHE_PROTO_ARRAY,
+};
+
+
+typedef struct {
+    njs_vm_t                     *vm;
+    njs_arr_t                    *objects;
+    njs_flathsh_t                ids;
+    njs_chb_t                    chain;
+} njs_gcache_t;
+
+
+typedef struct {
+    njs_vm_t                     *vm;
+    u_char                       *pos;
+    u_char                       *end;
+    uint32_t                     nobjects;
+    njs_object_t                 **objects;
+} njs_gcache_reader_t;
+
+
+static njs_int_t njs_gcache_props(njs_gcache_t *cw,
+    njs_object_t *object, njs_bool_t global);
+static njs_int_t njs_gcache_value(njs_gcache_t *cw,
+    njs_value_t *value);
+static njs_int_t njs_gcache_object_id(njs_gcache_t *cw,
+    njs_object_t *object, uint32_t *id);
+static njs_int_t njs_gcache_props_restore(njs_gcache_reader_t *rd,
+    njs_value_t *object);
+static njs_int_t njs_gcache_value_restore(njs_gcache_reader_t *rd,
+    njs_value_t *value);
+static njs_int_t njs_gcache_read(njs_gcache_reader_t *rd, void *dst,
+    size_t size);
+
+
+static njs_int_t
+njs_gcache_ids_test(njs_flathsh_query_t *fhq, void *data)
+{
+    return (*(void **) data == fhq->data) ? NJS_OK : NJS_DECLINED;
+}
+
+
+static const njs_flathsh_proto_t  njs_gcache_ids_proto
+    njs_aligned(64) =
+{
+    njs_gcache_ids_test,
+    njs_flathsh_proto_alloc,
+    njs_flathsh_proto_free,
+};
+
+
+#define njs_gcache_layout()                                                   \
+    ((uint32_t) (sizeof(njs_value_t) << 16 | sizeof(njs_gcache_object_t)))
+
+
+njs_int_t
+njs_vm_globals_cache(njs_vm_t *vm, njs_str_t *cache)
+{
+    u_char               *p, *start;
+    size_t               size;
+    int64_t              body_size;
+    uint32_t             i, nobjects;
+    njs_int_t            ret;
+    njs_uint_t           n;
+    njs_array_t          *array;
+    njs_object_t         *object, **objects;
+    njs_gcache_t         cw;
+    njs_flathsh_query_t  fhq;
+    njs_gcache_object_t  *table;
+    njs_gcache_header_t  header;
+
+    cw.vm = vm;
+    njs_flathsh_init(&cw.ids);
+    NJS_CHB_MP_INIT(&cw.chain, vm->mem_pool);
+
+    cw.objects = njs_arr_create(vm->mem_pool, 8, sizeof(njs_object_t *));
+    if (njs_slow_path(cw.objects == NULL)) {
+        njs_memory_error(vm);
+        return NJS_ERROR;
+    }
+
+    ret = njs_gcache_props(&cw, njs_object(&vm->global_value), 1);
+    if (njs_slow_path(ret != NJS_OK)) {
+        goto done;
+    }
+
+    /* Objects found while writing are appended to the table. */
+
+    for (n = 0; n < cw.objects->items; n++) {
+        objects = cw.objects->start;
+        object = objects[n];
+
+        if (object->fast_array) {
+            array = (njs_array_t *) object;
+
+            for (i = 0; i < array->length; i++) {
+                ret = njs_gcache_value(&cw, &array->start[i]);
+                if (njs_slow_path(ret != NJS_OK)) {
+                    goto done;
+                }
+            }
+        }
+
+        ret = njs_gcache_props(&cw, object, 0);
+        if (njs_slow_path(ret != NJS_OK)) {
+            goto done;
+        }
+    }
+
+    ret = NJS_ERROR;
+
+    nobjects = cw.objects->items;
+
+    body_size = njs_chb_size(&cw.chain);
+    if (njs_slow_path(body_size < 0)) {
+        njs_memory_error(vm);
+        goto done;
+    }
+
+    size = sizeof(njs_gcache_header_t) + sizeof(uint32_t)
+           + nobjects * sizeof(njs_gcache_object_t) + body_size;
+
+    if (njs_slow_path(size > UINT32_MAX)) {
+        njs_range_error(vm, "globals cache size limit exceeded");
+        goto done;
+    }
+
+    start = njs_mp_alloc(vm->mem_pool, size);
+    if (njs_slow_path(start == NULL)) {
+        njs_memory_error(vm);
+        goto done;
+    }
+
+    p = start + sizeof(njs_gcache_header_t);
+    p = njs_cpymem(p, &nobjects, sizeof(uint32_t));
+
+    table = (njs_gcache_object_t *) p;
+    objects = cw.objects->start;
+
+    for (n = 0; n < nobjects; n++) {
+        object = objects[n];
+
+        table[n].type = object->type;
+        table[n].fast_array = object->fast_array;
+        table[n].extensible = object->extensible;
+        table[n].length = object->fast_array
+                          ? ((njs_array_t *) object)->length : 0;
+
+        if (object->__proto__ == NULL) {
+            table[n].proto = NJS_GCACHE_PROTO_NULL;
+
+        } else if (object->__proto__ == njs_vm_proto(vm, NJS_OBJ_TYPE_ARRAY)) {
+            table[n].proto = NJS_GCACHE_PROTO_ARRAY;
+
+        } else {
+            table[n].proto = NJS_GCACHE_PROTO_OBJECT;
+        }
+    }
+
+    p += nobjects * sizeof(njs_gcache_object_t);
+
+    njs_chb_join_to(&cw.chain, p);
+
+    header.magic = NJS_GCACHE_MAGIC;
+    header.version = NJS_GCACHE_VERSION;
+    header.njs_version = NJS_VERSION_NUMBER;
+    header.layout = njs_gcache_layout();
+    header.size = size - sizeof(njs_gcache_header_t);
+    header.hash = njs_djb_hash(start + sizeof(njs_gcache_header_t),
+                               header.size);
+
+    memcpy(start, &header, sizeof(njs_gcache_header_t));
+
+    cache->start = start;
+    cache->length = size;
+
+    ret = NJS_OK;
+
+done:
+
+    fhq.pool = vm->mem_pool;
+    fhq.proto = &njs_gcache_ids_proto;
+
+    if (!njs_flathsh_is_empty(&cw.ids)) {
+        njs_flathsh_destroy(&cw.ids, &fhq);
+    }
+    njs_chb_destroy(&cw.chain);
+    njs_arr_destroy(cw.objects);
+
+    return ret;
+}
+
+
+static njs_int_t
+njs_gcache_props(njs_gcache_t *cw, njs_object_t *object,
+    njs_bool_t global)
+{
+    u_char               attrs;
+    uint32_t             n, length;
+    njs_int_t            ret;
+    njs_str_t            str;
+    njs_value_t          key;
+    njs_flathsh_t        *hash;
+    njs_object_prop_t    *prop;
+    njs_flathsh_elt_t    *elt;
+    njs_flathsh_each_t   fhe;
+    njs_flathsh_query_t  fhq;
+
+    /*
+     * The global object properties created at the VM initialization and
+     * the "length" handler of arrays live in the shared hash.  A private
+     * copy of a shared property shadows it, such copies of the global
+     * object properties are not stored.
+     */
+
+    fhq.proto = &njs_object_hash_proto;
+
+    for (n = 0; n < 2; n++) {
+        hash = &object->hash;
+
+        if (n == 1) {
+            if (global) {
+                break;
+            }
+
+            hash = &object->shared_hash;
+        }
+
+        njs_flathsh_each_init(&fhe, &njs_object_hash_proto);
+
+        for ( ;; ) {
+            elt = njs_flathsh_each(hash, &fhe);
+            if (elt == NULL) {
+                break;
+            }
+
+            prop = (njs_object_prop_t *) elt;
+
+            if (prop->type == NJS_WHITEOUT) {
+                continue;
+            }
+
+            fhq.key_hash = elt->key_hash;
+
+            if (global
+                && njs_flathsh_unique_find(&object->shared_hash, &fhq)
+                   == NJS_OK)
+            {
+                continue;
+            }
+
+            if (n == 1) {
+                if (prop->type == NJS_PROPERTY_HANDLER
+                    && object->type == NJS_ARRAY
+                    && elt->key_hash == NJS_ATOM_STRING_length)
+                {
+                    continue;
+                }
+
+                if (njs_flathsh_unique_find(&object->hash, &fhq) == NJS_OK) {
+                    continue;
+                }
+            }
+
+            ret = njs_atom_to_value(cw->vm, &key, elt->key_hash);
+            if (njs_slow_path(ret != NJS_OK)) {
+                return NJS_ERROR;
+            }
+
+            if (njs_slow_path(!njs_is_string(&key))) {
+                njs_type_error(cw->vm, "cannot cache a symbol property");
+                return NJS_ERROR;
+            }
+
+            njs_string_get(cw->vm, &key, &str);
+
+            if (njs_slow_path(prop->type != NJS_PROPERTY
+                              || !njs_is_valid(njs_prop_value(prop))))
+            {
+                njs_type_error(cw->vm, "cannot cache property \"%V\"",
+                               &str);
+                return NJS_ERROR;
+            }
+
+            attrs = prop->writable | prop->enumerable << 1
+                    | prop->configurable << 2;
+
+            length = str.length;
+
+            njs_chb_append(&cw->chain, &attrs, 1);
+            njs_chb_append(&cw->chain, &length, sizeof(uint32_t));
+            njs_chb_append_str(&cw->chain, &str);
+
+            ret = njs_gcache_value(cw, njs_prop_value(prop));
+            if (njs_slow_path(ret != NJS_OK)) {
+                return NJS_ERROR;
+            }
+        }
+    }
+
+    /* The end of properties. */
+
+    attrs = 0xff;
+    njs_chb_append(&cw->chain, &attrs, 1);
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_gcache_value(njs_gcache_t *cw, njs_value_t *value)
+{
+    u_char     type;
+    uint32_t   id, length;
+    njs_int_t  ret;
+    njs_str_t  str;
+
+    switch (value->type) {
+    case NJS_UNDEFINED:
+        type = NJS_GCACHE_UNDEFINED;
+        njs_chb_append(&cw->chain, &type, 1);
+        break;
+
+    case NJS_NULL:
+        type = NJS_GCACHE_NULL;
+        njs_chb_append(&cw->chain, &type, 1);
+        break;
+
+    case NJS_BOOLEAN:
+        type = njs_is_true(value) ? NJS_GCACHE_TRUE : NJS_GCACHE_FALSE;
+        njs_chb_append(&cw->chain, &type, 1);
+        break;
+
+    case NJS_NUMBER:
+        type = NJS_GCACHE_NUMBER;
+        njs_chb_append(&cw->chain, &type, 1);
+        njs_chb_append(&cw->chain, &njs_number(value), sizeof(double));
+        break;
+
+    case NJS_STRING:
+        type = NJS_GCACHE_STRING;
+        njs_string_get(cw->vm, value, &str);
+        length = str.length;
+
+        njs_chb_append(&cw->chain, &type, 1);
+        njs_chb_append(&cw->chain, &length, sizeof(uint32_t));
+        njs_chb_append_str(&cw->chain, &str);
+        break;
+
+    case NJS_OBJECT:
+    case NJS_ARRAY:
+        ret = njs_gcache_object_id(cw, njs_object(value), &id);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return NJS_ERROR;
+        }
+
+        type = NJS_GCACHE_OBJECT;
+        njs_chb_append(&cw->chain, &type, 1);
+        njs_chb_append(&cw->chain, &id, sizeof(uint32_t));
+        break;
+
+    case NJS_INVALID:
+        type = NJS_GCACHE_HOLE;
+        njs_chb_append(&cw->chain, &type, 1);
+        break;
+
+    default:
+        njs_type_error(cw->vm, "cannot cache a %s value",
+                       njs_type_string(value->type));
+        return NJS_ERROR;
+    }
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_gcache_object_id(njs_gcache_t *cw, njs_object_t *object,
+    uint32_t *id)
+{
+    njs_int_t            ret;
+    njs_object_t         *proto, **item;
+    njs_flathsh_elt_t    *elt;
+    njs_flathsh_query_t  fhq;
+
+    fhq.key_hash = njs_djb_hash(&object, sizeof(njs_object_t *));
+    fhq.proto = &njs_gcache_ids_proto;
+    fhq.data = object;
+
+    if (njs_flathsh_find(&cw->ids, &fhq) == NJS_OK) {
+        elt = fhq.value;
+        *id = (uint32_t) (uintptr_t) elt->value[1];
+        return NJS_OK;
+    }
+
+    proto = object->__proto__;
+
+    if (proto != NULL) {
+        proto = (object->type == NJS_ARRAY)
+                ? njs_vm_proto(cw->vm, NJS_OBJ_TYPE_ARRAY)
+                : njs_vm_proto(cw->vm, NJS_OBJ_TYPE_OBJECT);
+    }
+
+    if (object->slots != NULL
+        || object->error_data
+        || object->__proto__ != proto
+        || (object->type != NJS_OBJECT && object->type != NJS_ARRAY))
+    {
+        njs_type_error(cw->vm, "cannot cache a non-plain object");
+        return NJS_ERROR;
+    }
+
+    *id = cw->objects->items;
+
+    item = njs_arr_add(cw->objects);
+    if (njs_slow_path(item == NULL)) {
+        njs_memory_error(cw->vm);
+        return NJS_ERROR;
+    }
+
+    *item = object;
+
+    fhq.replace = 0;
+    fhq.pool = cw->vm->mem_pool;
+
+    ret = njs_flathsh_insert(&cw->ids, &fhq);
+    if (njs_slow_path(ret != NJS_OK)) {
+        njs_memory_error(cw->vm);
+        return NJS_ERROR;
+    }
+
+    elt = fhq.value;
+    elt->value[0] = object;
+    elt->value[1] = (void *) (uintptr_t) *id;
+
+    return NJS_OK;
+}
+
+
+njs_int_t
+njs_vm_globals_cache_restore(njs_vm_t *vm, const njs_str_t *cache)
+{
+    uint32_t             n, i;
+    njs_int_t            ret;
+    njs_array_t          *array;
+    njs_value_t          value;
+    njs_object_t         *object;
+    njs_gcache_object_t  *table;
+    njs_gcache_header_t  header;
+    njs_gcache_reader_t  rd;
+
+    if (cache->length < sizeof(njs_gcache_header_t)) {
+        return NJS_DECLINED;
+    }
+
+    memcpy(&header, cache->start, sizeof(njs_gcache_header_t));
+
+    rd.vm = vm;
+    rd.pos = cache->start + sizeof(njs_gcache_header_t);
+    rd.end = cache->start + cache->length;
+
+    if (header.magic != NJS_GCACHE_MAGIC
+        || header.version != NJS_GCACHE_VERSION
+        || header.njs_version != NJS_VERSION_NUMBER
+        || header.layout != njs_gcache_layout()
+        || header.size != cache->length - sizeof(njs_gcache_header_t)
+        || header.hash != njs_djb_hash(rd.pos, header.size))
+    {
+        return NJS_DECLINED;
+    }
+
+    if (njs_gcache_read(&rd, &rd.nobjects, sizeof(uint32_t)) != NJS_OK
+        || rd.nobjects > (size_t) (rd.end - rd.pos)
+                         / sizeof(njs_gcache_object_t))
+    {
+        return NJS_DECLINED;
+    }
+
+    table = (njs_gcache_object_t *) rd.pos;
+    rd.pos += rd.nobjects * sizeof(njs_gcache_object_t);
+
+    rd.objects = njs_mp_alloc(vm->mem_pool,
+                              (rd.nobjects + 1) * sizeof(njs_object_t *));
+    if (njs_slow_path(rd.objects == NULL)) {
+        njs_memory_error(vm);
+        return NJS_ERROR;
+    }
+
+    /* The objects are allocated first to relocate references. */
+
+    for (n = 0; n < rd.nobjects; n++) {
+        if (table[n].type == NJS_ARRAY) {
+            array = njs_array_alloc(vm, 1, table[n].length, 0);
+            if (njs_slow_path(array == NULL)) {
+                return NJS_ERROR;
+            }
+
+            if (!table[n].fast_array) {
+                ret = njs_array_convert_to_slow_array(vm, array);
+                if (njs_slow_path(ret != NJS_OK)) {
+                    return NJS_ERROR;
+                }
+            }
+
+            object = &array->object;
+
+        } else if (table[n].type == NJS_OBJECT && !table[n].fast_array) {
+            object = njs_object_alloc(vm);
+            if (njs_slow_path(object == NULL)) {
+                return NJS_ERROR;
+            }
+
+        } else {
+            return NJS_DECLINED;
+        }
+
+        switch (table[n].proto) {
+        case NJS_GCACHE_PROTO_NULL:
+            object->__proto__ = NULL;
+            break;
+
+        case NJS_GCACHE_PROTO_OBJECT:
+            object->__proto__ = njs_vm_proto(vm, NJS_OBJ_TYPE_OBJECT);
+            break;
+
+        case NJS_GCACHE_PROTO_ARRAY:
+            object->__proto__ = njs_vm_proto(vm, NJS_OBJ_TYPE_ARRAY);
+            break;
+
+        default:
+            return NJS_DECLINED;
+        }
+
+        rd.objects[n] = object;
+    }
+
+    ret = njs_gcache_props_restore(&rd, &vm->global_value);
+    if (ret != NJS_OK) {
+        return ret;
+    }
+
+    for (n = 0; n < rd.nobjects; n++) {
+        object = rd.objects[n];
+
+        if (object->fast_array) {
+            array = (njs_array_t *) object;
+
+            for (i = 0; i < array->length; i++) {
+                ret = njs_gcache_value_restore(&rd, &array->start[i]);
+                if (ret != NJS_OK) {
+                    return ret;
+                }
+            }
+        }
+
+        njs_set_object(&value, object);
+
+        if (object->type == NJS_ARRAY) {
+            njs_set_array(&value, (njs_array_t *) object);
+        }
+
+        ret = njs_gcache_props_restore(&rd, &value);
+        if (ret != NJS_OK) {
+            return ret;
+        }
+    }
+
+    if (rd.pos != rd.end) {
+        return NJS_DECLINED;
+    }
+
+    /* Objects are made non-extensible when all of them are populated. */
+
+    for (n = 0; n < rd.nobjects; n++) {
+        rd.objects[n]->extensible = table[n].extensible;
+    }
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_gcache_props_restore(njs_gcache_reader_t *rd, njs_value_t *object)
+{
+    u_char             attrs;
+    uint32_t           length;
+    njs_int_t          ret;
+    njs_value_t        key;
+    njs_object_prop_t  *prop;
+
+    for ( ;; ) {
+        if (njs_gcache_read(rd, &attrs, 1) != NJS_OK) {
+            return NJS_DECLINED;
+        }
+
+        if (attrs == 0xff) {
+            return NJS_OK;
+        }
+
+        if (njs_gcache_read(rd, &length, sizeof(uint32_t)) != NJS_OK
+            || length > (size_t) (rd->end - rd->pos))
+        {
+            return NJS_DECLINED;
+        }
+
+        ret = njs_string_create(rd->vm, &key, rd->pos, length);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return NJS_ERROR;
+        }
+
+        rd->pos += length;
+
+        ret = njs_atom_atomize_key(rd->vm, &key);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return NJS_ERROR;
+        }
+
+        prop = njs_object_property_add(rd->vm, object, key.atom_id, 1);
+        if (njs_slow_path(prop == NULL)) {
+            return NJS_ERROR;
+        }
+
+        prop->writable = attrs & 1;
+        prop->enumerable = (attrs >> 1) & 1;
+        prop->configurable = (attrs >> 2) & 1;
+
+        ret = njs_gcache_value_restore(rd, njs_prop_value(prop));
+        if (ret != NJS_OK) {
+            return ret;
+        }
+    }
+}
+
+
+static njs_int_t
+njs_gcache_value_restore(njs_gcache_reader_t *rd, njs_value_t *value)
+{
+    u_char     type;
+    double     num;
+    uint32_t   u32;
+    njs_int_t  ret;
+
+    if (njs_gcache_read(rd, &type, 1) != NJS_OK) {
+        return NJS_DECLINED;
+    }
+
+    switch (type) {
+    case NJS_GCACHE_HOLE:
+        njs_set_invalid(value);
+        break;
+
+    case NJS_GCACHE_UNDEFINED:
+        njs_set_undefined(value);
+        break;
+
+    case NJS_GCACHE_NULL:
+        njs_set_null(value);
+        break;
+
+    case NJS_GCACHE_FALSE:
+    case NJS_GCACHE_TRUE:
+        njs_set_boolean(value, type == NJS_GCACHE_TRUE);
+        break;
+
+    case NJS_GCACHE_NUMBER:
+        if (njs_gcache_read(rd, &num, sizeof(double)) != NJS_OK) {
+            return NJS_DECLINED;
+        }
+
+        njs_set_number(value, num);
+        break;
+
+    case NJS_GCACHE_STRING:
+        if (njs_gcache_read(rd, &u32, sizeof(uint32_t)) != NJS_OK
+            || u32 > (size_t) (rd->end - rd->pos))
+        {
+            return NJS_DECLINED;
+        }
+
+        ret = njs_string_create(rd->vm, value, rd->pos, u32);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return NJS_ERROR;
+        }
+
+        rd->pos += u32;
+        break;
+
+    case NJS_GCACHE_OBJECT:
+        if (njs_gcache_read(rd, &u32, sizeof(uint32_t)) != NJS_OK
+            || u32 >= rd->nobjects)
+        {
+            return NJS_DECLINED;
+        }
+
+        if (rd->objects[u32]->type == NJS_ARRAY) {
+            njs_set_array(value, (njs_array_t *) rd->objects[u32]);
+
+        } else {
+            njs_set_object(value, rd->objects[u32]);
+        }
+
+        break;
+
+    default:
+        return NJS_DECLINED;
+    }
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_gcache_read(njs_gcache_reader_t *rd, void *dst, size_t size)
+{
+    if (size > (size_t) (rd->end - rd->pos)) {
+        return NJS_DECLINED;
+    }
+
+    memcpy(dst, rd->pos, size);
+    rd->pos += size;
+
+    return NJS_OK;
+}
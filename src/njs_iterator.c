@@ -335,6 +335,10 @@ njs_object_iterate(njs_vm_t *vm, njs_iterator_args_t *args,
             value = njs_object_value(value);
         }
 
+        if (njs_slow_path(njs_string_flatten(vm, value) != NJS_OK)) {
+            return NJS_ERROR;
+        }
+
         length = njs_string_prop(vm, &string_prop, value);
 
         p = string_prop.start;
@@ -492,6 +496,10 @@ njs_object_iterate_reverse(njs_vm_t *vm, njs_iterator_args_t *args,
             value = njs_object_value(value);
         }
 
+        if (njs_slow_path(njs_string_flatten(vm, value) != NJS_OK)) {
+            return NJS_ERROR;
+        }
+
         length = njs_string_prop(vm, &string_prop, value);
         end = string_prop.start + string_prop.size;
 
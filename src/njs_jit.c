@@ -0,0 +1,1463 @@
+
+/*
+ * Copyright (C) NGINX, Inc.
+ */
+
+
+#include <njs_main.h>
+
+#include <sys/mman.h>
+
+
+/*
+ * A baseline JIT for x86-64.
+ *
+ * A function called more than NJS_JIT_THRESHOLD times is translated
+ * instruction by instruction into native code.  Each supported instruction
+ * has a template which handles the common case only: numbers, booleans
+ * by their truth and fast arrays indexed by integers.  The template checks
+ * the operand types first and, if a check fails, leaves the native code
+ * before changing any value, returning the address of the instruction to
+ * the interpreter.  Unsupported instructions, calls and returns among
+ * them, return to the interpreter unconditionally.  So the native code
+ * never throws and the interpreter runs the rest of the call with
+ * the same semantics.
+ *
+ * The native code keeps the level arrays of the VM in r12 - r15, they
+ * do not change until the code returns, and the VM in rbx.  rax, rcx, rdx,
+ * rsi, rdi and xmm0 - xmm2 are scratch registers.
+ *
+ * Backward jumps are safepoints: if a profile sample is pending, the code
+ * calls njs_profile_sample() and goes on.
+ *
+ * The code can be entered at any instruction which has a template:
+ * the prologue jumps to the entry given by the caller.  When the
+ * interpreter takes a backward jump after an exit, it re-enters the native
+ * code at the jump target with njs_jit_run(), so a guard failure or an
+ * unsupported instruction in a loop leaves the native code for the rest
+ * of the iteration only.
+ *
+ * The native code and the call counter belong to the lambda, so to the VM
+ * which compiled the function, and are shared by its clones.  The regions
+ * are linked to the njs_jit_t of that VM, which the clones refer to, and
+ * are unmapped with it.  So the clones of a VM must not run in different
+ * threads when the JIT is enabled, as in nginx, where they run in the
+ * worker which created them.
+ *
+ * Only x86-64 is supported, configure rejects --with-jit elsewhere.
+ */
+
+
+#define NJS_JIT_INSN_MAX         192
+#define NJS_JIT_EXIT_SIZE        20
+
+#define NJS_JIT_NO_LABEL         UINT32_MAX
+
+
+enum {
+    NJS_JIT_RAX = 0,
+    NJS_JIT_RCX,
+    NJS_JIT_RDX,
+    NJS_JIT_RBX,
+    NJS_JIT_RSP,
+    NJS_JIT_RBP,
+    NJS_JIT_RSI,
+    NJS_JIT_RDI,
+    NJS_JIT_R12 = 12,
+};
+
+
+enum {
+    NJS_JIT_XMM0 = 0,
+    NJS_JIT_XMM1,
+    NJS_JIT_XMM2,
+};
+
+
+/* Condition codes. */
+enum {
+    NJS_JIT_B = 0x2,
+    NJS_JIT_AE = 0x3,
+    NJS_JIT_E = 0x4,
+    NJS_JIT_NE = 0x5,
+    NJS_JIT_BE = 0x6,
+    NJS_JIT_A = 0x7,
+    NJS_JIT_P = 0xa,
+    NJS_JIT_NP = 0xb,
+    NJS_JIT_ALWAYS = 0x10,
+};
+
+
+/* Memory regions with native code are linked through their headers. */
+
+typedef struct njs_jit_region_s  njs_jit_region_t;
+
+struct njs_jit_region_s {
+    njs_jit_region_t        *next;
+    size_t                  size;
+};
+
+
+struct njs_jit_s {
+    njs_jit_region_t        *regions;
+};
+
+
+struct njs_jit_code_s {
+    njs_jit_code_pt         run;
+    u_char                  *native;
+
+    /* The bytecode of the function. */
+    u_char                  *start;
+    u_char                  *end;
+
+    /* Native offsets of entries, by bytecode offset / 8. */
+    uint32_t                *entries;
+};
+
+
+typedef struct {
+    uint32_t                pos;
+    uint32_t                target;
+} njs_jit_fixup_t;
+
+
+typedef struct {
+    njs_vm_t                *vm;
+
+    u_char                  *code;
+    u_char                  *end;
+
+    u_char                  *start;
+    u_char                  *pos;
+
+    /* Native offsets of instructions, by bytecode offset / 8. */
+    uint32_t                *labels;
+    uint32_t                *entries;
+
+    njs_arr_t               *jumps;
+    njs_arr_t               *exits;
+
+    uint32_t                type;
+    uint32_t                fast_array;
+    uint8_t                 fast_array_mask;
+
+    njs_bool_t              exit_only;
+    njs_bool_t              failed;
+} njs_jit_compiler_t;
+
+
+static njs_int_t njs_jit_compile(njs_vm_t *vm, njs_function_lambda_t *lambda);
+static njs_int_t njs_jit_layout(njs_jit_compiler_t *jc);
+static void njs_jit_instruction(njs_jit_compiler_t *jc, u_char *pc);
+static void njs_jit_arithmetic(njs_jit_compiler_t *jc, u_char *pc,
+    njs_uint_t op);
+static void njs_jit_bitwise(njs_jit_compiler_t *jc, u_char *pc);
+static void njs_jit_relation(njs_jit_compiler_t *jc, u_char *pc);
+static void njs_jit_relation_jump(njs_jit_compiler_t *jc, u_char *pc);
+static void njs_jit_increment(njs_jit_compiler_t *jc, u_char *pc);
+static void njs_jit_element(njs_jit_compiler_t *jc, u_char *pc,
+    njs_bool_t set);
+static void njs_jit_length(njs_jit_compiler_t *jc, u_char *pc);
+static void njs_jit_operand(njs_jit_compiler_t *jc, njs_uint_t reg,
+    njs_index_t index);
+static void njs_jit_guard_type(njs_jit_compiler_t *jc, njs_uint_t reg,
+    njs_value_type_t type, njs_uint_t cc, u_char *pc);
+static void njs_jit_guard_dst(njs_jit_compiler_t *jc, njs_uint_t reg,
+    njs_index_t index, u_char *pc);
+static void njs_jit_set_number(njs_jit_compiler_t *jc, njs_uint_t reg);
+static void njs_jit_set_boolean(njs_jit_compiler_t *jc, njs_uint_t reg);
+static void njs_jit_copy(njs_jit_compiler_t *jc, njs_uint_t dst,
+    njs_uint_t src);
+static void njs_jit_to_integer(njs_jit_compiler_t *jc, njs_uint_t reg,
+    njs_uint_t xmm, u_char *pc);
+static void njs_jit_safepoint(njs_jit_compiler_t *jc, u_char *pc,
+    njs_jump_off_t offset);
+static void njs_jit_jump(njs_jit_compiler_t *jc, njs_uint_t cc, u_char *pc,
+    njs_jump_off_t offset);
+static void njs_jit_exit_jump(njs_jit_compiler_t *jc, njs_uint_t cc,
+    u_char *pc);
+static void njs_jit_return(njs_jit_compiler_t *jc, u_char *pc);
+static void njs_jit_fixup(njs_jit_compiler_t *jc, njs_arr_t *fixups,
+    uint32_t target);
+static void njs_jit_patch(njs_jit_compiler_t *jc, uint32_t pos,
+    uint32_t target);
+static void njs_jit_mem(njs_jit_compiler_t *jc, njs_uint_t prefix,
+    njs_uint_t w, njs_uint_t op, njs_uint_t reg, njs_uint_t base,
+    int32_t disp);
+static void njs_jit_reg(njs_jit_compiler_t *jc, njs_uint_t prefix,
+    njs_uint_t w, njs_uint_t op, njs_uint_t reg, njs_uint_t rm);
+static void njs_jit_opcode(njs_jit_compiler_t *jc, njs_uint_t prefix,
+    njs_uint_t w, njs_uint_t op, njs_uint_t reg, njs_uint_t rm);
+static void njs_jit_imm64(njs_jit_compiler_t *jc, njs_uint_t reg,
+    uint64_t imm);
+static void njs_jit_cleanup(void *data);
+
+
+#define njs_jit_byte(jc, b)                                                   \
+    *(jc)->pos++ = (u_char) (b)
+
+#define njs_jit_u32(jc, u)                                                    \
+    do {                                                                      \
+        uint32_t  _u = (uint32_t) (u);                                        \
+                                                                              \
+        (jc)->pos = njs_cpymem((jc)->pos, &_u, sizeof(uint32_t));            \
+    } while (0)
+
+
+/* Instruction encodings: the opcode, 0x0f escaped if it has two bytes. */
+
+#define NJS_JIT_MOV_LOAD         0x8b
+#define NJS_JIT_MOV              0x89
+#define NJS_JIT_MOV_STORE8       0x88
+#define NJS_JIT_MOV_IMM8         0xc6
+#define NJS_JIT_MOV_IMM32        0xc7
+#define NJS_JIT_CMP_IMM8         0x80
+#define NJS_JIT_CMP32_IMM8       0x83
+#define NJS_JIT_TEST_IMM8        0xf6
+#define NJS_JIT_ADD              0x01
+#define NJS_JIT_OR               0x09
+#define NJS_JIT_OR8              0x08
+#define NJS_JIT_AND              0x21
+#define NJS_JIT_AND8             0x20
+#define NJS_JIT_XOR              0x31
+#define NJS_JIT_CMP              0x39
+#define NJS_JIT_TEST8            0x84
+#define NJS_JIT_SHIFT_CL         0xd3
+#define NJS_JIT_SHIFT_IMM        0xc1
+#define NJS_JIT_MOVSD_LOAD       0x0f10
+#define NJS_JIT_MOVSD_STORE      0x0f11
+#define NJS_JIT_MOVDQU_LOAD      0x0f6f
+#define NJS_JIT_MOVDQU_STORE     0x0f7f
+#define NJS_JIT_MOVQ             0x0f6e
+#define NJS_JIT_MOVAPD           0x0f28
+#define NJS_JIT_UCOMISD          0x0f2e
+#define NJS_JIT_XORPD            0x0f57
+#define NJS_JIT_ADDSD            0x0f58
+#define NJS_JIT_MULSD            0x0f59
+#define NJS_JIT_SUBSD            0x0f5c
+#define NJS_JIT_DIVSD            0x0f5e
+#define NJS_JIT_CVTSI2SD         0x0f2a
+#define NJS_JIT_CVTTSD2SI        0x0f2c
+#define NJS_JIT_CMOVNE           0x0f45
+#define NJS_JIT_SETCC            0x0f90
+#define NJS_JIT_JCC              0x0f80
+
+/* The value cvttsd2si returns for NaN, infinities and large numbers. */
+#define NJS_JIT_INTEGER_INDEFINITE  0x8000000000000000ULL
+
+
+njs_int_t
+njs_jit_init(njs_vm_t *vm)
+{
+    njs_jit_t         *jit;
+    njs_mp_cleanup_t  *cln;
+
+    cln = njs_mp_cleanup_add(vm->mem_pool, sizeof(njs_jit_t));
+    if (njs_slow_path(cln == NULL)) {
+        njs_memory_error(vm);
+        return NJS_ERROR;
+    }
+
+    jit = cln->data;
+    jit->regions = NULL;
+
+    cln->handler = njs_jit_cleanup;
+
+    vm->jit = jit;
+
+    return NJS_OK;
+}
+
+
+u_char *
+njs_jit_enter(njs_vm_t *vm, njs_function_lambda_t *lambda)
+{
+    if (lambda->jit != NULL) {
+        return njs_jit_run(vm, lambda, lambda->start);
+    }
+
+    /* A function is compiled once, failed or not. */
+
+    if (lambda->calls > NJS_JIT_THRESHOLD
+        || lambda->calls++ != NJS_JIT_THRESHOLD)
+    {
+        return lambda->start;
+    }
+
+#ifdef NJS_DEBUG_OPCODE
+    if (vm->options.opcode_debug) {
+        return lambda->start;
+    }
+#endif
+
+    if (njs_jit_compile(vm, lambda) == NJS_OK) {
+        return njs_jit_run(vm, lambda, lambda->start);
+    }
+
+    return lambda->start;
+}
+
+
+/*
+ * Runs the native code of the lambda from the instruction "pc" and returns
+ * the address of the instruction at which the interpreter continues,
+ * "pc" itself if the instruction has no native entry.
+ */
+
+u_char *
+njs_jit_run(njs_vm_t *vm, njs_function_lambda_t *lambda, u_char *pc)
+{
+    uint32_t        entry;
+    njs_jit_code_t  *code;
+
+    code = lambda->jit;
+
+    if (pc < code->start || pc >= code->end) {
+        return pc;
+    }
+
+    entry = code->entries[(pc - code->start) / sizeof(uint64_t)];
+
+    if (entry == NJS_JIT_NO_LABEL) {
+        return pc;
+    }
+
+    return code->run(vm, code->native + entry);
+}
+
+
+static njs_int_t
+njs_jit_compile(njs_vm_t *vm, njs_function_lambda_t *lambda)
+{
+    u_char              *p;
+    size_t              size, header, insn_size;
+    uint32_t            target;
+    njs_int_t           ret;
+    njs_uint_t          i, n, ninsns;
+    njs_vmcode_t        op;
+    njs_vm_code_t       *code;
+    njs_jit_code_t      *jit;
+    njs_jit_fixup_t     *fixup;
+    njs_jit_region_t    *region;
+    njs_jit_compiler_t  jc;
+
+    static const u_char  prologue[] = {
+        0x53,                       /* push rbx */
+        0x41, 0x54,                 /* push r12 */
+        0x41, 0x55,                 /* push r13 */
+        0x41, 0x56,                 /* push r14 */
+        0x41, 0x57,                 /* push r15 */
+    };
+
+    if (vm->codes == NULL) {
+        return NJS_DECLINED;
+    }
+
+    code = vm->codes->start;
+    n = vm->codes->items;
+
+    for (i = 0; i < n; i++) {
+        if (code[i].start == lambda->start) {
+            break;
+        }
+    }
+
+    if (i == n) {
+        return NJS_DECLINED;
+    }
+
+    njs_memzero(&jc, sizeof(njs_jit_compiler_t));
+
+    jc.vm = vm;
+    jc.code = code[i].start;
+    jc.end = code[i].end;
+
+    ret = njs_jit_layout(&jc);
+    if (ret != NJS_OK) {
+        return NJS_DECLINED;
+    }
+
+    ninsns = (jc.end - jc.code) / sizeof(uint64_t) + 1;
+
+    ret = NJS_ERROR;
+
+    jc.labels = njs_mp_alloc(vm->mem_pool, ninsns * sizeof(uint32_t));
+    jc.entries = njs_mp_alloc(vm->mem_pool, ninsns * sizeof(uint32_t));
+    jc.start = njs_mp_alloc(vm->mem_pool, ninsns * (NJS_JIT_INSN_MAX
+                                                   + NJS_JIT_EXIT_SIZE)
+                                          + sizeof(prologue) + 64);
+    jc.jumps = njs_arr_create(vm->mem_pool, 8, sizeof(njs_jit_fixup_t));
+    jc.exits = njs_arr_create(vm->mem_pool, 32, sizeof(njs_jit_fixup_t));
+
+    if (njs_slow_path(jc.labels == NULL || jc.entries == NULL
+                      || jc.start == NULL || jc.jumps == NULL
+                      || jc.exits == NULL))
+    {
+        goto done;
+    }
+
+    for (i = 0; i < ninsns; i++) {
+        jc.labels[i] = NJS_JIT_NO_LABEL;
+        jc.entries[i] = NJS_JIT_NO_LABEL;
+    }
+
+    jc.pos = njs_cpymem(jc.start, prologue, sizeof(prologue));
+
+    for (i = 0; i < NJS_LEVEL_MAX; i++) {
+        njs_jit_mem(&jc, 0, 1, NJS_JIT_MOV_LOAD, NJS_JIT_R12 + i,
+                    NJS_JIT_RDI, offsetof(njs_vm_t, levels)
+                                 + i * sizeof(njs_value_t **));
+    }
+
+    njs_jit_reg(&jc, 0, 1, NJS_JIT_MOV, NJS_JIT_RDI, NJS_JIT_RBX);
+
+    /* "jmp rsi" to the entry. */
+    njs_jit_reg(&jc, 0, 0, 0xff, 4, NJS_JIT_RSI);
+
+    op = NJS_VMCODE_STOP;
+
+    for (p = jc.code; p < jc.end; p += insn_size) {
+        op = *p;
+        insn_size = njs_bytecode_instruction_size(op);
+
+        if (insn_size == 0 || insn_size > (size_t) (jc.end - p)) {
+            goto done;
+        }
+
+        i = (p - jc.code) / sizeof(uint64_t);
+        jc.labels[i] = jc.pos - jc.start;
+
+        jc.exit_only = 0;
+
+        njs_jit_instruction(&jc, p);
+
+        if (jc.failed) {
+            goto done;
+        }
+
+        /* Entering an instruction without a template is useless. */
+
+        if (!jc.exit_only) {
+            jc.entries[i] = jc.labels[i];
+        }
+    }
+
+    /* The native code must not fall off the end. */
+
+    if (op != NJS_VMCODE_RETURN && op != NJS_VMCODE_STOP) {
+        goto done;
+    }
+
+    fixup = jc.jumps->start;
+
+    for (i = 0; i < jc.jumps->items; i++) {
+        target = jc.labels[fixup[i].target / sizeof(uint64_t)];
+
+        if (target == NJS_JIT_NO_LABEL) {
+            goto done;
+        }
+
+        njs_jit_patch(&jc, fixup[i].pos, target);
+    }
+
+    /* Exits of an instruction share a stub. */
+
+    fixup = jc.exits->start;
+    target = 0;
+
+    for (i = 0; i < jc.exits->items; i++) {
+        if (i == 0 || fixup[i].target != fixup[i - 1].target) {
+            target = jc.pos - jc.start;
+            njs_jit_return(&jc, jc.code + fixup[i].target);
+        }
+
+        njs_jit_patch(&jc, fixup[i].pos, target);
+    }
+
+    /* The region holds the njs_jit_code_t and its entries before the code. */
+
+    header = sizeof(njs_jit_region_t) + sizeof(njs_jit_code_t)
+             + ninsns * sizeof(uint32_t);
+    header = njs_align_size(header, 16);
+
+    size = njs_align_size(header + (jc.pos - jc.start), njs_pagesize());
+
+    region = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) {
+        goto done;
+    }
+
+    region->size = size;
+    region->next = vm->jit->regions;
+    vm->jit->regions = region;
+
+    jit = (njs_jit_code_t *) &region[1];
+    jit->entries = (uint32_t *) &jit[1];
+
+    p = (u_char *) region + header;
+    memcpy(p, jc.start, jc.pos - jc.start);
+
+    jit->run = (njs_jit_code_pt) (uintptr_t) p;
+    jit->native = p;
+    jit->start = jc.code;
+    jit->end = jc.end;
+
+    memcpy(jit->entries, jc.entries, ninsns * sizeof(uint32_t));
+
+    if (mprotect(region, size, PROT_READ | PROT_EXEC) != 0) {
+        goto done;
+    }
+
+    lambda->jit = jit;
+
+    ret = NJS_OK;
+
+done:
+
+    if (jc.labels != NULL) {
+        njs_mp_free(vm->mem_pool, jc.labels);
+    }
+
+    if (jc.entries != NULL) {
+        njs_mp_free(vm->mem_pool, jc.entries);
+    }
+
+    if (jc.start != NULL) {
+        njs_mp_free(vm->mem_pool, jc.start);
+    }
+
+    if (jc.jumps != NULL) {
+        njs_arr_destroy(jc.jumps);
+    }
+
+    if (jc.exits != NULL) {
+        njs_arr_destroy(jc.exits);
+    }
+
+    return ret;
+}
+
+
+static njs_int_t
+njs_jit_layout(njs_jit_compiler_t *jc)
+{
+    u_char        *p;
+    njs_uint_t    i, n;
+    njs_value_t   value;
+    njs_object_t  object;
+
+    if (sizeof(njs_value_t) != 16 || sizeof(void *) != 8
+        || sizeof(njs_profile_pending) != sizeof(uint32_t))
+    {
+        return NJS_DECLINED;
+    }
+
+    /* Offsets of bit-fields are found by setting them in zeroed copies. */
+
+    njs_memzero(&value, sizeof(njs_value_t));
+    value.type = NJS_INVALID;
+
+    p = (u_char *) &value;
+    n = 0;
+
+    for (i = 0; i < sizeof(njs_value_t); i++) {
+        if (p[i] != 0) {
+            jc->type = i;
+            n++;
+        }
+    }
+
+    if (n != 1 || p[jc->type] != NJS_INVALID) {
+        return NJS_DECLINED;
+    }
+
+    njs_memzero(&object, sizeof(njs_object_t));
+    object.fast_array = 1;
+
+    p = (u_char *) &object;
+    n = 0;
+
+    for (i = 0; i < sizeof(njs_object_t); i++) {
+        if (p[i] != 0) {
+            jc->fast_array = offsetof(njs_array_t, object) + i;
+            jc->fast_array_mask = p[i];
+            n++;
+        }
+    }
+
+    if (n != 1) {
+        return NJS_DECLINED;
+    }
+
+    return NJS_OK;
+}
+
+
+static void
+njs_jit_instruction(njs_jit_compiler_t *jc, u_char *pc)
+{
+    njs_vmcode_move_t       *move;
+    njs_vmcode_jump_t       *jump;
+    njs_vmcode_2addr_t      *code2;
+    njs_vmcode_cond_jump_t  *cond;
+    njs_vmcode_test_jump_t  *test;
+
+    switch (*pc) {
+
+    case NJS_VMCODE_MOVE:
+        move = (njs_vmcode_move_t *) pc;
+
+        njs_jit_operand(jc, NJS_JIT_RAX, move->src);
+        njs_jit_guard_type(jc, NJS_JIT_RAX, NJS_INVALID, NJS_JIT_E, pc);
+        njs_jit_operand(jc, NJS_JIT_RDX, move->dst);
+        njs_jit_guard_dst(jc, NJS_JIT_RDX, move->dst, pc);
+        njs_jit_copy(jc, NJS_JIT_RDX, NJS_JIT_RAX);
+        break;
+
+    case NJS_VMCODE_JUMP:
+        jump = (njs_vmcode_jump_t *) pc;
+
+        njs_jit_safepoint(jc, pc, jump->offset);
+        njs_jit_jump(jc, NJS_JIT_ALWAYS, pc, jump->offset);
+        break;
+
+    case NJS_VMCODE_IF_TRUE_JUMP:
+    case NJS_VMCODE_IF_FALSE_JUMP:
+        cond = (njs_vmcode_cond_jump_t *) pc;
+
+        njs_jit_safepoint(jc, pc, cond->offset);
+        njs_jit_operand(jc, NJS_JIT_RAX, cond->cond);
+        njs_jit_guard_type(jc, NJS_JIT_RAX, NJS_INVALID, NJS_JIT_E, pc);
+
+        njs_jit_mem(jc, 0, 0, NJS_JIT_CMP_IMM8, 7, NJS_JIT_RAX,
+                    offsetof(njs_value_t, data.truth));
+        njs_jit_byte(jc, 0);
+
+        njs_jit_jump(jc, (*pc == NJS_VMCODE_IF_TRUE_JUMP) ? NJS_JIT_NE
+                                                          : NJS_JIT_E,
+                     pc, cond->offset);
+        break;
+
+    case NJS_VMCODE_TEST_IF_TRUE:
+    case NJS_VMCODE_TEST_IF_FALSE:
+        test = (njs_vmcode_test_jump_t *) pc;
+
+        njs_jit_safepoint(jc, pc, test->offset);
+        njs_jit_operand(jc, NJS_JIT_RAX, test->value);
+        njs_jit_guard_type(jc, NJS_JIT_RAX, NJS_INVALID, NJS_JIT_E, pc);
+        njs_jit_operand(jc, NJS_JIT_RDX, test->retval);
+        njs_jit_guard_dst(jc, NJS_JIT_RDX, test->retval, pc);
+        njs_jit_copy(jc, NJS_JIT_RDX, NJS_JIT_RAX);
+
+        njs_jit_mem(jc, 0, 0, NJS_JIT_CMP_IMM8, 7, NJS_JIT_RDX,
+                    offsetof(njs_value_t, data.truth));
+        njs_jit_byte(jc, 0);
+
+        njs_jit_jump(jc, (*pc == NJS_VMCODE_TEST_IF_TRUE) ? NJS_JIT_NE
+                                                          : NJS_JIT_E,
+                     pc, test->offset);
+        break;
+
+    case NJS_VMCODE_ADDITION:
+        njs_jit_arithmetic(jc, pc, NJS_JIT_ADDSD);
+        break;
+
+    case NJS_VMCODE_SUBTRACTION:
+        njs_jit_arithmetic(jc, pc, NJS_JIT_SUBSD);
+        break;
+
+    case NJS_VMCODE_MULTIPLICATION:
+        njs_jit_arithmetic(jc, pc, NJS_JIT_MULSD);
+        break;
+
+    case NJS_VMCODE_DIVISION:
+        njs_jit_arithmetic(jc, pc, NJS_JIT_DIVSD);
+        break;
+
+    case NJS_VMCODE_BITWISE_AND:
+    case NJS_VMCODE_BITWISE_OR:
+    case NJS_VMCODE_BITWISE_XOR:
+    case NJS_VMCODE_LEFT_SHIFT:
+    case NJS_VMCODE_RIGHT_SHIFT:
+    case NJS_VMCODE_UNSIGNED_RIGHT_SHIFT:
+        njs_jit_bitwise(jc, pc);
+        break;
+
+    case NJS_VMCODE_LESS:
+    case NJS_VMCODE_GREATER:
+    case NJS_VMCODE_LESS_OR_EQUAL:
+    case NJS_VMCODE_GREATER_OR_EQUAL:
+    case NJS_VMCODE_EQUAL:
+    case NJS_VMCODE_NOT_EQUAL:
+    case NJS_VMCODE_STRICT_EQUAL:
+    case NJS_VMCODE_STRICT_NOT_EQUAL:
+        njs_jit_relation(jc, pc);
+        break;
+
+    case NJS_VMCODE_IF_EQUAL_JUMP:
+    case NJS_VMCODE_IF_NOT_EQUAL_JUMP:
+    case NJS_VMCODE_IF_LESS_JUMP:
+    case NJS_VMCODE_IF_GREATER_JUMP:
+    case NJS_VMCODE_IF_LESS_OR_EQUAL_JUMP:
+    case NJS_VMCODE_IF_GREATER_OR_EQUAL_JUMP:
+    case NJS_VMCODE_IF_NOT_LESS_JUMP:
+    case NJS_VMCODE_IF_NOT_GREATER_JUMP:
+    case NJS_VMCODE_IF_NOT_LESS_OR_EQUAL_JUMP:
+    case NJS_VMCODE_IF_NOT_GREATER_OR_EQUAL_JUMP:
+        njs_jit_relation_jump(jc, pc);
+        break;
+
+    case NJS_VMCODE_INCREMENT:
+    case NJS_VMCODE_POST_INCREMENT:
+    case NJS_VMCODE_DECREMENT:
+    case NJS_VMCODE_POST_DECREMENT:
+        njs_jit_increment(jc, pc);
+        break;
+
+    case NJS_VMCODE_LOGICAL_NOT:
+        code2 = (njs_vmcode_2addr_t *) pc;
+
+        njs_jit_operand(jc, NJS_JIT_RAX, code2->src);
+        njs_jit_guard_type(jc, NJS_JIT_RAX, NJS_INVALID, NJS_JIT_E, pc);
+        njs_jit_operand(jc, NJS_JIT_RDX, code2->dst);
+        njs_jit_guard_dst(jc, NJS_JIT_RDX, code2->dst, pc);
+
+        njs_jit_mem(jc, 0, 0, NJS_JIT_CMP_IMM8, 7, NJS_JIT_RAX,
+                    offsetof(njs_value_t, data.truth));
+        njs_jit_byte(jc, 0);
+        njs_jit_reg(jc, 0, 0, NJS_JIT_SETCC | NJS_JIT_E, 0, NJS_JIT_RAX);
+
+        njs_jit_set_boolean(jc, NJS_JIT_RDX);
+        break;
+
+    case NJS_VMCODE_UNARY_NEGATION:
+        code2 = (njs_vmcode_2addr_t *) pc;
+
+        njs_jit_operand(jc, NJS_JIT_RAX, code2->src);
+        njs_jit_guard_type(jc, NJS_JIT_RAX, NJS_NUMBER, NJS_JIT_NE, pc);
+        njs_jit_operand(jc, NJS_JIT_RDX, code2->dst);
+        njs_jit_guard_dst(jc, NJS_JIT_RDX, code2->dst, pc);
+
+        njs_jit_mem(jc, 0xf2, 0, NJS_JIT_MOVSD_LOAD, NJS_JIT_XMM0,
+                    NJS_JIT_RAX, offsetof(njs_value_t, data.u.number));
+        njs_jit_imm64(jc, NJS_JIT_RAX, 0x8000000000000000ULL);
+        njs_jit_reg(jc, 0x66, 1, NJS_JIT_MOVQ, NJS_JIT_XMM1, NJS_JIT_RAX);
+        njs_jit_reg(jc, 0x66, 0, NJS_JIT_XORPD, NJS_JIT_XMM0, NJS_JIT_XMM1);
+
+        njs_jit_set_number(jc, NJS_JIT_RDX);
+        break;
+
+    case NJS_VMCODE_PROPERTY_GET:
+        njs_jit_element(jc, pc, 0);
+        break;
+
+    case NJS_VMCODE_PROPERTY_SET:
+        njs_jit_element(jc, pc, 1);
+        break;
+
+    case NJS_VMCODE_PROPERTY_ATOM_GET:
+        njs_jit_length(jc, pc);
+        break;
+
+    default:
+        jc->exit_only = 1;
+        njs_jit_return(jc, pc);
+        break;
+    }
+}
+
+
+static void
+njs_jit_arithmetic(njs_jit_compiler_t *jc, u_char *pc, njs_uint_t op)
+{
+    njs_vmcode_3addr_t  *code;
+
+    code = (njs_vmcode_3addr_t *) pc;
+
+    njs_jit_operand(jc, NJS_JIT_RAX, code->src1);
+    njs_jit_guard_type(jc, NJS_JIT_RAX, NJS_NUMBER, NJS_JIT_NE, pc);
+    njs_jit_operand(jc, NJS_JIT_RCX, code->src2);
+    njs_jit_guard_type(jc, NJS_JIT_RCX, NJS_NUMBER, NJS_JIT_NE, pc);
+    njs_jit_operand(jc, NJS_JIT_RDX, code->dst);
+    njs_jit_guard_dst(jc, NJS_JIT_RDX, code->dst, pc);
+
+    njs_jit_mem(jc, 0xf2, 0, NJS_JIT_MOVSD_LOAD, NJS_JIT_XMM0, NJS_JIT_RAX,
+                offsetof(njs_value_t, data.u.number));
+    njs_jit_mem(jc, 0xf2, 0, op, NJS_JIT_XMM0, NJS_JIT_RCX,
+                offsetof(njs_value_t, data.u.number));
+
+    njs_jit_set_number(jc, NJS_JIT_RDX);
+}
+
+
+static void
+njs_jit_bitwise(njs_jit_compiler_t *jc, u_char *pc)
+{
+    njs_vmcode_3addr_t  *code;
+
+    code = (njs_vmcode_3addr_t *) pc;
+
+    njs_jit_operand(jc, NJS_JIT_RAX, code->src1);
+    njs_jit_guard_type(jc, NJS_JIT_RAX, NJS_NUMBER, NJS_JIT_NE, pc);
+    njs_jit_operand(jc, NJS_JIT_RCX, code->src2);
+    njs_jit_guard_type(jc, NJS_JIT_RCX, NJS_NUMBER, NJS_JIT_NE, pc);
+    njs_jit_operand(jc, NJS_JIT_RDX, code->dst);
+    njs_jit_guard_dst(jc, NJS_JIT_RDX, code->dst, pc);
+
+    njs_jit_mem(jc, 0xf2, 0, NJS_JIT_MOVSD_LOAD, NJS_JIT_XMM0, NJS_JIT_RAX,
+                offsetof(njs_value_t, data.u.number));
+    njs_jit_mem(jc, 0xf2, 0, NJS_JIT_MOVSD_LOAD, NJS_JIT_XMM1, NJS_JIT_RCX,
+                offsetof(njs_value_t, data.u.number));
+
+    njs_jit_to_integer(jc, NJS_JIT_RAX, NJS_JIT_XMM0, pc);
+    njs_jit_to_integer(jc, NJS_JIT_RCX, NJS_JIT_XMM1, pc);
+
+    /* 32-bit operations give ToInt32() of the operands modulo 2^32. */
+
+    switch (*pc) {
+
+    case NJS_VMCODE_BITWISE_AND:
+        njs_jit_reg(jc, 0, 0, NJS_JIT_AND, NJS_JIT_RCX, NJS_JIT_RAX);
+        break;
+
+    case NJS_VMCODE_BITWISE_OR:
+        njs_jit_reg(jc, 0, 0, NJS_JIT_OR, NJS_JIT_RCX, NJS_JIT_RAX);
+        break;
+
+    case NJS_VMCODE_BITWISE_XOR:
+        njs_jit_reg(jc, 0, 0, NJS_JIT_XOR, NJS_JIT_RCX, NJS_JIT_RAX);
+        break;
+
+    /* Shifts by cl use its 5 low bits as the language requires. */
+
+    case NJS_VMCODE_LEFT_SHIFT:
+        njs_jit_reg(jc, 0, 0, NJS_JIT_SHIFT_CL, 4, NJS_JIT_RAX);
+        break;
+
+    case NJS_VMCODE_RIGHT_SHIFT:
+        njs_jit_reg(jc, 0, 0, NJS_JIT_SHIFT_CL, 7, NJS_JIT_RAX);
+        break;
+
+    default:
+        njs_jit_reg(jc, 0, 0, NJS_JIT_SHIFT_CL, 5, NJS_JIT_RAX);
+
+        /* The result is unsigned, the upper half of rax is zero. */
+
+        njs_jit_reg(jc, 0xf2, 1, NJS_JIT_CVTSI2SD, NJS_JIT_XMM0, NJS_JIT_RAX);
+        njs_jit_set_number(jc, NJS_JIT_RDX);
+        return;
+    }
+
+    njs_jit_reg(jc, 0xf2, 0, NJS_JIT_CVTSI2SD, NJS_JIT_XMM0, NJS_JIT_RAX);
+    njs_jit_set_number(jc, NJS_JIT_RDX);
+}
+
+
+static void
+njs_jit_relation(njs_jit_compiler_t *jc, u_char *pc)
+{
+    njs_uint_t          cc, a, b;
+    njs_vmcode_3addr_t  *code;
+
+    code = (njs_vmcode_3addr_t *) pc;
+
+    njs_jit_operand(jc, NJS_JIT_RAX, code->src1);
+    njs_jit_guard_type(jc, NJS_JIT_RAX, NJS_NUMBER, NJS_JIT_NE, pc);
+    njs_jit_operand(jc, NJS_JIT_RCX, code->src2);
+    njs_jit_guard_type(jc, NJS_JIT_RCX, NJS_NUMBER, NJS_JIT_NE, pc);
+    njs_jit_operand(jc, NJS_JIT_RDX, code->dst);
+    njs_jit_guard_dst(jc, NJS_JIT_RDX, code->dst, pc);
+
+    njs_jit_mem(jc, 0xf2, 0, NJS_JIT_MOVSD_LOAD, NJS_JIT_XMM0, NJS_JIT_RAX,
+                offsetof(njs_value_t, data.u.number));
+    njs_jit_mem(jc, 0xf2, 0, NJS_JIT_MOVSD_LOAD, NJS_JIT_XMM1, NJS_JIT_RCX,
+                offsetof(njs_value_t, data.u.number));
+
+    /*
+     * "Above" conditions are false for unordered operands, so "a < b"
+     * is tested as "b above a".
+     */
+
+    a = NJS_JIT_XMM0;
+    b = NJS_JIT_XMM1;
+
+    switch (*pc) {
+
+    case NJS_VMCODE_LESS:
+        a = NJS_JIT_XMM1;
+        b = NJS_JIT_XMM0;
+        cc = NJS_JIT_A;
+        break;
+
+    case NJS_VMCODE_GREATER:
+        cc = NJS_JIT_A;
+        break;
+
+    case NJS_VMCODE_LESS_OR_EQUAL:
+        a = NJS_JIT_XMM1;
+        b = NJS_JIT_XMM0;
+        cc = NJS_JIT_AE;
+        break;
+
+    case NJS_VMCODE_GREATER_OR_EQUAL:
+        cc = NJS_JIT_AE;
+        break;
+
+    case NJS_VMCODE_EQUAL:
+    case NJS_VMCODE_STRICT_EQUAL:
+        cc = NJS_JIT_E;
+        break;
+
+    default:
+        cc = NJS_JIT_NE;
+        break;
+    }
+
+    njs_jit_reg(jc, 0x66, 0, NJS_JIT_UCOMISD, a, b);
+    njs_jit_reg(jc, 0, 0, NJS_JIT_SETCC | cc, 0, NJS_JIT_RAX);
+
+    /* Equality is false and inequality is true for NaN. */
+
+    if (cc == NJS_JIT_E) {
+        njs_jit_reg(jc, 0, 0, NJS_JIT_SETCC | NJS_JIT_NP, 0, NJS_JIT_RCX);
+        njs_jit_reg(jc, 0, 0, NJS_JIT_AND8, NJS_JIT_RCX, NJS_JIT_RAX);
+
+    } else if (cc == NJS_JIT_NE) {
+        njs_jit_reg(jc, 0, 0, NJS_JIT_SETCC | NJS_JIT_P, 0, NJS_JIT_RCX);
+        njs_jit_reg(jc, 0, 0, NJS_JIT_OR8, NJS_JIT_RCX, NJS_JIT_RAX);
+    }
+
+    njs_jit_set_boolean(jc, NJS_JIT_RDX);
+}
+
+
+static void
+njs_jit_relation_jump(njs_jit_compiler_t *jc, u_char *pc)
+{
+    njs_uint_t               cc, a, b;
+    njs_vmcode_equal_jump_t  *jump;
+
+    jump = (njs_vmcode_equal_jump_t *) pc;
+
+    njs_jit_safepoint(jc, pc, jump->offset);
+    njs_jit_operand(jc, NJS_JIT_RAX, jump->value1);
+    njs_jit_guard_type(jc, NJS_JIT_RAX, NJS_NUMBER, NJS_JIT_NE, pc);
+    njs_jit_operand(jc, NJS_JIT_RCX, jump->value2);
+    njs_jit_guard_type(jc, NJS_JIT_RCX, NJS_NUMBER, NJS_JIT_NE, pc);
+
+    njs_jit_mem(jc, 0xf2, 0, NJS_JIT_MOVSD_LOAD, NJS_JIT_XMM0, NJS_JIT_RAX,
+                offsetof(njs_value_t, data.u.number));
+    njs_jit_mem(jc, 0xf2, 0, NJS_JIT_MOVSD_LOAD, NJS_JIT_XMM1, NJS_JIT_RCX,
+                offsetof(njs_value_t, data.u.number));
+
+    a = NJS_JIT_XMM0;
+    b = NJS_JIT_XMM1;
+
+    switch (*pc) {
+
+    case NJS_VMCODE_IF_LESS_JUMP:
+        a = NJS_JIT_XMM1;
+        b = NJS_JIT_XMM0;
+        cc = NJS_JIT_A;
+        break;
+
+    case NJS_VMCODE_IF_GREATER_JUMP:
+        cc = NJS_JIT_A;
+        break;
+
+    case NJS_VMCODE_IF_LESS_OR_EQUAL_JUMP:
+        a = NJS_JIT_XMM1;
+        b = NJS_JIT_XMM0;
+        cc = NJS_JIT_AE;
+        break;
+
+    case NJS_VMCODE_IF_GREATER_OR_EQUAL_JUMP:
+        cc = NJS_JIT_AE;
+        break;
+
+    /* The negated relations are true for unordered operands. */
+
+    case NJS_VMCODE_IF_NOT_LESS_JUMP:
+        a = NJS_JIT_XMM1;
+        b = NJS_JIT_XMM0;
+        cc = NJS_JIT_BE;
+        break;
+
+    case NJS_VMCODE_IF_NOT_GREATER_JUMP:
+        cc = NJS_JIT_BE;
+        break;
+
+    case NJS_VMCODE_IF_NOT_LESS_OR_EQUAL_JUMP:
+        a = NJS_JIT_XMM1;
+        b = NJS_JIT_XMM0;
+        cc = NJS_JIT_B;
+        break;
+
+    case NJS_VMCODE_IF_NOT_GREATER_OR_EQUAL_JUMP:
+        cc = NJS_JIT_B;
+        break;
+
+    case NJS_VMCODE_IF_EQUAL_JUMP:
+        cc = NJS_JIT_E;
+        break;
+
+    default:
+        cc = NJS_JIT_NE;
+        break;
+    }
+
+    njs_jit_reg(jc, 0x66, 0, NJS_JIT_UCOMISD, a, b);
+
+    if (cc == NJS_JIT_E) {
+        /* jp over the following jcc rel32. */
+        njs_jit_byte(jc, 0x70 | NJS_JIT_P);
+        njs_jit_byte(jc, 6);
+
+    } else if (cc == NJS_JIT_NE) {
+        njs_jit_jump(jc, NJS_JIT_P, pc, jump->offset);
+    }
+
+    njs_jit_jump(jc, cc, pc, jump->offset);
+}
+
+
+static void
+njs_jit_increment(njs_jit_compiler_t *jc, u_char *pc)
+{
+    njs_vmcode_3addr_t  *code;
+
+    code = (njs_vmcode_3addr_t *) pc;
+
+    njs_jit_operand(jc, NJS_JIT_RCX, code->src2);
+    njs_jit_guard_type(jc, NJS_JIT_RCX, NJS_NUMBER, NJS_JIT_NE, pc);
+    njs_jit_operand(jc, NJS_JIT_RDX, code->src1);
+    njs_jit_guard_dst(jc, NJS_JIT_RDX, code->src1, pc);
+    njs_jit_operand(jc, NJS_JIT_RSI, code->dst);
+    njs_jit_guard_dst(jc, NJS_JIT_RSI, code->dst, pc);
+
+    njs_jit_mem(jc, 0xf2, 0, NJS_JIT_MOVSD_LOAD, NJS_JIT_XMM2, NJS_JIT_RCX,
+                offsetof(njs_value_t, data.u.number));
+    njs_jit_imm64(jc, NJS_JIT_RAX, 0x3ff0000000000000ULL);  /* 1.0 */
+    njs_jit_reg(jc, 0x66, 1, NJS_JIT_MOVQ, NJS_JIT_XMM1, NJS_JIT_RAX);
+    njs_jit_reg(jc, 0x66, 0, NJS_JIT_MOVAPD, NJS_JIT_XMM0, NJS_JIT_XMM2);
+
+    if (*pc == NJS_VMCODE_INCREMENT || *pc == NJS_VMCODE_POST_INCREMENT) {
+        njs_jit_reg(jc, 0xf2, 0, NJS_JIT_ADDSD, NJS_JIT_XMM0, NJS_JIT_XMM1);
+
+    } else {
+        njs_jit_reg(jc, 0xf2, 0, NJS_JIT_SUBSD, NJS_JIT_XMM0, NJS_JIT_XMM1);
+    }
+
+    njs_jit_set_number(jc, NJS_JIT_RDX);
+
+    if (*pc == NJS_VMCODE_INCREMENT || *pc == NJS_VMCODE_DECREMENT) {
+        njs_jit_copy(jc, NJS_JIT_RSI, NJS_JIT_RDX);
+        return;
+    }
+
+    njs_jit_reg(jc, 0x66, 0, NJS_JIT_MOVAPD, NJS_JIT_XMM0, NJS_JIT_XMM2);
+    njs_jit_set_number(jc, NJS_JIT_RSI);
+}
+
+
+/*
+ * An element of a fast array is accessed by a number index which is
+ * an integer less than the array length.
+ */
+
+static void
+njs_jit_element(njs_jit_compiler_t *jc, u_char *pc, njs_bool_t set)
+{
+    njs_vmcode_prop_get_t  *code;
+
+    code = (njs_vmcode_prop_get_t *) pc;
+
+    njs_jit_operand(jc, NJS_JIT_RAX, code->object);
+    njs_jit_guard_type(jc, NJS_JIT_RAX, NJS_ARRAY, NJS_JIT_NE, pc);
+    njs_jit_operand(jc, NJS_JIT_RCX, code->property);
+    njs_jit_guard_type(jc, NJS_JIT_RCX, NJS_NUMBER, NJS_JIT_NE, pc);
+    njs_jit_operand(jc, NJS_JIT_RDX, code->value);
+
+    if (set) {
+        njs_jit_guard_type(jc, NJS_JIT_RDX, NJS_INVALID, NJS_JIT_E, pc);
+
+    } else {
+        njs_jit_guard_dst(jc, NJS_JIT_RDX, code->value, pc);
+    }
+
+    njs_jit_mem(jc, 0, 1, NJS_JIT_MOV_LOAD, NJS_JIT_RAX, NJS_JIT_RAX,
+                offsetof(njs_value_t, data.u.array));
+    njs_jit_mem(jc, 0, 0, NJS_JIT_TEST_IMM8, 0, NJS_JIT_RAX, jc->fast_array);
+    njs_jit_byte(jc, jc->fast_array_mask);
+    njs_jit_exit_jump(jc, NJS_JIT_E, pc);
+
+    njs_jit_mem(jc, 0xf2, 0, NJS_JIT_MOVSD_LOAD, NJS_JIT_XMM0, NJS_JIT_RCX,
+                offsetof(njs_value_t, data.u.number));
+    njs_jit_reg(jc, 0xf2, 1, NJS_JIT_CVTTSD2SI, NJS_JIT_RCX, NJS_JIT_XMM0);
+    njs_jit_reg(jc, 0xf2, 1, NJS_JIT_CVTSI2SD, NJS_JIT_XMM1, NJS_JIT_RCX);
+    njs_jit_reg(jc, 0x66, 0, NJS_JIT_UCOMISD, NJS_JIT_XMM0, NJS_JIT_XMM1);
+    njs_jit_exit_jump(jc, NJS_JIT_NE, pc);
+    njs_jit_exit_jump(jc, NJS_JIT_P, pc);
+
+    /* Negative indexes are above the length as unsigned numbers. */
+
+    njs_jit_mem(jc, 0, 0, NJS_JIT_MOV_LOAD, NJS_JIT_RSI, NJS_JIT_RAX,
+                offsetof(njs_array_t, length));
+    njs_jit_reg(jc, 0, 1, NJS_JIT_CMP, NJS_JIT_RSI, NJS_JIT_RCX);
+    njs_jit_exit_jump(jc, NJS_JIT_AE, pc);
+
+    njs_jit_mem(jc, 0, 1, NJS_JIT_MOV_LOAD, NJS_JIT_RAX, NJS_JIT_RAX,
+                offsetof(njs_array_t, start));
+    njs_jit_reg(jc, 0, 1, NJS_JIT_SHIFT_IMM, 4, NJS_JIT_RCX);
+    njs_jit_byte(jc, 4);
+    njs_jit_reg(jc, 0, 1, NJS_JIT_ADD, NJS_JIT_RCX, NJS_JIT_RAX);
+
+    if (set) {
+        njs_jit_copy(jc, NJS_JIT_RAX, NJS_JIT_RDX);
+        return;
+    }
+
+    /* A hole is looked up in the prototypes. */
+
+    njs_jit_guard_type(jc, NJS_JIT_RAX, NJS_INVALID, NJS_JIT_E, pc);
+    njs_jit_copy(jc, NJS_JIT_RDX, NJS_JIT_RAX);
+}
+
+
+/* Only the length of fast arrays is read without the interpreter. */
+
+static void
+njs_jit_length(njs_jit_compiler_t *jc, u_char *pc)
+{
+    njs_value_t            *key;
+    njs_vmcode_prop_get_t  *code;
+
+    code = (njs_vmcode_prop_get_t *) pc;
+
+    if (njs_scope_index_type(code->property) != NJS_LEVEL_STATIC) {
+        njs_jit_return(jc, pc);
+        return;
+    }
+
+    key = njs_scope_value(jc->vm, code->property);
+
+    if (key->atom_id != NJS_ATOM_STRING_length) {
+        njs_jit_return(jc, pc);
+        return;
+    }
+
+    njs_jit_operand(jc, NJS_JIT_RAX, code->object);
+    njs_jit_guard_type(jc, NJS_JIT_RAX, NJS_ARRAY, NJS_JIT_NE, pc);
+    njs_jit_operand(jc, NJS_JIT_RDX, code->value);
+    njs_jit_guard_dst(jc, NJS_JIT_RDX, code->value, pc);
+
+    njs_jit_mem(jc, 0, 1, NJS_JIT_MOV_LOAD, NJS_JIT_RAX, NJS_JIT_RAX,
+                offsetof(njs_value_t, data.u.array));
+    njs_jit_mem(jc, 0, 0, NJS_JIT_TEST_IMM8, 0, NJS_JIT_RAX, jc->fast_array);
+    njs_jit_byte(jc, jc->fast_array_mask);
+    njs_jit_exit_jump(jc, NJS_JIT_E, pc);
+
+    njs_jit_mem(jc, 0, 0, NJS_JIT_MOV_LOAD, NJS_JIT_RAX, NJS_JIT_RAX,
+                offsetof(njs_array_t, length));
+    njs_jit_reg(jc, 0xf2, 1, NJS_JIT_CVTSI2SD, NJS_JIT_XMM0, NJS_JIT_RAX);
+
+    njs_jit_set_number(jc, NJS_JIT_RDX);
+}
+
+
+static void
+njs_jit_operand(njs_jit_compiler_t *jc, njs_uint_t reg, njs_index_t index)
+{
+    njs_uint_t  level;
+
+    level = njs_scope_index_type(index);
+
+    if (level >= NJS_LEVEL_MAX) {
+        jc->failed = 1;
+        return;
+    }
+
+    njs_jit_mem(jc, 0, 1, NJS_JIT_MOV_LOAD, reg, NJS_JIT_R12 + level,
+                njs_scope_index_value(index) * sizeof(njs_value_t *));
+}
+
+
+static void
+njs_jit_guard_type(njs_jit_compiler_t *jc, njs_uint_t reg,
+    njs_value_type_t type, njs_uint_t cc, u_char *pc)
+{
+    njs_jit_mem(jc, 0, 0, NJS_JIT_CMP_IMM8, 7, reg, jc->type);
+    njs_jit_byte(jc, type);
+    njs_jit_exit_jump(jc, cc, pc);
+}
+
+
+/*
+ * A destination which is not initialized yet is set by the interpreter,
+ * as a let or const variable it throws an exception.  Other variables
+ * are overwritten as is.
+ */
+
+static void
+njs_jit_guard_dst(njs_jit_compiler_t *jc, njs_uint_t reg, njs_index_t index,
+    u_char *pc)
+{
+    if (njs_scope_index_var(index) <= NJS_VARIABLE_LET) {
+        njs_jit_guard_type(jc, reg, NJS_INVALID, NJS_JIT_E, pc);
+    }
+}
+
+
+/* The value in reg is set to the number in xmm0, rax and xmm1 are spoiled. */
+
+static void
+njs_jit_set_number(njs_jit_compiler_t *jc, njs_uint_t reg)
+{
+    njs_jit_mem(jc, 0xf2, 0, NJS_JIT_MOVSD_STORE, NJS_JIT_XMM0, reg,
+                offsetof(njs_value_t, data.u.number));
+
+    njs_jit_mem(jc, 0, 0, NJS_JIT_MOV_IMM8, 0, reg, jc->type);
+    njs_jit_byte(jc, NJS_NUMBER);
+
+    njs_jit_reg(jc, 0x66, 0, NJS_JIT_XORPD, NJS_JIT_XMM1, NJS_JIT_XMM1);
+    njs_jit_reg(jc, 0x66, 0, NJS_JIT_UCOMISD, NJS_JIT_XMM0, NJS_JIT_XMM1);
+    njs_jit_reg(jc, 0, 0, NJS_JIT_SETCC | NJS_JIT_NE, 0, NJS_JIT_RAX);
+    njs_jit_mem(jc, 0, 0, NJS_JIT_MOV_STORE8, NJS_JIT_RAX, reg,
+                offsetof(njs_value_t, data.truth));
+
+    njs_jit_mem(jc, 0, 0, NJS_JIT_MOV_IMM32, 0, reg,
+                offsetof(njs_value_t, atom_id));
+    njs_jit_u32(jc, 0);
+}
+
+
+/*
+ * The value in reg is set to the boolean in al, rsi, rdi and xmm0
+ * are spoiled.
+ */
+
+static void
+njs_jit_set_boolean(njs_jit_compiler_t *jc, njs_uint_t reg)
+{
+    njs_jit_imm64(jc, NJS_JIT_RSI, (uintptr_t) &njs_value_false);
+    njs_jit_imm64(jc, NJS_JIT_RDI, (uintptr_t) &njs_value_true);
+    njs_jit_reg(jc, 0, 0, NJS_JIT_TEST8, NJS_JIT_RAX, NJS_JIT_RAX);
+    njs_jit_reg(jc, 0, 1, NJS_JIT_CMOVNE, NJS_JIT_RSI, NJS_JIT_RDI);
+
+    njs_jit_copy(jc, reg, NJS_JIT_RSI);
+}
+
+
+static void
+njs_jit_copy(njs_jit_compiler_t *jc, njs_uint_t dst, njs_uint_t src)
+{
+    njs_jit_mem(jc, 0xf3, 0, NJS_JIT_MOVDQU_LOAD, NJS_JIT_XMM0, src, 0);
+    njs_jit_mem(jc, 0xf3, 0, NJS_JIT_MOVDQU_STORE, NJS_JIT_XMM0, dst, 0);
+}
+
+
+/*
+ * The number in xmm is truncated to a 64-bit integer in reg, numbers
+ * out of its range, infinities and NaN leave the native code.
+ */
+
+static void
+njs_jit_to_integer(njs_jit_compiler_t *jc, njs_uint_t reg, njs_uint_t xmm,
+    u_char *pc)
+{
+    njs_jit_reg(jc, 0xf2, 1, NJS_JIT_CVTTSD2SI, reg, xmm);
+    njs_jit_imm64(jc, NJS_JIT_RSI, NJS_JIT_INTEGER_INDEFINITE);
+    njs_jit_reg(jc, 0, 1, NJS_JIT_CMP, NJS_JIT_RSI, reg);
+    njs_jit_exit_jump(jc, NJS_JIT_E, pc);
+}
+
+
+/*
+ * "mov rax, &njs_profile_pending; cmp dword [rax], 0; je skip;
+ *  mov rdi, rbx; mov rsi, pc; mov rax, njs_profile_sample; call rax".
+ */
+
+static void
+njs_jit_safepoint(njs_jit_compiler_t *jc, u_char *pc, njs_jump_off_t offset)
+{
+    u_char  *skip;
+
+    if (offset >= 0) {
+        return;
+    }
+
+    njs_jit_imm64(jc, NJS_JIT_RAX, (uintptr_t) &njs_profile_pending);
+    njs_jit_mem(jc, 0, 0, NJS_JIT_CMP32_IMM8, 7, NJS_JIT_RAX, 0);
+    njs_jit_byte(jc, 0);
+
+    njs_jit_byte(jc, 0x70 | NJS_JIT_E);
+    skip = jc->pos++;
+
+    njs_jit_reg(jc, 0, 1, NJS_JIT_MOV, NJS_JIT_RBX, NJS_JIT_RDI);
+    njs_jit_imm64(jc, NJS_JIT_RSI, (uintptr_t) pc);
+    njs_jit_imm64(jc, NJS_JIT_RAX, (uintptr_t) njs_profile_sample);
+    njs_jit_byte(jc, 0xff);
+    njs_jit_byte(jc, 0xd0);
+
+    *skip = (u_char) (jc->pos - skip - 1);
+}
+
+
+static void
+njs_jit_jump(njs_jit_compiler_t *jc, njs_uint_t cc, u_char *pc,
+    njs_jump_off_t offset)
+{
+    njs_jump_off_t  target;
+
+    target = (pc - jc->code) + offset;
+
+    if (target < 0
+        || target >= jc->end - jc->code
+        || target % sizeof(uint64_t) != 0)
+    {
+        jc->failed = 1;
+        return;
+    }
+
+    if (cc == NJS_JIT_ALWAYS) {
+        njs_jit_byte(jc, 0xe9);
+
+    } else {
+        njs_jit_opcode(jc, 0, 0, NJS_JIT_JCC | cc, 0, 0);
+    }
+
+    njs_jit_fixup(jc, jc->jumps, target);
+}
+
+
+static void
+njs_jit_exit_jump(njs_jit_compiler_t *jc, njs_uint_t cc, u_char *pc)
+{
+    njs_jit_opcode(jc, 0, 0, NJS_JIT_JCC | cc, 0, 0);
+    njs_jit_fixup(jc, jc->exits, pc - jc->code);
+}
+
+
+/* "mov rax, pc; pop r15; pop r14; pop r13; pop r12; pop rbx; ret". */
+
+static void
+njs_jit_return(njs_jit_compiler_t *jc, u_char *pc)
+{
+    njs_uint_t  i;
+
+    njs_jit_imm64(jc, NJS_JIT_RAX, (uintptr_t) pc);
+
+    for (i = NJS_LEVEL_MAX; i != 0; i--) {
+        njs_jit_byte(jc, 0x41);
+        njs_jit_byte(jc, 0x58 + ((NJS_JIT_R12 + i - 1) & 7));
+    }
+
+    njs_jit_byte(jc, 0x58 + NJS_JIT_RBX);
+    njs_jit_byte(jc, 0xc3);
+}
+
+
+static void
+njs_jit_fixup(njs_jit_compiler_t *jc, njs_arr_t *fixups, uint32_t target)
+{
+    njs_jit_fixup_t  *fixup;
+
+    fixup = njs_arr_add(fixups);
+    if (njs_slow_path(fixup == NULL)) {
+        jc->failed = 1;
+        return;
+    }
+
+    fixup->pos = jc->pos - jc->start;
+    fixup->target = target;
+
+    njs_jit_u32(jc, 0);
+}
+
+
+static void
+njs_jit_patch(njs_jit_compiler_t *jc, uint32_t pos, uint32_t target)
+{
+    int32_t  rel;
+
+    rel = (int32_t) target - (int32_t) (pos + sizeof(int32_t));
+
+    memcpy(jc->start + pos, &rel, sizeof(int32_t));
+}
+
+
+/* An instruction with a [base + disp32] memory operand. */
+
+static void
+njs_jit_mem(njs_jit_compiler_t *jc, njs_uint_t prefix, njs_uint_t w,
+    njs_uint_t op, njs_uint_t reg, njs_uint_t base, int32_t disp)
+{
+    njs_jit_opcode(jc, prefix, w, op, reg, base);
+
+    njs_jit_byte(jc, 0x80 | (reg & 7) << 3 | (base & 7));
+
+    if ((base & 7) == NJS_JIT_RSP) {
+        njs_jit_byte(jc, 0x24);
+    }
+
+    njs_jit_u32(jc, disp);
+}
+
+
+/* An instruction with register operands. */
+
+static void
+njs_jit_reg(njs_jit_compiler_t *jc, njs_uint_t prefix, njs_uint_t w,
+    njs_uint_t op, njs_uint_t reg, njs_uint_t rm)
+{
+    njs_jit_opcode(jc, prefix, w, op, reg, rm);
+
+    njs_jit_byte(jc, 0xc0 | (reg & 7) << 3 | (rm & 7));
+}
+
+
+static void
+njs_jit_opcode(njs_jit_compiler_t *jc, njs_uint_t prefix, njs_uint_t w,
+    njs_uint_t op, njs_uint_t reg, njs_uint_t rm)
+{
+    if (prefix != 0) {
+        njs_jit_byte(jc, prefix);
+    }
+
+    if (w || reg >= 8 || rm >= 8) {
+        njs_jit_byte(jc, 0x40 | w << 3 | (reg >> 3) << 2 | (rm >> 3));
+    }
+
+    if (op > 0xff) {
+        njs_jit_byte(jc, op >> 8);
+    }
+
+    njs_jit_byte(jc, op);
+}
+
+
+static void
+njs_jit_imm64(njs_jit_compiler_t *jc, njs_uint_t reg, uint64_t imm)
+{
+    njs_jit_byte(jc, 0x48 | (reg >> 3));
+    njs_jit_byte(jc, 0xb8 + (reg & 7));
+
+    jc->pos = njs_cpymem(jc->pos, &imm, sizeof(uint64_t));
+}
+
+
+static void
+njs_jit_cleanup(void *data)
+{
+    njs_jit_t         *jit;
+    njs_jit_region_t  *region, *next;
+
+    jit = data;
+
+    for (region = jit->regions; region != NULL; region = next) {
+        next = region->next;
+        (void) munmap(region, region->size);
+    }
+}
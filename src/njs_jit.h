@@ -0,0 +1,40 @@
+
+/*
+ * Copyright (C) NGINX, Inc.
+ */
+
+#ifndef _NJS_JIT_H_INCLUDED_
+#define _NJS_JIT_H_INCLUDED_
+
+
+#if (NJS_HAVE_JIT)
+
+/* The number of calls after which a function is compiled. */
+#ifndef NJS_JIT_THRESHOLD
+#define NJS_JIT_THRESHOLD  1000
+#endif
+
+
+typedef struct njs_jit_s       njs_jit_t;
+typedef struct njs_jit_code_s  njs_jit_code_t;
+
+/*
+ * Compiled code runs a function from the native code "entry" of one of its
+ * instructions and returns the address of the instruction at which
+ * the interpreter continues.
+ */
+typedef u_char *(*njs_jit_code_pt)(njs_vm_t *vm, u_char *entry);
+
+
+njs_int_t njs_jit_init(njs_vm_t *vm);
+u_char *njs_jit_enter(njs_vm_t *vm, njs_function_lambda_t *lambda);
+u_char *njs_jit_run(njs_vm_t *vm, njs_function_lambda_t *lambda, u_char *pc);
+
+#else
+
+#define njs_jit_enter(vm, lambda)  ((lambda)->start)
+
+#endif
+
+
+#endif /* _NJS_JIT_H_INCLUDED_ */
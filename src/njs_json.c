@@ -55,10 +55,14 @@ static const u_char *njs_json_parse_object(njs_json_parse_ctx_t *ctx,
 static const u_char *njs_json_parse_array(njs_json_parse_ctx_t *ctx,
     njs_value_t *value, const u_char *p);
 static const u_char *njs_json_parse_string(njs_json_parse_ctx_t *ctx,
-    njs_value_t *value, const u_char *p);
+    njs_value_t *value, const u_char *p, njs_bool_t key);
+static njs_int_t njs_json_key_create(njs_vm_t *vm, njs_value_t *value,
+    const u_char *start, size_t size);
 static const u_char *njs_json_parse_number(njs_json_parse_ctx_t *ctx,
     njs_value_t *value, const u_char *p);
 njs_inline uint32_t njs_json_unicode(const u_char *p);
+njs_inline const u_char *njs_json_skip_string(const u_char *p,
+    const u_char *end);
 static const u_char *njs_json_skip_space(const u_char *start,
     const u_char *end);
 
@@ -105,11 +109,9 @@ njs_json_parse(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
 
     text = njs_lvalue_arg(&lvalue, args, nargs, 1);
 
-    if (njs_slow_path(!njs_is_string(text))) {
-        ret = njs_value_to_string(vm, text, text);
-        if (njs_slow_path(ret != NJS_OK)) {
-            return ret;
-        }
+    ret = njs_value_to_string(vm, text, text);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return ret;
     }
 
     (void) njs_string_prop(vm, &string, text);
@@ -224,6 +226,10 @@ njs_json_stringify(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
 
     switch (space->type) {
     case NJS_STRING:
+        if (njs_slow_path(njs_string_flatten(vm, space) != NJS_OK)) {
+            return NJS_ERROR;
+        }
+
         length = njs_string_prop(vm, &prop, space);
         p = njs_string_offset(&prop, njs_min(length, 10));
 
@@ -289,7 +295,7 @@ njs_json_parse_value(njs_json_parse_ctx_t *ctx, njs_value_t *value,
         return njs_json_parse_array(ctx, value, p);
 
     case '"':
-        return njs_json_parse_string(ctx, value, p);
+        return njs_json_parse_string(ctx, value, p, 0);
 
     case 't':
         if (njs_fast_path(ctx->end - p >= 4 && memcmp(p, "true", 4) == 0)) {
@@ -372,7 +378,7 @@ njs_json_parse_object(njs_json_parse_ctx_t *ctx, njs_value_t *value,
             goto error_token;
         }
 
-        p = njs_json_parse_string(ctx, &prop_name, p);
+        p = njs_json_parse_string(ctx, &prop_name, p, 1);
         if (njs_slow_path(p == NULL)) {
             /* The exception is set by the called function. */
             return NULL;
@@ -537,13 +543,13 @@ error_end:
 
 static const u_char *
 njs_json_parse_string(njs_json_parse_ctx_t *ctx, njs_value_t *value,
-    const u_char *p)
+    const u_char *p, njs_bool_t key)
 {
     u_char        ch, *s, *dst;
     size_t        size, surplus;
     uint32_t      utf, utf_low;
     njs_int_t     ret;
-    const u_char  *start, *last;
+    const u_char  *start, *last, *q;
 
     enum {
         sw_usual = 0,
@@ -561,6 +567,16 @@ njs_json_parse_string(njs_json_parse_ctx_t *ctx, njs_value_t *value,
     surplus = 0;
 
     for (p = start; p < ctx->end; p++) {
+
+        if (state == sw_usual) {
+            /* Plain characters are skipped at once. */
+
+            p = njs_json_skip_string(p, ctx->end);
+            if (njs_slow_path(p == ctx->end)) {
+                break;
+            }
+        }
+
         ch = *p;
 
         switch (state) {
@@ -659,14 +675,18 @@ njs_json_parse_string(njs_json_parse_ctx_t *ctx, njs_value_t *value,
         s = dst;
 
         do {
-            ch = *p++;
+            q = njs_json_skip_string(p, last);
+            s = njs_cpymem(s, p, q - p);
+            p = q;
 
-            if (ch != '\\') {
-                *s++ = ch;
-                continue;
+            if (p == last) {
+                break;
             }
 
-            ch = *p++;
+            /* Skips the backslash. */
+
+            ch = p[1];
+            p += 2;
 
             switch (ch) {
             case '"':
@@ -734,7 +754,13 @@ njs_json_parse_string(njs_json_parse_ctx_t *ctx, njs_value_t *value,
         start = dst;
     }
 
-    ret = njs_atom_string_create(ctx->vm, value, (u_char *) start, size);
+    if (key) {
+        ret = njs_json_key_create(ctx->vm, value, start, size);
+
+    } else {
+        ret = njs_string_create(ctx->vm, value, start, size);
+    }
+
     if (njs_slow_path(ret != NJS_OK)) {
         return NULL;
     }
@@ -747,6 +773,35 @@ njs_json_parse_string(njs_json_parse_ctx_t *ctx, njs_value_t *value,
 }
 
 
+/*
+ * Object keys are mostly short ASCII names repeated across objects, so
+ * an existing atom is looked up by the source bytes without creating
+ * a string.  Keys starting with a digit may be integer indexes.
+ */
+
+static njs_int_t
+njs_json_key_create(njs_vm_t *vm, njs_value_t *value, const u_char *start,
+    size_t size)
+{
+    uint32_t           hash;
+    const njs_value_t  *entry;
+
+    if ((size == 0 || start[0] < '0' || start[0] > '9')
+        && njs_utf8_ascii_size(start, start + size) == size)
+    {
+        hash = njs_djb_hash(start, size);
+
+        entry = njs_atom_find(vm, (u_char *) start, size, hash);
+        if (entry != NULL) {
+            *value = *entry;
+            return NJS_OK;
+        }
+    }
+
+    return njs_atom_string_create(vm, value, start, size);
+}
+
+
 static const u_char *
 njs_json_parse_number(njs_json_parse_ctx_t *ctx, njs_value_t *value,
     const u_char *p)
@@ -792,12 +847,85 @@ njs_json_unicode(const u_char *p)
 }
 
 
+#if (NJS_SIMD_SIZE)
+
+/* Quotes, backslashes and control characters. */
+
+njs_inline uint64_t
+njs_json_simd_special(njs_simd_t v)
+{
+    return njs_simd_mask(njs_simd_or(njs_simd_or(njs_simd_eq(v, '"'),
+                                                 njs_simd_eq(v, '\\')),
+                                     njs_simd_range(v, 0x00, 0x1f)));
+}
+
+
+njs_inline uint64_t
+njs_json_simd_space(njs_simd_t v)
+{
+    return njs_simd_mask(njs_simd_or(njs_simd_or(njs_simd_eq(v, ' '),
+                                                 njs_simd_eq(v, '\n')),
+                                     njs_simd_or(njs_simd_eq(v, '\r'),
+                                                 njs_simd_eq(v, '\t'))));
+}
+
+#endif
+
+
+/* Returns the first quote, backslash or control character. */
+
+njs_inline const u_char *
+njs_json_skip_string(const u_char *p, const u_char *end)
+{
+#if (NJS_SIMD_SIZE)
+    uint64_t  mask;
+
+    while (end - p >= NJS_SIMD_SIZE) {
+        mask = njs_json_simd_special(njs_simd_load(p));
+
+        if (mask != 0) {
+            return p + njs_trailing_zeros64(mask) / NJS_SIMD_MASK_BITS;
+        }
+
+        p += NJS_SIMD_SIZE;
+    }
+#endif
+
+    while (p < end && *p != '"' && *p != '\\' && *p >= ' ') {
+        p++;
+    }
+
+    return p;
+}
+
+
 static const u_char *
 njs_json_skip_space(const u_char *start, const u_char *end)
 {
     const u_char  *p;
+#if (NJS_SIMD_SIZE)
+    uint64_t      mask;
+#endif
+
+    p = start;
+
+#if (NJS_SIMD_SIZE)
+
+    /* Indentation of pretty printed JSON. */
+
+    while (end - p >= NJS_SIMD_SIZE && *p <= ' ') {
+        mask = njs_json_simd_space(njs_simd_load(p));
 
-    for (p = start; njs_fast_path(p != end); p++) {
+        if (mask != NJS_SIMD_MASK_ALL) {
+            return p + njs_trailing_zeros64(~mask) / NJS_SIMD_MASK_BITS;
+        }
+
+        p += NJS_SIMD_SIZE;
+    }
+
+#endif
+
+    for ( /* void */ ; njs_fast_path(p != end); p++) {
 
         switch (*p) {
         case ' ':
@@ -1434,6 +1562,10 @@ njs_json_append_value(njs_vm_t *vm, njs_chb_t *chain, njs_value_t *value)
 
     switch (value->type) {
     case NJS_STRING:
+        if (njs_slow_path(njs_string_flatten(vm, value) != NJS_OK)) {
+            return NJS_ERROR;
+        }
+
         njs_json_append_string(vm, chain, value, '\"');
         break;
 
@@ -1678,7 +1810,10 @@ njs_dump_terminal(njs_json_stringify_t *stringify, njs_chb_t *chain,
         break;
 
     case NJS_STRING:
-        njs_string_get(stringify->vm, value, &str);
+        ret = njs_string_get_checked(stringify->vm, value, &str);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return NJS_ERROR;
+        }
 
         if (!console || stringify->depth != 0) {
             njs_json_append_string(stringify->vm, chain, value, '\'');
@@ -1749,6 +1884,11 @@ njs_dump_terminal(njs_json_stringify_t *stringify, njs_chb_t *chain,
 
         case NJS_STRING:
         default:
+            ret = njs_string_flatten(stringify->vm, value);
+            if (njs_slow_path(ret != NJS_OK)) {
+                return NJS_ERROR;
+            }
+
             njs_chb_append_literal(chain, "[String: ");
             njs_json_append_string(stringify->vm, chain, value, '\'');
             njs_chb_append_literal(chain, "]");
@@ -1772,7 +1912,10 @@ njs_dump_terminal(njs_json_stringify_t *stringify, njs_chb_t *chain,
         }
 
         if (njs_is_string(&tag)) {
-            njs_string_get(stringify->vm, &tag, &str);
+            ret = njs_string_get_checked(stringify->vm, &tag, &str);
+            if (njs_slow_path(ret != NJS_OK)) {
+                return NJS_ERROR;
+            }
         }
 
         if (str.length != 0) {
@@ -1792,6 +1935,11 @@ njs_dump_terminal(njs_json_stringify_t *stringify, njs_chb_t *chain,
         }
 
         if (ret == NJS_OK) {
+            ret = njs_string_flatten(stringify->vm, &tag);
+            if (njs_slow_path(ret != NJS_OK)) {
+                return NJS_ERROR;
+            }
+
             (void) njs_string_prop(stringify->vm, &string, &tag);
             njs_chb_append(chain, string.start, string.size);
             njs_chb_append_literal(chain, " ");
@@ -1847,7 +1995,10 @@ njs_dump_terminal(njs_json_stringify_t *stringify, njs_chb_t *chain,
             return NJS_ERROR;
         }
 
-        njs_string_get(stringify->vm, &str_val, &str);
+        ret = njs_string_get_checked(stringify->vm, &str_val, &str);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return NJS_ERROR;
+        }
         njs_chb_append_str(chain, &str);
 
         break;
@@ -2010,6 +2161,11 @@ njs_vm_value_dump(njs_vm_t *vm, njs_str_t *retval, njs_value_t *value,
             }
 
             if (ret == NJS_OK) {
+                ret = njs_string_flatten(vm, &tag);
+                if (njs_slow_path(ret != NJS_OK)) {
+                    return NJS_ERROR;
+                }
+
                 (void) njs_string_prop(vm, &string, &tag);
                 njs_chb_append(&chain, string.start, string.size);
                 njs_chb_append_literal(&chain, " ");
@@ -13,6 +13,7 @@
 #include <njs_unix.h>
 #include <njs_types.h>
 #include <njs_clang.h>
+#include <njs_simd.h>
 #include <njs_str.h>
 #include <njs_unicode.h>
 #include <njs_utf8.h>
@@ -38,6 +39,7 @@
 
 #include <njs.h>
 #include <njs_value.h>
+#include <njs_jit.h>
 
 #include <njs_vm.h>
 #include <njs_object_prop_declare.h>
@@ -50,7 +52,9 @@
 #include <njs_variable.h>
 #include <njs_lexer.h>
 #include <njs_parser.h>
+#include <njs_optimizer.h>
 #include <njs_generator.h>
+#include <njs_profile.h>
 #include <njs_scope.h>
 
 #include <njs_boolean.h>
@@ -19,6 +19,11 @@
  * sizes of the clusters and large allocations are stored in rbtree blocks
  * to find them on free operations.  The rbtree nodes are sorted by start
  * addresses.
+ *
+ * An arena pool allocates memory by bumping a pointer inside of blocks which
+ * sizes grow geometrically, the free operation does nothing.  The memory is
+ * released only when the pool is destroyed.  Allocations which do not fit in
+ * a half of the next block get a block of their own.
  */
 
 
@@ -48,6 +53,9 @@ typedef struct {
 
     /* Chunk bitmap.  There can be no more than 32 chunks in a page. */
     uint8_t                     map[4];
+
+    /* Bitmap of chunks reached by njs_mp_mark(). */
+    uint8_t                     marks[4];
 } njs_mp_page_t;
 
 
@@ -71,6 +79,9 @@ typedef struct {
     NJS_RBTREE_NODE             (node);
     njs_mp_block_type_t         type:8;
 
+    /* A large allocation is reached by njs_mp_mark(). */
+    uint8_t                     mark;
+
     /* Block size must be less than 4G. */
     uint32_t                    size;
 
@@ -79,6 +90,14 @@ typedef struct {
 } njs_mp_block_t;
 
 
+typedef struct njs_mp_arena_s  njs_mp_arena_t;
+
+struct njs_mp_arena_s {
+    njs_mp_arena_t              *next;
+    size_t                      size;
+};
+
+
 typedef struct {
     njs_queue_t                 pages;
 
@@ -106,6 +125,17 @@ struct njs_mp_s {
     uint32_t                    page_alignment;
     uint32_t                    cluster_size;
 
+    /* Total size of clusters and large allocations, or of arena blocks. */
+    size_t                      size;
+
+    /* Blocks of an arena pool, the current one is the first. */
+    njs_mp_arena_t              *arena;
+    u_char                      *arena_pos;
+    u_char                      *arena_end;
+
+    /* Size of the allocations of an arena pool, with the alignment. */
+    size_t                      arena_used;
+
     njs_mp_cleanup_t            *cleanup;
 
     njs_mp_slot_t               slots[];
@@ -128,6 +158,12 @@ struct njs_mp_s {
     ((((value) - 1) & (value)) == 0)
 
 
+#define NJS_MP_ARENA_HEADER                                                   \
+    njs_align_size(sizeof(njs_mp_arena_t), NJS_MAX_ALIGNMENT)
+
+#define NJS_MP_ARENA_MAX  (1024 * 1024)
+
+
 static njs_uint_t njs_mp_shift(njs_uint_t n);
 #if !(NJS_DEBUG_MEMORY)
 static void *njs_mp_alloc_small(njs_mp_t *mp, size_t size);
@@ -136,12 +172,15 @@ static njs_mp_page_t *njs_mp_alloc_page(njs_mp_t *mp);
 static njs_mp_block_t *njs_mp_alloc_cluster(njs_mp_t *mp);
 #endif
 static void *njs_mp_alloc_large(njs_mp_t *mp, size_t alignment, size_t size);
+static void *njs_mp_arena_alloc(njs_mp_t *mp, size_t alignment, size_t size);
+static njs_mp_arena_t *njs_mp_arena_block(njs_mp_t *mp, size_t size);
 static intptr_t njs_mp_rbtree_compare(njs_rbtree_node_t *node1,
     njs_rbtree_node_t *node2);
 static njs_mp_block_t *njs_mp_find_block(njs_rbtree_t *tree,
     u_char *p);
 static const char *njs_mp_chunk_free(njs_mp_t *mp, njs_mp_block_t *cluster,
     u_char *p);
+static void njs_mp_sweep_cluster(njs_mp_t *mp, njs_mp_block_t *cluster);
 
 
 njs_mp_t *
@@ -223,6 +262,45 @@ njs_mp_fast_create(size_t cluster_size, size_t page_alignment, size_t page_size,
 }
 
 
+njs_mp_t *
+njs_mp_arena_create(size_t size)
+{
+    njs_mp_t        *mp;
+    njs_mp_arena_t  *arena;
+
+    mp = njs_zalloc(sizeof(njs_mp_t));
+    if (njs_slow_path(mp == NULL)) {
+        return NULL;
+    }
+
+    mp->page_alignment = NJS_MAX_ALIGNMENT;
+
+    njs_rbtree_init(&mp->blocks, njs_mp_rbtree_compare);
+    njs_queue_init(&mp->free_pages);
+
+    size = njs_align_size(NJS_MP_ARENA_HEADER + size, njs_pagesize());
+
+    arena = njs_mp_arena_block(mp, njs_min(size, NJS_MP_ARENA_MAX));
+    if (njs_slow_path(arena == NULL)) {
+        njs_free(mp);
+        return NULL;
+    }
+
+    mp->arena = arena;
+    mp->arena_pos = (u_char *) arena + NJS_MP_ARENA_HEADER;
+    mp->arena_end = (u_char *) arena + arena->size;
+
+    return mp;
+}
+
+
+njs_bool_t
+njs_mp_is_arena(njs_mp_t *mp)
+{
+    return (mp->arena != NULL);
+}
+
+
 static njs_uint_t
 njs_mp_shift(njs_uint_t n)
 {
@@ -252,6 +330,7 @@ void
 njs_mp_destroy(njs_mp_t *mp)
 {
     void               *p;
+    njs_mp_arena_t     *arena;
     njs_mp_block_t     *block;
     njs_mp_cleanup_t   *c;
     njs_rbtree_node_t  *node, *next;
@@ -265,6 +344,13 @@ njs_mp_destroy(njs_mp_t *mp)
         }
     }
 
+    while (mp->arena != NULL) {
+        arena = mp->arena;
+        mp->arena = arena->next;
+
+        njs_free(arena);
+    }
+
     next = njs_rbtree_root(&mp->blocks);
 
     while (next != njs_rbtree_sentinel(&mp->blocks)) {
@@ -288,9 +374,24 @@ njs_mp_destroy(njs_mp_t *mp)
 void
 njs_mp_stat(njs_mp_t *mp, njs_mp_stat_t *stat)
 {
+    njs_mp_arena_t     *arena;
     njs_mp_block_t     *block;
     njs_rbtree_node_t  *node;
 
+    if (mp->arena != NULL) {
+        stat->size = mp->size;
+        stat->used = mp->arena_used;
+        stat->nblocks = 0;
+        stat->cluster_size = mp->arena->size;
+        stat->page_size = 0;
+
+        for (arena = mp->arena; arena != NULL; arena = arena->next) {
+            stat->nblocks++;
+        }
+
+        return;
+    }
+
     stat->size = 0;
     stat->nblocks = 0;
     stat->cluster_size = mp->cluster_size;
@@ -306,6 +407,8 @@ njs_mp_stat(njs_mp_t *mp, njs_mp_stat_t *stat)
 
         node = njs_rbtree_node_successor(&mp->blocks, node);
     }
+
+    stat->used = stat->size;
 }
 
 
@@ -314,6 +417,10 @@ njs_mp_alloc(njs_mp_t *mp, size_t size)
 {
     njs_debug_alloc("mp alloc: %uz\n", size);
 
+    if (mp->arena != NULL) {
+        return njs_mp_arena_alloc(mp, NJS_MAX_ALIGNMENT, size);
+    }
+
 #if !(NJS_DEBUG_MEMORY)
 
     if (size <= mp->page_size) {
@@ -350,6 +457,11 @@ njs_mp_align(njs_mp_t *mp, size_t alignment, size_t size)
 
     if (njs_fast_path(njs_is_power_of_two(alignment))) {
 
+        if (mp->arena != NULL) {
+            return njs_mp_arena_alloc(mp, njs_max(alignment, NJS_MAX_ALIGNMENT),
+                                      size);
+        }
+
 #if !(NJS_DEBUG_MEMORY)
 
         if (size <= mp->page_size && alignment <= mp->page_alignment) {
@@ -573,6 +685,8 @@ njs_mp_alloc_cluster(njs_mp_t *mp)
 
     njs_rbtree_insert(&mp->blocks, &cluster->node);
 
+    mp->size += mp->cluster_size;
+
     return cluster;
 }
 
@@ -629,13 +743,95 @@ njs_mp_alloc_large(njs_mp_t *mp, size_t alignment, size_t size)
     block->type = type;
     block->size = size;
     block->start = p;
+    block->mark = 0;
 
     njs_rbtree_insert(&mp->blocks, &block->node);
 
+    mp->size += size;
+
     return p;
 }
 
 
+static void *
+njs_mp_arena_alloc(njs_mp_t *mp, size_t alignment, size_t size)
+{
+    u_char          *p;
+    size_t          n;
+    njs_mp_arena_t  *arena;
+
+    p = njs_align_ptr(mp->arena_pos, alignment);
+
+    if (njs_fast_path(p <= mp->arena_end
+                      && size <= (size_t) (mp->arena_end - p)))
+    {
+        mp->arena_used += (p + size) - mp->arena_pos;
+        mp->arena_pos = p + size;
+
+        return p;
+    }
+
+    if (njs_slow_path(size >= UINT32_MAX)) {
+        return NULL;
+    }
+
+    n = njs_min(2 * mp->arena->size, NJS_MP_ARENA_MAX);
+
+    if (size + alignment > (n - NJS_MP_ARENA_HEADER) / 2) {
+        arena = njs_mp_arena_block(mp, NJS_MP_ARENA_HEADER + alignment + size);
+        if (njs_slow_path(arena == NULL)) {
+            return NULL;
+        }
+
+        /* The current block stays the first one. */
+
+        arena->next = mp->arena->next;
+        mp->arena->next = arena;
+
+        mp->arena_used += size;
+
+        return njs_align_ptr((u_char *) arena + NJS_MP_ARENA_HEADER,
+                             alignment);
+    }
+
+    arena = njs_mp_arena_block(mp, n);
+    if (njs_slow_path(arena == NULL)) {
+        return NULL;
+    }
+
+    mp->arena = arena;
+    mp->arena_end = (u_char *) arena + arena->size;
+
+    mp->arena_pos = (u_char *) arena + NJS_MP_ARENA_HEADER;
+
+    p = njs_align_ptr(mp->arena_pos, alignment);
+
+    mp->arena_used += (p + size) - mp->arena_pos;
+    mp->arena_pos = p + size;
+
+    return p;
+}
+
+
+static njs_mp_arena_t *
+njs_mp_arena_block(njs_mp_t *mp, size_t size)
+{
+    njs_mp_arena_t  *arena;
+
+    arena = njs_memalign(NJS_MAX_ALIGNMENT, size);
+    if (njs_slow_path(arena == NULL)) {
+        return NULL;
+    }
+
+    arena->next = mp->arena;
+    arena->size = size;
+
+    mp->size += size;
+
+    return arena;
+}
+
+
 static intptr_t
 njs_mp_rbtree_compare(njs_rbtree_node_t *node1, njs_rbtree_node_t *node2)
 {
@@ -687,6 +883,10 @@ njs_mp_free(njs_mp_t *mp, void *p)
 
     njs_debug_alloc("mp free: @%p\n", p);
 
+    if (mp->arena != NULL) {
+        return;
+    }
+
     block = njs_mp_find_block(&mp->blocks, p);
 
     if (njs_fast_path(block != NULL)) {
@@ -701,6 +901,8 @@ njs_mp_free(njs_mp_t *mp, void *p)
         } else if (njs_fast_path(p == block->start)) {
             njs_rbtree_delete(&mp->blocks, &block->node);
 
+            mp->size -= block->size;
+
             if (block->type == NJS_MP_DISCRETE_BLOCK) {
                 njs_free(block);
             }
@@ -719,6 +921,253 @@ njs_mp_free(njs_mp_t *mp, void *p)
 }
 
 
+size_t
+njs_mp_size(njs_mp_t *mp)
+{
+    return mp->size;
+}
+
+
+njs_mp_cleanup_t *
+njs_mp_cleanups(njs_mp_t *mp)
+{
+    return mp->cleanup;
+}
+
+
+/* Tells whether the address "p" is inside of the memory of the pool. */
+
+njs_bool_t
+njs_mp_contains(njs_mp_t *mp, void *p)
+{
+    return (njs_mp_find_block(&mp->blocks, p) != NULL);
+}
+
+
+/*
+ * Marks the allocation which contains the address "p".  Returns the start
+ * and the size of the allocation if it has not been marked yet, or NULL
+ * if the address is outside of the allocations or is already marked.
+ */
+
+void *
+njs_mp_mark(njs_mp_t *mp, void *p, size_t *size)
+{
+    u_char          *start;
+    uint8_t         mask;
+    njs_uint_t      n, chunk, chunk_size;
+    njs_mp_page_t   *page;
+    njs_mp_block_t  *block;
+
+    block = njs_mp_find_block(&mp->blocks, p);
+    if (block == NULL) {
+        return NULL;
+    }
+
+    if (block->type != NJS_MP_CLUSTER_BLOCK) {
+        if (block->mark) {
+            return NULL;
+        }
+
+        block->mark = 1;
+        *size = block->size;
+
+        return block->start;
+    }
+
+    n = ((u_char *) p - block->start) >> mp->page_size_shift;
+    page = &block->pages[n];
+
+    if (page->size == 0) {
+        return NULL;
+    }
+
+    start = block->start + (n << mp->page_size_shift);
+    chunk_size = page->size << mp->chunk_size_shift;
+
+    if (chunk_size != mp->page_size) {
+        chunk = ((u_char *) p - start) / chunk_size;
+
+        if (njs_mp_chunk_is_free(page->map, chunk)) {
+            return NULL;
+        }
+
+    } else {
+        chunk = 0;
+    }
+
+    mask = 0x80 >> (chunk & 7);
+
+    if (page->marks[chunk / 8] & mask) {
+        return NULL;
+    }
+
+    page->marks[chunk / 8] |= mask;
+    *size = chunk_size;
+
+    return start + chunk * chunk_size;
+}
+
+
+/* Frees the allocations which are not marked and clears the marks. */
+
+void
+njs_mp_sweep(njs_mp_t *mp)
+{
+    njs_mp_block_t     *block;
+    njs_rbtree_node_t  *node;
+
+    node = njs_rbtree_min(&mp->blocks);
+
+    while (njs_rbtree_is_there_successor(&mp->blocks, node)) {
+        block = (njs_mp_block_t *) node;
+
+        /* The block may be freed below. */
+        node = njs_rbtree_node_successor(&mp->blocks, node);
+
+        if (block->type == NJS_MP_CLUSTER_BLOCK) {
+            njs_mp_sweep_cluster(mp, block);
+
+        } else if (block->mark) {
+            block->mark = 0;
+
+        } else {
+            njs_mp_free(mp, block->start);
+        }
+    }
+}
+
+
+void
+njs_mp_unmark(njs_mp_t *mp)
+{
+    njs_uint_t         n;
+    njs_mp_block_t     *block;
+    njs_rbtree_node_t  *node;
+
+    node = njs_rbtree_min(&mp->blocks);
+
+    while (njs_rbtree_is_there_successor(&mp->blocks, node)) {
+        block = (njs_mp_block_t *) node;
+
+        if (block->type == NJS_MP_CLUSTER_BLOCK) {
+            n = mp->cluster_size >> mp->page_size_shift;
+
+            while (n != 0) {
+                n--;
+                njs_memzero(block->pages[n].marks, 4);
+            }
+
+        } else {
+            block->mark = 0;
+        }
+
+        node = njs_rbtree_node_successor(&mp->blocks, node);
+    }
+}
+
+
+static void
+njs_mp_sweep_cluster(njs_mp_t *mp, njs_mp_block_t *cluster)
+{
+    u_char         *start;
+    uint8_t        marks[4];
+    njs_uint_t     n, pages, chunk, chunks, chunk_size, live, dead;
+    njs_mp_page_t  *page;
+
+    live = 0;
+    dead = 0;
+
+    pages = mp->cluster_size >> mp->page_size_shift;
+
+    for (n = 0; n < pages; n++) {
+        page = &cluster->pages[n];
+
+        if (page->size == 0) {
+            continue;
+        }
+
+        chunk_size = page->size << mp->chunk_size_shift;
+
+        if (chunk_size == mp->page_size) {
+            if (page->marks[0] & 0x80) {
+                live++;
+
+            } else {
+                dead++;
+            }
+
+            continue;
+        }
+
+        chunks = mp->page_size / chunk_size;
+
+        for (chunk = 0; chunk < chunks; chunk++) {
+            if (njs_mp_chunk_is_free(page->map, chunk)) {
+                continue;
+            }
+
+            if (njs_mp_chunk_is_free(page->marks, chunk)) {
+                dead++;
+
+            } else {
+                live++;
+            }
+        }
+    }
+
+    /*
+     * The cluster is freed together with its last allocation,
+     * so the pages are not accessed after that.
+     */
+
+    for (n = 0; dead != 0; n++) {
+        page = &cluster->pages[n];
+
+        if (page->size == 0) {
+            continue;
+        }
+
+        memcpy(marks, page->marks, 4);
+        njs_memzero(page->marks, 4);
+
+        start = cluster->start + (n << mp->page_size_shift);
+        chunk_size = page->size << mp->chunk_size_shift;
+
+        if (chunk_size == mp->page_size) {
+            if (!(marks[0] & 0x80)) {
+                dead--;
+                (void) njs_mp_chunk_free(mp, cluster, start);
+            }
+
+            continue;
+        }
+
+        chunks = mp->page_size / chunk_size;
+
+        for (chunk = 0; chunk < chunks && dead != 0; chunk++) {
+            if (njs_mp_chunk_is_free(page->map, chunk)
+                || !njs_mp_chunk_is_free(marks, chunk))
+            {
+                continue;
+            }
+
+            dead--;
+            (void) njs_mp_chunk_free(mp, cluster, start + chunk * chunk_size);
+        }
+    }
+
+    if (live == 0) {
+        return;
+    }
+
+    while (n < pages) {
+        njs_memzero(cluster->pages[n].marks, 4);
+        n++;
+    }
+}
+
+
 static njs_mp_block_t *
 njs_mp_find_block(njs_rbtree_t *tree, u_char *p)
 {
@@ -847,6 +1296,8 @@ njs_mp_chunk_free(njs_mp_t *mp, njs_mp_block_t *cluster,
 
     njs_rbtree_delete(&mp->blocks, &cluster->node);
 
+    mp->size -= mp->cluster_size;
+
     p = cluster->start;
 
     njs_free(cluster);
@@ -22,6 +22,8 @@ struct njs_mp_cleanup_s {
 
 typedef struct {
     size_t                  size;
+    /* Size of the allocations of an arena pool, equals to size otherwise. */
+    size_t                  used;
     size_t                  nblocks;
     size_t                  page_size;
     size_t                  cluster_size;
@@ -33,6 +35,8 @@ NJS_EXPORT njs_mp_t *njs_mp_create(size_t cluster_size, size_t page_alignment,
 NJS_EXPORT njs_mp_t * njs_mp_fast_create(size_t cluster_size,
     size_t page_alignment, size_t page_size, size_t min_chunk_size)
     NJS_MALLOC_LIKE;
+NJS_EXPORT njs_mp_t *njs_mp_arena_create(size_t size) NJS_MALLOC_LIKE;
+NJS_EXPORT njs_bool_t njs_mp_is_arena(njs_mp_t *mp);
 NJS_EXPORT njs_bool_t njs_mp_is_empty(njs_mp_t *mp);
 NJS_EXPORT void njs_mp_destroy(njs_mp_t *mp);
 NJS_EXPORT void njs_mp_stat(njs_mp_t *mp, njs_mp_stat_t *stat);
@@ -49,6 +53,20 @@ NJS_EXPORT void *njs_mp_zalign(njs_mp_t *mp,
 NJS_EXPORT njs_mp_cleanup_t *njs_mp_cleanup_add(njs_mp_t *mp, size_t size);
 NJS_EXPORT void njs_mp_free(njs_mp_t *mp, void *p);
 
+/*
+ * Mark and sweep primitives for a tracing collector: njs_mp_sweep() frees
+ * all the allocations not marked since the previous sweep, njs_mp_unmark()
+ * abandons the marking.  The cleanup records are not referenced by
+ * the pool allocations and have to be marked as roots.  njs_mp_contains()
+ * tells whether an address belongs to the pool memory.
+ */
+NJS_EXPORT size_t njs_mp_size(njs_mp_t *mp);
+NJS_EXPORT void *njs_mp_mark(njs_mp_t *mp, void *p, size_t *size);
+NJS_EXPORT void njs_mp_sweep(njs_mp_t *mp);
+NJS_EXPORT void njs_mp_unmark(njs_mp_t *mp);
+NJS_EXPORT njs_mp_cleanup_t *njs_mp_cleanups(njs_mp_t *mp);
+NJS_EXPORT njs_bool_t njs_mp_contains(njs_mp_t *mp, void *p);
+
 
 #if (NJS_ALLOC_DEBUG)
 #define njs_debug_alloc(...)                                                  \
@@ -730,6 +730,10 @@ njs_object_enumerate_string(njs_vm_t *vm, const njs_value_t *value,
     const u_char       *src, *end;
     njs_string_prop_t  str_prop;
 
+    if (njs_slow_path(njs_string_flatten(vm, value) != NJS_OK)) {
+        return NJS_ERROR;
+    }
+
     len = (uint32_t) njs_string_prop(vm, &str_prop, value);
 
     ret = njs_array_expand(vm, items, 0, len);
@@ -1804,7 +1808,7 @@ njs_object_get_prototype_of(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
 
         } else {
             njs_set_object_value(retval,
-                                 &vm->prototypes[index].object_value);
+                           (njs_object_value_t *) njs_vm_proto(vm, index));
         }
 
         return NJS_OK;
@@ -2182,7 +2186,7 @@ njs_object_prototype_create(njs_vm_t *vm, njs_object_prop_t *prop,
 
     if (index >= 0 && (size_t) index < vm->constructors_size) {
         proto = njs_property_prototype_create(vm, &function->object.hash,
-                                              &vm->prototypes[index].object);
+                                              njs_vm_proto(vm, index));
     }
 
     if (proto == NULL) {
@@ -2435,12 +2439,12 @@ njs_object_prototype_create_constructor(njs_vm_t *vm, njs_object_prop_t *prop,
 
     } else {
         index = njs_primitive_prototype_index(value->type);
-        prototype = &vm->prototypes[index];
+        prototype = (njs_object_prototype_t *) njs_vm_proto(vm, index);
     }
 
 found:
 
-    if (njs_flathsh_is_empty(&vm->constructors[index].object.shared_hash)) {
+    if (njs_flathsh_is_empty(&njs_vm_ctor(vm, index).object.shared_hash)) {
         index = NJS_OBJ_TYPE_OBJECT;
     }
 
@@ -2593,6 +2597,10 @@ njs_object_to_string(njs_vm_t *vm, njs_value_t *this, njs_value_t *retval)
         return NJS_OK;
     }
 
+    if (njs_slow_path(njs_string_flatten(vm, &tag) != NJS_OK)) {
+        return NJS_ERROR;
+    }
+
     (void) njs_string_prop(vm, &string, &tag);
 
     p = njs_string_alloc(vm, retval, string.size + njs_length("[object ]"),
@@ -0,0 +1,895 @@
+
+/*
+ * Copyright (C) NGINX, Inc.
+ */
+
+
+#include <njs_main.h>
+
+
+/*
+ * The optimizer rewrites the parser AST in place before code generation:
+ *   operations with literal operands are folded into literals;
+ *   references to "const" bindings initialized with a literal are replaced
+ *   by the literal;
+ *   unreachable branches of "if", "?:", "&&", "||" and "??" are removed.
+ *
+ * Nodes are rewritten in place rather than replaced, because other nodes
+ * (optional chain preserves) may hold pointers to them.
+ *
+ * A "const" binding is propagated only to references which follow the
+ * declaration in the same function and only if the declaration is not
+ * inside a "switch" statement.  Such references are always evaluated
+ * after the binding is initialized, so the temporal dead zone errors are
+ * preserved.
+ */
+
+
+typedef struct {
+    njs_parser_node_t      **slot;
+    njs_parser_node_t      *parent;
+    njs_bool_t             visited;
+} njs_optimizer_entry_t;
+
+
+typedef struct {
+    njs_variable_t         *variable;
+    njs_parser_node_t      *value;
+} njs_optimizer_const_t;
+
+
+typedef struct {
+    njs_parser_node_t      *from;
+    njs_parser_node_t      *to;
+} njs_optimizer_retarget_t;
+
+
+typedef struct {
+    njs_vm_t               *vm;
+    njs_arr_t              *stack;
+    njs_arr_t              *consts;
+    njs_uint_t             switches;
+} njs_optimizer_t;
+
+
+static njs_int_t njs_optimizer_push(njs_optimizer_t *opt,
+    njs_parser_node_t **slot, njs_parser_node_t *parent);
+static njs_int_t njs_optimizer_node(njs_optimizer_t *opt,
+    njs_parser_node_t **slot, njs_parser_node_t *parent);
+static njs_int_t njs_optimizer_binary(njs_optimizer_t *opt,
+    njs_parser_node_t *node);
+static njs_int_t njs_optimizer_concat(njs_optimizer_t *opt,
+    njs_parser_node_t *node, const njs_value_t *val1,
+    const njs_value_t *val2);
+static njs_int_t njs_optimizer_unary(njs_optimizer_t *opt,
+    njs_parser_node_t *node);
+static njs_int_t njs_optimizer_branch(njs_optimizer_t *opt,
+    njs_parser_node_t **slot, njs_parser_node_t *parent);
+static njs_int_t njs_optimizer_retarget(njs_optimizer_t *opt,
+    njs_parser_node_t *from, njs_parser_node_t *to);
+static njs_int_t njs_optimizer_retarget_cb(njs_vm_t *vm,
+    njs_parser_node_t *node, void *ctx);
+static njs_int_t njs_optimizer_removable(njs_optimizer_t *opt,
+    njs_parser_node_t *node);
+static njs_int_t njs_optimizer_lambda_cb(njs_vm_t *vm,
+    njs_parser_node_t *node, void *ctx);
+static njs_int_t njs_optimizer_const(njs_optimizer_t *opt,
+    njs_parser_node_t *node);
+static njs_int_t njs_optimizer_name(njs_optimizer_t *opt,
+    njs_parser_node_t **slot, njs_parser_node_t *parent);
+static njs_bool_t njs_optimizer_rvalue(njs_parser_node_t **slot,
+    njs_parser_node_t *parent);
+static void njs_optimizer_number(njs_parser_node_t *node, double num);
+static void njs_optimizer_boolean(njs_parser_node_t *node, njs_bool_t yn);
+
+
+njs_inline const njs_value_t *
+njs_optimizer_value(njs_parser_node_t *node)
+{
+    /* The value of the "null" node is not set by the parser. */
+
+    return (node->token_type == NJS_TOKEN_NULL) ? &njs_value_null
+                                                : &node->u.value;
+}
+
+
+njs_int_t
+njs_optimizer(njs_vm_t *vm, njs_parser_node_t **root)
+{
+    njs_int_t              ret;
+    njs_optimizer_t        opt;
+    njs_parser_node_t      *node, **slot, *parent;
+    njs_optimizer_entry_t  *entry;
+
+    if (*root == NULL) {
+        return NJS_OK;
+    }
+
+    opt.vm = vm;
+    opt.consts = NULL;
+    opt.switches = 0;
+
+    opt.stack = njs_arr_create(vm->mem_pool, 16,
+                               sizeof(njs_optimizer_entry_t));
+    if (njs_slow_path(opt.stack == NULL)) {
+        njs_memory_error(vm);
+        return NJS_ERROR;
+    }
+
+    ret = njs_optimizer_push(&opt, root, NULL);
+    if (njs_slow_path(ret != NJS_OK)) {
+        goto done;
+    }
+
+    /* Post-order traversal, children are visited in the source order. */
+
+    while (!njs_arr_is_empty(opt.stack)) {
+        entry = njs_arr_last(opt.stack);
+        node = *entry->slot;
+
+        if (!entry->visited) {
+            entry->visited = 1;
+
+            if (node->token_type == NJS_TOKEN_SWITCH) {
+                opt.switches++;
+            }
+
+            if (node->right != NULL) {
+                ret = njs_optimizer_push(&opt, &node->right, node);
+                if (njs_slow_path(ret != NJS_OK)) {
+                    goto done;
+                }
+            }
+
+            if (node->left != NULL) {
+                ret = njs_optimizer_push(&opt, &node->left, node);
+                if (njs_slow_path(ret != NJS_OK)) {
+                    goto done;
+                }
+            }
+
+            continue;
+        }
+
+        slot = entry->slot;
+        parent = entry->parent;
+
+        njs_arr_remove_last(opt.stack);
+
+        if (node->token_type == NJS_TOKEN_SWITCH) {
+            opt.switches--;
+        }
+
+        ret = njs_optimizer_node(&opt, slot, parent);
+        if (njs_slow_path(ret != NJS_OK)) {
+            goto done;
+        }
+    }
+
+    ret = NJS_OK;
+
+done:
+
+    if (opt.consts != NULL) {
+        njs_arr_destroy(opt.consts);
+    }
+
+    njs_arr_destroy(opt.stack);
+
+    return ret;
+}
+
+
+static njs_int_t
+njs_optimizer_push(njs_optimizer_t *opt, njs_parser_node_t **slot,
+    njs_parser_node_t *parent)
+{
+    njs_optimizer_entry_t  *entry;
+
+    entry = njs_arr_add(opt->stack);
+    if (njs_slow_path(entry == NULL)) {
+        njs_memory_error(opt->vm);
+        return NJS_ERROR;
+    }
+
+    entry->slot = slot;
+    entry->parent = parent;
+    entry->visited = 0;
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_optimizer_node(njs_optimizer_t *opt, njs_parser_node_t **slot,
+    njs_parser_node_t *parent)
+{
+    njs_parser_node_t  *node;
+
+    node = *slot;
+
+    switch (node->token_type) {
+
+    case NJS_TOKEN_ADDITION:
+    case NJS_TOKEN_SUBTRACTION:
+    case NJS_TOKEN_MULTIPLICATION:
+    case NJS_TOKEN_EXPONENTIATION:
+    case NJS_TOKEN_DIVISION:
+    case NJS_TOKEN_REMAINDER:
+    case NJS_TOKEN_BITWISE_AND:
+    case NJS_TOKEN_BITWISE_OR:
+    case NJS_TOKEN_BITWISE_XOR:
+    case NJS_TOKEN_LEFT_SHIFT:
+    case NJS_TOKEN_RIGHT_SHIFT:
+    case NJS_TOKEN_UNSIGNED_RIGHT_SHIFT:
+    case NJS_TOKEN_LESS:
+    case NJS_TOKEN_LESS_OR_EQUAL:
+    case NJS_TOKEN_GREATER:
+    case NJS_TOKEN_GREATER_OR_EQUAL:
+    case NJS_TOKEN_EQUAL:
+    case NJS_TOKEN_NOT_EQUAL:
+    case NJS_TOKEN_STRICT_EQUAL:
+    case NJS_TOKEN_STRICT_NOT_EQUAL:
+        return njs_optimizer_binary(opt, node);
+
+    case NJS_TOKEN_UNARY_PLUS:
+    case NJS_TOKEN_UNARY_NEGATION:
+    case NJS_TOKEN_BITWISE_NOT:
+    case NJS_TOKEN_LOGICAL_NOT:
+    case NJS_TOKEN_TYPEOF:
+        return njs_optimizer_unary(opt, node);
+
+    case NJS_TOKEN_LOGICAL_AND:
+    case NJS_TOKEN_LOGICAL_OR:
+    case NJS_TOKEN_COALESCE:
+    case NJS_TOKEN_CONDITIONAL:
+    case NJS_TOKEN_IF:
+        return njs_optimizer_branch(opt, slot, parent);
+
+    case NJS_TOKEN_CONST:
+        return njs_optimizer_const(opt, node);
+
+    case NJS_TOKEN_NAME:
+        return njs_optimizer_name(opt, slot, parent);
+
+    default:
+        return NJS_OK;
+    }
+}
+
+
+static njs_int_t
+njs_optimizer_binary(njs_optimizer_t *opt, njs_parser_node_t *node)
+{
+    double             num, num2, exponent;
+    int32_t            i32;
+    uint32_t           u32;
+    njs_bool_t         yn;
+    const njs_value_t  *val1, *val2;
+
+    if (!njs_parser_is_primitive(node->left)
+        || !njs_parser_is_primitive(node->right))
+    {
+        return NJS_OK;
+    }
+
+    val1 = njs_optimizer_value(node->left);
+    val2 = njs_optimizer_value(node->right);
+
+    switch (node->token_type) {
+
+    case NJS_TOKEN_STRICT_EQUAL:
+    case NJS_TOKEN_STRICT_NOT_EQUAL:
+        yn = njs_values_strict_equal(opt->vm, val1, val2);
+
+        if (node->token_type == NJS_TOKEN_STRICT_NOT_EQUAL) {
+            yn = !yn;
+        }
+
+        njs_optimizer_boolean(node, yn);
+        return NJS_OK;
+
+    case NJS_TOKEN_EQUAL:
+    case NJS_TOKEN_NOT_EQUAL:
+        if (njs_is_null(val1) || njs_is_null(val2)) {
+            yn = (njs_is_null(val1) && njs_is_null(val2));
+
+        } else if (val1->type == val2->type) {
+            yn = njs_values_strict_equal(opt->vm, val1, val2);
+
+        } else {
+            /* Conversions between different types are left to runtime. */
+            return NJS_OK;
+        }
+
+        if (node->token_type == NJS_TOKEN_NOT_EQUAL) {
+            yn = !yn;
+        }
+
+        njs_optimizer_boolean(node, yn);
+        return NJS_OK;
+
+    case NJS_TOKEN_ADDITION:
+        if (njs_is_string(val1) && njs_is_string(val2)) {
+            return njs_optimizer_concat(opt, node, val1, val2);
+        }
+
+        break;
+
+    default:
+        break;
+    }
+
+    if (!njs_is_number(val1) || !njs_is_number(val2)) {
+        return NJS_OK;
+    }
+
+    num = njs_number(val1);
+    num2 = njs_number(val2);
+
+    switch (node->token_type) {
+
+    case NJS_TOKEN_LESS:
+        njs_optimizer_boolean(node, num < num2);
+        return NJS_OK;
+
+    case NJS_TOKEN_LESS_OR_EQUAL:
+        njs_optimizer_boolean(node, num <= num2);
+        return NJS_OK;
+
+    case NJS_TOKEN_GREATER:
+        njs_optimizer_boolean(node, num > num2);
+        return NJS_OK;
+
+    case NJS_TOKEN_GREATER_OR_EQUAL:
+        njs_optimizer_boolean(node, num >= num2);
+        return NJS_OK;
+
+    case NJS_TOKEN_ADDITION:
+        num += num2;
+        break;
+
+    case NJS_TOKEN_SUBTRACTION:
+        num -= num2;
+        break;
+
+    case NJS_TOKEN_MULTIPLICATION:
+        num *= num2;
+        break;
+
+    case NJS_TOKEN_EXPONENTIATION:
+        exponent = num2;
+
+        /* The same as in njs_vmcode_interpreter(). */
+
+        if (fabs(num) != 1 || (!isnan(exponent) && !isinf(exponent))) {
+            num = pow(num, exponent);
+
+        } else {
+            num = NAN;
+        }
+
+        break;
+
+    case NJS_TOKEN_DIVISION:
+        num /= num2;
+        break;
+
+    case NJS_TOKEN_REMAINDER:
+        num = fmod(num, num2);
+        break;
+
+    case NJS_TOKEN_BITWISE_AND:
+        num = njs_number_to_int32(num) & njs_number_to_int32(num2);
+        break;
+
+    case NJS_TOKEN_BITWISE_OR:
+        num = njs_number_to_int32(num) | njs_number_to_int32(num2);
+        break;
+
+    case NJS_TOKEN_BITWISE_XOR:
+        num = njs_number_to_int32(num) ^ njs_number_to_int32(num2);
+        break;
+
+    case NJS_TOKEN_LEFT_SHIFT:
+        u32 = njs_number_to_uint32(num2) & 0x1f;
+
+        /* Shifting of negative numbers is undefined. */
+        i32 = (uint32_t) njs_number_to_int32(num) << u32;
+
+        num = i32;
+        break;
+
+    case NJS_TOKEN_RIGHT_SHIFT:
+        u32 = njs_number_to_uint32(num2) & 0x1f;
+        num = njs_number_to_int32(num) >> u32;
+        break;
+
+    case NJS_TOKEN_UNSIGNED_RIGHT_SHIFT:
+        u32 = njs_number_to_uint32(num2) & 0x1f;
+        num = njs_number_to_uint32(num) >> u32;
+        break;
+
+    default:
+        return NJS_OK;
+    }
+
+    njs_optimizer_number(node, num);
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_optimizer_concat(njs_optimizer_t *opt, njs_parser_node_t *node,
+    const njs_value_t *val1, const njs_value_t *val2)
+{
+    u_char             *start;
+    njs_int_t          ret;
+    njs_value_t        value;
+    njs_string_prop_t  string1, string2;
+
+    (void) njs_string_prop(opt->vm, &string1, val1);
+    (void) njs_string_prop(opt->vm, &string2, val2);
+
+    start = njs_string_alloc(opt->vm, &value, string1.size + string2.size,
+                             string1.length + string2.length);
+    if (njs_slow_path(start == NULL)) {
+        return NJS_ERROR;
+    }
+
+    memcpy(start, string1.start, string1.size);
+    memcpy(start + string1.size, string2.start, string2.size);
+
+    ret = njs_atom_atomize_key(opt->vm, &value);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return NJS_ERROR;
+    }
+
+    node->token_type = NJS_TOKEN_STRING;
+    node->u.value = value;
+    node->left = NULL;
+    node->right = NULL;
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_optimizer_unary(njs_optimizer_t *opt, njs_parser_node_t *node)
+{
+    double             num;
+    uint32_t           atom_id;
+    njs_int_t          ret;
+    const njs_value_t  *value;
+
+    if (!njs_parser_is_primitive(node->left)) {
+        return NJS_OK;
+    }
+
+    value = njs_optimizer_value(node->left);
+
+    switch (node->token_type) {
+
+    case NJS_TOKEN_LOGICAL_NOT:
+        njs_optimizer_boolean(node, !njs_is_true(value));
+        return NJS_OK;
+
+    case NJS_TOKEN_TYPEOF:
+        switch (node->left->token_type) {
+
+        case NJS_TOKEN_NUMBER:
+            atom_id = NJS_ATOM_STRING_number;
+            break;
+
+        case NJS_TOKEN_STRING:
+            atom_id = NJS_ATOM_STRING_string;
+            break;
+
+        case NJS_TOKEN_TRUE:
+        case NJS_TOKEN_FALSE:
+            atom_id = NJS_ATOM_STRING_boolean;
+            break;
+
+        default:
+            /* ECMAScript 5.1: null is an object. */
+            atom_id = NJS_ATOM_STRING_object;
+            break;
+        }
+
+        ret = njs_atom_to_value(opt->vm, &node->u.value, atom_id);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return NJS_ERROR;
+        }
+
+        node->token_type = NJS_TOKEN_STRING;
+        node->left = NULL;
+        node->right = NULL;
+
+        return NJS_OK;
+
+    default:
+        break;
+    }
+
+    if (!njs_is_number(value)) {
+        return NJS_OK;
+    }
+
+    num = njs_number(value);
+
+    switch (node->token_type) {
+
+    case NJS_TOKEN_UNARY_NEGATION:
+        num = -num;
+        break;
+
+    case NJS_TOKEN_BITWISE_NOT:
+        num = (int32_t) ~njs_number_to_uint32(num);
+        break;
+
+    default:
+        /* NJS_TOKEN_UNARY_PLUS. */
+        break;
+    }
+
+    njs_optimizer_number(node, num);
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_optimizer_branch(njs_optimizer_t *opt, njs_parser_node_t **slot,
+    njs_parser_node_t *parent)
+{
+    njs_int_t          ret;
+    njs_bool_t         truth;
+    njs_parser_node_t  *node, *taken, *dropped;
+    const njs_value_t  *value;
+
+    node = *slot;
+
+    if (!njs_parser_is_primitive(node->left)) {
+        return NJS_OK;
+    }
+
+    value = njs_optimizer_value(node->left);
+    truth = njs_is_true(value);
+
+    switch (node->token_type) {
+
+    case NJS_TOKEN_LOGICAL_AND:
+        taken = truth ? node->right : node->left;
+        dropped = truth ? NULL : node->right;
+        break;
+
+    case NJS_TOKEN_LOGICAL_OR:
+        taken = truth ? node->left : node->right;
+        dropped = truth ? node->right : NULL;
+        break;
+
+    case NJS_TOKEN_COALESCE:
+        taken = njs_is_null(value) ? node->right : node->left;
+        dropped = njs_is_null(value) ? NULL : node->right;
+        break;
+
+    default:
+        /* NJS_TOKEN_CONDITIONAL, NJS_TOKEN_IF. */
+
+        if (node->name.length != 0) {
+            /* A labelled statement. */
+            return NJS_OK;
+        }
+
+        if (node->right != NULL
+            && node->right->token_type == NJS_TOKEN_BRANCHING)
+        {
+            taken = truth ? node->right->left : node->right->right;
+            dropped = truth ? node->right->right : node->right->left;
+
+        } else {
+            /* The "if" statement without "else". */
+            taken = truth ? node->right : NULL;
+            dropped = truth ? NULL : node->right;
+        }
+
+        if (node->token_type == NJS_TOKEN_IF
+            && taken != NULL
+            && parent != NULL
+            && parent->token_type == NJS_TOKEN_END)
+        {
+            /* The "if" statement does not provide the completion value. */
+            return NJS_OK;
+        }
+
+        break;
+    }
+
+    if (dropped != NULL) {
+        ret = njs_optimizer_removable(opt, dropped);
+        if (ret != NJS_OK) {
+            return (ret == NJS_DECLINED) ? NJS_OK : NJS_ERROR;
+        }
+    }
+
+    if (taken == NULL) {
+        /* Only a statement can be removed entirely. */
+
+        if (parent == NULL
+            || (parent->token_type != NJS_TOKEN_STATEMENT
+                && parent->token_type != NJS_TOKEN_END)
+            || slot != &parent->right)
+        {
+            return NJS_OK;
+        }
+
+        *slot = NULL;
+
+        return NJS_OK;
+    }
+
+    *node = *taken;
+
+    return njs_optimizer_retarget(opt, taken, node);
+}
+
+
+static njs_int_t
+njs_optimizer_retarget(njs_optimizer_t *opt, njs_parser_node_t *from,
+    njs_parser_node_t *to)
+{
+    njs_int_t                 ret;
+    njs_optimizer_retarget_t  ctx;
+
+    /*
+     * Object and array literal values refer to the literal node
+     * from inside of its subtree.
+     */
+
+    ctx.from = from;
+    ctx.to = to;
+
+    ret = njs_parser_traverse(opt->vm, to, &ctx, njs_optimizer_retarget_cb);
+    if (njs_slow_path(ret != NJS_OK)) {
+        njs_memory_error(opt->vm);
+        return NJS_ERROR;
+    }
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_optimizer_retarget_cb(njs_vm_t *vm, njs_parser_node_t *node, void *ctx)
+{
+    njs_optimizer_retarget_t  *retarget;
+
+    retarget = ctx;
+
+    if ((node->token_type == NJS_TOKEN_OBJECT_VALUE
+         || node->token_type == NJS_TOKEN_OPTIONAL_PRESERVE)
+        && node->u.object == retarget->from)
+    {
+        node->u.object = retarget->to;
+    }
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_optimizer_removable(njs_optimizer_t *opt, njs_parser_node_t *node)
+{
+    njs_int_t   ret;
+    njs_bool_t  lambda;
+
+    /*
+     * Function declarations are hoisted to the beginning of the enclosing
+     * function, so the code of their lambdas must be generated anyway.
+     */
+
+    lambda = 0;
+
+    ret = njs_parser_traverse(opt->vm, node, &lambda, njs_optimizer_lambda_cb);
+    if (njs_slow_path(ret != NJS_OK)) {
+        njs_memory_error(opt->vm);
+        return NJS_ERROR;
+    }
+
+    return lambda ? NJS_DECLINED : NJS_OK;
+}
+
+
+static njs_int_t
+njs_optimizer_lambda_cb(njs_vm_t *vm, njs_parser_node_t *node, void *ctx)
+{
+    switch (node->token_type) {
+
+    case NJS_TOKEN_FUNCTION:
+    case NJS_TOKEN_FUNCTION_DECLARATION:
+    case NJS_TOKEN_FUNCTION_EXPRESSION:
+    case NJS_TOKEN_ASYNC_FUNCTION:
+    case NJS_TOKEN_ASYNC_FUNCTION_DECLARATION:
+    case NJS_TOKEN_ASYNC_FUNCTION_EXPRESSION:
+        *((njs_bool_t *) ctx) = 1;
+        break;
+
+    default:
+        break;
+    }
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_optimizer_const(njs_optimizer_t *opt, njs_parser_node_t *node)
+{
+    njs_variable_t         *var;
+    njs_optimizer_const_t  *cnst;
+
+    if (opt->switches != 0
+        || node->left == NULL
+        || node->left->token_type != NJS_TOKEN_NAME
+        || node->right == NULL
+        || !njs_parser_is_primitive(node->right))
+    {
+        return NJS_OK;
+    }
+
+    var = njs_variable_resolve(opt->vm, node->left);
+    if (var == NULL || var->type != NJS_VARIABLE_CONST) {
+        return NJS_OK;
+    }
+
+    if (opt->consts == NULL) {
+        opt->consts = njs_arr_create(opt->vm->mem_pool, 4,
+                                     sizeof(njs_optimizer_const_t));
+        if (njs_slow_path(opt->consts == NULL)) {
+            njs_memory_error(opt->vm);
+            return NJS_ERROR;
+        }
+    }
+
+    cnst = njs_arr_add(opt->consts);
+    if (njs_slow_path(cnst == NULL)) {
+        njs_memory_error(opt->vm);
+        return NJS_ERROR;
+    }
+
+    cnst->variable = var;
+    cnst->value = node->right;
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_optimizer_name(njs_optimizer_t *opt, njs_parser_node_t **slot,
+    njs_parser_node_t *parent)
+{
+    njs_uint_t             n;
+    njs_variable_t         *var;
+    njs_parser_node_t      *node, *value;
+    njs_optimizer_const_t  *cnst;
+
+    node = *slot;
+
+    if (opt->consts == NULL
+        || parent == NULL
+        || node->scope == NULL
+        || node->u.reference.type == NJS_DECLARATION
+        || !njs_optimizer_rvalue(slot, parent))
+    {
+        return NJS_OK;
+    }
+
+    var = njs_variable_resolve(opt->vm, node);
+    if (var == NULL || var->type != NJS_VARIABLE_CONST) {
+        return NJS_OK;
+    }
+
+    if (njs_function_scope(node->scope) != njs_function_scope(var->scope)) {
+        return NJS_OK;
+    }
+
+    cnst = opt->consts->start;
+
+    for (n = 0; n < opt->consts->items; n++) {
+        if (cnst[n].variable == var) {
+            value = cnst[n].value;
+
+            node->token_type = value->token_type;
+            node->u.value = value->u.value;
+            node->left = NULL;
+            node->right = NULL;
+
+            break;
+        }
+    }
+
+    return NJS_OK;
+}
+
+
+static njs_bool_t
+njs_optimizer_rvalue(njs_parser_node_t **slot, njs_parser_node_t *parent)
+{
+    switch (parent->token_type) {
+
+    case NJS_TOKEN_ADDITION:
+    case NJS_TOKEN_SUBTRACTION:
+    case NJS_TOKEN_MULTIPLICATION:
+    case NJS_TOKEN_EXPONENTIATION:
+    case NJS_TOKEN_DIVISION:
+    case NJS_TOKEN_REMAINDER:
+    case NJS_TOKEN_BITWISE_AND:
+    case NJS_TOKEN_BITWISE_OR:
+    case NJS_TOKEN_BITWISE_XOR:
+    case NJS_TOKEN_LEFT_SHIFT:
+    case NJS_TOKEN_RIGHT_SHIFT:
+    case NJS_TOKEN_UNSIGNED_RIGHT_SHIFT:
+    case NJS_TOKEN_LESS:
+    case NJS_TOKEN_LESS_OR_EQUAL:
+    case NJS_TOKEN_GREATER:
+    case NJS_TOKEN_GREATER_OR_EQUAL:
+    case NJS_TOKEN_EQUAL:
+    case NJS_TOKEN_NOT_EQUAL:
+    case NJS_TOKEN_STRICT_EQUAL:
+    case NJS_TOKEN_STRICT_NOT_EQUAL:
+    case NJS_TOKEN_UNARY_PLUS:
+    case NJS_TOKEN_UNARY_NEGATION:
+    case NJS_TOKEN_BITWISE_NOT:
+    case NJS_TOKEN_LOGICAL_NOT:
+    case NJS_TOKEN_TYPEOF:
+    case NJS_TOKEN_LOGICAL_AND:
+    case NJS_TOKEN_LOGICAL_OR:
+    case NJS_TOKEN_COALESCE:
+        return 1;
+
+    case NJS_TOKEN_IF:
+    case NJS_TOKEN_CONDITIONAL:
+    case NJS_TOKEN_ARGUMENT:
+        return (slot == &parent->left);
+
+    case NJS_TOKEN_VAR:
+    case NJS_TOKEN_LET:
+    case NJS_TOKEN_CONST:
+    case NJS_TOKEN_RETURN:
+        return (slot == &parent->right);
+
+    default:
+        return 0;
+    }
+}
+
+
+static void
+njs_optimizer_number(njs_parser_node_t *node, double num)
+{
+    node->token_type = NJS_TOKEN_NUMBER;
+
+    njs_set_number(&node->u.value, num);
+
+    /* The same as in njs_parser_primary_expression_test(). */
+
+    if (njs_number_is_integer_index(num) && num < 0x80000000) {
+        node->u.value.atom_id = njs_number_atom((uint32_t) num);
+    }
+
+    node->left = NULL;
+    node->right = NULL;
+}
+
+
+static void
+njs_optimizer_boolean(njs_parser_node_t *node, njs_bool_t yn)
+{
+    node->token_type = yn ? NJS_TOKEN_TRUE : NJS_TOKEN_FALSE;
+
+    njs_set_boolean(&node->u.value, yn);
+
+    node->left = NULL;
+    node->right = NULL;
+}
@@ -0,0 +1,13 @@
+
+/*
+ * Copyright (C) NGINX, Inc.
+ */
+
+#ifndef _NJS_OPTIMIZER_H_INCLUDED_
+#define _NJS_OPTIMIZER_H_INCLUDED_
+
+
+njs_int_t njs_optimizer(njs_vm_t *vm, njs_parser_node_t **root);
+
+
+#endif /* _NJS_OPTIMIZER_H_INCLUDED_ */
@@ -489,7 +489,7 @@ static njs_parser_node_t *njs_parser_reference(njs_parser_t *parser,
     njs_lexer_token_t *token);
 
 static njs_parser_node_t *njs_parser_argument(njs_parser_t *parser,
-    njs_parser_node_t *expr, njs_index_t index);
+    njs_parser_node_t *expr);
 
 static njs_int_t njs_parser_object_property(njs_parser_t *parser,
     njs_parser_node_t *parent, njs_parser_node_t *property,
@@ -654,7 +654,7 @@ njs_parser(njs_vm_t *vm, njs_parser_t *parser)
         njs_parser_chain_top_set(parser, parser->node);
     }
 
-    return NJS_OK;
+    return njs_optimizer(vm, &parser->scope->top);
 }
 
 
@@ -1349,7 +1349,6 @@ static njs_int_t
 njs_parser_template_literal(njs_parser_t *parser, njs_lexer_token_t *token,
     njs_queue_link_t *current)
 {
-    njs_index_t        index;
     njs_parser_node_t  *node, *array, *template, *temp;
 
     temp = njs_parser_node_new(parser, 0);
@@ -1366,27 +1365,15 @@ njs_parser_template_literal(njs_parser_t *parser, njs_lexer_token_t *token,
 
     template = parser->node;
 
-    index = njs_scope_temp_index(template->scope);
-    if (njs_slow_path(index == NJS_INDEX_ERROR)) {
-        return NJS_ERROR;
-    }
-
     if (template->token_type != NJS_TOKEN_TEMPLATE_LITERAL) {
-        node = njs_parser_argument(parser, array, index);
+        node = njs_parser_argument(parser, array);
         if (node == NULL) {
             return NJS_ERROR;
         }
 
-        node->temporary = 1;
-
         template->right = node;
         temp->right = node;
 
-        index = njs_scope_temp_index(template->scope);
-        if (njs_slow_path(index == NJS_INDEX_ERROR)) {
-            return NJS_ERROR;
-        }
-
     } else {
         template->left = array;
         temp->right = template;
@@ -1394,7 +1381,6 @@ njs_parser_template_literal(njs_parser_t *parser, njs_lexer_token_t *token,
 
     temp->temporary = 1;
     temp->left = template;
-    temp->index = index;
 
     parser->target = temp;
 
@@ -1474,7 +1460,7 @@ njs_parser_template_literal_expression(njs_parser_t *parser,
     template = parser->target->left;
 
     if (template->token_type != NJS_TOKEN_TEMPLATE_LITERAL) {
-        node = njs_parser_argument(parser, parser->node, parser->target->index);
+        node = njs_parser_argument(parser, parser->node);
         if (node == NULL) {
             return NJS_ERROR;
         }
@@ -1482,11 +1468,6 @@ njs_parser_template_literal_expression(njs_parser_t *parser,
         parent->right = node;
         parent = node;
 
-        parser->target->index = njs_scope_temp_index(node->scope);
-        if (njs_slow_path(parser->target->index == NJS_INDEX_ERROR)) {
-            return NJS_ERROR;
-        }
-
     } else {
         ret = njs_parser_array_item(parser, template->left, parser->node);
         if (ret != NJS_OK) {
@@ -3147,11 +3128,6 @@ njs_parser_argument_list_after(njs_parser_t *parser, njs_lexer_token_t *token,
         return NJS_ERROR;
     }
 
-    node->index = njs_scope_temp_index(node->scope);
-    if (njs_slow_path(node->index == NJS_INDEX_ERROR)) {
-        return NJS_ERROR;
-    }
-
     node->token_line = token->line;
     node->left = parser->node;
 
@@ -8778,8 +8754,7 @@ njs_parser_object_value(njs_parser_t *parser, njs_parser_node_t *parent,
 
 
 static njs_parser_node_t *
-njs_parser_argument(njs_parser_t *parser, njs_parser_node_t *expr,
-    njs_index_t index)
+njs_parser_argument(njs_parser_t *parser, njs_parser_node_t *expr)
 {
     njs_parser_node_t  *node;
 
@@ -8789,7 +8764,6 @@ njs_parser_argument(njs_parser_t *parser, njs_parser_node_t *expr,
     }
 
     node->token_line = expr->token_line;
-    node->index = index;
 
     node->left = expr;
     expr->dest = node;
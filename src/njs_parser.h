@@ -128,6 +128,7 @@ njs_int_t njs_parser(njs_vm_t *vm, njs_parser_t *parser);
 njs_bool_t njs_variable_closure_test(njs_parser_scope_t *root,
     njs_parser_scope_t *scope);
 njs_variable_t *njs_variable_resolve(njs_vm_t *vm, njs_parser_node_t *node);
+njs_int_t njs_variable_escape(njs_vm_t *vm, njs_parser_node_t *root);
 njs_index_t njs_variable_index(njs_vm_t *vm, njs_parser_node_t *node);
 njs_bool_t njs_parser_has_side_effect(njs_parser_node_t *node);
 njs_int_t njs_parser_variable_reference(njs_parser_t *parser,
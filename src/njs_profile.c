@@ -0,0 +1,700 @@
+
+/*
+ * Copyright (C) NGINX, Inc.
+ */
+
+
+#include <njs_main.h>
+
+
+/*
+ * A sampling profiler.
+ *
+ * A timer signal handler calls njs_profile_tick() which only raises
+ * njs_profile_pending.  The interpreter and the native code check the flag
+ * at backward jumps and function entries, where the frames are consistent,
+ * and record the stack of the active frames there.  So a tick is attributed
+ * to the nearest such point after it, and the ticks which come while no code
+ * runs are dropped by njs_vm_start() and njs_vm_invoke().
+ *
+ * Functions, locations and stacks are interned by their keys into tables
+ * which number them in the order of appearance starting from 1, as pprof
+ * reserves the id 0.
+ */
+
+
+typedef struct {
+    njs_str_t                key;
+    uint32_t                 id;
+    uint64_t                 count;
+} njs_profile_entry_t;
+
+
+typedef struct {
+    njs_flathsh_t            hash;
+    njs_arr_t                *entries;  /* of njs_profile_entry_t * */
+} njs_profile_table_t;
+
+
+struct njs_profile_s {
+    njs_mp_t                 *pool;
+    njs_uint_t               period;
+
+    /* The name length, the name and the file name. */
+    njs_profile_table_t      functions;
+    /* The function id and the line. */
+    njs_profile_table_t      locations;
+    /* The location ids, the leaf first. */
+    njs_profile_table_t      stacks;
+
+    njs_str_t                output;
+};
+
+
+/* Wire types and fields of the pprof profile.proto messages. */
+
+#define NJS_PB_VARINT                0
+#define NJS_PB_BYTES                 2
+
+#define NJS_PB_VARINT_MAX            10
+
+#define NJS_PB_PROFILE_SAMPLE_TYPE   1
+#define NJS_PB_PROFILE_SAMPLE        2
+#define NJS_PB_PROFILE_LOCATION      4
+#define NJS_PB_PROFILE_FUNCTION      5
+#define NJS_PB_PROFILE_STRING_TABLE  6
+#define NJS_PB_PROFILE_PERIOD_TYPE   11
+#define NJS_PB_PROFILE_PERIOD        12
+
+
+enum {
+    NJS_PROFILE_STR_EMPTY = 0,
+    NJS_PROFILE_STR_SAMPLES,
+    NJS_PROFILE_STR_COUNT,
+    NJS_PROFILE_STR_CPU,
+    NJS_PROFILE_STR_NANOSECONDS,
+    NJS_PROFILE_STR_FUNCTIONS,
+};
+
+
+static njs_int_t njs_profile_table_init(njs_profile_t *profile,
+    njs_profile_table_t *table);
+static njs_profile_entry_t *njs_profile_entry(njs_profile_t *profile,
+    njs_profile_table_t *table, const u_char *key, size_t length);
+static njs_profile_entry_t *njs_profile_location(njs_profile_t *profile,
+    const njs_str_t *name, const njs_str_t *file, uint32_t line);
+static void njs_profile_native_name(njs_vm_t *vm, njs_function_t *function,
+    njs_str_t *name);
+static void njs_profile_function_get(njs_profile_entry_t *function,
+    njs_str_t *name, njs_str_t *file);
+static void njs_profile_folded(njs_profile_t *profile, njs_chb_t *chain);
+static void njs_profile_folded_str(njs_chb_t *chain, const njs_str_t *str);
+static void njs_profile_pprof(njs_profile_t *profile, njs_chb_t *chain);
+static void njs_profile_pb_bytes(njs_chb_t *chain, njs_uint_t field,
+    const u_char *data, size_t length);
+static u_char *njs_profile_pb_varint(u_char *p, njs_uint_t field,
+    uint64_t value);
+static u_char *njs_profile_varint(u_char *p, uint64_t value);
+
+
+volatile sig_atomic_t  njs_profile_pending;
+
+
+static const njs_str_t  njs_profile_strings[] = {
+    njs_str(""),
+    njs_str("samples"),
+    njs_str("count"),
+    njs_str("cpu"),
+    njs_str("nanoseconds"),
+};
+
+
+static njs_int_t
+njs_profile_entry_test(njs_flathsh_query_t *fhq, void *data)
+{
+    njs_profile_entry_t  *entry;
+
+    entry = *(njs_profile_entry_t **) data;
+
+    return njs_strstr_eq(&fhq->key, &entry->key) ? NJS_OK : NJS_DECLINED;
+}
+
+
+static const njs_flathsh_proto_t  njs_profile_entry_proto
+    njs_aligned(64) =
+{
+    njs_profile_entry_test,
+    njs_flathsh_proto_alloc,
+    njs_flathsh_proto_free,
+};
+
+
+njs_profile_t *
+njs_profile_create(njs_uint_t period)
+{
+    njs_mp_t       *mp;
+    njs_profile_t  *profile;
+
+    mp = njs_mp_fast_create(2 * njs_pagesize(), 128, 512, 16);
+    if (njs_slow_path(mp == NULL)) {
+        return NULL;
+    }
+
+    profile = njs_mp_zalloc(mp, sizeof(njs_profile_t));
+    if (njs_slow_path(profile == NULL)) {
+        goto fail;
+    }
+
+    profile->pool = mp;
+    profile->period = period;
+
+    if (njs_profile_table_init(profile, &profile->functions) != NJS_OK
+        || njs_profile_table_init(profile, &profile->locations) != NJS_OK
+        || njs_profile_table_init(profile, &profile->stacks) != NJS_OK)
+    {
+        goto fail;
+    }
+
+    return profile;
+
+fail:
+
+    njs_mp_destroy(mp);
+
+    return NULL;
+}
+
+
+void
+njs_profile_destroy(njs_profile_t *profile)
+{
+    njs_mp_destroy(profile->pool);
+}
+
+
+void
+njs_profile_tick(void)
+{
+    njs_profile_pending = 1;
+}
+
+
+njs_uint_t
+njs_profile_samples(njs_profile_t *profile)
+{
+    njs_uint_t           i, n;
+    njs_profile_entry_t  **stacks;
+
+    n = 0;
+    stacks = profile->stacks.entries->start;
+
+    for (i = 0; i < profile->stacks.entries->items; i++) {
+        n += stacks[i]->count;
+    }
+
+    return n;
+}
+
+
+void
+njs_profile_sample(njs_vm_t *vm, u_char *pc)
+{
+    uint32_t             line, ids[NJS_PROFILE_DEPTH_MAX];
+    njs_str_t            name, file;
+    njs_uint_t           n;
+    njs_profile_t        *profile;
+    njs_vm_code_t        *code;
+    njs_native_frame_t   *frame;
+    njs_profile_entry_t  *entry;
+
+    njs_profile_pending = 0;
+
+    profile = vm->profile;
+
+    if (profile == NULL) {
+        return;
+    }
+
+    vm->active_frame->native.pc = pc;
+
+    n = 0;
+
+    for (frame = &vm->active_frame->native;
+         frame != NULL && n < NJS_PROFILE_DEPTH_MAX;
+         frame = frame->previous)
+    {
+        line = 0;
+        file = njs_str_value("");
+
+        if (!frame->native) {
+            if (frame->pc == NULL) {
+                continue;
+            }
+
+            code = njs_lookup_code(vm, frame->pc);
+
+            if (code != NULL) {
+                name = code->name;
+
+                if (name.length == 0) {
+                    name = njs_entry_anonymous;
+                }
+
+                file = code->file;
+                line = njs_lookup_line(code->lines, frame->pc - code->start);
+
+            } else {
+                name = njs_entry_unknown;
+            }
+
+        } else {
+            if (njs_slow_path(frame->function->bound != NULL)) {
+                continue;
+            }
+
+            njs_profile_native_name(vm, frame->function, &name);
+        }
+
+        entry = njs_profile_location(profile, &name, &file, line);
+        if (njs_slow_path(entry == NULL)) {
+            return;
+        }
+
+        ids[n++] = entry->id;
+    }
+
+    if (n == 0) {
+        return;
+    }
+
+    entry = njs_profile_entry(profile, &profile->stacks, (u_char *) ids,
+                              n * sizeof(uint32_t));
+    if (njs_slow_path(entry == NULL)) {
+        return;
+    }
+
+    entry->count++;
+}
+
+
+njs_int_t
+njs_profile_dump(njs_profile_t *profile, njs_profile_format_t format,
+    njs_str_t *dst)
+{
+    njs_int_t  ret;
+    njs_chb_t  chain;
+
+    if (profile->output.start != NULL) {
+        njs_mp_free(profile->pool, profile->output.start);
+        profile->output.start = NULL;
+    }
+
+    NJS_CHB_MP_INIT(&chain, profile->pool);
+
+    if (format == NJS_PROFILE_PPROF) {
+        njs_profile_pprof(profile, &chain);
+
+    } else {
+        njs_profile_folded(profile, &chain);
+    }
+
+    ret = njs_chb_join(&chain, &profile->output);
+
+    njs_chb_destroy(&chain);
+
+    if (njs_slow_path(ret != NJS_OK)) {
+        profile->output.start = NULL;
+        return NJS_ERROR;
+    }
+
+    *dst = profile->output;
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_profile_table_init(njs_profile_t *profile, njs_profile_table_t *table)
+{
+    njs_flathsh_init(&table->hash);
+
+    table->entries = njs_arr_create(profile->pool, 16,
+                                    sizeof(njs_profile_entry_t *));
+    if (njs_slow_path(table->entries == NULL)) {
+        return NJS_ERROR;
+    }
+
+    return NJS_OK;
+}
+
+
+static njs_profile_entry_t *
+njs_profile_entry(njs_profile_t *profile, njs_profile_table_t *table,
+    const u_char *key, size_t length)
+{
+    njs_int_t            ret;
+    njs_flathsh_elt_t    *elt;
+    njs_flathsh_query_t  fhq;
+    njs_profile_entry_t  *entry, **item;
+
+    fhq.key.start = (u_char *) key;
+    fhq.key.length = length;
+    fhq.key_hash = njs_djb_hash(key, length);
+    fhq.proto = &njs_profile_entry_proto;
+
+    if (njs_flathsh_find(&table->hash, &fhq) == NJS_OK) {
+        elt = fhq.value;
+        return elt->value[0];
+    }
+
+    entry = njs_mp_alloc(profile->pool, sizeof(njs_profile_entry_t) + length);
+    if (njs_slow_path(entry == NULL)) {
+        return NULL;
+    }
+
+    entry->key.start = (u_char *) &entry[1];
+    entry->key.length = length;
+    entry->id = table->entries->items + 1;
+    entry->count = 0;
+
+    memcpy(entry->key.start, key, length);
+
+    item = njs_arr_add(table->entries);
+    if (njs_slow_path(item == NULL)) {
+        njs_mp_free(profile->pool, entry);
+        return NULL;
+    }
+
+    fhq.replace = 0;
+    fhq.pool = profile->pool;
+
+    ret = njs_flathsh_insert(&table->hash, &fhq);
+    if (njs_slow_path(ret != NJS_OK)) {
+        njs_arr_remove_last(table->entries);
+        njs_mp_free(profile->pool, entry);
+        return NULL;
+    }
+
+    elt = fhq.value;
+    elt->value[0] = entry;
+
+    *item = entry;
+
+    return entry;
+}
+
+
+static njs_profile_entry_t *
+njs_profile_location(njs_profile_t *profile, const njs_str_t *name,
+    const njs_str_t *file, uint32_t line)
+{
+    u_char               *p, *key;
+    size_t               length;
+    uint32_t             location[2];
+    njs_profile_entry_t  *function;
+
+    length = sizeof(uint32_t) + name->length + file->length;
+
+    key = njs_mp_alloc(profile->pool, length);
+    if (njs_slow_path(key == NULL)) {
+        return NULL;
+    }
+
+    location[0] = name->length;
+
+    p = njs_cpymem(key, &location[0], sizeof(uint32_t));
+    p = njs_cpymem(p, name->start, name->length);
+    memcpy(p, file->start, file->length);
+
+    function = njs_profile_entry(profile, &profile->functions, key, length);
+
+    njs_mp_free(profile->pool, key);
+
+    if (njs_slow_path(function == NULL)) {
+        return NULL;
+    }
+
+    location[0] = function->id;
+    location[1] = line;
+
+    return njs_profile_entry(profile, &profile->locations, (u_char *) location,
+                             sizeof(location));
+}
+
+
+/*
+ * Only the own "name" property of a native function is used,
+ * as a getter must not be called in the middle of an instruction.
+ */
+
+static void
+njs_profile_native_name(njs_vm_t *vm, njs_function_t *function,
+    njs_str_t *name)
+{
+    njs_int_t            ret;
+    njs_flathsh_t        *hash;
+    njs_object_prop_t    *prop;
+    njs_flathsh_query_t  fhq;
+
+    hash = &function->object.hash;
+
+    for ( ;; ) {
+        fhq.key_hash = NJS_ATOM_STRING_name;
+
+        ret = njs_flathsh_unique_find(hash, &fhq);
+        if (ret == NJS_OK) {
+            prop = fhq.value;
+
+            if (prop->type == NJS_PROPERTY
+                && njs_is_string(njs_prop_value(prop)))
+            {
+                njs_string_get(vm, njs_prop_value(prop), name);
+
+                if (name->length != 0) {
+                    return;
+                }
+            }
+        }
+
+        if (hash == &function->object.shared_hash) {
+            break;
+        }
+
+        hash = &function->object.shared_hash;
+    }
+
+    *name = njs_entry_unknown;
+}
+
+
+static void
+njs_profile_function_get(njs_profile_entry_t *function, njs_str_t *name,
+    njs_str_t *file)
+{
+    uint32_t  length;
+
+    memcpy(&length, function->key.start, sizeof(uint32_t));
+
+    name->start = function->key.start + sizeof(uint32_t);
+    name->length = length;
+
+    file->start = name->start + length;
+    file->length = function->key.length - sizeof(uint32_t) - length;
+}
+
+
+/*
+ * The folded stacks format of flamegraph.pl: a line per stack with
+ * the frames from the root separated by ";" and the number of samples.
+ */
+
+static void
+njs_profile_folded(njs_profile_t *profile, njs_chb_t *chain)
+{
+    uint32_t             *ids, *location;
+    njs_str_t            name, file;
+    njs_uint_t           i, n;
+    njs_profile_entry_t  **stacks, **locations, **functions;
+
+    stacks = profile->stacks.entries->start;
+    locations = profile->locations.entries->start;
+    functions = profile->functions.entries->start;
+
+    for (i = 0; i < profile->stacks.entries->items; i++) {
+        ids = (uint32_t *) stacks[i]->key.start;
+        n = stacks[i]->key.length / sizeof(uint32_t);
+
+        while (n != 0) {
+            location = (uint32_t *) locations[ids[--n] - 1]->key.start;
+
+            njs_profile_function_get(functions[location[0] - 1], &name,
+                                     &file);
+
+            njs_profile_folded_str(chain, &name);
+
+            if (file.length == 0 && location[1] == 0) {
+                njs_chb_append_literal(chain, " (native)");
+
+            } else {
+                njs_chb_append_literal(chain, " (");
+                njs_profile_folded_str(chain, &file);
+
+                if (location[1] != 0) {
+                    njs_chb_sprintf(chain, 12, ":%uD", location[1]);
+                }
+
+                njs_chb_append_literal(chain, ")");
+            }
+
+            if (n != 0) {
+                njs_chb_append_literal(chain, ";");
+            }
+        }
+
+        njs_chb_sprintf(chain, 24, " %uL\n", stacks[i]->count);
+    }
+}
+
+
+static void
+njs_profile_folded_str(njs_chb_t *chain, const njs_str_t *str)
+{
+    u_char  *p, *start, *end;
+
+    start = str->start;
+    end = start + str->length;
+
+    for (p = start; p < end; p++) {
+        if (*p == ';' || *p == '\n') {
+            njs_chb_append(chain, start, p - start);
+            njs_chb_append_literal(chain, "_");
+            start = p + 1;
+        }
+    }
+
+    njs_chb_append(chain, start, end - start);
+}
+
+
+/*
+ * An uncompressed pprof profile.proto message.  A function refers to
+ * its name and file name in the string table by indexes, so the table
+ * lists them in the order of the functions after the fixed strings.
+ */
+
+static void
+njs_profile_pprof(njs_profile_t *profile, njs_chb_t *chain)
+{
+    u_char               *p, *q;
+    uint32_t             *ids, *location;
+    uint64_t             index, count;
+    njs_str_t            name, file;
+    njs_uint_t           i, n;
+    njs_profile_entry_t  **stacks, **locations, **functions;
+    u_char               msg[64 + NJS_PROFILE_DEPTH_MAX * 2
+                             * NJS_PB_VARINT_MAX];
+    u_char               packed[NJS_PROFILE_DEPTH_MAX * NJS_PB_VARINT_MAX];
+
+    stacks = profile->stacks.entries->start;
+    locations = profile->locations.entries->start;
+    functions = profile->functions.entries->start;
+
+    /* The values of a sample: the number of samples and the CPU time. */
+
+    p = njs_profile_pb_varint(msg, 1, NJS_PROFILE_STR_SAMPLES);
+    p = njs_profile_pb_varint(p, 2, NJS_PROFILE_STR_COUNT);
+    njs_profile_pb_bytes(chain, NJS_PB_PROFILE_SAMPLE_TYPE, msg, p - msg);
+
+    p = njs_profile_pb_varint(msg, 1, NJS_PROFILE_STR_CPU);
+    p = njs_profile_pb_varint(p, 2, NJS_PROFILE_STR_NANOSECONDS);
+    njs_profile_pb_bytes(chain, NJS_PB_PROFILE_SAMPLE_TYPE, msg, p - msg);
+    njs_profile_pb_bytes(chain, NJS_PB_PROFILE_PERIOD_TYPE, msg, p - msg);
+
+    p = njs_profile_pb_varint(msg, NJS_PB_PROFILE_PERIOD,
+                              (uint64_t) profile->period * 1000);
+    njs_chb_append(chain, msg, p - msg);
+
+    for (i = 0; i < profile->stacks.entries->items; i++) {
+        ids = (uint32_t *) stacks[i]->key.start;
+        n = stacks[i]->key.length / sizeof(uint32_t);
+
+        q = packed;
+
+        while (n != 0) {
+            q = njs_profile_varint(q, *ids++);
+            n--;
+        }
+
+        p = njs_profile_varint(msg, 1 << 3 | NJS_PB_BYTES);
+        p = njs_profile_varint(p, q - packed);
+        p = njs_cpymem(p, packed, q - packed);
+
+        count = stacks[i]->count;
+
+        q = njs_profile_varint(packed, count);
+        q = njs_profile_varint(q, count * profile->period * 1000);
+
+        p = njs_profile_varint(p, 2 << 3 | NJS_PB_BYTES);
+        p = njs_profile_varint(p, q - packed);
+        p = njs_cpymem(p, packed, q - packed);
+
+        njs_profile_pb_bytes(chain, NJS_PB_PROFILE_SAMPLE, msg, p - msg);
+    }
+
+    for (i = 0; i < profile->locations.entries->items; i++) {
+        location = (uint32_t *) locations[i]->key.start;
+
+        q = njs_profile_pb_varint(packed, 1, location[0]);
+        q = njs_profile_pb_varint(q, 2, location[1]);
+
+        p = njs_profile_pb_varint(msg, 1, locations[i]->id);
+        p = njs_profile_varint(p, 4 << 3 | NJS_PB_BYTES);
+        p = njs_profile_varint(p, q - packed);
+        p = njs_cpymem(p, packed, q - packed);
+
+        njs_profile_pb_bytes(chain, NJS_PB_PROFILE_LOCATION, msg, p - msg);
+    }
+
+    for (i = 0; i < profile->functions.entries->items; i++) {
+        index = NJS_PROFILE_STR_FUNCTIONS + 2 * i;
+
+        p = njs_profile_pb_varint(msg, 1, functions[i]->id);
+        p = njs_profile_pb_varint(p, 2, index);
+        p = njs_profile_pb_varint(p, 3, index);
+        p = njs_profile_pb_varint(p, 4, index + 1);
+
+        njs_profile_pb_bytes(chain, NJS_PB_PROFILE_FUNCTION, msg, p - msg);
+    }
+
+    for (i = 0; i < njs_nitems(njs_profile_strings); i++) {
+        njs_profile_pb_bytes(chain, NJS_PB_PROFILE_STRING_TABLE,
+                             njs_profile_strings[i].start,
+                             njs_profile_strings[i].length);
+    }
+
+    for (i = 0; i < profile->functions.entries->items; i++) {
+        njs_profile_function_get(functions[i], &name, &file);
+
+        njs_profile_pb_bytes(chain, NJS_PB_PROFILE_STRING_TABLE, name.start,
+                             name.length);
+        njs_profile_pb_bytes(chain, NJS_PB_PROFILE_STRING_TABLE, file.start,
+                             file.length);
+    }
+}
+
+
+static void
+njs_profile_pb_bytes(njs_chb_t *chain, njs_uint_t field, const u_char *data,
+    size_t length)
+{
+    u_char  *p, buf[2 * NJS_PB_VARINT_MAX];
+
+    p = njs_profile_varint(buf, field << 3 | NJS_PB_BYTES);
+    p = njs_profile_varint(p, length);
+
+    njs_chb_append(chain, buf, p - buf);
+    njs_chb_append(chain, data, length);
+}
+
+
+static u_char *
+njs_profile_pb_varint(u_char *p, njs_uint_t field, uint64_t value)
+{
+    p = njs_profile_varint(p, field << 3 | NJS_PB_VARINT);
+
+    return njs_profile_varint(p, value);
+}
+
+
+static u_char *
+njs_profile_varint(u_char *p, uint64_t value)
+{
+    while (value >= 0x80) {
+        *p++ = (u_char) (value | 0x80);
+        value >>= 7;
+    }
+
+    *p++ = (u_char) value;
+
+    return p;
+}
@@ -0,0 +1,20 @@
+
+/*
+ * Copyright (C) NGINX, Inc.
+ */
+
+#ifndef _NJS_PROFILE_H_INCLUDED_
+#define _NJS_PROFILE_H_INCLUDED_
+
+
+/* The maximum number of frames recorded in a sample, the leaf ones. */
+#define NJS_PROFILE_DEPTH_MAX  64
+
+
+extern volatile sig_atomic_t  njs_profile_pending;
+
+
+void njs_profile_sample(njs_vm_t *vm, u_char *pc);
+
+
+#endif /* _NJS_PROFILE_H_INCLUDED_ */
@@ -35,6 +35,10 @@ static njs_array_t *njs_regexp_exec_result(njs_vm_t *vm, njs_value_t *r,
 njs_int_t
 njs_regexp_init(njs_vm_t *vm)
 {
+    if (vm->regex_generic_ctx != NULL) {
+        return NJS_OK;
+    }
+
     vm->regex_generic_ctx = njs_regex_generic_ctx_create(njs_regexp_malloc,
                                                          njs_regexp_free,
                                                          vm->mem_pool);
@@ -423,6 +427,11 @@ njs_regexp_pattern_compile(njs_vm_t *vm, njs_regex_t *regex, u_char *source,
     njs_int_t            ret;
     njs_trace_handler_t  handler;
 
+    ret = njs_regexp_init(vm);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return NJS_ERROR;
+    }
+
     handler = vm->trace.handler;
     vm->trace.handler = njs_regexp_compile_trace_handler;
 
@@ -902,6 +911,11 @@ njs_regexp_builtin_exec(njs_vm_t *vm, njs_value_t *r, njs_value_t *s,
         goto not_found;
     }
 
+    ret = njs_regexp_init(vm);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return NJS_ERROR;
+    }
+
     match_data = njs_regex_match_data(&pattern->regex[type],
                                       vm->regex_generic_ctx);
     if (njs_slow_path(match_data == NULL)) {
@@ -12,19 +12,6 @@ static njs_value_t *njs_scope_value_index(njs_vm_t *vm, const njs_value_t *src,
     njs_uint_t runtime, njs_index_t **index);
 
 
-njs_index_t
-njs_scope_temp_index(njs_parser_scope_t *scope)
-{
-    scope = njs_function_scope(scope);
-    if (njs_slow_path(scope == NULL)) {
-        return NJS_INDEX_ERROR;
-    }
-
-    return njs_scope_index(scope->type, scope->items++, NJS_LEVEL_LOCAL,
-                           NJS_VARIABLE_VAR);
-}
-
-
 njs_value_t **
 njs_scope_make(njs_vm_t *vm, uint32_t count)
 {
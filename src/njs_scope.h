@@ -26,7 +26,6 @@
 #define NJS_INDEX_ERROR         ((njs_index_t) -1)
 
 
-njs_index_t njs_scope_temp_index(njs_parser_scope_t *scope);
 njs_value_t **njs_scope_make(njs_vm_t *vm, uint32_t count);
 njs_index_t njs_scope_global_index(njs_vm_t *vm, const njs_value_t *src,
     njs_uint_t runtime);
@@ -0,0 +1,422 @@
+
+/*
+ * Copyright (C) F5, Inc.
+ */
+
+#ifndef _NJS_SIMD_H_INCLUDED_
+#define _NJS_SIMD_H_INCLUDED_
+
+
+/*
+ * 16 byte vectors available on all the CPUs of an architecture: SSE2 on
+ * x86-64 and NEON on AArch64, so no runtime CPU detection is required.
+ *
+ * njs_simd_mask() converts a vector of 0x00 and 0xff bytes into an integer
+ * with NJS_SIMD_MASK_BITS bits per byte, the first byte in the lowest bits;
+ * NJS_SIMD_MASK_ALL is the mask of a vector with all the bytes set,
+ * NJS_SIMD_MASK_LOW keeps a single bit per byte.
+ *
+ * Comparisons return 0xff bytes for true and 0x00 bytes for false.
+ * njs_simd_range() checks lo <= v <= hi for bounds within 0x00..0x7e, bytes
+ * with the high bit set are always out of range.
+ */
+
+#if (NJS_HAVE_SSE2)
+
+#include <emmintrin.h>
+
+#define NJS_SIMD_SIZE       16
+#define NJS_SIMD_MASK_BITS  1
+#define NJS_SIMD_MASK_ALL   0xffff
+#define NJS_SIMD_MASK_LOW   0xffff
+
+typedef __m128i  njs_simd_t;
+
+
+njs_inline njs_simd_t
+njs_simd_load(const u_char *p)
+{
+    return _mm_loadu_si128((const __m128i *) p);
+}
+
+
+njs_inline void
+njs_simd_store(u_char *p, njs_simd_t v)
+{
+    _mm_storeu_si128((__m128i *) p, v);
+}
+
+
+njs_inline njs_simd_t
+njs_simd_splat(u_char c)
+{
+    return _mm_set1_epi8((char) c);
+}
+
+
+njs_inline njs_simd_t
+njs_simd_and(njs_simd_t a, njs_simd_t b)
+{
+    return _mm_and_si128(a, b);
+}
+
+
+njs_inline njs_simd_t
+njs_simd_or(njs_simd_t a, njs_simd_t b)
+{
+    return _mm_or_si128(a, b);
+}
+
+
+njs_inline njs_simd_t
+njs_simd_add(njs_simd_t a, njs_simd_t b)
+{
+    return _mm_add_epi8(a, b);
+}
+
+
+njs_inline njs_simd_t
+njs_simd_eq(njs_simd_t v, u_char c)
+{
+    return _mm_cmpeq_epi8(v, njs_simd_splat(c));
+}
+
+
+njs_inline njs_simd_t
+njs_simd_equal(njs_simd_t a, njs_simd_t b)
+{
+    return _mm_cmpeq_epi8(a, b);
+}
+
+
+njs_inline njs_simd_t
+njs_simd_range(njs_simd_t v, u_char lo, u_char hi)
+{
+    return _mm_and_si128(_mm_cmpgt_epi8(v, njs_simd_splat(lo - 1)),
+                         _mm_cmplt_epi8(v, njs_simd_splat(hi + 1)));
+}
+
+
+njs_inline njs_simd_t
+njs_simd_high(njs_simd_t v)
+{
+    return _mm_cmplt_epi8(v, _mm_setzero_si128());
+}
+
+
+njs_inline uint64_t
+njs_simd_mask(njs_simd_t v)
+{
+    return (uint32_t) _mm_movemask_epi8(v);
+}
+
+
+/* Splits bytes into high and low nibbles. */
+
+njs_inline void
+njs_simd_nibbles(njs_simd_t v, njs_simd_t *hi, njs_simd_t *lo)
+{
+    __m128i  m;
+
+    m = _mm_set1_epi8(0x0f);
+
+    *hi = _mm_and_si128(_mm_srli_epi16(v, 4), m);
+    *lo = _mm_and_si128(v, m);
+}
+
+
+/* Joins nibbles into bytes. */
+
+njs_inline njs_simd_t
+njs_simd_join_nibbles(njs_simd_t hi, njs_simd_t lo)
+{
+    return _mm_or_si128(_mm_slli_epi16(hi, 4), lo);
+}
+
+
+/* Stores 32 bytes interleaving a and b: a[0], b[0], a[1], b[1], ... */
+
+njs_inline void
+njs_simd_store_zip(u_char *p, njs_simd_t a, njs_simd_t b)
+{
+    _mm_storeu_si128((__m128i *) p, _mm_unpacklo_epi8(a, b));
+    _mm_storeu_si128((__m128i *) (p + 16), _mm_unpackhi_epi8(a, b));
+}
+
+
+/*
+ * Splits the first 12 bytes into 16 values of 6 bits, as in base64:
+ * every 3 bytes are moved into a 32-bit lane and split there.
+ */
+
+njs_inline njs_simd_t
+njs_simd_split_24(njs_simd_t v)
+{
+    __m128i  x;
+
+    x = _mm_or_si128(
+            _mm_or_si128(_mm_and_si128(v, _mm_set_epi32(0, 0, 0, 0x00ffffff)),
+                         _mm_and_si128(_mm_slli_si128(v, 1),
+                                       _mm_set_epi32(0, 0, 0x00ffffff, 0))),
+            _mm_or_si128(_mm_and_si128(_mm_slli_si128(v, 2),
+                                       _mm_set_epi32(0, 0x00ffffff, 0, 0)),
+                         _mm_and_si128(_mm_slli_si128(v, 3),
+                                       _mm_set_epi32(0x00ffffff, 0, 0, 0))));
+
+    return _mm_or_si128(
+        _mm_or_si128(
+            _mm_and_si128(_mm_srli_epi32(x, 2), _mm_set1_epi32(0x0000003f)),
+            _mm_or_si128(
+                _mm_and_si128(_mm_slli_epi32(x, 12),
+                              _mm_set1_epi32(0x00003000)),
+                _mm_and_si128(_mm_srli_epi32(x, 4),
+                              _mm_set1_epi32(0x00000f00)))),
+        _mm_or_si128(
+            _mm_or_si128(
+                _mm_and_si128(_mm_slli_epi32(x, 10),
+                              _mm_set1_epi32(0x003c0000)),
+                _mm_and_si128(_mm_srli_epi32(x, 6),
+                              _mm_set1_epi32(0x00030000))),
+            _mm_and_si128(_mm_slli_epi32(x, 8), _mm_set1_epi32(0x3f000000))));
+}
+
+
+/*
+ * The reverse of njs_simd_split_24(): joins 16 values of 6 bits into
+ * the first 12 bytes, the last 4 bytes are zeroed.
+ */
+
+njs_inline njs_simd_t
+njs_simd_join_24(njs_simd_t v)
+{
+    __m128i  x;
+
+    x = _mm_or_si128(
+        _mm_or_si128(
+            _mm_or_si128(
+                _mm_and_si128(_mm_slli_epi32(v, 2), _mm_set1_epi32(0x000000fc)),
+                _mm_and_si128(_mm_srli_epi32(v, 12),
+                              _mm_set1_epi32(0x00000003))),
+            _mm_or_si128(
+                _mm_and_si128(_mm_slli_epi32(v, 4), _mm_set1_epi32(0x0000f000)),
+                _mm_and_si128(_mm_srli_epi32(v, 10),
+                              _mm_set1_epi32(0x00000f00)))),
+        _mm_or_si128(
+            _mm_and_si128(_mm_slli_epi32(v, 6), _mm_set1_epi32(0x00c00000)),
+            _mm_and_si128(_mm_srli_epi32(v, 8), _mm_set1_epi32(0x003f0000))));
+
+    return _mm_or_si128(
+        _mm_or_si128(_mm_and_si128(x, _mm_set_epi32(0, 0, 0, 0x00ffffff)),
+                     _mm_and_si128(_mm_srli_si128(x, 1),
+                                   _mm_set_epi32(0, 0, 0x0000ffff,
+                                                 (int) 0xff000000))),
+        _mm_or_si128(_mm_and_si128(_mm_srli_si128(x, 2),
+                                   _mm_set_epi32(0, 0x000000ff,
+                                                 (int) 0xffff0000, 0)),
+                     _mm_and_si128(_mm_srli_si128(x, 3),
+                                   _mm_set_epi32(0, (int) 0xffffff00, 0, 0))));
+}
+
+
+/* Loads 32 bytes into even bytes a and odd bytes b. */
+
+njs_inline void
+njs_simd_load_unzip(const u_char *p, njs_simd_t *a, njs_simd_t *b)
+{
+    __m128i  v0, v1, m;
+
+    v0 = _mm_loadu_si128((const __m128i *) p);
+    v1 = _mm_loadu_si128((const __m128i *) (p + 16));
+    m = _mm_set1_epi16(0x00ff);
+
+    *a = _mm_packus_epi16(_mm_and_si128(v0, m), _mm_and_si128(v1, m));
+    *b = _mm_packus_epi16(_mm_srli_epi16(v0, 8), _mm_srli_epi16(v1, 8));
+}
+
+
+#elif (NJS_HAVE_NEON)
+
+#include <arm_neon.h>
+
+#define NJS_SIMD_SIZE       16
+#define NJS_SIMD_MASK_BITS  4
+#define NJS_SIMD_MASK_ALL   0xffffffffffffffffULL
+#define NJS_SIMD_MASK_LOW   0x1111111111111111ULL
+
+typedef uint8x16_t  njs_simd_t;
+
+
+njs_inline njs_simd_t
+njs_simd_load(const u_char *p)
+{
+    return vld1q_u8(p);
+}
+
+
+njs_inline void
+njs_simd_store(u_char *p, njs_simd_t v)
+{
+    vst1q_u8(p, v);
+}
+
+
+njs_inline njs_simd_t
+njs_simd_splat(u_char c)
+{
+    return vdupq_n_u8(c);
+}
+
+
+njs_inline njs_simd_t
+njs_simd_and(njs_simd_t a, njs_simd_t b)
+{
+    return vandq_u8(a, b);
+}
+
+
+njs_inline njs_simd_t
+njs_simd_or(njs_simd_t a, njs_simd_t b)
+{
+    return vorrq_u8(a, b);
+}
+
+
+njs_inline njs_simd_t
+njs_simd_add(njs_simd_t a, njs_simd_t b)
+{
+    return vaddq_u8(a, b);
+}
+
+
+njs_inline njs_simd_t
+njs_simd_eq(njs_simd_t v, u_char c)
+{
+    return vceqq_u8(v, vdupq_n_u8(c));
+}
+
+
+njs_inline njs_simd_t
+njs_simd_equal(njs_simd_t a, njs_simd_t b)
+{
+    return vceqq_u8(a, b);
+}
+
+
+njs_inline njs_simd_t
+njs_simd_range(njs_simd_t v, u_char lo, u_char hi)
+{
+    return vandq_u8(vcgeq_u8(v, vdupq_n_u8(lo)), vcleq_u8(v, vdupq_n_u8(hi)));
+}
+
+
+njs_inline njs_simd_t
+njs_simd_high(njs_simd_t v)
+{
+    return vcgeq_u8(v, vdupq_n_u8(0x80));
+}
+
+
+njs_inline uint64_t
+njs_simd_mask(njs_simd_t v)
+{
+    return vget_lane_u64(vreinterpret_u64_u8(
+                             vshrn_n_u16(vreinterpretq_u16_u8(v), 4)), 0);
+}
+
+
+njs_inline void
+njs_simd_nibbles(njs_simd_t v, njs_simd_t *hi, njs_simd_t *lo)
+{
+    *hi = vshrq_n_u8(v, 4);
+    *lo = vandq_u8(v, vdupq_n_u8(0x0f));
+}
+
+
+njs_inline njs_simd_t
+njs_simd_join_nibbles(njs_simd_t hi, njs_simd_t lo)
+{
+    return vorrq_u8(vshlq_n_u8(hi, 4), lo);
+}
+
+
+njs_inline void
+njs_simd_store_zip(u_char *p, njs_simd_t a, njs_simd_t b)
+{
+    uint8x16x2_t  v;
+
+    v.val[0] = a;
+    v.val[1] = b;
+
+    vst2q_u8(p, v);
+}
+
+
+njs_inline njs_simd_t
+njs_simd_split_24(njs_simd_t v)
+{
+    uint32x4_t  x;
+
+    static const uint8_t  spread[16] = {
+        0, 1, 2, 0xff, 3, 4, 5, 0xff, 6, 7, 8, 0xff, 9, 10, 11, 0xff
+    };
+
+    x = vreinterpretq_u32_u8(vqtbl1q_u8(v, vld1q_u8(spread)));
+
+    x = vorrq_u32(
+        vorrq_u32(
+            vandq_u32(vshrq_n_u32(x, 2), vdupq_n_u32(0x0000003f)),
+            vorrq_u32(vandq_u32(vshlq_n_u32(x, 12), vdupq_n_u32(0x00003000)),
+                      vandq_u32(vshrq_n_u32(x, 4), vdupq_n_u32(0x00000f00)))),
+        vorrq_u32(
+            vorrq_u32(vandq_u32(vshlq_n_u32(x, 10), vdupq_n_u32(0x003c0000)),
+                      vandq_u32(vshrq_n_u32(x, 6), vdupq_n_u32(0x00030000))),
+            vandq_u32(vshlq_n_u32(x, 8), vdupq_n_u32(0x3f000000))));
+
+    return vreinterpretq_u8_u32(x);
+}
+
+
+njs_inline njs_simd_t
+njs_simd_join_24(njs_simd_t v)
+{
+    uint32x4_t  x, y;
+
+    static const uint8_t  compact[16] = {
+        0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 0xff, 0xff, 0xff, 0xff
+    };
+
+    y = vreinterpretq_u32_u8(v);
+
+    x = vorrq_u32(
+        vorrq_u32(
+            vorrq_u32(vandq_u32(vshlq_n_u32(y, 2), vdupq_n_u32(0x000000fc)),
+                      vandq_u32(vshrq_n_u32(y, 12), vdupq_n_u32(0x00000003))),
+            vorrq_u32(vandq_u32(vshlq_n_u32(y, 4), vdupq_n_u32(0x0000f000)),
+                      vandq_u32(vshrq_n_u32(y, 10), vdupq_n_u32(0x00000f00)))),
+        vorrq_u32(vandq_u32(vshlq_n_u32(y, 6), vdupq_n_u32(0x00c00000)),
+                  vandq_u32(vshrq_n_u32(y, 8), vdupq_n_u32(0x003f0000))));
+
+    return vqtbl1q_u8(vreinterpretq_u8_u32(x), vld1q_u8(compact));
+}
+
+
+njs_inline void
+njs_simd_load_unzip(const u_char *p, njs_simd_t *a, njs_simd_t *b)
+{
+    uint8x16x2_t  v;
+
+    v = vld2q_u8(p);
+
+    *a = v.val[0];
+    *b = v.val[1];
+}
+
+
+#else
+
+#define NJS_SIMD_SIZE       0
+
+#endif
+
+
+#endif /* _NJS_SIMD_H_INCLUDED_ */
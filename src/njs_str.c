@@ -8,6 +8,13 @@
 #include <njs_main.h>
 
 
+/*
+ * The number of bytes compared by memcmp() during the search may not
+ * exceed this limit on the scanned bytes.
+ */
+#define NJS_MEMMEM_WORK(scanned)  (4 * (size_t) (scanned) + 4096)
+
+
 njs_int_t
 njs_strncasecmp(u_char *s1, u_char *s2, size_t n)
 {
@@ -35,3 +42,302 @@ njs_strncasecmp(u_char *s1, u_char *s2, size_t n)
 
     return 0;
 }
+
+
+/*
+ * The Two-Way string matching algorithm by M. Crochemore and D. Perrin,
+ * linear in time and constant in space.
+ */
+
+static size_t
+njs_two_way_max_suffix(const u_char *needle, size_t size, njs_bool_t reverse,
+    size_t *period)
+{
+    u_char  a, b;
+    size_t  j, k, p, suffix;
+
+    suffix = (size_t) -1;
+    j = 0;
+    k = 1;
+    p = 1;
+
+    while (j + k < size) {
+        a = needle[j + k];
+        b = needle[suffix + k];
+
+        if (reverse ? (a > b) : (a < b)) {
+            j += k;
+            k = 1;
+            p = j - suffix;
+
+        } else if (a == b) {
+            if (k != p) {
+                k++;
+
+            } else {
+                j += p;
+                k = 1;
+            }
+
+        } else {
+            suffix = j++;
+            k = 1;
+            p = 1;
+        }
+    }
+
+    *period = p;
+
+    return suffix;
+}
+
+
+static u_char *
+njs_two_way(const u_char *p, const u_char *end, const u_char *needle,
+    size_t size)
+{
+    size_t  i, j, n, suffix, suffix_rev, period, period_rev, memory;
+
+    suffix = njs_two_way_max_suffix(needle, size, 0, &period);
+    suffix_rev = njs_two_way_max_suffix(needle, size, 1, &period_rev);
+
+    /* The critical factorization, "suffix" is the start of the right part. */
+
+    if (suffix + 1 < suffix_rev + 1) {
+        suffix = suffix_rev;
+        period = period_rev;
+    }
+
+    suffix++;
+
+    n = end - p;
+
+    if (n < size) {
+        return NULL;
+    }
+
+    j = 0;
+
+    if (memcmp(needle, needle + period, suffix) == 0) {
+
+        /* A periodic needle, the matched period prefix is remembered. */
+
+        memory = 0;
+
+        while (j <= n - size) {
+            i = njs_max(suffix, memory);
+
+            while (i < size && needle[i] == p[i + j]) {
+                i++;
+            }
+
+            if (i < size) {
+                j += i - suffix + 1;
+                memory = 0;
+                continue;
+            }
+
+            i = suffix - 1;
+
+            while (memory < i + 1 && needle[i] == p[i + j]) {
+                i--;
+            }
+
+            if (i + 1 < memory + 1) {
+                return (u_char *) p + j;
+            }
+
+            j += period;
+            memory = size - period;
+        }
+
+        return NULL;
+    }
+
+    period = njs_max(suffix, size - suffix) + 1;
+
+    while (j <= n - size) {
+        i = suffix;
+
+        while (i < size && needle[i] == p[i + j]) {
+            i++;
+        }
+
+        if (i < size) {
+            j += i - suffix + 1;
+            continue;
+        }
+
+        i = suffix - 1;
+
+        while (i != (size_t) -1 && needle[i] == p[i + j]) {
+            i--;
+        }
+
+        if (i == (size_t) -1) {
+            return (u_char *) p + j;
+        }
+
+        j += period;
+    }
+
+    return NULL;
+}
+
+
+/*
+ * Finds the first occurrence of the needle in [p, end).  Candidates are
+ * selected by the first and the last bytes of the needle, NJS_SIMD_SIZE
+ * positions at once.  When verification of false candidates takes too
+ * long, the search continues with the Two-Way algorithm.
+ */
+
+u_char *
+njs_memmem(const u_char *p, const u_char *end, const u_char *needle,
+    size_t size)
+{
+    u_char        first, last;
+    size_t        work;
+    const u_char  *c, *start, *limit;
+#if (NJS_SIMD_SIZE)
+    uint64_t      mask;
+#endif
+
+    if (size == 0) {
+        return (u_char *) p;
+    }
+
+    if (p >= end || (size_t) (end - p) < size) {
+        return NULL;
+    }
+
+    if (size == 1) {
+        return memchr(p, needle[0], end - p);
+    }
+
+    first = needle[0];
+    last = needle[size - 1];
+
+    start = p;
+    limit = end - size;
+    work = 0;
+
+#if (NJS_SIMD_SIZE)
+
+    while (p + (NJS_SIMD_SIZE - 1) <= limit) {
+        mask = njs_simd_mask(njs_simd_and(
+                                 njs_simd_eq(njs_simd_load(p), first),
+                                 njs_simd_eq(njs_simd_load(p + size - 1),
+                                             last)));
+
+        mask &= NJS_SIMD_MASK_LOW;
+
+        while (mask != 0) {
+            c = p + njs_trailing_zeros64(mask) / NJS_SIMD_MASK_BITS;
+
+            if (memcmp(c + 1, needle + 1, size - 2) == 0) {
+                return (u_char *) c;
+            }
+
+            work += size;
+            mask &= mask - 1;
+        }
+
+        p += NJS_SIMD_SIZE;
+
+        if (njs_slow_path(work > NJS_MEMMEM_WORK(p - start))) {
+            return njs_two_way(p, end, needle, size);
+        }
+    }
+
+#endif
+
+    while (p <= limit) {
+        c = memchr(p, first, limit - p + 1);
+        if (c == NULL) {
+            return NULL;
+        }
+
+        if (c[size - 1] == last && memcmp(c + 1, needle + 1, size - 2) == 0) {
+            return (u_char *) c;
+        }
+
+        p = c + 1;
+        work += size;
+
+        if (njs_slow_path(work > NJS_MEMMEM_WORK(p - start))) {
+            return njs_two_way(p, end, needle, size);
+        }
+    }
+
+    return NULL;
+}
+
+
+/* Finds the last occurrence of the needle in [start, end). */
+
+u_char *
+njs_memrmem(const u_char *start, const u_char *end, const u_char *needle,
+    size_t size)
+{
+    u_char        first, last;
+    const u_char  *p;
+#if (NJS_SIMD_SIZE)
+    uint64_t      mask;
+    njs_uint_t    bit;
+    const u_char  *c;
+#endif
+
+    if (start > end || (size_t) (end - start) < size) {
+        return NULL;
+    }
+
+    if (size == 0) {
+        return (u_char *) end;
+    }
+
+    first = needle[0];
+    last = needle[size - 1];
+
+    /* The last candidate. */
+
+    p = end - size;
+
+#if (NJS_SIMD_SIZE)
+
+    while (p >= start + (NJS_SIMD_SIZE - 1)) {
+        p -= NJS_SIMD_SIZE - 1;
+
+        mask = njs_simd_mask(njs_simd_and(
+                                 njs_simd_eq(njs_simd_load(p), first),
+                                 njs_simd_eq(njs_simd_load(p + size - 1),
+                                             last)));
+
+        mask &= NJS_SIMD_MASK_LOW;
+
+        while (mask != 0) {
+            bit = 63 - njs_leading_zeros64(mask);
+            c = p + bit / NJS_SIMD_MASK_BITS;
+
+            if (memcmp(c + 1, needle + 1, size - 1) == 0) {
+                return (u_char *) c;
+            }
+
+            mask &= ~((uint64_t) 1 << bit);
+        }
+
+        p--;
+    }
+
+#endif
+
+    for ( /* void */ ; p >= start; p--) {
+        if (p[0] == first && p[size - 1] == last
+            && memcmp(p + 1, needle + 1, size - 1) == 0)
+        {
+            return (u_char *) p;
+        }
+    }
+
+    return NULL;
+}
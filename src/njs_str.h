@@ -158,6 +158,10 @@ njs_strstr_starts_with(str, prefix)                                           \
 
 
 NJS_EXPORT njs_int_t njs_strncasecmp(u_char *s1, u_char *s2, size_t n);
+NJS_EXPORT u_char *njs_memmem(const u_char *p, const u_char *end,
+    const u_char *needle, size_t size);
+NJS_EXPORT u_char *njs_memrmem(const u_char *start, const u_char *end,
+    const u_char *needle, size_t size);
 
 
 #endif /* _NJS_STR_H_INCLUDED_ */
@@ -56,6 +56,17 @@ static u_char   njs_basis64url_enc[] =
     "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
 
 
+typedef struct {
+    njs_string_t  *parts[NJS_STRING_ROPE_DEPTH + 1];
+    njs_uint_t    n;
+} njs_string_parts_t;
+
+
+static njs_string_t *njs_string_data(njs_vm_t *vm, const njs_value_t *value);
+static njs_int_t njs_string_flat_test(njs_flathsh_query_t *fhq, void *data);
+static void njs_string_rope_copy(u_char *end, njs_string_t *string);
+static njs_bool_t njs_string_rope_eq(njs_string_t *s1, njs_string_t *s2);
+static njs_string_t *njs_string_parts_next(njs_string_parts_t *parts);
 static void njs_encode_base64_core(njs_str_t *dst, const njs_str_t *src,
     const u_char *basis, njs_uint_t padding);
 static njs_int_t njs_string_decode_base64_core(njs_vm_t *vm,
@@ -74,21 +85,22 @@ static njs_int_t njs_string_match_multiple(njs_vm_t *vm, njs_value_t *args,
 #define njs_base64_decoded_length(len, pad)  (((len / 4) * 3) - pad)
 
 
+static const njs_flathsh_proto_t  njs_string_flat_proto
+    njs_aligned(64) =
+{
+    njs_string_flat_test,
+    njs_flathsh_proto_alloc,
+    njs_flathsh_proto_free,
+};
+
+
 njs_int_t
 njs_string_create(njs_vm_t *vm, njs_value_t *value, const u_char *src,
     size_t size)
 {
-    u_char     *p, *p_end;
     njs_str_t  str;
 
-    p = (u_char *) src;
-    p_end = p + size;
-
-    while (p < p_end && *p < 0x80) {
-          p++;
-    }
-
-    if (p == p_end) {
+    if (njs_utf8_ascii_size(src, src + size) == size) {
         return njs_string_new(vm, value, (u_char *) src, size, size);
     }
 
@@ -219,12 +231,308 @@ njs_string_alloc(njs_vm_t *vm, njs_value_t *value, uint64_t size,
 }
 
 
+static njs_string_t *
+njs_string_data(njs_vm_t *vm, const njs_value_t *value)
+{
+    njs_value_t  s;
+
+    if (njs_slow_path(value->string.data == NULL)) {
+        njs_assert(value->atom_id != NJS_ATOM_STRING_unknown);
+        (void) njs_atom_to_value(vm, &s, value->atom_id);
+        return s.string.data;
+    }
+
+    return value->string.data;
+}
+
+
+njs_int_t
+njs_string_rope(njs_vm_t *vm, njs_value_t *value, const njs_value_t *left,
+    const njs_value_t *right)
+{
+    size_t             size, total;
+    uint32_t           depth;
+    njs_string_t       *l, *r, *part, *copy;
+    njs_string_rope_t  *rope;
+
+    l = njs_string_data(vm, left);
+    r = njs_string_data(vm, right);
+
+    size = (size_t) l->size + r->size;
+
+    if (size < NJS_STRING_ROPE_MIN || l->size == 0 || r->size == 0) {
+        return NJS_DECLINED;
+    }
+
+    if (njs_slow_path(size > NJS_STRING_MAX_LENGTH)) {
+        njs_range_error(vm, "invalid string length");
+        return NJS_ERROR;
+    }
+
+    depth = njs_string_is_rope(l) ? ((njs_string_rope_t *) l)->depth : 0;
+
+    if (njs_string_is_rope(r)) {
+        depth = njs_max(depth, ((njs_string_rope_t *) r)->depth + 1);
+
+    } else {
+        depth = njs_max(depth, 1);
+    }
+
+    if (depth > NJS_STRING_ROPE_DEPTH) {
+        return NJS_DECLINED;
+    }
+
+    /* NJS_STRING_ROPE_MIN ensures that at most one part is short. */
+
+    part = NULL;
+    total = sizeof(njs_string_rope_t);
+
+    if (l->size <= NJS_STRING_ROPE_SHORT) {
+        part = l;
+
+    } else if (r->size <= NJS_STRING_ROPE_SHORT) {
+        part = r;
+    }
+
+    if (part != NULL) {
+        total += sizeof(njs_string_t)
+                 + njs_string_data_size(part->size, part->length);
+    }
+
+    rope = njs_mp_alloc(vm->mem_pool, total);
+    if (njs_slow_path(rope == NULL)) {
+        njs_memory_error(vm);
+        return NJS_ERROR;
+    }
+
+    rope->string.start = NULL;
+    rope->string.size = size;
+    rope->string.length = l->length + r->length;
+    rope->left = l;
+    rope->right = r;
+    rope->mem_pool = vm->mem_pool;
+    rope->depth = depth;
+
+    if (part != NULL) {
+        copy = (njs_string_t *) &rope[1];
+
+        njs_string_data_init(copy, part->size, part->length);
+        memcpy(copy->start, part->start, part->size);
+
+        if (part == l) {
+            rope->left = copy;
+
+        } else {
+            rope->right = copy;
+        }
+    }
+
+    value->type = NJS_STRING;
+    value->truth = 1;
+    value->atom_id = NJS_ATOM_STRING_unknown;
+    value->string.data = &rope->string;
+
+    return NJS_OK;
+}
+
+
+/*
+ * Returns the flat string of the content of a rope.  The rope is
+ * replaced by the flat string in place, unless the rope belongs to
+ * the VM the current VM was cloned from and thus must not be changed.
+ * The flat copy of such a rope is kept in vm->flat_ropes, so it is made
+ * once per clone.
+ */
+
+njs_string_t *
+njs_string_flat(njs_vm_t *vm, njs_string_t *string)
+{
+    u_char               *start;
+    uint32_t             total, map_offset, *map;
+    njs_string_t         *flat;
+    njs_flathsh_elt_t    *elt;
+    njs_string_rope_t    *rope;
+    njs_flathsh_query_t  fhq;
+
+    if (!njs_string_is_rope(string)) {
+        return string;
+    }
+
+    rope = (njs_string_rope_t *) string;
+
+    total = njs_string_data_size(string->size, string->length);
+
+    if (rope->mem_pool == vm->mem_pool) {
+        flat = string;
+        start = njs_mp_alloc(vm->mem_pool, total);
+
+    } else {
+        fhq.key_hash = njs_djb_hash(&string, sizeof(njs_string_t *));
+        fhq.proto = &njs_string_flat_proto;
+        fhq.data = string;
+
+        if (njs_flathsh_find(&vm->flat_ropes, &fhq) == NJS_OK) {
+            elt = fhq.value;
+            return elt->value[1];
+        }
+
+        flat = njs_mp_alloc(vm->mem_pool, sizeof(njs_string_t) + total);
+        start = (flat != NULL) ? (u_char *) &flat[1] : NULL;
+    }
+
+    if (njs_slow_path(start == NULL)) {
+        njs_memory_error(vm);
+        return NULL;
+    }
+
+    njs_string_rope_copy(start + string->size, string);
+
+    start[string->size] = '\0';
+
+    if (string->size != string->length
+        && string->length > NJS_STRING_MAP_STRIDE)
+    {
+        map_offset = njs_string_map_offset(string->size + njs_length("\0"));
+        map = (uint32_t *) (start + map_offset);
+        map[0] = 0;
+    }
+
+    flat->start = start;
+    flat->size = string->size;
+    flat->length = string->length;
+
+    if (flat == string) {
+        /* The parts are not referenced anymore. */
+        rope->left = NULL;
+        rope->right = NULL;
+
+        return flat;
+    }
+
+    fhq.replace = 0;
+    fhq.pool = vm->mem_pool;
+
+    if (njs_slow_path(njs_flathsh_insert(&vm->flat_ropes, &fhq) != NJS_OK)) {
+        njs_mp_free(vm->mem_pool, flat);
+        njs_memory_error(vm);
+        return NULL;
+    }
+
+    elt = fhq.value;
+    elt->value[0] = string;
+    elt->value[1] = flat;
+
+    return flat;
+}
+
+
+static njs_int_t
+njs_string_flat_test(njs_flathsh_query_t *fhq, void *data)
+{
+    return (*(void **) data == fhq->data) ? NJS_OK : NJS_DECLINED;
+}
+
+
+static void
+njs_string_rope_copy(u_char *end, njs_string_t *string)
+{
+    njs_string_rope_t  *rope;
+
+    while (njs_string_is_rope(string)) {
+        rope = (njs_string_rope_t *) string;
+
+        njs_string_rope_copy(end, rope->right);
+
+        end -= rope->right->size;
+        string = rope->left;
+    }
+
+    memcpy(end - string->size, string->start, string->size);
+}
+
+
+/*
+ * A rope must be flattened by njs_string_flatten() or by a conversion to
+ * string before its content is read with njs_string_get() or
+ * njs_string_prop(), they cannot report an error.  Then the content is
+ * available without memory allocation and cannot depend on the memory
+ * left in the pool.
+ */
+
+njs_int_t
+njs_string_flatten(njs_vm_t *vm, const njs_value_t *value)
+{
+    if (njs_slow_path(value->string.data != NULL
+                      && njs_string_is_rope(value->string.data)))
+    {
+        if (njs_slow_path(njs_string_flat(vm, value->string.data) == NULL)) {
+            return NJS_ERROR;
+        }
+    }
+
+    return NJS_OK;
+}
+
+
+njs_string_t *
+njs_string_flattened(njs_vm_t *vm, njs_string_t *string)
+{
+    njs_flathsh_elt_t    *elt;
+    njs_flathsh_query_t  fhq;
+
+    if (!njs_string_is_rope(string)) {
+        return string;
+    }
+
+    /* A rope of the clone itself is replaced by the flat string in place. */
+
+    fhq.key_hash = njs_djb_hash(&string, sizeof(njs_string_t *));
+    fhq.proto = &njs_string_flat_proto;
+    fhq.data = string;
+
+    if (njs_fast_path(njs_flathsh_find(&vm->flat_ropes, &fhq) == NJS_OK)) {
+        elt = fhq.value;
+        return elt->value[1];
+    }
+
+    njs_assert_msg(0, "string: a rope is read before it is flattened");
+
+    return njs_string_flat(vm, string);
+}
+
+
+njs_int_t
+njs_string_get_checked(njs_vm_t *vm, const njs_value_t *value, njs_str_t *str)
+{
+    njs_string_t  *flat;
+
+    if (njs_slow_path(value->string.data != NULL
+                      && njs_string_is_rope(value->string.data)))
+    {
+        flat = njs_string_flat(vm, value->string.data);
+        if (njs_slow_path(flat == NULL)) {
+            return NJS_ERROR;
+        }
+
+        str->length = flat->size;
+        str->start = flat->start;
+
+        return NJS_OK;
+    }
+
+    njs_string_get(vm, value, str);
+
+    return NJS_OK;
+}
+
+
 size_t
 njs_string_prop(njs_vm_t *vm, njs_string_prop_t *string,
     const njs_value_t *value)
 {
-    size_t       size, length;
-    njs_value_t  s;
+    size_t        size, length;
+    njs_value_t   s;
+    njs_string_t  *flat;
 
     if (njs_slow_path(value->string.data == NULL)) {
         njs_assert(value->atom_id != NJS_ATOM_STRING_unknown);
@@ -232,6 +540,24 @@ njs_string_prop(njs_vm_t *vm, njs_string_prop_t *string,
         value = &s;
     }
 
+    if (njs_slow_path(njs_string_is_rope(value->string.data))) {
+        flat = njs_string_flattened(vm, value->string.data);
+        if (njs_slow_path(flat == NULL)) {
+            /* Not reached, the rope is flattened by the caller. */
+            string->start = (u_char *) "";
+            string->size = 0;
+            string->length = 0;
+
+            return 0;
+        }
+
+        string->start = flat->start;
+        string->size = flat->size;
+        string->length = flat->length;
+
+        return (flat->length == 0) ? flat->size : flat->length;
+    }
+
     string->start = (u_char *) value->string.data->start;
     size = value->string.data->size;
     length = value->string.data->length;
@@ -270,12 +596,143 @@ njs_string_hex(njs_vm_t *vm, njs_value_t *retval, const njs_str_t *src)
 }
 
 
+#if (NJS_SIMD_SIZE)
+
+/*
+ * The hex and base64 codecs use the baseline vectors of njs_simd.h, SSE2
+ * on x86-64 and NEON on AArch64, and that is deliberate.  With AVX2 the
+ * byte interleaving of njs_simd_store_zip() and the 24-bit groups of
+ * njs_simd_split_24() would cross 128-bit lanes and need extra permutes,
+ * and the cpuid dispatch per call would not pay off on the short inputs
+ * these functions mostly see.
+ */
+
+/* Converts nibbles to lowercase hex digits. */
+
+njs_inline njs_simd_t
+njs_simd_hex_digits(njs_simd_t n)
+{
+    n = njs_simd_add(n, njs_simd_splat('0'));
+
+    return njs_simd_add(n, njs_simd_and(njs_simd_range(n, '9' + 1, '9' + 6),
+                                        njs_simd_splat('a' - '9' - 1)));
+}
+
+
+/*
+ * Converts hex digits to nibbles, the same characters as njs_char_to_hex()
+ * are accepted.  Returns the mask of valid bytes.
+ */
+
+njs_inline njs_simd_t
+njs_simd_hex_nibbles(njs_simd_t v, njs_simd_t *n)
+{
+    njs_simd_t  digit, letter, offset;
+
+    v = njs_simd_or(v, njs_simd_splat(0x20));
+
+    digit = njs_simd_range(v, '0', '9');
+    letter = njs_simd_range(v, 'a', 'f');
+
+    offset = njs_simd_and(digit, njs_simd_splat((u_char) -'0'));
+    offset = njs_simd_or(offset, njs_simd_and(letter,
+                                       njs_simd_splat((u_char) (10 - 'a'))));
+
+    *n = njs_simd_add(v, offset);
+
+    return njs_simd_or(digit, letter);
+}
+
+
+/*
+ * Converts base64 characters to 6-bit values.  Returns the mask of valid
+ * bytes.
+ */
+
+njs_inline njs_simd_t
+njs_simd_base64_values(njs_simd_t v, const u_char *basis, njs_simd_t *n)
+{
+    u_char      c62, c63;
+    njs_simd_t  mask, valid, offset;
+
+    if (basis == njs_basis64url) {
+        c62 = '-';
+        c63 = '_';
+
+    } else {
+        c62 = '+';
+        c63 = '/';
+    }
+
+    valid = njs_simd_range(v, 'A', 'Z');
+    offset = njs_simd_and(valid, njs_simd_splat((u_char) -'A'));
+
+    mask = njs_simd_range(v, 'a', 'z');
+    valid = njs_simd_or(valid, mask);
+    offset = njs_simd_or(offset, njs_simd_and(mask,
+                                       njs_simd_splat((u_char) (26 - 'a'))));
+
+    mask = njs_simd_range(v, '0', '9');
+    valid = njs_simd_or(valid, mask);
+    offset = njs_simd_or(offset, njs_simd_and(mask,
+                                       njs_simd_splat((u_char) (52 - '0'))));
+
+    mask = njs_simd_eq(v, c62);
+    valid = njs_simd_or(valid, mask);
+    offset = njs_simd_or(offset, njs_simd_and(mask,
+                                       njs_simd_splat((u_char) (62 - c62))));
+
+    mask = njs_simd_eq(v, c63);
+    valid = njs_simd_or(valid, mask);
+    offset = njs_simd_or(offset, njs_simd_and(mask,
+                                       njs_simd_splat((u_char) (63 - c63))));
+
+    *n = njs_simd_add(v, offset);
+
+    return valid;
+}
+
+
+/* Converts 6-bit values to base64 characters. */
+
+njs_inline njs_simd_t
+njs_simd_base64_chars(njs_simd_t n, const u_char *basis)
+{
+    u_char      c62, c63;
+    njs_simd_t  offset;
+
+    c62 = basis[62] - 62 - 'A';
+    c63 = basis[63] - 63 - 'A';
+
+    offset = njs_simd_splat('A');
+
+    offset = njs_simd_add(offset, njs_simd_and(njs_simd_range(n, 26, 51),
+                                       njs_simd_splat('a' - 26 - 'A')));
+
+    offset = njs_simd_add(offset, njs_simd_and(njs_simd_range(n, 52, 61),
+                                  njs_simd_splat((u_char) ('0' - 52 - 'A'))));
+
+    offset = njs_simd_add(offset, njs_simd_and(njs_simd_eq(n, 62),
+                                               njs_simd_splat(c62)));
+
+    offset = njs_simd_add(offset, njs_simd_and(njs_simd_eq(n, 63),
+                                               njs_simd_splat(c63)));
+
+    return njs_simd_add(n, offset);
+}
+
+#endif
+
+
 void
 njs_encode_hex(njs_str_t *dst, const njs_str_t *src)
 {
     u_char        *p, c;
     size_t        i, len;
     const u_char  *start;
+#if (NJS_SIMD_SIZE)
+    njs_simd_t    hi, lo;
+#endif
 
     static const u_char  hex[] = "0123456789abcdef";
 
@@ -283,8 +740,19 @@ njs_encode_hex(njs_str_t *dst, const njs_str_t *src)
     start = src->start;
 
     p = dst->start;
+    i = 0;
+
+#if (NJS_SIMD_SIZE)
 
-    for (i = 0; i < len; i++) {
+    for ( /* void */ ; i + NJS_SIMD_SIZE <= len; i += NJS_SIMD_SIZE) {
+        njs_simd_nibbles(njs_simd_load(&start[i]), &hi, &lo);
+        njs_simd_store_zip(p, njs_simd_hex_digits(hi), njs_simd_hex_digits(lo));
+        p += 2 * NJS_SIMD_SIZE;
+    }
+
+#endif
+
+    for ( /* void */ ; i < len; i++) {
         c = start[i];
         *p++ = hex[c >> 4];
         *p++ = hex[c & 0x0f];
@@ -347,6 +815,21 @@ njs_encode_base64_core(njs_str_t *dst, const njs_str_t *src,
     s = src->start;
     d = dst->start;
 
+#if (NJS_SIMD_SIZE)
+
+    /* 12 bytes are encoded per step, but 16 bytes are loaded. */
+
+    while (len >= NJS_SIMD_SIZE) {
+        njs_simd_store(d, njs_simd_base64_chars(
+                              njs_simd_split_24(njs_simd_load(s)), basis));
+
+        s += NJS_SIMD_SIZE / 4 * 3;
+        d += NJS_SIMD_SIZE;
+        len -= NJS_SIMD_SIZE / 4 * 3;
+    }
+
+#endif
+
     while (len > 2) {
         c0 = s[0];
         c1 = s[1];
@@ -556,16 +1039,94 @@ njs_string_instance_length(njs_vm_t *vm, njs_object_prop_t *prop,
 njs_bool_t
 njs_string_eq(njs_vm_t *vm, const njs_value_t *v1, const njs_value_t *v2)
 {
-    njs_str_t  s1, s2;
+    njs_string_t  *s1, *s2;
 
-    njs_string_get(vm, v1, &s1);
-    njs_string_get(vm, v2, &s2);
+    s1 = njs_string_data(vm, v1);
+    s2 = njs_string_data(vm, v2);
 
-    if (s1.length != s2.length) {
+    if (s1->size != s2->size) {
         return 0;
     }
 
-    return (memcmp(s1.start, s2.start, s1.length) == 0);
+    if (njs_slow_path(njs_string_is_rope(s1) || njs_string_is_rope(s2))) {
+        /*
+         * The values compared by the builtins may be kept in objects
+         * and are not flattened, the comparison of the ropes needs
+         * no memory and cannot fail.
+         */
+        return njs_string_rope_eq(s1, s2);
+    }
+
+    return (memcmp(s1->start, s2->start, s1->size) == 0);
+}
+
+
+static njs_bool_t
+njs_string_rope_eq(njs_string_t *s1, njs_string_t *s2)
+{
+    size_t              n, size, size1, size2;
+    njs_string_t        *p1, *p2;
+    njs_string_parts_t  parts1, parts2;
+
+    parts1.parts[0] = s1;
+    parts1.n = 1;
+
+    parts2.parts[0] = s2;
+    parts2.n = 1;
+
+    p1 = NULL;
+    p2 = NULL;
+    size1 = 0;
+    size2 = 0;
+
+    /* The contents are compared from the end, the sizes are equal. */
+
+    for (size = s1->size; size != 0; size -= n) {
+        if (size1 == 0) {
+            p1 = njs_string_parts_next(&parts1);
+            size1 = p1->size;
+        }
+
+        if (size2 == 0) {
+            p2 = njs_string_parts_next(&parts2);
+            size2 = p2->size;
+        }
+
+        n = njs_min(size1, size2);
+
+        if (memcmp(&p1->start[size1 - n], &p2->start[size2 - n], n) != 0) {
+            return 0;
+        }
+
+        size1 -= n;
+        size2 -= n;
+    }
+
+    return 1;
+}
+
+
+/*
+ * Returns the parts of a rope from the last one.  Only the left parts
+ * are kept in the stack, so its size is limited by NJS_STRING_ROPE_DEPTH.
+ */
+
+static njs_string_t *
+njs_string_parts_next(njs_string_parts_t *parts)
+{
+    njs_string_t       *string;
+    njs_string_rope_t  *rope;
+
+    string = parts->parts[--parts->n];
+
+    while (njs_string_is_rope(string)) {
+        rope = (njs_string_rope_t *) string;
+
+        parts->parts[parts->n++] = rope->left;
+        string = rope->right;
+    }
+
+    return string;
 }
 
 
@@ -706,12 +1267,9 @@ njs_string_prototype_concat(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
             length += njs_length("undefined");
 
         } else {
-            if (!njs_is_string(&args[i])) {
-                ret = njs_value_to_string(vm, &args[i], &args[i]);
-                if (ret != NJS_OK) {
-                    return ret;
-                }
-
+            ret = njs_value_to_string(vm, &args[i], &args[i]);
+            if (ret != NJS_OK) {
+                return ret;
             }
 
             njs_string_prop(vm, &string, &args[i]);
@@ -782,21 +1340,16 @@ njs_string_prototype_concat(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
 njs_inline njs_int_t
 njs_string_object_validate(njs_vm_t *vm, njs_value_t *object)
 {
-    njs_int_t  ret;
-
     if (njs_slow_path(njs_is_null_or_undefined(object))) {
         njs_type_error(vm, "cannot convert undefined to object");
         return NJS_ERROR;
     }
 
     if (njs_slow_path(!njs_is_string(object))) {
-        ret = njs_value_to_string(vm, object, object);
-        if (njs_slow_path(ret != NJS_OK)) {
-            return ret;
-        }
+        return njs_value_to_string(vm, object, object);
     }
 
-    return NJS_OK;
+    return njs_string_flatten(vm, object);
 }
 
 
@@ -1235,14 +1788,37 @@ njs_decode_hex(njs_str_t *dst, const njs_str_t *src)
     njs_int_t     c;
     njs_uint_t    i, n;
     const u_char  *start;
+#if (NJS_SIMD_SIZE)
+    njs_simd_t    hi, lo, valid;
+#endif
+
+    n = 0;
+    p = dst->start;
+
+    start = src->start;
+    len = src->length;
+    i = 0;
+
+#if (NJS_SIMD_SIZE)
+
+    for ( /* void */ ; i + 2 * NJS_SIMD_SIZE <= len; i += 2 * NJS_SIMD_SIZE) {
+        njs_simd_load_unzip(&start[i], &hi, &lo);
+
+        valid = njs_simd_and(njs_simd_hex_nibbles(hi, &hi),
+                             njs_simd_hex_nibbles(lo, &lo));
+
+        if (njs_slow_path(njs_simd_mask(valid) != NJS_SIMD_MASK_ALL)) {
+            /* The scalar loop stops at the invalid character. */
+            break;
+        }
 
-    n = 0;
-    p = dst->start;
+        njs_simd_store(p, njs_simd_join_nibbles(hi, lo));
+        p += NJS_SIMD_SIZE;
+    }
 
-    start = src->start;
-    len = src->length;
+#endif
 
-    for (i = 0; i < len; i++) {
+    for ( /* void */ ; i < len; i++) {
         c = njs_char_to_hex(start[i]);
         if (njs_slow_path(c < 0)) {
             break;
@@ -1332,19 +1908,52 @@ njs_string_decode_hex(njs_vm_t *vm, njs_value_t *retval, const njs_str_t *src)
 }
 
 
+/* Returns the number of leading characters of the base64 alphabet. */
+
 static size_t
-njs_decode_base64_length_core(const njs_str_t *src, const u_char *basis,
-    size_t *out_size)
+njs_decode_base64_valid(const njs_str_t *src, const u_char *basis)
 {
-    uint    pad;
-    size_t  len;
+    size_t      len;
+#if (NJS_SIMD_SIZE)
+    njs_simd_t  n, valid;
+#endif
+
+    len = 0;
+
+#if (NJS_SIMD_SIZE)
+
+    for ( /* void */ ; len + NJS_SIMD_SIZE <= src->length;
+         len += NJS_SIMD_SIZE)
+    {
+        valid = njs_simd_base64_values(njs_simd_load(&src->start[len]), basis,
+                                       &n);
+
+        if (njs_simd_mask(valid) != NJS_SIMD_MASK_ALL) {
+            break;
+        }
+    }
 
-    for (len = 0; len < src->length; len++) {
+#endif
+
+    for ( /* void */ ; len < src->length; len++) {
         if (basis[src->start[len]] == 77) {
             break;
         }
     }
 
+    return len;
+}
+
+
+static size_t
+njs_decode_base64_length_core(const njs_str_t *src, const u_char *basis,
+    size_t *out_size)
+{
+    uint    pad;
+    size_t  len;
+
+    len = njs_decode_base64_valid(src, basis);
+
     pad = 0;
 
     if (len % 4 != 0) {
@@ -1380,14 +1989,35 @@ static void
 njs_decode_base64_core(njs_str_t *dst, const njs_str_t *src,
     const u_char *basis)
 {
-    size_t  len;
-    u_char  *d, *s;
+    size_t      len;
+    u_char      *d, *s;
+#if (NJS_SIMD_SIZE)
+    njs_simd_t  v;
+#endif
 
     s = src->start;
     d = dst->start;
 
     len = dst->length;
 
+#if (NJS_SIMD_SIZE)
+
+    /*
+     * The characters are already validated by the length function.
+     * 16 characters are decoded per step, but 16 bytes are stored.
+     */
+
+    while (len >= NJS_SIMD_SIZE) {
+        (void) njs_simd_base64_values(njs_simd_load(s), basis, &v);
+        njs_simd_store(d, njs_simd_join_24(v));
+
+        s += NJS_SIMD_SIZE;
+        d += NJS_SIMD_SIZE / 4 * 3;
+        len -= NJS_SIMD_SIZE / 4 * 3;
+    }
+
+#endif
+
     while (len >= 3) {
         *d++ = (u_char) (basis[s[0]] << 2 | basis[s[1]] >> 4);
         *d++ = (u_char) (basis[s[1]] << 4 | basis[s[2]] >> 2);
@@ -1576,58 +2206,60 @@ range_error:
 }
 
 
-static int64_t
-njs_string_index_of(njs_string_prop_t *string, njs_string_prop_t *search,
-    size_t from)
-{
-    size_t        index, length, search_length;
-    const u_char  *p, *end;
+/*
+ * The number of characters in a part of a valid UTF-8 string, that is
+ * the number of bytes other than continuation bytes.
+ */
 
-    length = string->length;
+njs_inline size_t
+njs_string_utf8_count(const u_char *p, const u_char *end)
+{
+    size_t  n, size;
 
-    if (search->length == 0 && from <= length) {
-        return from;
-    }
+    n = 0;
 
-    index = from;
-    search_length = search->length;
+    while (p < end) {
+        size = njs_utf8_ascii_size(p, end);
+        n += size;
+        p += size;
 
-    if (length - index >= search_length) {
-        end = string->start + string->size;
+        while (p < end && *p >= 0x80) {
+            n += ((*p & 0xc0) != 0x80);
+            p++;
+        }
+    }
 
-        if (string->size == length) {
-            /* ASCII string. */
+    return n;
+}
 
-            end -= (search->size - 1);
 
-            for (p = string->start + index; p < end; p++) {
-                if (memcmp(p, search->start, search->size) == 0) {
-                    return index;
-                }
+static int64_t
+njs_string_index_of(njs_string_prop_t *string, njs_string_prop_t *search,
+    size_t from)
+{
+    const u_char  *p, *end, *found;
 
-                index++;
-            }
+    if (search->length == 0 && from <= string->length) {
+        return from;
+    }
 
-        } else {
-            /* UTF-8 string. */
+    if (string->length - from < search->length) {
+        return -1;
+    }
 
-            p = (index < string->length)
-                    ? njs_string_utf8_offset(string->start, end, index)
-                    : end;
-            end -= search->size - 1;
+    end = string->start + string->size;
+    p = njs_string_offset(string, from);
 
-            while (p < end) {
-                if (memcmp(p, search->start, search->size) == 0) {
-                    return index;
-                }
+    found = njs_memmem(p, end, search->start, search->size);
+    if (found == NULL) {
+        return -1;
+    }
 
-                index++;
-                p = njs_utf8_next(p, end);
-            }
-        }
+    if (njs_is_ascii_string(string)) {
+        return found - string->start;
     }
 
-    return -1;
+    return from + njs_string_utf8_count(p, found);
 }
 
 
@@ -1741,14 +2373,9 @@ njs_string_prototype_last_index_of(njs_vm_t *vm, njs_value_t *args,
             p = end - s.size;
         }
 
-        for (; p >= string.start; p--) {
-            if (memcmp(p, s.start, s.size) == 0) {
-                index = p - string.start;
-                goto done;
-            }
-        }
+        p = njs_memrmem(string.start, p + s.size, s.start, s.size);
 
-        index = -1;
+        index = (p != NULL) ? p - string.start : -1;
 
     } else {
         /* UTF-8 string. */
@@ -1760,15 +2387,18 @@ njs_string_prototype_last_index_of(njs_vm_t *vm, njs_value_t *args,
 
         p = njs_string_utf8_offset(string.start, end, index);
 
-        for (; p >= string.start;  p = njs_utf8_prev(p, string.start)) {
-            if ((p + s.size) <= end && memcmp(p, s.start, s.size) == 0) {
-                goto done;
-            }
+        if ((size_t) (end - p) > s.size) {
+            end = p + s.size;
+        }
 
-            index--;
+        p = njs_memrmem(string.start, end, s.start, s.size);
+
+        if (p == NULL) {
+            index = -1;
+            goto done;
         }
 
-        index = -1;
+        index = njs_string_index(&string, p - string.start);
     }
 
 done:
@@ -1839,14 +2469,8 @@ njs_string_prototype_includes(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
             end = string.start + string.size;
             p = njs_string_offset(&string, index);
 
-            end -= search.size - 1;
-
-            while (p < end) {
-                if (memcmp(p, search.start, search.size) == 0) {
-                    return NJS_OK;
-                }
-
-                p++;
+            if (njs_memmem(p, end, search.start, search.size) != NULL) {
+                return NJS_OK;
             }
         }
     }
@@ -2065,7 +2689,7 @@ static njs_int_t
 njs_string_prototype_to_lower_case(njs_vm_t *vm, njs_value_t *args,
     njs_uint_t nargs, njs_index_t unused, njs_value_t *retval)
 {
-    size_t             size, length;
+    size_t             n, size;
     u_char             *p;
     uint32_t           code;
     njs_int_t          ret;
@@ -2086,26 +2710,24 @@ njs_string_prototype_to_lower_case(njs_vm_t *vm, njs_value_t *args,
             return NJS_ERROR;
         }
 
-        s = string.start;
-        size = string.size;
-
-        while (size != 0) {
-            *p++ = njs_lower_case(*s++);
-            size--;
-        }
+        njs_utf8_ascii_lower_case(p, string.start, string.size);
 
     } else {
-        /* UTF-8 string. */
+        /* UTF-8 string, ASCII spans are mapped at once. */
         s = string.start;
         end = s + string.size;
-        length = string.length;
 
         size = 0;
 
-        while (length != 0) {
-            code = njs_utf8_lower_case(&s, end);
-            size += njs_utf8_size(code);
-            length--;
+        while (s < end) {
+            n = njs_utf8_ascii_size(s, end);
+            size += n;
+            s += n;
+
+            if (s < end) {
+                code = njs_utf8_lower_case(&s, end);
+                size += njs_utf8_size(code);
+            }
         }
 
         p = njs_string_alloc(vm, retval, size, string.length);
@@ -2114,12 +2736,17 @@ njs_string_prototype_to_lower_case(njs_vm_t *vm, njs_value_t *args,
         }
 
         s = string.start;
-        length = string.length;
 
-        while (length != 0) {
-            code = njs_utf8_lower_case(&s, end);
-            p = njs_utf8_encode(p, code);
-            length--;
+        while (s < end) {
+            n = njs_utf8_ascii_size(s, end);
+            njs_utf8_ascii_lower_case(p, s, n);
+            p += n;
+            s += n;
+
+            if (s < end) {
+                code = njs_utf8_lower_case(&s, end);
+                p = njs_utf8_encode(p, code);
+            }
         }
     }
 
@@ -2136,7 +2763,7 @@ static njs_int_t
 njs_string_prototype_to_upper_case(njs_vm_t *vm, njs_value_t *args,
     njs_uint_t nargs, njs_index_t unused, njs_value_t *retval)
 {
-    size_t             size, length;
+    size_t             n, size;
     u_char             *p;
     uint32_t           code;
     njs_int_t          ret;
@@ -2157,26 +2784,24 @@ njs_string_prototype_to_upper_case(njs_vm_t *vm, njs_value_t *args,
             return NJS_ERROR;
         }
 
-        s = string.start;
-        size = string.size;
-
-        while (size != 0) {
-            *p++ = njs_upper_case(*s++);
-            size--;
-        }
+        njs_utf8_ascii_upper_case(p, string.start, string.size);
 
     } else {
-        /* UTF-8 string. */
+        /* UTF-8 string, ASCII spans are mapped at once. */
         s = string.start;
         end = s + string.size;
-        length = string.length;
 
         size = 0;
 
-        while (length != 0) {
-            code = njs_utf8_upper_case(&s, end);
-            size += njs_utf8_size(code);
-            length--;
+        while (s < end) {
+            n = njs_utf8_ascii_size(s, end);
+            size += n;
+            s += n;
+
+            if (s < end) {
+                code = njs_utf8_upper_case(&s, end);
+                size += njs_utf8_size(code);
+            }
         }
 
         p = njs_string_alloc(vm, retval, size, string.length);
@@ -2185,12 +2810,17 @@ njs_string_prototype_to_upper_case(njs_vm_t *vm, njs_value_t *args,
         }
 
         s = string.start;
-        length = string.length;
 
-        while (length != 0) {
-            code = njs_utf8_upper_case(&s, end);
-            p = njs_utf8_encode(p, code);
-            length--;
+        while (s < end) {
+            n = njs_utf8_ascii_size(s, end);
+            njs_utf8_ascii_upper_case(p, s, n);
+            p += n;
+            s += n;
+
+            if (s < end) {
+                code = njs_utf8_upper_case(&s, end);
+                p = njs_utf8_encode(p, code);
+            }
         }
     }
 
@@ -2198,10 +2828,95 @@ njs_string_prototype_to_upper_case(njs_vm_t *vm, njs_value_t *args,
 }
 
 
+#if (NJS_SIMD_SIZE)
+
+njs_inline uint64_t
+njs_simd_whitespace(njs_simd_t v)
+{
+    return njs_simd_mask(njs_simd_or(njs_simd_range(v, 0x09, 0x0D),
+                                     njs_simd_eq(v, 0x20)));
+}
+
+#endif
+
+
+/* The number of ASCII whitespace bytes at the start. */
+
+njs_inline size_t
+njs_string_space_start(const u_char *start, const u_char *end)
+{
+    const u_char  *p;
+#if (NJS_SIMD_SIZE)
+    uint64_t      mask;
+#endif
+
+    p = start;
+
+#if (NJS_SIMD_SIZE)
+
+    while (end - p >= NJS_SIMD_SIZE) {
+        mask = njs_simd_whitespace(njs_simd_load(p));
+
+        if (mask != NJS_SIMD_MASK_ALL) {
+            return (p - start)
+                   + njs_trailing_zeros64(~mask) / NJS_SIMD_MASK_BITS;
+        }
+
+        p += NJS_SIMD_SIZE;
+    }
+
+#endif
+
+    while (p < end && njs_is_whitespace(*p)) {
+        p++;
+    }
+
+    return p - start;
+}
+
+
+/* The number of ASCII whitespace bytes at the end. */
+
+njs_inline size_t
+njs_string_space_end(const u_char *start, const u_char *end)
+{
+    const u_char  *p;
+#if (NJS_SIMD_SIZE)
+    uint64_t      mask;
+#endif
+
+    p = end;
+
+#if (NJS_SIMD_SIZE)
+
+    while (p - start >= NJS_SIMD_SIZE) {
+        mask = njs_simd_whitespace(njs_simd_load(p - NJS_SIMD_SIZE));
+
+        if (mask != NJS_SIMD_MASK_ALL) {
+            mask = ~mask & NJS_SIMD_MASK_ALL;
+
+            return (end - p) + NJS_SIMD_SIZE - 1
+                   - (63 - njs_leading_zeros64(mask)) / NJS_SIMD_MASK_BITS;
+        }
+
+        p -= NJS_SIMD_SIZE;
+    }
+
+#endif
+
+    while (p > start && njs_is_whitespace(p[-1])) {
+        p--;
+    }
+
+    return end - p;
+}
+
+
 uint32_t
 njs_string_trim(njs_vm_t *vm, const njs_value_t *value,
     njs_string_prop_t *string, unsigned mode)
 {
+    size_t                n;
     uint32_t              cp, trim;
     const u_char          *p, *prev, *start, *end;
     njs_unicode_decode_t  ctx;
@@ -2213,43 +2928,21 @@ njs_string_trim(njs_vm_t *vm, const njs_value_t *value,
     start = string->start;
     end = string->start + string->size;
 
-    if (njs_is_ascii_string(string)) {
-
-        if (mode & NJS_TRIM_START) {
-            for ( ;; ) {
-                if (start == end) {
-                    break;
-                }
-
-                if (njs_is_whitespace(*start)) {
-                    start++;
-                    trim++;
-                    continue;
-                }
-
-                break;
-            }
-        }
-
-        if (mode & NJS_TRIM_END) {
-            for ( ;; ) {
-                if (start == end) {
-                    break;
-                }
-
-                end--;
+    /* ASCII whitespace is trimmed at once. */
 
-                if (njs_is_whitespace(*end)) {
-                    trim++;
-                    continue;
-                }
+    if (mode & NJS_TRIM_START) {
+        n = njs_string_space_start(start, end);
+        start += n;
+        trim += n;
+    }
 
-                end++;
-                break;
-            }
-        }
+    if (mode & NJS_TRIM_END) {
+        n = njs_string_space_end(start, end);
+        end -= n;
+        trim += n;
+    }
 
-    } else {
+    if (!njs_is_ascii_string(string)) {
         /* UTF-8 string. */
 
         if (mode & NJS_TRIM_START) {
@@ -2570,11 +3263,9 @@ njs_string_prototype_search(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
             goto done;
 
         default:
-            if (njs_slow_path(!njs_is_string(value))) {
-                ret = njs_value_to_string(vm, value, value);
-                if (njs_slow_path(ret != NJS_OK)) {
-                    return ret;
-                }
+            ret = njs_value_to_string(vm, value, value);
+            if (njs_slow_path(ret != NJS_OK)) {
+                return ret;
             }
 
             (void) njs_string_prop(vm, &string, value);
@@ -2599,6 +3290,11 @@ njs_string_prototype_search(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
         n = (string.length != 0);
 
         if (njs_regex_is_valid(&pattern->regex[n])) {
+            ret = njs_regexp_init(vm);
+            if (njs_slow_path(ret != NJS_OK)) {
+                return NJS_ERROR;
+            }
+
             ret = njs_regexp_match(vm, &pattern->regex[n], string.start,
                                    0, string.size, vm->single_match_data);
             if (ret >= 0) {
@@ -2667,7 +3363,10 @@ njs_string_prototype_match(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
             }
 
         } else {
-            njs_string_get(vm, &args[1], &string);
+            ret = njs_string_get_checked(vm, &args[1], &string);
+            if (njs_slow_path(ret != NJS_OK)) {
+                return ret;
+            }
         }
 
         /* A void value. */
@@ -2715,6 +3414,11 @@ njs_string_match_multiple(njs_vm_t *vm, njs_value_t *args,
 
     if (njs_regex_is_valid(&pattern->regex[type])) {
 
+        ret = njs_regexp_init(vm);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return NJS_ERROR;
+        }
+
         array = njs_array_alloc(vm, 0, 0, NJS_ARRAY_SPARE);
         if (njs_slow_path(array == NULL)) {
             return NJS_ERROR;
@@ -2797,7 +3501,7 @@ njs_string_prototype_split(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
     njs_value_t        *this, *separator, *value;
     njs_value_t        separator_lvalue, limit_lvalue, splitter;
     njs_array_t        *array;
-    const u_char       *p, *start, *next, *last, *end;
+    const u_char       *p, *start, *next, *end;
     njs_string_prop_t  string, split;
     njs_value_t        arguments[3];
 
@@ -2883,20 +3587,13 @@ njs_string_prototype_split(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
 
     start = string.start;
     end = string.start + string.size;
-    last = end - split.size;
 
     do {
-
-        for (p = start; p <= last; p++) {
-            if (memcmp(p, split.start, split.size) == 0) {
-                goto found;
-            }
+        p = njs_memmem(start, end, split.start, split.size);
+        if (p == NULL) {
+            p = end;
         }
 
-        p = end;
-
-found:
-
         next = p + split.size;
 
         /* Empty split string. */
@@ -2954,7 +3651,13 @@ njs_string_get_substitution(njs_vm_t *vm, njs_value_t *matched,
     njs_value_t        name, value;
     njs_string_prop_t  s, m;
 
-    njs_string_get(vm, replacement, &rep);
+    if (njs_slow_path(njs_string_get_checked(vm, replacement, &rep) != NJS_OK
+                      || njs_string_flatten(vm, matched) != NJS_OK
+                      || njs_string_flatten(vm, string) != NJS_OK))
+    {
+        return NJS_ERROR;
+    }
+
     p = rep.start;
     end = rep.start + rep.length;
 
@@ -3065,7 +3768,11 @@ njs_string_get_substitution(njs_vm_t *vm, njs_value_t *matched,
                 p += (c2 != 0) ? 3 : 2;
 
                 if (njs_is_defined(&captures[n])) {
-                    njs_string_get(vm, &captures[n], &cap);
+                    ret = njs_string_get_checked(vm, &captures[n], &cap);
+                    if (njs_slow_path(ret != NJS_OK)) {
+                        goto exception;
+                    }
+
                     njs_chb_append_str(&chain, &cap);
                 }
 
@@ -3109,7 +3816,7 @@ njs_string_prototype_replace(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
     njs_value_t        *this, *search, *replace;
     njs_value_t        search_lvalue, replace_lvalue, replacer, value,
                        arguments[3];
-    const u_char       *start, *end;
+    const u_char       *start, *end, *last;
     njs_function_t     *func_replace;
     njs_string_prop_t  string, s, ret_string;
 
@@ -3245,8 +3952,10 @@ njs_string_prototype_replace(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
     NJS_CHB_MP_INIT_MAX(&chain, njs_vm_memory_pool(vm), NJS_STRING_MAX_LENGTH);
 
     start = string.start;
+    end = njs_string_offset(&string, pos);
+    last = string.start + string.size;
 
-    do {
+    for ( ;; ) {
         if (func_replace == NULL) {
             ret = njs_string_get_substitution(vm, search, this, pos, NULL, 0,
                                               NULL, replace, &value);
@@ -3271,7 +3980,6 @@ njs_string_prototype_replace(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
             }
         }
 
-        end = njs_string_offset(&string, pos);
         (void) njs_string_prop(vm, &ret_string, &value);
 
         njs_chb_append(&chain, start, end - start);
@@ -3282,19 +3990,27 @@ njs_string_prototype_replace(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
 
         if (njs_slow_path(s.length == 0)) {
             if (end_of_last_match >= string.length) {
-                pos = -1;
-
-            } else {
-                pos = end_of_last_match + 1;
+                break;
             }
 
-        } else {
-            pos = njs_string_index_of(&string, &s, end_of_last_match);
+            pos = end_of_last_match + 1;
+            end = njs_string_offset(&string, pos);
+            continue;
+        }
+
+        /* The search continues from the byte position of the last match. */
+
+        end = njs_memmem(start, last, s.start, s.size);
+        if (end == NULL) {
+            break;
         }
 
-    } while (pos >= 0);
+        pos = end_of_last_match + (njs_is_ascii_string(&string)
+                                   ? (size_t) (end - start)
+                                   : njs_string_utf8_count(start, end));
+    }
 
-    njs_chb_append(&chain, start, string.start + string.size - start);
+    njs_chb_append(&chain, start, last - start);
 
     ret = njs_string_create_chb(vm, retval, &chain);
     if (njs_slow_path(ret != NJS_OK)) {
@@ -3391,6 +4107,8 @@ njs_string_to_index(const njs_value_t *value)
         return njs_atom_number(value->atom_id);
     }
 
+    njs_assert(!njs_string_is_rope(value->string.data));
+
     size = value->string.data->size;
     start = value->string.data->start;
 
@@ -4030,6 +4748,74 @@ njs_chb_write_byte_as_utf8(njs_chb_t *chain, u_char byte)
 }
 
 
+/*
+ * Strict base64 decoding: the input without whitespace and with padding
+ * only at the end is decoded at once, NJS_DECLINED is returned otherwise.
+ */
+
+static njs_int_t
+njs_string_atob_strict(njs_vm_t *vm, const njs_str_t *src,
+    njs_value_t *retval)
+{
+    u_char     *p, *end;
+    size_t     len, pad, size;
+    njs_int_t  ret;
+    njs_str_t  dst;
+    njs_chb_t  chain;
+
+    len = njs_decode_base64_valid(src, njs_basis64);
+    pad = src->length - len;
+
+    if (len == 0
+        || len % 4 == 1
+        || pad > 2
+        || (pad != 0 && (src->length % 4 != 0
+                         || src->start[len] != '='
+                         || src->start[src->length - 1] != '=')))
+    {
+        return NJS_DECLINED;
+    }
+
+    size = len / 4 * 3 + ((len % 4 != 0) ? len % 4 - 1 : 0);
+
+    dst.start = njs_mp_alloc(vm->mem_pool, size);
+    if (njs_slow_path(dst.start == NULL)) {
+        njs_memory_error(vm);
+        return NJS_ERROR;
+    }
+
+    dst.length = size;
+
+    njs_decode_base64(&dst, src);
+
+    end = dst.start + size;
+
+    if (njs_utf8_ascii_size(dst.start, end) == size) {
+        ret = njs_string_new(vm, retval, dst.start, size, size);
+
+    } else {
+        NJS_CHB_MP_INIT(&chain, njs_vm_memory_pool(vm));
+
+        if (njs_slow_path(njs_chb_reserve(&chain, size * 2) == NULL)) {
+            njs_mp_free(vm->mem_pool, dst.start);
+            njs_memory_error(vm);
+            return NJS_ERROR;
+        }
+
+        for (p = dst.start; p < end; p++) {
+            njs_chb_write_byte_as_utf8(&chain, *p);
+        }
+
+        ret = njs_string_create_chb(vm, retval, &chain);
+        njs_chb_destroy(&chain);
+    }
+
+    njs_mp_free(vm->mem_pool, dst.start);
+
+    return ret;
+}
+
+
 njs_int_t
 njs_string_atob(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
     njs_index_t unused, njs_value_t *retval)
@@ -4055,6 +4841,11 @@ njs_string_atob(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
     b64 = njs_basis64;
     njs_string_get(vm, value, &str);
 
+    ret = njs_string_atob_strict(vm, &str, retval);
+    if (ret != NJS_DECLINED) {
+        return ret;
+    }
+
     /*
      * Each significant character contributes six bits; even when every
      * decoded byte expands to two UTF-8 bytes, the output is bounded by the
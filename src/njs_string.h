@@ -77,6 +77,38 @@ struct njs_string_s {
 };
 
 
+/*
+ * A concatenation of long strings is deferred: the result is a rope,
+ * a string with NULL start referring to its left and right parts.
+ * The rope is flattened when its content is needed for the first time.
+ * The flattening copies the parts iterating over left parts and
+ * recursing into right ones, so the depth of right parts is limited by
+ * NJS_STRING_ROPE_DEPTH.  Short parts are copied into the rope, as
+ * the value they are from may be temporary.
+ */
+
+#define NJS_STRING_ROPE_MIN    256
+#define NJS_STRING_ROPE_SHORT  64
+#define NJS_STRING_ROPE_DEPTH  128
+
+
+typedef struct {
+    struct njs_string_s  string;
+    struct njs_string_s  *left;
+    struct njs_string_s  *right;
+    njs_mp_t             *mem_pool;
+    uint32_t             depth;
+} njs_string_rope_t;
+
+
+#define njs_string_is_rope(string)  ((string)->start == NULL)
+
+#define njs_is_rope(value)                                                    \
+    (njs_is_string(value)                                                     \
+     && (value)->string.data != NULL                                          \
+     && njs_string_is_rope((value)->string.data))
+
+
 uint32_t njs_string_data_size(uint32_t size, uint32_t length);
 void njs_string_data_init(struct njs_string_s *string, uint32_t size,
     uint32_t length);
@@ -117,8 +149,17 @@ njs_int_t njs_string_create(njs_vm_t *vm, njs_value_t *value, const u_char *src,
 njs_int_t njs_string_create_chb(njs_vm_t *vm, njs_value_t *value,
     njs_chb_t *chain);
 
+njs_int_t njs_string_rope(njs_vm_t *vm, njs_value_t *value,
+    const njs_value_t *left, const njs_value_t *right);
+struct njs_string_s *njs_string_flat(njs_vm_t *vm,
+    struct njs_string_s *string);
+struct njs_string_s *njs_string_flattened(njs_vm_t *vm,
+    struct njs_string_s *string);
 size_t njs_string_prop(njs_vm_t *vm, njs_string_prop_t *string,
     const njs_value_t *value);
+njs_int_t njs_string_flatten(njs_vm_t *vm, const njs_value_t *value);
+njs_int_t njs_string_get_checked(njs_vm_t *vm, const njs_value_t *value,
+    njs_str_t *str);
 
 void njs_encode_hex(njs_str_t *dst, const njs_str_t *src);
 size_t njs_encode_hex_length(const njs_str_t *src, size_t *out_size);
@@ -2124,12 +2124,10 @@ njs_typed_array_prototype_join(njs_vm_t *vm, njs_value_t *args,
 
     separator = njs_arg(args, nargs, 1);
 
-    if (njs_slow_path(!njs_is_string(separator))) {
-        if (njs_is_defined(separator)) {
-            ret = njs_value_to_string(vm, separator, separator);
-            if (njs_slow_path(ret != NJS_OK)) {
-                return ret;
-            }
+    if (njs_is_defined(separator)) {
+        ret = njs_value_to_string(vm, separator, separator);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return ret;
         }
     }
 
@@ -56,6 +56,171 @@ njs_utf8_encode(u_char *p, uint32_t u)
 }
 
 
+size_t
+njs_utf8_ascii_size(const u_char *p, const u_char *end)
+{
+    uint64_t      word;
+    const u_char  *start;
+
+    start = p;
+
+#if (NJS_SIMD_SIZE)
+
+    /*
+     * The SIMD loops in this file use the baseline vectors of njs_simd.h,
+     * SSE2 on x86-64 and NEON on AArch64, and that is deliberate.  AVX2
+     * would need cpuid dispatch through a function pointer per call, which
+     * costs more than it saves on the short strings typical for scripts,
+     * and it would prevent inlining of njs_utf8_ascii_case().
+     */
+
+    while (end - p >= NJS_SIMD_SIZE) {
+        if (njs_simd_mask(njs_simd_high(njs_simd_load(p))) != 0) {
+            break;
+        }
+
+        p += NJS_SIMD_SIZE;
+    }
+
+#endif
+
+    while (end - p >= (ssize_t) sizeof(uint64_t)) {
+        memcpy(&word, p, sizeof(uint64_t));
+
+        if ((word & 0x8080808080808080ULL) != 0) {
+            break;
+        }
+
+        p += sizeof(uint64_t);
+    }
+
+    while (p < end && *p < 0x80) {
+        p++;
+    }
+
+    return p - start;
+}
+
+
+/*
+ * Maps ASCII letters in the range [lo, hi] by adding delta, other bytes
+ * are copied as is, so UTF-8 sequences are preserved.
+ */
+
+njs_inline void
+njs_utf8_ascii_case(u_char *dst, const u_char *src, size_t size, u_char lo,
+    u_char hi, u_char delta)
+{
+    u_char        c;
+    const u_char  *end;
+#if (NJS_SIMD_SIZE)
+    njs_simd_t    v;
+#endif
+
+    end = src + size;
+
+#if (NJS_SIMD_SIZE)
+
+    while (end - src >= NJS_SIMD_SIZE) {
+        v = njs_simd_load(src);
+        v = njs_simd_add(v, njs_simd_and(njs_simd_range(v, lo, hi),
+                                         njs_simd_splat(delta)));
+        njs_simd_store(dst, v);
+
+        src += NJS_SIMD_SIZE;
+        dst += NJS_SIMD_SIZE;
+    }
+
+#endif
+
+    while (src < end) {
+        c = *src++;
+        *dst++ = (c >= lo && c <= hi) ? (u_char) (c + delta) : c;
+    }
+}
+
+
+void
+njs_utf8_ascii_lower_case(u_char *dst, const u_char *src, size_t size)
+{
+    njs_utf8_ascii_case(dst, src, size, 'A', 'Z', 'a' - 'A');
+}
+
+
+void
+njs_utf8_ascii_upper_case(u_char *dst, const u_char *src, size_t size)
+{
+    njs_utf8_ascii_case(dst, src, size, 'a', 'z', (u_char) ('A' - 'a'));
+}
+
+
+/*
+ * Returns the size of a complete well-formed non-ASCII sequence
+ * or 0 otherwise, see Table 3-7 of the Unicode Standard.
+ */
+
+njs_inline size_t
+njs_utf8_sequence_size(const u_char *p, const u_char *end)
+{
+    u_char  c, lower, upper;
+
+    c = p[0];
+
+    if (c >= 0xC2 && c <= 0xDF) {
+        if (end - p < 2 || (p[1] & 0xC0) != 0x80) {
+            return 0;
+        }
+
+        return 2;
+    }
+
+    lower = 0x80;
+    upper = 0xBF;
+
+    if (c >= 0xE0 && c <= 0xEF) {
+        if (end - p < 3) {
+            return 0;
+        }
+
+        if (c == 0xE0) {
+            lower = 0xA0;
+
+        } else if (c == 0xED) {
+            upper = 0x9F;
+        }
+
+        if (p[1] < lower || p[1] > upper || (p[2] & 0xC0) != 0x80) {
+            return 0;
+        }
+
+        return 3;
+    }
+
+    if (c >= 0xF0 && c <= 0xF4) {
+        if (end - p < 4) {
+            return 0;
+        }
+
+        if (c == 0xF0) {
+            lower = 0x90;
+
+        } else if (c == 0xF4) {
+            upper = 0x8F;
+        }
+
+        if (p[1] < lower || p[1] > upper
+            || (p[2] & 0xC0) != 0x80 || (p[3] & 0xC0) != 0x80)
+        {
+            return 0;
+        }
+
+        return 4;
+    }
+
+    return 0;
+}
+
+
 njs_inline njs_int_t
 njs_utf8_boundary(njs_unicode_decode_t *ctx, const u_char **data,
     unsigned *need, u_char lower, u_char upper)
@@ -218,9 +383,25 @@ u_char *
 njs_utf8_stream_encode(njs_unicode_decode_t *ctx, const u_char *start,
     const u_char *end, u_char *dst, njs_bool_t last, njs_bool_t fatal)
 {
+    size_t    n;
     uint32_t  cp;
 
     while (start < end) {
+
+        /* Well-formed input is copied as is. */
+
+        if (ctx->need == 0) {
+            n = (*start < 0x80) ? njs_utf8_ascii_size(start, end)
+                                : njs_utf8_sequence_size(start, end);
+
+            if (n != 0) {
+                dst = njs_cpymem(dst, start, n);
+                start += n;
+
+                continue;
+            }
+        }
+
         cp = njs_utf8_decode(ctx, &start, end);
 
         if (cp > NJS_UNICODE_MAX_CODEPOINT) {
@@ -263,15 +444,51 @@ njs_utf8_casecmp(const u_char *start1, const u_char *start2, size_t len1,
     int32_t       n;
     uint32_t      u1, u2;
     const u_char  *end1, *end2;
+#if (NJS_SIMD_SIZE)
+    njs_simd_t    v1, v2;
+#endif
 
     end1 = start1 + len1;
     end2 = start2 + len2;
 
+#if (NJS_SIMD_SIZE)
+
+    /* ASCII blocks equal up to the case are skipped. */
+
+    while (end1 - start1 >= NJS_SIMD_SIZE && end2 - start2 >= NJS_SIMD_SIZE) {
+        v1 = njs_simd_load(start1);
+        v2 = njs_simd_load(start2);
+
+        if (njs_simd_mask(njs_simd_high(njs_simd_or(v1, v2))) != 0) {
+            break;
+        }
+
+        v1 = njs_simd_or(v1, njs_simd_and(njs_simd_range(v1, 'A', 'Z'),
+                                          njs_simd_splat(0x20)));
+        v2 = njs_simd_or(v2, njs_simd_and(njs_simd_range(v2, 'A', 'Z'),
+                                          njs_simd_splat(0x20)));
+
+        if (njs_simd_mask(njs_simd_equal(v1, v2)) != NJS_SIMD_MASK_ALL) {
+            break;
+        }
+
+        start1 += NJS_SIMD_SIZE;
+        start2 += NJS_SIMD_SIZE;
+    }
+
+#endif
+
     while (start1 < end1 && start2 < end2) {
 
-        u1 = njs_utf8_lower_case(&start1, end1);
+        if ((*start1 | *start2) < 0x80) {
+            u1 = njs_lower_case(*start1++);
+            u2 = njs_lower_case(*start2++);
+
+        } else {
+            u1 = njs_utf8_lower_case(&start1, end1);
 
-        u2 = njs_utf8_lower_case(&start2, end2);
+            u2 = njs_utf8_lower_case(&start2, end2);
+        }
 
         if (njs_slow_path((u1 | u2) == 0xFFFFFFFF)) {
             return NJS_UNICODE_ERROR;
@@ -354,7 +571,7 @@ ssize_t
 njs_utf8_stream_length(njs_unicode_decode_t *ctx, const u_char *p, size_t len,
     njs_bool_t last, njs_bool_t fatal, size_t *out_size)
 {
-    size_t        size, length;
+    size_t        n, size, length;
     uint32_t      codepoint;
     const u_char  *end;
 
@@ -365,6 +582,31 @@ njs_utf8_stream_length(njs_unicode_decode_t *ctx, const u_char *p, size_t len,
         end = p + len;
 
         while (p < end) {
+
+            /* Well-formed input is counted without decoding. */
+
+            if (ctx->need == 0) {
+                if (*p < 0x80) {
+                    n = njs_utf8_ascii_size(p, end);
+
+                    p += n;
+                    size += n;
+                    length += n;
+
+                    continue;
+                }
+
+                n = njs_utf8_sequence_size(p, end);
+
+                if (n != 0) {
+                    p += n;
+                    size += n;
+                    length++;
+
+                    continue;
+                }
+            }
+
             codepoint = njs_utf8_decode(ctx, &p, end);
 
             if (codepoint > NJS_UNICODE_MAX_CODEPOINT) {
@@ -404,6 +646,7 @@ njs_utf8_stream_length(njs_unicode_decode_t *ctx, const u_char *p, size_t len,
 njs_bool_t
 njs_utf8_is_valid(const u_char *p, size_t len)
 {
+    size_t                n;
     const u_char          *end;
     njs_unicode_decode_t  ctx;
 
@@ -412,6 +655,18 @@ njs_utf8_is_valid(const u_char *p, size_t len)
     njs_utf8_decode_init(&ctx);
 
     while (p < end) {
+        if (*p < 0x80) {
+            p += njs_utf8_ascii_size(p, end);
+            continue;
+        }
+
+        n = njs_utf8_sequence_size(p, end);
+
+        if (njs_fast_path(n != 0)) {
+            p += n;
+            continue;
+        }
+
         if (njs_slow_path(njs_utf8_decode(&ctx, &p, end)
                           > NJS_UNICODE_MAX_CODEPOINT))
         {
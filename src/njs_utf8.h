@@ -24,6 +24,11 @@ NJS_EXPORT ssize_t njs_utf8_stream_length(njs_unicode_decode_t *ctx,
     const u_char *p, size_t len, njs_bool_t last, njs_bool_t fatal,
     size_t *out_size);
 NJS_EXPORT njs_bool_t njs_utf8_is_valid(const u_char *p, size_t len);
+NJS_EXPORT size_t njs_utf8_ascii_size(const u_char *p, const u_char *end);
+NJS_EXPORT void njs_utf8_ascii_lower_case(u_char *dst, const u_char *src,
+    size_t size);
+NJS_EXPORT void njs_utf8_ascii_upper_case(u_char *dst, const u_char *src,
+    size_t size);
 
 
 njs_inline uint32_t
@@ -20,6 +20,15 @@ static njs_int_t njs_string_property_query(njs_vm_t *vm,
     njs_property_query_t *pq, njs_value_t *object, uint32_t index);
 static njs_int_t njs_external_property_query(njs_vm_t *vm,
     njs_property_query_t *pq, njs_value_t *value);
+static njs_int_t njs_value_property_get(njs_vm_t *vm, njs_value_t *value,
+    uint32_t atom_id, njs_object_prop_t *prop, njs_object_prop_t *scratch,
+    njs_value_t *retval);
+static njs_object_t *njs_prop_cache_object(njs_vm_t *vm, njs_value_t *value,
+    uint32_t atom_id);
+static njs_object_prop_t *njs_prop_cache_find(njs_object_t *object,
+    uint32_t atom_id, njs_prop_cache_t *cache, njs_bool_t own);
+static void njs_prop_cache_update(njs_vm_t *vm, njs_object_t *object,
+    uint32_t atom_id, njs_object_prop_t *prop, njs_prop_cache_t *cache);
 
 
 const njs_value_t  njs_value_null =         njs_value(NJS_NULL, 0, 0.0);
@@ -299,6 +308,10 @@ njs_value_length(njs_vm_t *vm, njs_value_t *value, int64_t *length)
     njs_string_prop_t  string_prop;
 
     if (njs_is_string(value)) {
+        if (njs_slow_path(njs_string_flatten(vm, value) != NJS_OK)) {
+            return NJS_ERROR;
+        }
+
         *length = njs_string_prop(vm, &string_prop, value);
 
     } else if (njs_is_primitive(value)) {
@@ -422,6 +435,17 @@ njs_value_external_set(njs_value_t *value, njs_external_ptr_t external)
 }
 
 
+void
+njs_value_external_detach(njs_value_t *value)
+{
+    njs_assert(njs_value_is_external(value, NJS_PROTO_ID_ANY));
+
+    /* The object is no longer an external for any proto id. */
+
+    njs_set_undefined(njs_object_value(value));
+}
+
+
 uint8_t
 njs_value_bool(const njs_value_t *value)
 {
@@ -958,6 +982,10 @@ njs_string_property_query(njs_vm_t *vm, njs_property_query_t *pq,
 
     prop = &pq->scratch;
 
+    if (njs_slow_path(njs_string_flatten(vm, object) != NJS_OK)) {
+        return NJS_ERROR;
+    }
+
     slice.start = index;
     slice.length = 1;
     slice.string_length = njs_string_prop(vm, &string, object);
@@ -1052,7 +1080,6 @@ njs_value_property(njs_vm_t *vm, njs_value_t *value, uint32_t atom_id,
     uint32_t              index;
     njs_int_t             ret;
     njs_array_t          *array;
-    njs_object_prop_t     *prop;
     njs_typed_array_t     *tarray;
     njs_property_query_t  pq;
 
@@ -1105,54 +1132,110 @@ slow_path:
     switch (ret) {
 
     case NJS_OK:
-        prop = pq.fhq.value;
+        return njs_value_property_get(vm, value, atom_id, pq.fhq.value,
+                                      &pq.scratch, retval);
 
-        switch (prop->type) {
-        case NJS_PROPERTY:
-        case NJS_ACCESSOR:
-            if (njs_is_data_descriptor(prop)) {
-                njs_value_assign(retval, njs_prop_value(prop));
-                break;
-            }
+    case NJS_DECLINED:
+not_found:
+        njs_set_undefined(retval);
 
-            if (njs_prop_getter(prop) == NULL) {
-                njs_set_undefined(retval);
-                break;
-            }
+        return NJS_DECLINED;
 
-            return njs_function_apply(vm, njs_prop_getter(prop), value, 1,
-                                      retval);
+    case NJS_ERROR:
+    default:
 
-        case NJS_PROPERTY_HANDLER:
-            pq.scratch = *prop;
-            prop = &pq.scratch;
-            ret = njs_prop_handler(prop)(vm, prop, atom_id, value, NULL,
-                                         njs_prop_value(prop));
+        return NJS_ERROR;
+    }
+}
 
-            if (njs_slow_path(ret != NJS_OK)) {
-                if (ret == NJS_ERROR) {
-                    return ret;
-                }
 
-                njs_set_undefined(njs_prop_value(prop));
-            }
+static njs_int_t
+njs_value_property_get(njs_vm_t *vm, njs_value_t *value, uint32_t atom_id,
+    njs_object_prop_t *prop, njs_object_prop_t *scratch, njs_value_t *retval)
+{
+    njs_int_t  ret;
 
+    switch (prop->type) {
+    case NJS_PROPERTY:
+    case NJS_ACCESSOR:
+        if (njs_is_data_descriptor(prop)) {
             njs_value_assign(retval, njs_prop_value(prop));
+            break;
+        }
 
+        if (njs_prop_getter(prop) == NULL) {
+            njs_set_undefined(retval);
             break;
+        }
 
-        default:
-            njs_internal_error(vm, "unexpected property type \"%s\" "
-                               "while getting",
-                               njs_prop_type_string(prop->type));
+        return njs_function_apply(vm, njs_prop_getter(prop), value, 1,
+                                  retval);
 
-            return NJS_ERROR;
+    case NJS_PROPERTY_HANDLER:
+        *scratch = *prop;
+        prop = scratch;
+        ret = njs_prop_handler(prop)(vm, prop, atom_id, value, NULL,
+                                     njs_prop_value(prop));
+
+        if (njs_slow_path(ret != NJS_OK)) {
+            if (ret == NJS_ERROR) {
+                return ret;
+            }
+
+            njs_set_undefined(njs_prop_value(prop));
         }
 
+        njs_value_assign(retval, njs_prop_value(prop));
+
         break;
 
+    default:
+        njs_internal_error(vm, "unexpected property type \"%s\" "
+                           "while getting",
+                           njs_prop_type_string(prop->type));
+
+        return NJS_ERROR;
+    }
+
+    return NJS_OK;
+}
+
+
+njs_int_t
+njs_value_property_cached(njs_vm_t *vm, njs_value_t *value, uint32_t atom_id,
+    njs_prop_cache_t *cache, njs_value_t *retval)
+{
+    njs_int_t             ret;
+    njs_object_t          *object;
+    njs_object_prop_t     *prop;
+    njs_property_query_t  pq;
+
+    object = njs_prop_cache_object(vm, value, atom_id);
+    if (njs_slow_path(object == NULL || cache == NULL)) {
+        return njs_value_property(vm, value, atom_id, retval);
+    }
+
+    prop = njs_prop_cache_find(object, atom_id, cache, 0);
+    if (njs_fast_path(prop != NULL)) {
+        return njs_value_property_get(vm, value, atom_id, prop, &pq.scratch,
+                                      retval);
+    }
+
+    njs_property_query_init(&pq, NJS_PROPERTY_QUERY_GET, 0);
+
+    ret = njs_property_query(vm, &pq, value, atom_id);
+
+    switch (ret) {
+
+    case NJS_OK:
+        prop = pq.fhq.value;
+
+        njs_prop_cache_update(vm, object, atom_id, prop, cache);
+
+        return njs_value_property_get(vm, value, atom_id, prop, &pq.scratch,
+                                      retval);
+
     case NJS_DECLINED:
-not_found:
         njs_set_undefined(retval);
 
         return NJS_DECLINED;
@@ -1162,11 +1245,229 @@ not_found:
 
         return NJS_ERROR;
     }
+}
+
+
+njs_int_t
+njs_value_property_set_cached(njs_vm_t *vm, njs_value_t *value,
+    uint32_t atom_id, njs_prop_cache_t *cache, njs_value_t *setval)
+{
+    njs_int_t            ret;
+    njs_object_t         *object;
+    njs_object_prop_t    *prop;
+    njs_flathsh_query_t  fhq;
+
+    if (njs_slow_path(!njs_is_object(value)
+                      || (njs_is_array(value)
+                          && atom_id == NJS_ATOM_STRING_length)))
+    {
+        return njs_value_property_set(vm, value, atom_id, setval);
+    }
+
+    object = njs_prop_cache_object(vm, value, atom_id);
+    if (njs_slow_path(object == NULL || cache == NULL)) {
+        return njs_value_property_set(vm, value, atom_id, setval);
+    }
+
+    prop = njs_prop_cache_find(object, atom_id, cache, 1);
+
+    if (njs_fast_path(prop != NULL
+                      && prop->type == NJS_PROPERTY
+                      && prop->writable
+                      && njs_is_valid(njs_prop_value(prop))))
+    {
+        njs_value_assign(njs_prop_value(prop), setval);
+        return NJS_OK;
+    }
+
+    ret = njs_value_property_set(vm, value, atom_id, setval);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return ret;
+    }
+
+    /* Only own writable data properties are cached for assignment. */
+
+    fhq.key_hash = atom_id;
+
+    if (njs_flathsh_unique_find(&object->hash, &fhq) == NJS_OK) {
+        prop = fhq.value;
+
+        if (prop->type == NJS_PROPERTY && prop->writable) {
+            njs_prop_cache_update(vm, object, atom_id, prop, cache);
+        }
+    }
 
     return NJS_OK;
 }
 
 
+/*
+ * Returns the object whose private hash is searched first by
+ * njs_property_query() for the value, or NULL if the access cannot be
+ * cached.  Integer index keys are not cached because arrays, typed arrays
+ * and string objects handle them before the private hash is searched.
+ */
+
+static njs_object_t *
+njs_prop_cache_object(njs_vm_t *vm, njs_value_t *value, uint32_t atom_id)
+{
+    if (njs_slow_path(njs_atom_is_number(atom_id))) {
+        return NULL;
+    }
+
+    switch (value->type) {
+    case NJS_BOOLEAN:
+    case NJS_NUMBER:
+    case NJS_SYMBOL:
+        return njs_vm_proto(vm, njs_primitive_prototype_index(value->type));
+
+    case NJS_STRING:
+        return &vm->string_object;
+
+    case NJS_NULL:
+    case NJS_UNDEFINED:
+    case NJS_DATA:
+    case NJS_INVALID:
+        return NULL;
+
+    default:
+        return njs_object(value);
+    }
+}
+
+
+static njs_object_prop_t *
+njs_prop_cache_find(njs_object_t *object, uint32_t atom_id,
+    njs_prop_cache_t *cache, njs_bool_t own)
+{
+    njs_uint_t              i;
+    njs_object_t            *holder;
+    njs_flathsh_elt_t       *elt;
+    njs_flathsh_query_t     fhq;
+    njs_flathsh_descr_t     *h;
+    njs_prop_cache_entry_t  *entry;
+
+    for (i = 0; i < NJS_PROP_CACHE_SIZE; i++) {
+        entry = &cache->entries[i];
+
+        if (entry->index == 0) {
+            return NULL;
+        }
+
+        holder = object;
+
+        if (entry->depth != 0) {
+            if (own) {
+                continue;
+            }
+
+            /*
+             * A prototype property is valid only while the receiver
+             * does not have an own property with the same key.
+             */
+
+            fhq.key_hash = atom_id;
+
+            if (njs_flathsh_unique_find(&object->hash, &fhq) == NJS_OK
+                || njs_flathsh_unique_find(&object->shared_hash, &fhq)
+                   == NJS_OK)
+            {
+                continue;
+            }
+
+            holder = object->__proto__;
+
+            if (holder == NULL) {
+                continue;
+            }
+        }
+
+        h = holder->hash.slot;
+
+        if (h == NULL || entry->index > h->elts_count) {
+            continue;
+        }
+
+        elt = &njs_hash_elts(h)[entry->index - 1];
+
+        if (elt->key_hash == atom_id
+            && elt->type != NJS_FREE_FLATHSH_ELEMENT
+            && elt->type != NJS_WHITEOUT)
+        {
+            return (njs_object_prop_t *) elt;
+        }
+    }
+
+    return NULL;
+}
+
+
+static void
+njs_prop_cache_update(njs_vm_t *vm, njs_object_t *object, uint32_t atom_id,
+    njs_object_prop_t *prop, njs_prop_cache_t *cache)
+{
+    double                  num;
+    uint32_t                depth;
+    njs_uint_t              i;
+    njs_value_t             key;
+    njs_object_t            *holder;
+    njs_flathsh_elt_t       *elts;
+    njs_flathsh_descr_t     *h;
+    njs_prop_cache_entry_t  *entry;
+
+    if (cache->entries[NJS_PROP_CACHE_SIZE - 1].index != 0) {
+        /* Megamorphic site. */
+        return;
+    }
+
+    holder = object;
+
+    for (depth = 0; depth < 2; depth++) {
+        if (holder == NULL) {
+            return;
+        }
+
+        h = holder->hash.slot;
+
+        if (h != NULL) {
+            elts = njs_hash_elts(h);
+
+            if ((njs_flathsh_elt_t *) prop >= elts
+                && (njs_flathsh_elt_t *) prop < &elts[h->elts_count])
+            {
+                goto found;
+            }
+        }
+
+        holder = holder->__proto__;
+    }
+
+    return;
+
+found:
+
+    if (njs_atom_to_value(vm, &key, atom_id) != NJS_OK) {
+        return;
+    }
+
+    num = njs_key_to_index(&key);
+
+    if (!isnan(num)) {
+        return;
+    }
+
+    for (i = 0; i < NJS_PROP_CACHE_SIZE; i++) {
+        entry = &cache->entries[i];
+
+        if (entry->index == 0) {
+            entry->index = (njs_flathsh_elt_t *) prop - elts + 1;
+            entry->depth = depth;
+            return;
+        }
+    }
+}
+
+
 njs_int_t
 njs_value_property_set(njs_vm_t *vm, njs_value_t *value, uint32_t atom_id,
     njs_value_t *setval)
@@ -1542,6 +1843,10 @@ njs_primitive_value_to_string(njs_vm_t *vm, njs_value_t *dst,
         return NJS_ERROR;
 
     case NJS_STRING:
+        if (njs_slow_path(njs_string_flatten(vm, src) != NJS_OK)) {
+            return NJS_ERROR;
+        }
+
         value = src;
         break;
 
@@ -1589,6 +1894,10 @@ njs_primitive_value_to_chain(njs_vm_t *vm, njs_chb_t *chain,
         return NJS_ERROR;
 
     case NJS_STRING:
+        if (njs_slow_path(njs_string_flatten(vm, src) != NJS_OK)) {
+            return NJS_ERROR;
+        }
+
         (void) njs_string_prop(vm, &string, src);
         njs_chb_append(chain, string.start, string.size);
         return string.length;
@@ -364,6 +364,34 @@ typedef struct {
 } njs_property_query_t;
 
 
+/*
+ * Inline cache of a property access site.  An entry remembers where
+ * the property was found last time: the element number in the private
+ * hash of the holder object and the number of __proto__ links between
+ * the receiver and the holder.  Since objects of the same layout keep
+ * their properties at the same element numbers, an entry is validated
+ * by comparing the element key with the property atom, so no hash
+ * probe or prototype walk is needed.  The first entry makes the site
+ * monomorphic, the others are filled as new layouts are met.
+ *
+ * Bytecode is shared by a VM and its clones, so an instruction only keeps
+ * a slot number and the caches live in a per VM table, see
+ * njs_vm_prop_cache().
+ */
+
+#define NJS_PROP_CACHE_SIZE     4
+
+typedef struct {
+    uint32_t                    index;      /* 0 if the entry is empty. */
+    uint32_t                    depth;
+} njs_prop_cache_entry_t;
+
+
+typedef struct {
+    njs_prop_cache_entry_t      entries[NJS_PROP_CACHE_SIZE];
+} njs_prop_cache_t;
+
+
 #define njs_value(_type, _truth, _number) (njs_value_t) {                     \
     .data = {                                                                 \
         .type = _type,                                                        \
@@ -533,6 +561,14 @@ typedef struct {
             njs_assert(njs_is_string(&_dst));                                 \
             njs_string_get_unsafe(&_dst, str);                                \
                                                                               \
+        } else if (njs_slow_path((value)->string.data->start == NULL)) {      \
+            /* A rope, see njs_string_flatten(). */                           \
+            _dst.string.data = njs_string_flattened(vm, (value)->string.data);\
+            (str)->length = (_dst.string.data != NULL)                        \
+                            ? _dst.string.data->size : 0;                     \
+            (str)->start = (_dst.string.data != NULL)                         \
+                           ? _dst.string.data->start : (u_char *) "";         \
+                                                                              \
         } else {                                                              \
             njs_string_get_unsafe(value, str);                                \
         }                                                                     \
@@ -970,6 +1006,10 @@ njs_int_t njs_property_query(njs_vm_t *vm, njs_property_query_t *pq,
     njs_value_t *value, uint32_t atom_id);
 njs_int_t njs_value_property_set(njs_vm_t *vm, njs_value_t *value,
     uint32_t atom_id, njs_value_t *setval);
+njs_int_t njs_value_property_cached(njs_vm_t *vm, njs_value_t *value,
+    uint32_t atom_id, njs_prop_cache_t *cache, njs_value_t *retval);
+njs_int_t njs_value_property_set_cached(njs_vm_t *vm, njs_value_t *value,
+    uint32_t atom_id, njs_prop_cache_t *cache, njs_value_t *setval);
 njs_int_t njs_value_property_delete(njs_vm_t *vm, njs_value_t *value,
     uint32_t atom_id, njs_value_t *removed, njs_bool_t thrw);
 njs_int_t njs_value_to_object(njs_vm_t *vm, njs_value_t *value);
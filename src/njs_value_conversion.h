@@ -33,6 +33,10 @@ njs_value_to_number(njs_vm_t *vm, njs_value_t *value, double *dst)
         *dst = NAN;
 
         if (njs_is_string(value)) {
+            if (njs_slow_path(njs_string_flatten(vm, value) != NJS_OK)) {
+                return NJS_ERROR;
+            }
+
             *dst = njs_string_to_number(vm, value);
         }
 
@@ -15,6 +15,8 @@ static njs_parser_scope_t *njs_variable_scope_find(njs_parser_t *parser,
      njs_parser_scope_t *scope, uintptr_t atom_id, njs_variable_type_t type);
 static njs_variable_t *njs_variable_alloc(njs_vm_t *vm, uintptr_t atom_id,
     njs_variable_type_t type);
+static njs_int_t njs_variable_escape_cb(njs_vm_t *vm, njs_parser_node_t *node,
+    void *unused);
 
 
 njs_variable_t *
@@ -379,6 +381,37 @@ njs_variable_closure_test(njs_parser_scope_t *root, njs_parser_scope_t *scope)
 }
 
 
+/*
+ * Marks variables referenced by inner functions as closures before
+ * the code is generated, so block scoped variables which do not escape
+ * their function are kept in frame slots and are not boxed on every
+ * declaration.
+ */
+
+njs_int_t
+njs_variable_escape(njs_vm_t *vm, njs_parser_node_t *root)
+{
+    return njs_parser_traverse(vm, root, NULL, njs_variable_escape_cb);
+}
+
+
+static njs_int_t
+njs_variable_escape_cb(njs_vm_t *vm, njs_parser_node_t *node, void *unused)
+{
+    njs_variable_t  *var;
+
+    if (node->token_type == NJS_TOKEN_NAME) {
+        var = njs_variable_resolve(vm, node);
+
+        if (var != NULL && njs_variable_closure_test(node->scope, var->scope)) {
+            var->closure = 1;
+        }
+    }
+
+    return NJS_OK;
+}
+
+
 njs_variable_t *
 njs_variable_resolve(njs_vm_t *vm, njs_parser_node_t *node)
 {
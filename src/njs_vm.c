@@ -8,7 +8,9 @@
 #include <njs_main.h>
 
 
-static njs_int_t njs_vm_protos_init(njs_vm_t *vm, njs_value_t *global);
+static njs_int_t njs_vm_protos_init(njs_vm_t *vm, njs_value_t *global,
+    njs_bool_t lazy);
+static void njs_vm_proto_init(njs_vm_t *vm, njs_uint_t index);
 
 
 const njs_str_t  njs_entry_empty =          njs_str("");
@@ -55,6 +57,13 @@ njs_vm_create(njs_vm_opt_t *options)
 
     njs_flathsh_init(&vm->values_hash);
 
+#if (NJS_HAVE_JIT)
+    ret = njs_jit_init(vm);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return NULL;
+    }
+#endif
+
     vm->options = *options;
 
     if (options->shared != NULL) {
@@ -107,7 +116,7 @@ njs_vm_create(njs_vm_opt_t *options)
         }
     }
 
-    ret = njs_vm_protos_init(vm, &vm->global_value);
+    ret = njs_vm_protos_init(vm, &vm->global_value, 0);
     if (njs_slow_path(ret != NJS_OK)) {
         return NULL;
     }
@@ -204,6 +213,21 @@ njs_vm_call_exit_hook(njs_vm_t *vm)
 void
 njs_vm_destroy(njs_vm_t *vm)
 {
+    size_t         size;
+    njs_mp_stat_t  stat;
+
+    if (vm->gc != NULL) {
+        njs_gc_abandon(vm);
+    }
+
+    if (njs_mp_is_arena(vm->mem_pool)) {
+        njs_mp_stat(vm->mem_pool, &stat);
+
+        size = vm->shared->arena_size;
+        vm->shared->arena_size = (size != 0) ? (size + stat.used) / 2
+                                             : stat.used;
+    }
+
     njs_mp_destroy(vm->mem_pool);
 }
 
@@ -377,6 +401,29 @@ njs_vm_compile_module(njs_vm_t *vm, njs_str_t *name, u_char **start,
 }
 
 
+njs_int_t
+njs_vm_reset(njs_vm_t *vm, njs_external_ptr_t external)
+{
+    if (njs_vm_pending(vm)
+        || (vm->top_frame != NULL && vm->top_frame->previous != NULL))
+    {
+        return NJS_DECLINED;
+    }
+
+    if (vm->external_generation == 0xffff) {
+        return NJS_DECLINED;
+    }
+
+    vm->external = external;
+    vm->external_generation++;
+
+    njs_memzero(vm->hooks, sizeof(vm->hooks));
+    njs_set_invalid(&vm->exception);
+
+    return NJS_OK;
+}
+
+
 njs_int_t
 njs_vm_reuse(njs_vm_t *vm)
 {
@@ -402,7 +449,13 @@ njs_vm_clone(njs_vm_t *vm, njs_external_ptr_t external)
         return NULL;
     }
 
-    nmp = njs_mp_fast_create(2 * njs_pagesize(), 128, 512, 16);
+    if (vm->options.arena) {
+        nmp = njs_mp_arena_create(vm->shared->arena_size);
+
+    } else {
+        nmp = njs_mp_fast_create(2 * njs_pagesize(), 128, 512, 16);
+    }
+
     if (njs_slow_path(nmp == NULL)) {
         return NULL;
     }
@@ -417,18 +470,33 @@ njs_vm_clone(njs_vm_t *vm, njs_external_ptr_t external)
     nvm->mem_pool = nmp;
     nvm->trace.data = nvm;
     nvm->external = external;
+    nvm->external_generation = 0;
+    nvm->spare_stack = NULL;
+    nvm->gc_threshold = 0;
+    nvm->gc = NULL;
+    nvm->gc_abandoned = 0;
+    nvm->prop_caches = NULL;
+    nvm->prop_caches_size = 0;
+
+    /* The regex contexts are created by njs_regexp_init() on the first use. */
+
+    nvm->regex_generic_ctx = NULL;
+    nvm->regex_compile_ctx = NULL;
+    nvm->single_match_data = NULL;
 
     nvm->shared_atom_count = vm->atom_id_generator;
 
     njs_flathsh_init(&nvm->atom_hash);
     nvm->atom_hash_current = &nvm->atom_hash;
 
+    njs_flathsh_init(&nvm->flat_ropes);
+
     ret = njs_vm_runtime_init(nvm);
     if (njs_slow_path(ret != NJS_OK)) {
         goto fail;
     }
 
-    ret = njs_vm_protos_init(nvm, &nvm->global_value);
+    ret = njs_vm_protos_init(nvm, &nvm->global_value, 1);
     if (njs_slow_path(ret != NJS_OK)) {
         goto fail;
     }
@@ -476,7 +544,6 @@ fail:
 njs_int_t
 njs_vm_runtime_init(njs_vm_t *vm)
 {
-    njs_int_t    ret;
     njs_frame_t  *frame;
 
     if (vm->active_frame == NULL) {
@@ -493,11 +560,6 @@ njs_vm_runtime_init(njs_vm_t *vm)
         vm->active_frame = frame;
     }
 
-    ret = njs_regexp_init(vm);
-    if (njs_slow_path(ret != NJS_OK)) {
-        return NJS_ERROR;
-    }
-
     njs_flathsh_init(&vm->values_hash);
 
     njs_flathsh_init(&vm->modules_hash);
@@ -513,68 +575,109 @@ njs_vm_runtime_init(njs_vm_t *vm)
 void
 njs_vm_constructors_init(njs_vm_t *vm)
 {
-    njs_uint_t    i;
-    njs_object_t  *object_prototype, *function_prototype,
-                  *typed_array_prototype, *error_prototype, *async_prototype,
-                  *typed_array_ctor, *error_ctor;
-
-    object_prototype = njs_vm_proto(vm, NJS_OBJ_TYPE_OBJECT);
+    njs_uint_t  i;
 
-    for (i = NJS_OBJ_TYPE_ARRAY; i < NJS_OBJ_TYPE_NORMAL_MAX; i++) {
-        vm->prototypes[i].object.__proto__ = object_prototype;
+    for (i = 0; i < vm->constructors_size; i++) {
+        njs_vm_proto_init(vm, i);
     }
+}
 
-    typed_array_prototype = njs_vm_proto(vm, NJS_OBJ_TYPE_TYPED_ARRAY);
 
-    for (i = NJS_OBJ_TYPE_TYPED_ARRAY_MIN;
-         i < NJS_OBJ_TYPE_TYPED_ARRAY_MAX;
-         i++)
-    {
-        vm->prototypes[i].object.__proto__ = typed_array_prototype;
+njs_prop_cache_t *
+njs_vm_prop_cache_grow(njs_vm_t *vm, uint32_t slot)
+{
+    uint32_t          size;
+    njs_prop_cache_t  *caches;
+
+    if (slot == 0 || slot > vm->prop_cache_slots) {
+        return NULL;
     }
 
-    vm->prototypes[NJS_OBJ_TYPE_ARRAY_ITERATOR].object.__proto__ =
-                                       njs_vm_proto(vm, NJS_OBJ_TYPE_ITERATOR);
+    size = njs_max(slot + 1, vm->prop_caches_size * 2);
+    size = njs_min(size, vm->prop_cache_slots + 1);
 
-    vm->prototypes[NJS_OBJ_TYPE_BUFFER].object.__proto__ =
-                                    njs_vm_proto(vm, NJS_OBJ_TYPE_UINT8_ARRAY);
+    caches = njs_mp_zalloc(vm->mem_pool, size * sizeof(njs_prop_cache_t));
+    if (njs_slow_path(caches == NULL)) {
+        /* The access goes uncached. */
+        return NULL;
+    }
 
-    error_prototype = njs_vm_proto(vm, NJS_OBJ_TYPE_ERROR);
-    error_prototype->__proto__ = object_prototype;
+    if (vm->prop_caches != NULL) {
+        memcpy(caches, vm->prop_caches,
+               vm->prop_caches_size * sizeof(njs_prop_cache_t));
 
-    for (i = NJS_OBJ_TYPE_EVAL_ERROR; i < vm->constructors_size; i++) {
-        vm->prototypes[i].object.__proto__ = error_prototype;
+        njs_mp_free(vm->mem_pool, vm->prop_caches);
     }
 
-    function_prototype = njs_vm_proto(vm, NJS_OBJ_TYPE_FUNCTION);
+    vm->prop_caches = caches;
+    vm->prop_caches_size = size;
+
+    return &caches[slot];
+}
 
-    async_prototype = njs_vm_proto(vm, NJS_OBJ_TYPE_ASYNC_FUNCTION);
-    async_prototype->__proto__ = function_prototype;
 
-    for (i = NJS_OBJ_TYPE_OBJECT; i < NJS_OBJ_TYPE_NORMAL_MAX; i++) {
-        vm->constructors[i].object.__proto__ = function_prototype;
+void
+njs_vm_proto_copy(njs_vm_t *vm, njs_uint_t index)
+{
+    njs_assert(index < vm->constructors_size);
+
+    /*
+     * The entry is marked first, njs_vm_proto_init() copies the parents
+     * which may refer back to it.  Neither allocates memory.
+     */
+
+    vm->protos_ready[index] = 1;
+
+    vm->constructors[index] = *njs_shared_ctor(vm->shared, index);
+    vm->prototypes[index] = *njs_shared_prototype(vm->shared, index);
+
+    njs_vm_proto_init(vm, index);
+}
+
+
+static void
+njs_vm_proto_init(njs_vm_t *vm, njs_uint_t index)
+{
+    njs_object_t  *proto, *ctor;
+
+    proto = &vm->prototypes[index].object;
+    ctor = &vm->constructors[index].object;
+
+    if (index == NJS_OBJ_TYPE_ASYNC_FUNCTION) {
+        proto->__proto__ = njs_vm_proto(vm, NJS_OBJ_TYPE_FUNCTION);
+
+    } else if (index == NJS_OBJ_TYPE_ARRAY_ITERATOR) {
+        proto->__proto__ = njs_vm_proto(vm, NJS_OBJ_TYPE_ITERATOR);
+
+    } else if (index == NJS_OBJ_TYPE_BUFFER) {
+        proto->__proto__ = njs_vm_proto(vm, NJS_OBJ_TYPE_UINT8_ARRAY);
+
+    } else if (index >= NJS_OBJ_TYPE_ARRAY && index < NJS_OBJ_TYPE_NORMAL_MAX) {
+        proto->__proto__ = njs_vm_proto(vm, NJS_OBJ_TYPE_OBJECT);
     }
 
-    typed_array_ctor = &njs_vm_ctor(vm, NJS_OBJ_TYPE_TYPED_ARRAY).object;
+    if (index < NJS_OBJ_TYPE_NORMAL_MAX || index == NJS_OBJ_TYPE_ERROR) {
+        ctor->__proto__ = njs_vm_proto(vm, NJS_OBJ_TYPE_FUNCTION);
+    }
 
-    for (i = NJS_OBJ_TYPE_TYPED_ARRAY_MIN;
-         i < NJS_OBJ_TYPE_TYPED_ARRAY_MAX;
-         i++)
+    if (index >= NJS_OBJ_TYPE_TYPED_ARRAY_MIN
+        && index < NJS_OBJ_TYPE_TYPED_ARRAY_MAX)
     {
-        vm->constructors[i].object.__proto__ = typed_array_ctor;
-    }
+        proto->__proto__ = njs_vm_proto(vm, NJS_OBJ_TYPE_TYPED_ARRAY);
+        ctor->__proto__ = &njs_vm_ctor(vm, NJS_OBJ_TYPE_TYPED_ARRAY).object;
 
-    error_ctor = &njs_vm_ctor(vm, NJS_OBJ_TYPE_ERROR).object;
-    error_ctor->__proto__ = function_prototype;
+    } else if (index == NJS_OBJ_TYPE_ERROR) {
+        proto->__proto__ = njs_vm_proto(vm, NJS_OBJ_TYPE_OBJECT);
 
-    for (i = NJS_OBJ_TYPE_EVAL_ERROR; i < vm->constructors_size; i++) {
-        vm->constructors[i].object.__proto__ = error_ctor;
+    } else if (index > NJS_OBJ_TYPE_ERROR) {
+        proto->__proto__ = njs_vm_proto(vm, NJS_OBJ_TYPE_ERROR);
+        ctor->__proto__ = &njs_vm_ctor(vm, NJS_OBJ_TYPE_ERROR).object;
     }
 }
 
 
 static njs_int_t
-njs_vm_protos_init(njs_vm_t *vm, njs_value_t *global)
+njs_vm_protos_init(njs_vm_t *vm, njs_value_t *global, njs_bool_t lazy)
 {
     size_t  ctor_size, proto_size;
 
@@ -583,7 +686,8 @@ njs_vm_protos_init(njs_vm_t *vm, njs_value_t *global)
     ctor_size = vm->constructors_size * sizeof(njs_function_t);
     proto_size = vm->constructors_size * sizeof(njs_object_prototype_t);
 
-    vm->constructors = njs_mp_alloc(vm->mem_pool, ctor_size + proto_size);
+    vm->constructors = njs_mp_alloc(vm->mem_pool, ctor_size + proto_size
+                                                  + vm->constructors_size);
     if (njs_slow_path(vm->constructors == NULL)) {
         njs_memory_error(vm);
         return NJS_ERROR;
@@ -592,10 +696,19 @@ njs_vm_protos_init(njs_vm_t *vm, njs_value_t *global)
     vm->prototypes = (njs_object_prototype_t *)
                                      ((u_char *) vm->constructors + ctor_size);
 
-    memcpy(vm->constructors, vm->shared->constructors->start, ctor_size);
-    memcpy(vm->prototypes, vm->shared->prototypes->start, proto_size);
+    vm->protos_ready = (uint8_t *) vm->prototypes + proto_size;
+
+    if (lazy) {
+        njs_memzero(vm->protos_ready, vm->constructors_size);
+
+    } else {
+        memcpy(vm->constructors, vm->shared->constructors->start, ctor_size);
+        memcpy(vm->prototypes, vm->shared->prototypes->start, proto_size);
+
+        njs_memset(vm->protos_ready, 1, vm->constructors_size);
 
-    njs_vm_constructors_init(vm);
+        njs_vm_constructors_init(vm);
+    }
 
     vm->global_object.__proto__ = njs_vm_proto(vm, NJS_OBJ_TYPE_OBJECT);
 
@@ -631,6 +744,8 @@ njs_vm_invoke(njs_vm_t *vm, njs_function_t *function, const njs_value_t *args,
         return ret;
     }
 
+    njs_profile_pending = 0;
+
     return njs_function_frame_invoke(vm, retval);
 }
 
@@ -696,6 +811,12 @@ njs_vm_start(njs_vm_t *vm, njs_value_t *retval)
 {
     njs_int_t  ret;
 
+    if (njs_slow_path(vm->gc != NULL)) {
+        njs_gc_abandon(vm);
+    }
+
+    njs_profile_pending = 0;
+
     ret = njs_vmcode_interpreter(vm, vm->start, retval, NULL, NULL);
 
     return (ret == NJS_ERROR) ? NJS_ERROR : NJS_OK;
@@ -749,6 +870,13 @@ njs_vm_set_rejection_tracker(njs_vm_t *vm,
 }
 
 
+void
+njs_vm_profile(njs_vm_t *vm, njs_profile_t *profile)
+{
+    vm->profile = profile;
+}
+
+
 njs_value_t
 njs_vm_exception(njs_vm_t *vm)
 {
@@ -775,6 +903,29 @@ njs_vm_memory_pool(njs_vm_t *vm)
 }
 
 
+size_t
+njs_vm_code_size(njs_vm_t *vm)
+{
+    size_t         size;
+    njs_uint_t     n;
+    njs_vm_code_t  *code;
+
+    size = 0;
+
+    if (vm->codes == NULL) {
+        return size;
+    }
+
+    code = vm->codes->start;
+
+    for (n = 0; n < vm->codes->items; n++) {
+        size += code[n].end - code[n].start;
+    }
+
+    return size;
+}
+
+
 njs_external_ptr_t
 njs_vm_external_ptr(njs_vm_t *vm)
 {
@@ -981,7 +1132,12 @@ njs_vm_bind_handler(njs_vm_t *vm, const njs_str_t *var_name,
 void
 njs_value_string_get(njs_vm_t *vm, njs_value_t *value, njs_str_t *dst)
 {
-    njs_string_get(vm, value, dst);
+    /* The values given by the host are not flattened beforehand. */
+
+    if (njs_slow_path(njs_string_get_checked(vm, value, dst) != NJS_OK)) {
+        dst->length = 0;
+        dst->start = (u_char *) "";
+    }
 }
 
 
@@ -1524,6 +1680,13 @@ njs_vm_value_to_c_string(njs_vm_t *vm, njs_value_t *value)
 {
     njs_assert(njs_is_string(value));
 
+    if (njs_slow_path(njs_string_is_rope(value->string.data))) {
+        value->string.data = njs_string_flat(vm, value->string.data);
+        if (njs_slow_path(value->string.data == NULL)) {
+            return NULL;
+        }
+    }
+
     return (const char *) value->string.data->start;
 }
 
@@ -1608,8 +1771,7 @@ njs_vm_value_to_bytes(njs_vm_t *vm, njs_str_t *dst, njs_value_t *src)
             return NJS_ERROR;
         }
 
-        dst->length = value.string.data->size;
-        dst->start = value.string.data->start;
+        njs_string_get(vm, &value, dst);
     }
 
     return ret;
@@ -17,6 +17,7 @@ typedef struct njs_parser_s           njs_parser_t;
 typedef struct njs_parser_scope_s     njs_parser_scope_t;
 typedef struct njs_parser_node_s      njs_parser_node_t;
 typedef struct njs_generator_s        njs_generator_t;
+typedef struct njs_gc_s               njs_gc_t;
 
 
 typedef enum {
@@ -124,6 +125,11 @@ struct njs_vm_s {
     njs_value_t              **levels[NJS_LEVEL_MAX];
 
     njs_external_ptr_t       external;
+    /*
+     * The externals are stamped with the generation they are created in,
+     * the ones of a past generation are stale, see njs_vm_reset().
+     */
+    uint16_t                 external_generation;
 
     njs_native_frame_t       *top_frame;
     njs_frame_t              *active_frame;
@@ -138,24 +144,44 @@ struct njs_vm_s {
 
     njs_flathsh_t            modules_hash;
 
+    /* Flat copies of the ropes of the VM a clone was created from. */
+    njs_flathsh_t            flat_ropes;
+
     uint32_t                 event_id;
     njs_queue_t              jobs;
 
     njs_vm_opt_t             options;
 
-#define njs_vm_proto(vm, index) (&(vm)->prototypes[index].object)
-#define njs_vm_ctor(vm, index) ((vm)->constructors[index])
+#define njs_vm_proto(vm, index)                                               \
+    (&njs_vm_proto_ready(vm, index)->prototypes[index].object)
+#define njs_vm_ctor(vm, index)                                                \
+    (njs_vm_proto_ready(vm, index)->constructors[index])
 
     njs_object_prototype_t   *prototypes;
     njs_function_t           *constructors;
     size_t                   constructors_size;
 
+    /*
+     * A clone copies a constructor and its prototype from the shared ones
+     * on the first access.  The copy cannot fail: the storage for all of
+     * them is allocated by njs_vm_protos_init() when the clone is created,
+     * so njs_vm_proto() and njs_vm_ctor() never return NULL.
+     */
+    uint8_t                  *protos_ready;
+
     njs_function_t           *hooks[NJS_HOOK_MAX];
 
     njs_mp_t                 *mem_pool;
 
     u_char                   *start;
     size_t                   spare_stack_size;
+    njs_native_frame_t       *spare_stack;
+
+    /* The pool size at which the next collection is pending. */
+    size_t                   gc_threshold;
+    /* The collection in progress, see njs_vm_gc_step(). */
+    njs_gc_t                 *gc;
+    njs_bool_t               gc_abandoned;
 
     njs_vm_shared_t          *shared;
 
@@ -177,6 +203,20 @@ struct njs_vm_s {
 
     njs_arr_t                *codes;  /* of njs_vm_code_t */
 
+    /*
+     * Inline caches of the property access instructions, the table is
+     * private to a VM and is allocated on the first use.
+     */
+    njs_prop_cache_t         *prop_caches;
+    uint32_t                 prop_caches_size;
+    uint32_t                 prop_cache_slots;
+
+#if (NJS_HAVE_JIT)
+    njs_jit_t                *jit;
+#endif
+
+    njs_profile_t            *profile;
+
     njs_trace_t              trace;
     njs_random_t             random;
 
@@ -234,14 +274,20 @@ struct njs_vm_shared_s {
     njs_exotic_slots_t       global_slots;
 
     njs_regexp_pattern_t     *empty_regexp_pattern;
+
+    /* Smoothed arena usage of the clones, the initial size of their arena. */
+    size_t                   arena_size;
 };
 
 
 njs_int_t njs_vm_runtime_init(njs_vm_t *vm);
 njs_int_t njs_vm_ctor_push(njs_vm_t *vm);
 void njs_vm_constructors_init(njs_vm_t *vm);
+void njs_vm_proto_copy(njs_vm_t *vm, njs_uint_t index);
 njs_value_t njs_vm_exception(njs_vm_t *vm);
+njs_prop_cache_t *njs_vm_prop_cache_grow(njs_vm_t *vm, uint32_t slot);
 void njs_vm_scopes_restore(njs_vm_t *vm, njs_native_frame_t *frame);
+void njs_gc_abandon(njs_vm_t *vm);
 
 njs_int_t njs_builtin_objects_create(njs_vm_t *vm);
 
@@ -252,6 +298,33 @@ void *njs_flathsh_proto_alloc(void *data, size_t size);
 void njs_flathsh_proto_free(void *data, void *p, size_t size);
 
 
+/*
+ * Returns the inline cache of an instruction slot or NULL if the slot
+ * has no cache, in which case the property is accessed uncached.
+ */
+
+njs_inline njs_prop_cache_t *
+njs_vm_prop_cache(njs_vm_t *vm, uint32_t slot)
+{
+    if (njs_fast_path(slot < vm->prop_caches_size && slot != 0)) {
+        return &vm->prop_caches[slot];
+    }
+
+    return njs_vm_prop_cache_grow(vm, slot);
+}
+
+
+njs_inline njs_vm_t *
+njs_vm_proto_ready(njs_vm_t *vm, njs_uint_t index)
+{
+    if (njs_slow_path(!vm->protos_ready[index])) {
+        njs_vm_proto_copy(vm, index);
+    }
+
+    return vm;
+}
+
+
 extern const njs_str_t    njs_entry_empty;
 extern const njs_str_t    njs_entry_main;
 extern const njs_str_t    njs_entry_module;
@@ -13,7 +13,8 @@ struct njs_property_next_s {
     njs_array_t  *array;
 };
 
-static njs_jump_off_t njs_vmcode_object(njs_vm_t *vm, njs_value_t *retval);
+static njs_jump_off_t njs_vmcode_object(njs_vm_t *vm, u_char *pc,
+    njs_value_t *retval);
 static njs_jump_off_t njs_vmcode_array(njs_vm_t *vm, u_char *pc,
     njs_value_t *retval);
 static njs_jump_off_t njs_vmcode_function(njs_vm_t *vm, u_char *pc);
@@ -63,6 +64,8 @@ static njs_jump_off_t njs_string_concat(njs_vm_t *vm, njs_value_t *val1,
     njs_value_t *val2, njs_value_t *retval);
 static njs_jump_off_t njs_values_equal(njs_vm_t *vm, njs_value_t *val1,
     njs_value_t *val2);
+static njs_jump_off_t njs_vmcode_relation(njs_vm_t *vm, njs_vmcode_t op,
+    njs_value_t *value1, njs_value_t *value2);
 static njs_jump_off_t njs_primitive_values_compare(njs_vm_t *vm,
     njs_value_t *val1, njs_value_t *val2);
 static njs_jump_off_t njs_function_frame_create(njs_vm_t *vm,
@@ -70,6 +73,16 @@ static njs_jump_off_t njs_function_frame_create(njs_vm_t *vm,
     njs_bool_t ctor);
 
 
+/*
+ * The string comparison cannot report a failure to flatten a rope,
+ * so the operands are flattened beforehand.
+ */
+
+#define njs_vmcode_string_flatten(vm, value)                                  \
+    (njs_slow_path(njs_is_rope(value))                                        \
+     && njs_string_flatten(vm, value) != NJS_OK)
+
+
 #define njs_vmcode_operand(vm, index, _retval)                                \
     do {                                                                      \
         _retval = njs_scope_valid_value(vm, index);                           \
@@ -79,6 +92,49 @@ static njs_jump_off_t njs_function_frame_create(njs_vm_t *vm,
     } while (0)
 
 
+/* Sign-extends a jump offset read through njs_vmcode_generic_t. */
+#define njs_vmcode_jump_offset(operand)                                       \
+    ((njs_jump_off_t) (njs_vmcode_offset_t) (operand))
+
+
+/*
+ * A pending profile sample is taken at backward jumps and at function
+ * entries only, so the other instructions do not check for it.
+ */
+#define njs_vmcode_profile(vm, pc, ret)                                       \
+    do {                                                                      \
+        if (njs_slow_path((ret) < 0 && njs_profile_pending)) {               \
+            njs_profile_sample(vm, pc);                                       \
+        }                                                                     \
+    } while (0)
+
+
+#if (NJS_HAVE_JIT)
+
+/*
+ * A backward jump of a function which has native code continues in it at
+ * the jump target, see njs_jit_run().
+ */
+#define njs_vmcode_jit(vm, pc, ret)                                           \
+    do {                                                                      \
+        njs_function_t  *_function;                                           \
+                                                                              \
+        if (njs_slow_path((ret) < 0)) {                                       \
+            _function = (vm)->active_frame->native.function;                  \
+                                                                              \
+            if (_function != NULL && _function->u.lambda->jit != NULL) {      \
+                pc = njs_jit_run(vm, _function->u.lambda, pc);                \
+            }                                                                 \
+        }                                                                     \
+    } while (0)
+
+#else
+
+#define njs_vmcode_jit(vm, pc, ret)
+
+#endif
+
+
 njs_int_t
 njs_vmcode_interpreter(njs_vm_t *vm, u_char *pc, njs_value_t *rval,
     void *promise_cap, void *async_ctx)
@@ -90,10 +146,12 @@ njs_vmcode_interpreter(njs_vm_t *vm, u_char *pc, njs_value_t *rval,
     njs_bool_t                   valid, lambda_call;
     njs_value_t                  *retval, *value1, *value2;
     njs_value_t                  *src, *s1, *s2, dst;
+    njs_array_t                  *array;
     njs_value_t                  *function, name;
     njs_value_t                  numeric1, numeric2, primitive1, primitive2;
     njs_frame_t                  *frame;
     njs_jump_off_t               ret;
+    njs_prop_cache_t             *cache;
     njs_vmcode_1addr_t           *put_arg;
     njs_vmcode_await_t           *await;
     njs_native_frame_t           *previous, *native;
@@ -105,6 +163,7 @@ njs_vmcode_interpreter(njs_vm_t *vm, u_char *pc, njs_value_t *rval,
     njs_vmcode_prop_set_t        *set;
     njs_vmcode_prop_next_t       *pnext;
     njs_vmcode_test_jump_t       *test_jump;
+    njs_vmcode_atom_frame_t      *atom_frame;
     njs_vmcode_equal_jump_t      *equal;
     njs_vmcode_try_return_t      *try_return;
     njs_vmcode_method_frame_t    *method_frame;
@@ -118,6 +177,8 @@ njs_vmcode_interpreter(njs_vm_t *vm, u_char *pc, njs_value_t *rval,
     #define SWITCH(op)      switch (op)
     #define CASE(op)        case op
     #define BREAK           pc += ret; NEXT
+    #define JUMP            njs_vmcode_profile(vm, pc, ret); pc += ret;       \
+                            njs_vmcode_jit(vm, pc, ret); NEXT
 
     #define NEXT            vmcode = (njs_vmcode_generic_t *) pc;             \
                             goto next
@@ -129,6 +190,8 @@ njs_vmcode_interpreter(njs_vm_t *vm, u_char *pc, njs_value_t *rval,
     #define SWITCH(op)      goto *switch_tbl[(uint8_t) op];
     #define CASE(op)        case_ ## op
     #define BREAK           pc += ret; NEXT
+    #define JUMP            njs_vmcode_profile(vm, pc, ret); pc += ret;       \
+                            njs_vmcode_jit(vm, pc, ret); NEXT
 
     #define NEXT            vmcode = (njs_vmcode_generic_t *) pc;             \
                             SWITCH (vmcode->code)
@@ -149,10 +212,20 @@ njs_vmcode_interpreter(njs_vm_t *vm, u_char *pc, njs_value_t *rval,
         NJS_GOTO_ROW(NJS_VMCODE_IF_TRUE_JUMP),
         NJS_GOTO_ROW(NJS_VMCODE_IF_FALSE_JUMP),
         NJS_GOTO_ROW(NJS_VMCODE_IF_EQUAL_JUMP),
+        NJS_GOTO_ROW(NJS_VMCODE_IF_NOT_EQUAL_JUMP),
+        NJS_GOTO_ROW(NJS_VMCODE_IF_LESS_JUMP),
+        NJS_GOTO_ROW(NJS_VMCODE_IF_GREATER_JUMP),
+        NJS_GOTO_ROW(NJS_VMCODE_IF_LESS_OR_EQUAL_JUMP),
+        NJS_GOTO_ROW(NJS_VMCODE_IF_GREATER_OR_EQUAL_JUMP),
+        NJS_GOTO_ROW(NJS_VMCODE_IF_NOT_LESS_JUMP),
+        NJS_GOTO_ROW(NJS_VMCODE_IF_NOT_GREATER_JUMP),
+        NJS_GOTO_ROW(NJS_VMCODE_IF_NOT_LESS_OR_EQUAL_JUMP),
+        NJS_GOTO_ROW(NJS_VMCODE_IF_NOT_GREATER_OR_EQUAL_JUMP),
         NJS_GOTO_ROW(NJS_VMCODE_PROPERTY_INIT),
         NJS_GOTO_ROW(NJS_VMCODE_RETURN),
         NJS_GOTO_ROW(NJS_VMCODE_FUNCTION_FRAME),
         NJS_GOTO_ROW(NJS_VMCODE_METHOD_FRAME),
+        NJS_GOTO_ROW(NJS_VMCODE_METHOD_ATOM_FRAME),
         NJS_GOTO_ROW(NJS_VMCODE_FUNCTION_CALL),
         NJS_GOTO_ROW(NJS_VMCODE_PROPERTY_NEXT),
         NJS_GOTO_ROW(NJS_VMCODE_ARGUMENTS),
@@ -171,6 +244,7 @@ njs_vmcode_interpreter(njs_vm_t *vm, u_char *pc, njs_value_t *rval,
         NJS_GOTO_ROW(NJS_VMCODE_FINALLY),
         NJS_GOTO_ROW(NJS_VMCODE_LET),
         NJS_GOTO_ROW(NJS_VMCODE_LET_UPDATE),
+        NJS_GOTO_ROW(NJS_VMCODE_LET_LOCAL),
         NJS_GOTO_ROW(NJS_VMCODE_INITIALIZATION_TEST),
         NJS_GOTO_ROW(NJS_VMCODE_NOT_INITIALIZED),
         NJS_GOTO_ROW(NJS_VMCODE_ASSIGNMENT_ERROR),
@@ -257,7 +331,10 @@ NEXT_LBL;
         get = (njs_vmcode_prop_get_t *) pc;
         njs_vmcode_operand(vm, get->value, retval);
 
-        ret = njs_value_property(vm, value1, value2->atom_id, retval);
+        cache = njs_vm_prop_cache(vm, get->cache);
+
+        ret = njs_value_property_cached(vm, value1, value2->atom_id, cache,
+                                        retval);
         if (njs_slow_path(ret == NJS_ERROR)) {
             goto error;
         }
@@ -274,6 +351,24 @@ NEXT_LBL;
         get = (njs_vmcode_prop_get_t *) pc;
         njs_vmcode_operand(vm, get->value, retval);
 
+        if (njs_is_number(value2) && njs_is_fast_array(value1)) {
+            array = njs_array(value1);
+            num = njs_number(value2);
+
+            if (num >= 0 && num < array->length) {
+                u32 = (uint32_t) num;
+
+                if (njs_fast_path(u32 == num
+                                  && njs_is_valid(&array->start[u32])))
+                {
+                    njs_value_assign(retval, &array->start[u32]);
+
+                    pc += sizeof(njs_vmcode_prop_get_t);
+                    NEXT;
+                }
+            }
+        }
+
         if (njs_slow_path(!njs_is_index_or_key(value2))) {
             if (njs_slow_path(njs_is_null_or_undefined(value1))) {
                 (void) njs_throw_cannot_property(vm, value1, value2, "get");
@@ -457,12 +552,30 @@ NEXT_LBL;
         pc += try_return->offset;
         NEXT;
 
+/*
+ * Comparison of two numbers needs neither primitive conversion nor
+ * NaN handling: all relations with NaN are false as in C.
+ */
+#define NJS_NUMERIC_RELATION(op)                                              \
+                                                                              \
+        if (njs_fast_path(njs_is_numeric(value1)                              \
+                          && njs_is_numeric(value2)))                         \
+        {                                                                     \
+            njs_vmcode_operand(vm, vmcode->operand1, retval);                 \
+            njs_set_boolean(retval, njs_number(value1) op njs_number(value2));\
+                                                                              \
+            pc += sizeof(njs_vmcode_3addr_t);                                 \
+            NEXT;                                                             \
+        }
+
     CASE (NJS_VMCODE_LESS):
         njs_vmcode_debug_opcode();
 
         njs_vmcode_operand(vm, vmcode->operand3, value2);
         njs_vmcode_operand(vm, vmcode->operand2, value1);
 
+        NJS_NUMERIC_RELATION(<);
+
         if (njs_slow_path(!njs_is_primitive(value1))) {
             ret = njs_value_to_primitive(vm, &primitive1, value1,
                                          NJS_HINT_NUMBER);
@@ -490,6 +603,12 @@ NEXT_LBL;
             goto error;
         }
 
+        if (njs_slow_path(njs_vmcode_string_flatten(vm, value1)
+                          || njs_vmcode_string_flatten(vm, value2)))
+        {
+            goto error;
+        }
+
         njs_vmcode_operand(vm, vmcode->operand1, retval);
 
         njs_set_boolean(retval,
@@ -504,6 +623,8 @@ NEXT_LBL;
         njs_vmcode_operand(vm, vmcode->operand3, value2);
         njs_vmcode_operand(vm, vmcode->operand2, value1);
 
+        NJS_NUMERIC_RELATION(>);
+
         if (njs_slow_path(!njs_is_primitive(value1))) {
             ret = njs_value_to_primitive(vm, &primitive1, value1,
                                          NJS_HINT_NUMBER);
@@ -531,6 +652,12 @@ NEXT_LBL;
             goto error;
         }
 
+        if (njs_slow_path(njs_vmcode_string_flatten(vm, value1)
+                          || njs_vmcode_string_flatten(vm, value2)))
+        {
+            goto error;
+        }
+
         njs_vmcode_operand(vm, vmcode->operand1, retval);
 
         njs_set_boolean(retval,
@@ -545,6 +672,8 @@ NEXT_LBL;
         njs_vmcode_operand(vm, vmcode->operand3, value2);
         njs_vmcode_operand(vm, vmcode->operand2, value1);
 
+        NJS_NUMERIC_RELATION(<=);
+
         if (njs_slow_path(!njs_is_primitive(value1))) {
             ret = njs_value_to_primitive(vm, &primitive1, value1,
                                          NJS_HINT_NUMBER);
@@ -572,6 +701,12 @@ NEXT_LBL;
             goto error;
         }
 
+        if (njs_slow_path(njs_vmcode_string_flatten(vm, value1)
+                          || njs_vmcode_string_flatten(vm, value2)))
+        {
+            goto error;
+        }
+
         njs_vmcode_operand(vm, vmcode->operand1, retval);
 
         njs_set_boolean(retval,
@@ -586,6 +721,8 @@ NEXT_LBL;
         njs_vmcode_operand(vm, vmcode->operand3, value2);
         njs_vmcode_operand(vm, vmcode->operand2, value1);
 
+        NJS_NUMERIC_RELATION(>=);
+
         if (njs_slow_path(!njs_is_primitive(value1))) {
             ret = njs_value_to_primitive(vm, &primitive1, value1,
                                          NJS_HINT_NUMBER);
@@ -613,6 +750,12 @@ NEXT_LBL;
             goto error;
         }
 
+        if (njs_slow_path(njs_vmcode_string_flatten(vm, value1)
+                          || njs_vmcode_string_flatten(vm, value2)))
+        {
+            goto error;
+        }
+
         njs_vmcode_operand(vm, vmcode->operand1, retval);
 
         njs_set_boolean(retval,
@@ -627,6 +770,16 @@ NEXT_LBL;
         njs_vmcode_operand(vm, vmcode->operand3, value2);
         njs_vmcode_operand(vm, vmcode->operand2, value1);
 
+        if (njs_fast_path(njs_is_numeric(value1)
+                          && njs_is_numeric(value2)))
+        {
+            njs_vmcode_operand(vm, vmcode->operand1, retval);
+            njs_set_number(retval, njs_number(value1) + njs_number(value2));
+
+            pc += sizeof(njs_vmcode_3addr_t);
+            NEXT;
+        }
+
         if (njs_slow_path(!njs_is_primitive(value1))) {
             ret = njs_value_to_primitive(vm, &primitive1, value1,
                                          NJS_HINT_NONE);
@@ -1028,6 +1181,12 @@ NEXT_LBL;
         njs_vmcode_operand(vm, vmcode->operand3, value2);
         njs_vmcode_operand(vm, vmcode->operand2, value1);
 
+        if (njs_slow_path(njs_vmcode_string_flatten(vm, value1)
+                          || njs_vmcode_string_flatten(vm, value2)))
+        {
+            goto error;
+        }
+
         ret = njs_values_strict_equal(vm, value1, value2);
 
         njs_vmcode_operand(vm, vmcode->operand1, retval);
@@ -1042,6 +1201,12 @@ NEXT_LBL;
         njs_vmcode_operand(vm, vmcode->operand3, value2);
         njs_vmcode_operand(vm, vmcode->operand2, value1);
 
+        if (njs_slow_path(njs_vmcode_string_flatten(vm, value1)
+                          || njs_vmcode_string_flatten(vm, value2)))
+        {
+            goto error;
+        }
+
         ret = njs_values_strict_equal(vm, value1, value2);
 
         njs_vmcode_operand(vm, vmcode->operand1, retval);
@@ -1068,7 +1233,7 @@ NEXT_LBL;
         njs_vmcode_operand(vm, vmcode->operand1, retval);
         *retval = *value1;
 
-        BREAK;
+        JUMP;
 
     CASE (NJS_VMCODE_TEST_IF_FALSE):
         njs_vmcode_debug_opcode();
@@ -1088,7 +1253,7 @@ NEXT_LBL;
         njs_vmcode_operand(vm, vmcode->operand1, retval);
         *retval = *value1;
 
-        BREAK;
+        JUMP;
 
     CASE (NJS_VMCODE_COALESCE):
         njs_vmcode_debug_opcode();
@@ -1194,7 +1359,7 @@ NEXT_LBL;
 
         njs_vmcode_operand(vm, vmcode->operand1, retval);
 
-        ret = njs_vmcode_object(vm, retval);
+        ret = njs_vmcode_object(vm, pc, retval);
         if (njs_slow_path(ret < 0 && ret >= NJS_PREEMPT)) {
             goto error;
         }
@@ -1321,8 +1486,8 @@ NEXT_LBL;
     CASE (NJS_VMCODE_JUMP):
         njs_vmcode_debug_opcode();
 
-        ret = (njs_jump_off_t) vmcode->operand1;
-        BREAK;
+        ret = njs_vmcode_jump_offset(vmcode->operand1);
+        JUMP;
 
     CASE (NJS_VMCODE_PROPERTY_ATOM_SET):
         njs_vmcode_debug_opcode();
@@ -1331,7 +1496,12 @@ NEXT_LBL;
         njs_vmcode_operand(vm, vmcode->operand2, value1);
         njs_vmcode_operand(vm, vmcode->operand1, retval);
 
-        ret = njs_value_property_set(vm, value1, value2->atom_id, retval);
+        set = (njs_vmcode_prop_set_t *) pc;
+
+        cache = njs_vm_prop_cache(vm, set->cache);
+
+        ret = njs_value_property_set_cached(vm, value1, value2->atom_id,
+                                            cache, retval);
         if (njs_slow_path(ret == NJS_ERROR)) {
             goto error;
         }
@@ -1346,6 +1516,22 @@ NEXT_LBL;
         njs_vmcode_operand(vm, vmcode->operand2, value1);
         njs_vmcode_operand(vm, vmcode->operand1, retval);
 
+        if (njs_is_number(value2) && njs_is_fast_array(value1)) {
+            array = njs_array(value1);
+            num = njs_number(value2);
+
+            if (num >= 0 && num < array->length) {
+                u32 = (uint32_t) num;
+
+                if (njs_fast_path(u32 == num)) {
+                    njs_value_assign(&array->start[u32], retval);
+
+                    ret = sizeof(njs_vmcode_prop_set_t);
+                    BREAK;
+                }
+            }
+        }
+
         if (njs_slow_path(!njs_is_index_or_key(value2))) {
             if (njs_slow_path(njs_is_null_or_undefined(value1))) {
                 (void) njs_throw_cannot_property(vm, value1, value2, "set");
@@ -1415,27 +1601,27 @@ NEXT_LBL;
         njs_vmcode_debug_opcode();
 
         njs_vmcode_operand(vm, vmcode->operand2, value1);
-        value2 = (njs_value_t *) vmcode->operand1;
+        value2 = (njs_value_t *) njs_vmcode_jump_offset(vmcode->operand1);
 
         ret = njs_is_true(value1);
 
         ret = ret ? (njs_jump_off_t) value2
                   : (njs_jump_off_t) sizeof(njs_vmcode_cond_jump_t);
 
-        BREAK;
+        JUMP;
 
     CASE (NJS_VMCODE_IF_FALSE_JUMP):
         njs_vmcode_debug_opcode();
 
         njs_vmcode_operand(vm, vmcode->operand2, value1);
-        value2 = (njs_value_t *) vmcode->operand1;
+        value2 = (njs_value_t *) njs_vmcode_jump_offset(vmcode->operand1);
 
         ret = njs_is_true(value1);
 
         ret = !ret ? (njs_jump_off_t) value2
                    : (njs_jump_off_t) sizeof(njs_vmcode_cond_jump_t);
 
-        BREAK;
+        JUMP;
 
     CASE (NJS_VMCODE_IF_EQUAL_JUMP):
         njs_vmcode_debug_opcode();
@@ -1443,15 +1629,124 @@ NEXT_LBL;
         njs_vmcode_operand(vm, vmcode->operand3, value2);
         njs_vmcode_operand(vm, vmcode->operand2, value1);
 
+        if (njs_slow_path(njs_vmcode_string_flatten(vm, value1)
+                          || njs_vmcode_string_flatten(vm, value2)))
+        {
+            goto error;
+        }
+
         if (njs_values_strict_equal(vm, value1, value2)) {
             equal = (njs_vmcode_equal_jump_t *) pc;
             ret = equal->offset;
 
         } else {
-            ret = sizeof(njs_vmcode_3addr_t);
+            ret = sizeof(njs_vmcode_equal_jump_t);
         }
 
-        BREAK;
+        JUMP;
+
+    CASE (NJS_VMCODE_IF_NOT_EQUAL_JUMP):
+        njs_vmcode_debug_opcode();
+
+        njs_vmcode_operand(vm, vmcode->operand3, value2);
+        njs_vmcode_operand(vm, vmcode->operand2, value1);
+
+        if (njs_slow_path(njs_vmcode_string_flatten(vm, value1)
+                          || njs_vmcode_string_flatten(vm, value2)))
+        {
+            goto error;
+        }
+
+        if (!njs_values_strict_equal(vm, value1, value2)) {
+            equal = (njs_vmcode_equal_jump_t *) pc;
+            ret = equal->offset;
+
+        } else {
+            ret = sizeof(njs_vmcode_equal_jump_t);
+        }
+
+        JUMP;
+
+/*
+ * The relation is negated by the IF_NOT_* variants, as "!(a < b)" is not
+ * "a >= b" if one of the operands is NaN.
+ */
+#define NJS_RELATION_JUMP(op, operation, negate)                              \
+                                                                              \
+        njs_vmcode_operand(vm, vmcode->operand3, value2);                     \
+        njs_vmcode_operand(vm, vmcode->operand2, value1);                     \
+                                                                              \
+        if (njs_fast_path(njs_is_numeric(value1)                              \
+                          && njs_is_numeric(value2)))                         \
+        {                                                                     \
+            ret = (njs_number(value1) op njs_number(value2));                 \
+                                                                              \
+        } else {                                                              \
+            ret = njs_vmcode_relation(vm, operation, value1, value2);         \
+            if (njs_slow_path(ret == NJS_ERROR)) {                            \
+                goto error;                                                   \
+            }                                                                 \
+        }                                                                     \
+                                                                              \
+        equal = (njs_vmcode_equal_jump_t *) pc;                               \
+        ret = (ret != (negate)) ? equal->offset                               \
+                  : (njs_jump_off_t) sizeof(njs_vmcode_equal_jump_t)
+
+    CASE (NJS_VMCODE_IF_LESS_JUMP):
+        njs_vmcode_debug_opcode();
+
+        NJS_RELATION_JUMP(<, NJS_VMCODE_LESS, 0);
+
+        JUMP;
+
+    CASE (NJS_VMCODE_IF_GREATER_JUMP):
+        njs_vmcode_debug_opcode();
+
+        NJS_RELATION_JUMP(>, NJS_VMCODE_GREATER, 0);
+
+        JUMP;
+
+    CASE (NJS_VMCODE_IF_LESS_OR_EQUAL_JUMP):
+        njs_vmcode_debug_opcode();
+
+        NJS_RELATION_JUMP(<=, NJS_VMCODE_LESS_OR_EQUAL, 0);
+
+        JUMP;
+
+    CASE (NJS_VMCODE_IF_GREATER_OR_EQUAL_JUMP):
+        njs_vmcode_debug_opcode();
+
+        NJS_RELATION_JUMP(>=, NJS_VMCODE_GREATER_OR_EQUAL, 0);
+
+        JUMP;
+
+    CASE (NJS_VMCODE_IF_NOT_LESS_JUMP):
+        njs_vmcode_debug_opcode();
+
+        NJS_RELATION_JUMP(<, NJS_VMCODE_LESS, 1);
+
+        JUMP;
+
+    CASE (NJS_VMCODE_IF_NOT_GREATER_JUMP):
+        njs_vmcode_debug_opcode();
+
+        NJS_RELATION_JUMP(>, NJS_VMCODE_GREATER, 1);
+
+        JUMP;
+
+    CASE (NJS_VMCODE_IF_NOT_LESS_OR_EQUAL_JUMP):
+        njs_vmcode_debug_opcode();
+
+        NJS_RELATION_JUMP(<=, NJS_VMCODE_LESS_OR_EQUAL, 1);
+
+        JUMP;
+
+    CASE (NJS_VMCODE_IF_NOT_GREATER_OR_EQUAL_JUMP):
+        njs_vmcode_debug_opcode();
+
+        NJS_RELATION_JUMP(>=, NJS_VMCODE_GREATER_OR_EQUAL, 1);
+
+        JUMP;
 
     CASE (NJS_VMCODE_PROPERTY_INIT):
         njs_vmcode_debug_opcode();
@@ -1459,8 +1754,7 @@ NEXT_LBL;
         njs_vmcode_operand(vm, vmcode->operand3, value2);
         njs_vmcode_operand(vm, vmcode->operand2, value1);
 
-        set = (njs_vmcode_prop_set_t *) pc;
-        njs_vmcode_operand(vm, set->value, retval);
+        njs_vmcode_operand(vm, vmcode->operand1, retval);
         ret = njs_vmcode_property_init(vm, value1, value2, retval);
         if (njs_slow_path(ret == NJS_ERROR)) {
             goto error;
@@ -1471,7 +1765,7 @@ NEXT_LBL;
     CASE (NJS_VMCODE_RETURN):
         njs_vmcode_debug_opcode();
 
-        value2 = (njs_value_t *) vmcode->operand1;
+        value2 = (njs_value_t *) (uintptr_t) vmcode->operand1;
 
         njs_vmcode_operand(vm, (njs_index_t) value2, value2);
 
@@ -1484,7 +1778,7 @@ NEXT_LBL;
     CASE (NJS_VMCODE_FUNCTION_FRAME):
         njs_vmcode_debug_opcode();
 
-        value2 = (njs_value_t *) vmcode->operand1;
+        value2 = (njs_value_t *) (uintptr_t) vmcode->operand1;
         njs_vmcode_operand(vm, vmcode->operand2, value1);
 
         function_frame = (njs_vmcode_function_frame_t *) pc;
@@ -1519,10 +1813,37 @@ NEXT_LBL;
         ret = sizeof(njs_vmcode_method_frame_t);
         BREAK;
 
+    CASE (NJS_VMCODE_METHOD_ATOM_FRAME):
+        njs_vmcode_debug_opcode();
+
+        atom_frame = (njs_vmcode_atom_frame_t *) pc;
+
+        njs_vmcode_operand(vm, atom_frame->property, value2);
+        njs_vmcode_operand(vm, atom_frame->this_object, value1);
+        njs_vmcode_operand(vm, atom_frame->function, retval);
+
+        cache = njs_vm_prop_cache(vm, atom_frame->cache);
+
+        ret = njs_value_property_cached(vm, value1, value2->atom_id, cache,
+                                        retval);
+        if (njs_slow_path(ret == NJS_ERROR)) {
+            goto error;
+        }
+
+        ret = njs_function_frame_create(vm, retval, value1,
+                                        atom_frame->nargs, atom_frame->ctor);
+
+        if (njs_slow_path(ret != NJS_OK)) {
+            goto error;
+        }
+
+        ret = sizeof(njs_vmcode_atom_frame_t);
+        BREAK;
+
     CASE (NJS_VMCODE_FUNCTION_CALL):
         njs_vmcode_debug_opcode();
 
-        value2 = (njs_value_t *) vmcode->operand1;
+        value2 = (njs_value_t *) (uintptr_t) vmcode->operand1;
 
         vm->active_frame->native.pc = pc;
 
@@ -1575,7 +1896,7 @@ NEXT_LBL;
     CASE (NJS_VMCODE_TO_PROPERTY_KEY):
         njs_vmcode_debug_opcode();
 
-        value2 = (njs_value_t *) vmcode->operand1;
+        value2 = (njs_value_t *) (uintptr_t) vmcode->operand1;
         njs_vmcode_operand(vm, vmcode->operand2, value1);
 
         njs_vmcode_operand(vm, (njs_index_t) value2, retval);
@@ -1591,7 +1912,7 @@ NEXT_LBL;
     CASE (NJS_VMCODE_TO_PROPERTY_KEY_CHK):
         njs_vmcode_debug_opcode();
 
-        value2 = (njs_value_t *) vmcode->operand1;
+        value2 = (njs_value_t *) (uintptr_t) vmcode->operand1;
         njs_vmcode_operand(vm, vmcode->operand2, value1);
 
         njs_vmcode_operand(vm, (njs_index_t) value2, retval);
@@ -1613,7 +1934,7 @@ NEXT_LBL;
     CASE (NJS_VMCODE_SET_FUNCTION_NAME):
         njs_vmcode_debug_opcode();
 
-        value2 = (njs_value_t *) vmcode->operand1;
+        value2 = (njs_value_t *) (uintptr_t) vmcode->operand1;
         njs_vmcode_operand(vm, vmcode->operand2, value1);
 
         njs_vmcode_operand(vm, (njs_index_t) value2, value2);
@@ -1635,8 +1956,7 @@ NEXT_LBL;
         njs_vmcode_operand(vm, vmcode->operand3, value2);
         njs_vmcode_operand(vm, vmcode->operand2, value1);
 
-        set = (njs_vmcode_prop_set_t *) pc;
-        njs_vmcode_operand(vm, set->value, retval);
+        njs_vmcode_operand(vm, vmcode->operand1, retval);
         ret = njs_vmcode_proto_init(vm, value1, value2, retval);
         if (njs_slow_path(ret == NJS_ERROR)) {
             goto error;
@@ -1674,7 +1994,7 @@ NEXT_LBL;
     CASE (NJS_VMCODE_TRY_START):
         njs_vmcode_debug_opcode();
 
-        value2 = (njs_value_t *) vmcode->operand1;
+        value2 = (njs_value_t *) njs_vmcode_jump_offset(vmcode->operand1);
         njs_vmcode_operand(vm, vmcode->operand2, value1);
 
         ret = njs_vmcode_try_start(vm, value1, value2, pc);
@@ -1687,7 +2007,7 @@ NEXT_LBL;
     CASE (NJS_VMCODE_THROW):
         njs_vmcode_debug_opcode();
 
-        value2 = (njs_value_t *) vmcode->operand1;
+        value2 = (njs_value_t *) (uintptr_t) vmcode->operand1;
 
         njs_vmcode_operand(vm, (njs_index_t) value2, value2);
         njs_vm_throw(vm, value2);
@@ -1697,7 +2017,7 @@ NEXT_LBL;
     CASE (NJS_VMCODE_TRY_BREAK):
         njs_vmcode_debug_opcode();
 
-        value2 = (njs_value_t *) vmcode->operand1;
+        value2 = (njs_value_t *) njs_vmcode_jump_offset(vmcode->operand1);
 
         try_trampoline = (njs_vmcode_try_trampoline_t *) pc;
         value1 = njs_scope_value(vm, try_trampoline->exit_value);
@@ -1708,7 +2028,7 @@ NEXT_LBL;
     CASE (NJS_VMCODE_TRY_CONTINUE):
         njs_vmcode_debug_opcode();
 
-        value2 = (njs_value_t *) vmcode->operand1;
+        value2 = (njs_value_t *) njs_vmcode_jump_offset(vmcode->operand1);
 
         try_trampoline = (njs_vmcode_try_trampoline_t *) pc;
         value1 = njs_scope_value(vm, try_trampoline->exit_value);
@@ -1719,7 +2039,9 @@ NEXT_LBL;
     CASE (NJS_VMCODE_TRY_END):
         njs_vmcode_debug_opcode();
 
-        ret = njs_vmcode_try_end(vm, NULL, (njs_value_t *) vmcode->operand1);
+        value2 = (njs_value_t *) njs_vmcode_jump_offset(vmcode->operand1);
+
+        ret = njs_vmcode_try_end(vm, NULL, value2);
         BREAK;
 
     /*
@@ -1733,7 +2055,7 @@ NEXT_LBL;
     CASE (NJS_VMCODE_CATCH):
         njs_vmcode_debug_opcode();
 
-        value2 = (njs_value_t *) vmcode->operand1;
+        value2 = (njs_value_t *) njs_vmcode_jump_offset(vmcode->operand1);
         njs_vmcode_operand(vm, vmcode->operand2, value1);
 
         *value1 = njs_vm_exception(vm);
@@ -1752,7 +2074,7 @@ NEXT_LBL;
     CASE (NJS_VMCODE_FINALLY):
         njs_vmcode_debug_opcode();
 
-        value2 = (njs_value_t *) vmcode->operand1;
+        value2 = (njs_value_t *) (uintptr_t) vmcode->operand1;
 
         ret = njs_vmcode_finally(vm, rval, value2, pc);
 
@@ -1807,6 +2129,19 @@ NEXT_LBL;
         ret = sizeof(njs_vmcode_variable_t);
         BREAK;
 
+    CASE (NJS_VMCODE_LET_LOCAL):
+        njs_vmcode_debug_opcode();
+
+        /* The variable is not captured, so its frame slot is reused. */
+
+        var = (njs_vmcode_variable_t *) pc;
+        value1 = njs_scope_value(vm, var->dst);
+
+        njs_set_undefined(value1);
+
+        ret = sizeof(njs_vmcode_variable_t);
+        BREAK;
+
     CASE (NJS_VMCODE_INITIALIZATION_TEST):
         njs_vmcode_debug_opcode();
 
@@ -1870,10 +2205,7 @@ error:
 
         njs_vm_scopes_restore(vm, native);
 
-        if (native->size != 0) {
-            vm->spare_stack_size += native->size;
-            njs_mp_free(vm->mem_pool, native);
-        }
+        njs_function_frame_free(vm, native);
 
         if (lambda_call) {
             break;
@@ -1887,19 +2219,33 @@ error:
 
 
 static njs_jump_off_t
-njs_vmcode_object(njs_vm_t *vm, njs_value_t *retval)
+njs_vmcode_object(njs_vm_t *vm, u_char *pc, njs_value_t *retval)
 {
-    njs_object_t  *object;
+    njs_object_t         *object;
+    njs_flathsh_query_t  fhq;
+    njs_vmcode_object_t  *code;
 
     object = njs_object_alloc(vm);
+    if (njs_slow_path(object == NULL)) {
+        return NJS_ERROR;
+    }
 
-    if (njs_fast_path(object != NULL)) {
-        njs_set_object(retval, object);
+    code = (njs_vmcode_object_t *) pc;
 
-        return sizeof(njs_vmcode_object_t);
+    if (!njs_flathsh_is_empty(&code->props)) {
+        fhq.pool = vm->mem_pool;
+        fhq.proto = &njs_object_hash_proto;
+
+        object->hash.slot = njs_flathsh_copy(&code->props, &fhq);
+        if (njs_slow_path(object->hash.slot == NULL)) {
+            njs_memory_error(vm);
+            return NJS_ERROR;
+        }
     }
 
-    return NJS_ERROR;
+    njs_set_object(retval, object);
+
+    return sizeof(njs_vmcode_object_t);
 }
 
 
@@ -2149,7 +2495,7 @@ njs_vmcode_property_init(njs_vm_t *vm, njs_value_t *value, njs_value_t *key,
         return NJS_ERROR;
     }
 
-    return sizeof(njs_vmcode_prop_set_t);
+    return sizeof(njs_vmcode_prop_init_t);
 }
 
 
@@ -2185,7 +2531,7 @@ njs_vmcode_proto_init(njs_vm_t *vm, njs_value_t *value, njs_value_t *unused,
         goto fail;
     }
 
-    return sizeof(njs_vmcode_prop_set_t);
+    return sizeof(njs_vmcode_prop_init_t);
 
 fail:
 
@@ -2390,8 +2736,21 @@ njs_string_concat(njs_vm_t *vm, njs_value_t *val1, njs_value_t *val2,
 {
     u_char             *start;
     size_t             size, length;
+    njs_int_t          ret;
     njs_string_prop_t  string1, string2;
 
+    ret = njs_string_rope(vm, retval, val1, val2);
+    if (ret != NJS_DECLINED) {
+        return (ret == NJS_OK) ? (njs_jump_off_t) sizeof(njs_vmcode_3addr_t)
+                               : NJS_ERROR;
+    }
+
+    if (njs_slow_path(njs_string_flatten(vm, val1) != NJS_OK
+                      || njs_string_flatten(vm, val2) != NJS_OK))
+    {
+        return NJS_ERROR;
+    }
+
     (void) njs_string_prop(vm, &string1, val1);
     (void) njs_string_prop(vm, &string2, val2);
 
@@ -2436,6 +2795,12 @@ again:
     if (val1->type == val2->type) {
 
         if (njs_is_string(val1)) {
+            if (njs_slow_path(njs_string_flatten(vm, val1) != NJS_OK
+                              || njs_string_flatten(vm, val2) != NJS_OK))
+            {
+                return NJS_ERROR;
+            }
+
             return njs_string_eq(vm, val1, val2);
         }
 
@@ -2469,6 +2834,10 @@ again:
 
     /* If "hv" is a string then "lv" can be a numeric or symbol. */
     if (njs_is_string(hv)) {
+        if (njs_slow_path(njs_string_flatten(vm, hv) != NJS_OK)) {
+            return NJS_ERROR;
+        }
+
         return !njs_is_symbol(lv)
             && (njs_number(lv) == njs_string_to_number(vm, hv));
     }
@@ -2487,6 +2856,60 @@ again:
 }
 
 
+/*
+ * njs_vmcode_relation() evaluates the relational operator "op" in the same
+ * way as the NJS_VMCODE_LESS .. NJS_VMCODE_GREATER_OR_EQUAL instructions do.
+ * It returns 1 if the relation holds, 0 if it does not, or NJS_ERROR.
+ */
+
+static njs_jump_off_t
+njs_vmcode_relation(njs_vm_t *vm, njs_vmcode_t op, njs_value_t *value1,
+    njs_value_t *value2)
+{
+    njs_int_t    ret;
+    njs_value_t  primitive1, primitive2;
+
+    if (njs_slow_path(!njs_is_primitive(value1))) {
+        ret = njs_value_to_primitive(vm, &primitive1, value1,
+                                     NJS_HINT_NUMBER);
+        if (ret != NJS_OK) {
+            return NJS_ERROR;
+        }
+
+        value1 = &primitive1;
+    }
+
+    if (njs_slow_path(!njs_is_primitive(value2))) {
+        ret = njs_value_to_primitive(vm, &primitive2, value2,
+                                     NJS_HINT_NUMBER);
+        if (ret != NJS_OK) {
+            return NJS_ERROR;
+        }
+
+        value2 = &primitive2;
+    }
+
+    if (njs_slow_path(njs_is_symbol(value1) || njs_is_symbol(value2))) {
+        njs_symbol_conversion_failed(vm, 0);
+        return NJS_ERROR;
+    }
+
+    switch (op) {
+    case NJS_VMCODE_LESS:
+        return njs_primitive_values_compare(vm, value1, value2) > 0;
+
+    case NJS_VMCODE_GREATER:
+        return njs_primitive_values_compare(vm, value2, value1) > 0;
+
+    case NJS_VMCODE_LESS_OR_EQUAL:
+        return njs_primitive_values_compare(vm, value2, value1) == 0;
+
+    default:
+        return njs_primitive_values_compare(vm, value1, value2) == 0;
+    }
+}
+
+
 /*
  * ECMAScript 5.1: 11.8.5
  * njs_primitive_values_compare() returns
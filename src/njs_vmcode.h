@@ -10,8 +10,9 @@
 
 /*
  * Negative return values handled by nJSVM interpreter as special events.
- * The values must be in range from -1 to -11, because -12 is minimal jump
- * offset on 32-bit platforms.
+ * The values must be in range from -1 to -11.  Instructions returning
+ * them may jump only forward, so the values are not confused with backward
+ * jump offsets which are multiples of 8.
  *    0  (NJS_OK)   :  njs_vmcode_stop() has stopped execution,
  *                          execution successfully finished
  *    -1 (NJS_ERROR):  error or exception;
@@ -25,6 +26,18 @@
 typedef intptr_t                        njs_jump_off_t;
 typedef uint8_t                         njs_vmcode_t;
 
+/*
+ * Instruction operands are stored in 32 bits: a scope index fits in
+ * 32 bits and a jump offset is limited by NJS_VMCODE_MAX_SIZE.
+ * Instructions are aligned to 8 bytes, so instructions with pointer
+ * operands stay aligned in the code.
+ */
+typedef uint32_t                        njs_vmcode_index_t;
+typedef int32_t                         njs_vmcode_offset_t;
+
+#define NJS_VMCODE_ALIGNED              njs_aligned(8)
+#define NJS_VMCODE_MAX_SIZE             INT32_MAX
+
 
 enum {
     NJS_VMCODE_PUT_ARG = 0,
@@ -36,10 +49,20 @@ enum {
     NJS_VMCODE_IF_TRUE_JUMP,
     NJS_VMCODE_IF_FALSE_JUMP,
     NJS_VMCODE_IF_EQUAL_JUMP,
+    NJS_VMCODE_IF_NOT_EQUAL_JUMP,
+    NJS_VMCODE_IF_LESS_JUMP,
+    NJS_VMCODE_IF_GREATER_JUMP,
+    NJS_VMCODE_IF_LESS_OR_EQUAL_JUMP,
+    NJS_VMCODE_IF_GREATER_OR_EQUAL_JUMP,
+    NJS_VMCODE_IF_NOT_LESS_JUMP,
+    NJS_VMCODE_IF_NOT_GREATER_JUMP,
+    NJS_VMCODE_IF_NOT_LESS_OR_EQUAL_JUMP,
+    NJS_VMCODE_IF_NOT_GREATER_OR_EQUAL_JUMP,
     NJS_VMCODE_PROPERTY_INIT,
     NJS_VMCODE_RETURN,
     NJS_VMCODE_FUNCTION_FRAME,
     NJS_VMCODE_METHOD_FRAME,
+    NJS_VMCODE_METHOD_ATOM_FRAME,
     NJS_VMCODE_FUNCTION_CALL,
     NJS_VMCODE_PROPERTY_NEXT,
     NJS_VMCODE_ARGUMENTS,
@@ -58,6 +81,7 @@ enum {
     NJS_VMCODE_FINALLY,
     NJS_VMCODE_LET,
     NJS_VMCODE_LET_UPDATE,
+    NJS_VMCODE_LET_LOCAL,
     NJS_VMCODE_INITIALIZATION_TEST,
     NJS_VMCODE_NOT_INITIALIZED,
     NJS_VMCODE_ASSIGNMENT_ERROR,
@@ -118,257 +142,279 @@ enum {
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                operand1;
-    njs_index_t                operand2;
-    njs_index_t                operand3;
-} njs_vmcode_generic_t;
+    njs_vmcode_index_t         operand1;
+    njs_vmcode_index_t         operand2;
+    njs_vmcode_index_t         operand3;
+} NJS_VMCODE_ALIGNED njs_vmcode_generic_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                index;
-} njs_vmcode_1addr_t;
+    njs_vmcode_index_t         index;
+} NJS_VMCODE_ALIGNED njs_vmcode_1addr_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                dst;
-    njs_index_t                src;
-} njs_vmcode_2addr_t;
+    njs_vmcode_index_t         dst;
+    njs_vmcode_index_t         src;
+} NJS_VMCODE_ALIGNED njs_vmcode_2addr_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                dst;
-    njs_index_t                src1;
-    njs_index_t                src2;
-} njs_vmcode_3addr_t;
+    njs_vmcode_index_t         dst;
+    njs_vmcode_index_t         src1;
+    njs_vmcode_index_t         src2;
+} NJS_VMCODE_ALIGNED njs_vmcode_3addr_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                dst;
-    njs_index_t                src;
-} njs_vmcode_move_t;
+    njs_vmcode_index_t         dst;
+    njs_vmcode_index_t         src;
+} NJS_VMCODE_ALIGNED njs_vmcode_move_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                retval;
-} njs_vmcode_object_t;
+    njs_vmcode_index_t         retval;
+    njs_flathsh_t              props;
+} NJS_VMCODE_ALIGNED njs_vmcode_object_t;
 
 
 typedef struct {
      njs_vmcode_t              code;
-     njs_index_t               dst;
-} njs_vmcode_this_t;
+     njs_vmcode_index_t        dst;
+} NJS_VMCODE_ALIGNED njs_vmcode_this_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                dst;
-} njs_vmcode_arguments_t;
+    njs_vmcode_index_t         dst;
+} NJS_VMCODE_ALIGNED njs_vmcode_arguments_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                retval;
+    njs_vmcode_index_t         retval;
     uintptr_t                  length;
     uint8_t                    ctor;       /* 1 bit  */
-} njs_vmcode_array_t;
+} NJS_VMCODE_ALIGNED njs_vmcode_array_t;
 
 
 typedef struct {
      njs_vmcode_t              code;
-     njs_index_t               retval;
-} njs_vmcode_template_literal_t;
+     njs_vmcode_index_t        retval;
+} NJS_VMCODE_ALIGNED njs_vmcode_template_literal_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                retval;
+    njs_vmcode_index_t         retval;
     njs_function_lambda_t      *lambda;
     njs_bool_t                 async;
-} njs_vmcode_function_t;
+} NJS_VMCODE_ALIGNED njs_vmcode_function_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                retval;
+    njs_vmcode_index_t         retval;
     njs_regexp_pattern_t       *pattern;
-} njs_vmcode_regexp_t;
+} NJS_VMCODE_ALIGNED njs_vmcode_regexp_t;
+
+
+typedef struct {
+    njs_vmcode_t               code;
+    njs_vmcode_index_t         retval;
+    njs_vmcode_index_t         object;
+} NJS_VMCODE_ALIGNED njs_vmcode_object_copy_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                retval;
-    njs_index_t                object;
-} njs_vmcode_object_copy_t;
+    njs_vmcode_offset_t        offset;
+} NJS_VMCODE_ALIGNED njs_vmcode_jump_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_jump_off_t             offset;
-} njs_vmcode_jump_t;
+    njs_vmcode_offset_t        offset;
+    njs_vmcode_index_t         cond;
+} NJS_VMCODE_ALIGNED njs_vmcode_cond_jump_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_jump_off_t             offset;
-    njs_index_t                cond;
-} njs_vmcode_cond_jump_t;
+    njs_vmcode_offset_t        offset;
+    njs_vmcode_index_t         value1;
+    njs_vmcode_index_t         value2;
+} NJS_VMCODE_ALIGNED njs_vmcode_equal_jump_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_jump_off_t             offset;
-    njs_index_t                value1;
-    njs_index_t                value2;
-} njs_vmcode_equal_jump_t;
+    njs_vmcode_index_t         retval;
+    njs_vmcode_index_t         value;
+    njs_vmcode_offset_t        offset;
+} NJS_VMCODE_ALIGNED njs_vmcode_test_jump_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                retval;
-    njs_index_t                value;
-    njs_jump_off_t             offset;
-} njs_vmcode_test_jump_t;
+    njs_vmcode_index_t         value;
+    njs_vmcode_index_t         object;
+    njs_vmcode_index_t         property;
+    uint32_t                   cache;      /* njs_vm_prop_cache() slot */
+} NJS_VMCODE_ALIGNED njs_vmcode_prop_get_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                value;
-    njs_index_t                object;
-    njs_index_t                property;
-} njs_vmcode_prop_get_t;
+    njs_vmcode_index_t         value;
+    njs_vmcode_index_t         object;
+    njs_vmcode_index_t         property;
+    uint32_t                   cache;      /* njs_vm_prop_cache() slot */
+} NJS_VMCODE_ALIGNED njs_vmcode_prop_set_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                value;
-    njs_index_t                object;
-    njs_index_t                property;
-} njs_vmcode_prop_set_t;
+    njs_vmcode_index_t         value;
+    njs_vmcode_index_t         object;
+    njs_vmcode_index_t         property;
+} NJS_VMCODE_ALIGNED njs_vmcode_prop_init_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                value;
-    njs_index_t                object;
-    njs_index_t                property;
+    njs_vmcode_index_t         value;
+    njs_vmcode_index_t         object;
+    njs_vmcode_index_t         property;
     uint8_t                    type;
-} njs_vmcode_prop_accessor_t;
+} NJS_VMCODE_ALIGNED njs_vmcode_prop_accessor_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                next;
-    njs_index_t                object;
-    njs_jump_off_t             offset;
-} njs_vmcode_prop_foreach_t;
+    njs_vmcode_index_t         next;
+    njs_vmcode_index_t         object;
+    njs_vmcode_offset_t        offset;
+} NJS_VMCODE_ALIGNED njs_vmcode_prop_foreach_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                retval;
-    njs_index_t                object;
-    njs_index_t                next;
-    njs_jump_off_t             offset;
-} njs_vmcode_prop_next_t;
+    njs_vmcode_index_t         retval;
+    njs_vmcode_index_t         object;
+    njs_vmcode_index_t         next;
+    njs_vmcode_offset_t        offset;
+} NJS_VMCODE_ALIGNED njs_vmcode_prop_next_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                value;
-    njs_index_t                constructor;
-    njs_index_t                object;
-} njs_vmcode_instance_of_t;
+    njs_vmcode_index_t         value;
+    njs_vmcode_index_t         constructor;
+    njs_vmcode_index_t         object;
+} NJS_VMCODE_ALIGNED njs_vmcode_instance_of_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                nargs;
-    njs_index_t                name;
+    njs_vmcode_index_t         nargs;
+    njs_vmcode_index_t         name;
     uint8_t                    ctor;       /* 1 bit  */
-} njs_vmcode_function_frame_t;
+} NJS_VMCODE_ALIGNED njs_vmcode_function_frame_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                nargs;
-    njs_index_t                function;
-    njs_index_t                this_object;
+    njs_vmcode_index_t         nargs;
+    njs_vmcode_index_t         function;
+    njs_vmcode_index_t         this_object;
     uint8_t                    ctor;       /* 1 bit  */
-} njs_vmcode_method_frame_t;
+} NJS_VMCODE_ALIGNED njs_vmcode_method_frame_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                retval;
-} njs_vmcode_function_call_t;
+    njs_vmcode_index_t         nargs;
+    njs_vmcode_index_t         function;
+    njs_vmcode_index_t         this_object;
+    uint8_t                    ctor;       /* 1 bit  */
+    njs_vmcode_index_t         property;
+    uint32_t                   cache;      /* njs_vm_prop_cache() slot */
+} NJS_VMCODE_ALIGNED njs_vmcode_atom_frame_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                retval;
-} njs_vmcode_return_t;
+    njs_vmcode_index_t         retval;
+} NJS_VMCODE_ALIGNED njs_vmcode_function_call_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                retval;
-} njs_vmcode_stop_t;
+    njs_vmcode_index_t         retval;
+} NJS_VMCODE_ALIGNED njs_vmcode_return_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_jump_off_t             offset;
-    njs_index_t                exception_value;
-    njs_index_t                exit_value;
-} njs_vmcode_try_start_t;
+    njs_vmcode_index_t         retval;
+} NJS_VMCODE_ALIGNED njs_vmcode_stop_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_jump_off_t             offset;
-    njs_index_t                exit_value;
-} njs_vmcode_try_trampoline_t;
+    njs_vmcode_offset_t        offset;
+    njs_vmcode_index_t         exception_value;
+    njs_vmcode_index_t         exit_value;
+} NJS_VMCODE_ALIGNED njs_vmcode_try_start_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_jump_off_t             offset;
-    njs_index_t                exception;
-} njs_vmcode_catch_t;
+    njs_vmcode_offset_t        offset;
+    njs_vmcode_index_t         exit_value;
+} NJS_VMCODE_ALIGNED njs_vmcode_try_trampoline_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                retval;
-} njs_vmcode_throw_t;
+    njs_vmcode_offset_t        offset;
+    njs_vmcode_index_t         exception;
+} NJS_VMCODE_ALIGNED njs_vmcode_catch_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_jump_off_t             offset;
-} njs_vmcode_try_end_t;
+    njs_vmcode_index_t         retval;
+} NJS_VMCODE_ALIGNED njs_vmcode_throw_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                save;
-    njs_index_t                retval;
-    njs_jump_off_t             offset;
-} njs_vmcode_try_return_t;
+    njs_vmcode_offset_t        offset;
+} NJS_VMCODE_ALIGNED njs_vmcode_try_end_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                retval;
-    njs_index_t                exit_value;
-    njs_jump_off_t             continue_offset;
-    njs_jump_off_t             break_offset;
-} njs_vmcode_finally_t;
+    njs_vmcode_index_t         save;
+    njs_vmcode_index_t         retval;
+    njs_vmcode_offset_t        offset;
+} NJS_VMCODE_ALIGNED njs_vmcode_try_return_t;
+
+
+typedef struct {
+    njs_vmcode_t               code;
+    njs_vmcode_index_t         retval;
+    njs_vmcode_index_t         exit_value;
+    njs_vmcode_offset_t        continue_offset;
+    njs_vmcode_offset_t        break_offset;
+} NJS_VMCODE_ALIGNED njs_vmcode_finally_t;
 
 
 typedef struct {
@@ -378,32 +424,32 @@ typedef struct {
         njs_str_t              name;
         njs_str_t              message;
     } u;
-} njs_vmcode_error_t;
+} NJS_VMCODE_ALIGNED njs_vmcode_error_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                retval;
+    njs_vmcode_index_t         retval;
     njs_mod_t                  *module;
-} njs_vmcode_import_t;
+} NJS_VMCODE_ALIGNED njs_vmcode_import_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                dst;
-} njs_vmcode_variable_t;
+    njs_vmcode_index_t         dst;
+} NJS_VMCODE_ALIGNED njs_vmcode_variable_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                retval;
-} njs_vmcode_debugger_t;
+    njs_vmcode_index_t         retval;
+} NJS_VMCODE_ALIGNED njs_vmcode_debugger_t;
 
 
 typedef struct {
     njs_vmcode_t               code;
-    njs_index_t                retval;
-} njs_vmcode_await_t;
+    njs_vmcode_index_t         retval;
+} NJS_VMCODE_ALIGNED njs_vmcode_await_t;
 
 
 njs_int_t njs_vmcode_interpreter(njs_vm_t *vm, u_char *pc, njs_value_t *retval,
@@ -411,6 +457,8 @@ njs_int_t njs_vmcode_interpreter(njs_vm_t *vm, u_char *pc, njs_value_t *retval,
 
 njs_object_t *njs_function_new_object(njs_vm_t *vm, njs_value_t *constructor);
 
+size_t njs_bytecode_instruction_size(njs_vmcode_t code);
+
 #ifdef NJS_DEBUG_OPCODE
 #define njs_vmcode_debug(vm, pc, prefix) {                                    \
         if (vm->options.opcode_debug) do {                                    \
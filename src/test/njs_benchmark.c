@@ -99,6 +99,7 @@ static njs_int_t
 njs_benchmark_test(njs_vm_t *parent, njs_opts_t *opts, njs_value_t *report,
     njs_benchmark_test_t *test)
 {
+    size_t              size;
     u_char              *start;
     njs_vm_t            *vm, *nvm;
     uint64_t            ns;
@@ -108,16 +109,18 @@ njs_benchmark_test(njs_vm_t *parent, njs_opts_t *opts, njs_value_t *report,
     njs_bool_t          success;
     njs_value_t         *result;
     njs_vm_opt_t        options;
-    njs_opaque_value_t  retval, name, usec, times;
+    njs_opaque_value_t  retval, name, usec, times, code;
 
     static const njs_str_t  name_key = njs_str("name");
     static const njs_str_t  usec_key = njs_str("usec");
     static const njs_str_t  times_key = njs_str("times");
+    static const njs_str_t  code_key = njs_str("code");
 
     njs_vm_opt_init(&options);
 
     options.backtrace = 1;
     options.addons = njs_benchmark_addon_external_modules;
+    options.arena = 1;
 
     vm = NULL;
     nvm = NULL;
@@ -137,6 +140,8 @@ njs_benchmark_test(njs_vm_t *parent, njs_opts_t *opts, njs_value_t *report,
         goto done;
     }
 
+    size = njs_vm_code_size(vm);
+
     n = test->repeat;
     expected = &test->result;
 
@@ -174,14 +179,15 @@ njs_benchmark_test(njs_vm_t *parent, njs_opts_t *opts, njs_value_t *report,
 
     if (!opts->dump_report) {
         if (n == 1) {
-            njs_printf("%s%s: %.3fs\n", opts->previous ? "    " : "",
-                       test->name, (double) ns / 1000000000);
+            njs_printf("%s%s: %.3fs, code %uz bytes\n",
+                       opts->previous ? "    " : "", test->name,
+                       (double) ns / 1000000000, size);
 
         } else {
-            njs_printf("%s%s: %.3fµs, %d times/s\n",
+            njs_printf("%s%s: %.3fµs, %d times/s, code %uz bytes\n",
                        opts->previous ? "    " : "",
                        test->name, (double) ns / n / 1000,
-                       (int) ((uint64_t) n * 1000000000 / ns));
+                       (int) ((uint64_t) n * 1000000000 / ns), size);
         }
     }
 
@@ -201,6 +207,7 @@ njs_benchmark_test(njs_vm_t *parent, njs_opts_t *opts, njs_value_t *report,
 
     njs_value_number_set(njs_value_arg(&usec), 1000 * ns);
     njs_value_number_set(njs_value_arg(&times), n);
+    njs_value_number_set(njs_value_arg(&code), size);
 
     ret = njs_vm_object_alloc(parent, result, NULL);
     if (ret != NJS_OK) {
@@ -226,6 +233,12 @@ njs_benchmark_test(njs_vm_t *parent, njs_opts_t *opts, njs_value_t *report,
         goto done;
     }
 
+    ret = njs_vm_object_prop_set(parent, result, &code_key, &code);
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_object_prop_set() failed\n");
+        goto done;
+    }
+
     ret = NJS_OK;
 
 done:
@@ -321,6 +334,161 @@ static njs_benchmark_test_t  njs_test[] =
       njs_str("undefined"),
       1 },
 
+    { "utf8 decode ascii 1M",
+      njs_str("var b = Buffer.from('x'.repeat(1 << 20)), n = 0;"
+              "for (var i = 0; i < 20; i++) { n += b.toString().length; }"
+              "n"),
+      njs_str("20971520"),
+      1 },
+
+    { "utf8 decode mixed 768K",
+      njs_str("var b = Buffer.from('жx'.repeat(1 << 18)), n = 0;"
+              "for (var i = 0; i < 20; i++) { n += b.toString().length; }"
+              "n"),
+      njs_str("10485760"),
+      1 },
+
+    { "base64 encode/decode 32B",
+      njs_str("var b = Buffer.alloc(32, 0xfb), n = 0;"
+              "for (var i = 0; i < 100000; i++) {"
+              "    n += Buffer.from(b.toString('base64'), 'base64').length;"
+              "}"
+              "n"),
+      njs_str("3200000"),
+      1 },
+
+    { "base64 encode/decode 1K",
+      njs_str("var b = Buffer.alloc(1 << 10, 0xfb), n = 0;"
+              "for (var i = 0; i < 3000; i++) {"
+              "    n += Buffer.from(b.toString('base64'), 'base64').length;"
+              "}"
+              "n"),
+      njs_str("3072000"),
+      1 },
+
+    { "base64 encode/decode 64K",
+      njs_str("var b = Buffer.alloc(1 << 16, 0xfb), n = 0;"
+              "for (var i = 0; i < 50; i++) {"
+              "    n += Buffer.from(b.toString('base64'), 'base64').length;"
+              "}"
+              "n"),
+      njs_str("3276800"),
+      1 },
+
+    { "base64 encode/decode 1M",
+      njs_str("var b = Buffer.alloc(1 << 20, 0xfb), n = 0;"
+              "for (var i = 0; i < 3; i++) {"
+              "    n += Buffer.from(b.toString('base64'), 'base64').length;"
+              "}"
+              "n"),
+      njs_str("3145728"),
+      1 },
+
+    { "hex encode/decode 32B",
+      njs_str("var b = Buffer.alloc(32, 0xfb), n = 0;"
+              "for (var i = 0; i < 100000; i++) {"
+              "    n += Buffer.from(b.toString('hex'), 'hex').length;"
+              "}"
+              "n"),
+      njs_str("3200000"),
+      1 },
+
+    { "hex encode/decode 1K",
+      njs_str("var b = Buffer.alloc(1 << 10, 0xfb), n = 0;"
+              "for (var i = 0; i < 3000; i++) {"
+              "    n += Buffer.from(b.toString('hex'), 'hex').length;"
+              "}"
+              "n"),
+      njs_str("3072000"),
+      1 },
+
+    { "hex encode/decode 64K",
+      njs_str("var b = Buffer.alloc(1 << 16, 0xfb), n = 0;"
+              "for (var i = 0; i < 50; i++) {"
+              "    n += Buffer.from(b.toString('hex'), 'hex').length;"
+              "}"
+              "n"),
+      njs_str("3276800"),
+      1 },
+
+    { "hex encode/decode 1M",
+      njs_str("var b = Buffer.alloc(1 << 20, 0xfb), n = 0;"
+              "for (var i = 0; i < 3; i++) {"
+              "    n += Buffer.from(b.toString('hex'), 'hex').length;"
+              "}"
+              "n"),
+      njs_str("3145728"),
+      1 },
+
+    { "string indexOf miss 1.4M",
+      njs_str("var s = ('<div class=\"item\">Hello, world! ' + 'x'.repeat(50)"
+              "         + '</div>\\n').repeat(16384), n = 0;"
+              "for (var i = 0; i < 20; i++) {"
+              "    n += s.indexOf('<span>') + s.includes('</section>');"
+              "}"
+              "n"),
+      njs_str("-20"),
+      1 },
+
+    { "string replaceAll/split 1.4M",
+      njs_str("var s = ('<div class=\"item\">Hello, world! ' + 'x'.repeat(50)"
+              "         + '</div>\\n').repeat(16384), n = 0;"
+              "for (var i = 0; i < 5; i++) {"
+              "    n += s.replaceAll('world', 'njs').length"
+              "         + s.split('\\n').length;"
+              "}"
+              "n"),
+      njs_str("7208965"),
+      1 },
+
+    { "string replaceAll utf8 168K",
+      njs_str("var s = ('<p>Привет, мир! ' + 'ж'.repeat(20) + '</p>\\n')"
+              "        .repeat(4096), n = 0;"
+              "for (var i = 0; i < 5; i++) {"
+              "    n += s.replaceAll('мир', 'njs').length"
+              "         + s.lastIndexOf('<div>');"
+              "}"
+              "n"),
+      njs_str("839675"),
+      1 },
+
+    { "string toLowerCase/toUpperCase 1.2M",
+      njs_str("var s = 'Content-Type: Text/HTML; Charset=UTF-8\\r\\n'"
+              "        .repeat(32768), n = 0;"
+              "for (var i = 0; i < 5; i++) {"
+              "    n += s.toLowerCase().length + s.toUpperCase().length;"
+              "}"
+              "n"),
+      njs_str("13107200"),
+      1 },
+
+    { "string toLowerCase utf8 196K",
+      njs_str("var s = ('Header-Name: Значение ' + 'X'.repeat(20))"
+              "        .repeat(4096), n = 0;"
+              "for (var i = 0; i < 5; i++) {"
+              "    n += s.toLowerCase().length;"
+              "}"
+              "n"),
+      njs_str("860160"),
+      1 },
+
+    { "string trim 64K",
+      njs_str("var s = ' \\t\\r\\n'.repeat(8192), t = s + 'x' + s, n = 0;"
+              "for (var i = 0; i < 100; i++) {"
+              "    n += t.trim().length + t.trimStart().length"
+              "         + t.trimEnd().length;"
+              "}"
+              "n"),
+      njs_str("6553900"),
+      1 },
+
+    { "string concat 100K",
+      njs_str("var s = '';"
+              "for (var i = 0; i < 100000; i++) { s += 'line ' + i + ';'; }"
+              "s.length"),
+      njs_str("1088890"),
+      1 },
+
     { "JSON.parse",
       njs_str("JSON.parse('{\"a\":123, \"XXX\":[3,4,null]}').a"),
       njs_str("123"),
@@ -336,6 +504,42 @@ static njs_benchmark_test_t  njs_test[] =
       njs_str(""),
       10 },
 
+    { "JSON.parse objects 2.4M",
+      njs_str("var o = {id: 12345, name: 'item name', active: true,"
+              "         tags: ['alpha', 'beta'],"
+              "         text: 'Lorem ipsum dolor sit amet, consectetur'};"
+              "var s = JSON.stringify(Array(20000).fill(o)), n = 0;"
+              "for (var i = 0; i < 5; i++) {"
+              "    n += JSON.parse(s).length;"
+              "}"
+              "n"),
+      njs_str("100000"),
+      1 },
+
+    { "JSON.parse pretty 5M",
+      njs_str("var o = {id: 12345, name: 'item name', active: true,"
+              "         tags: ['alpha', 'beta'],"
+              "         text: 'Lorem ipsum dolor sit amet, consectetur'};"
+              "var s = JSON.stringify({items: Array(20000).fill(o)}, null, 4);"
+              "var n = 0;"
+              "for (var i = 0; i < 5; i++) {"
+              "    n += JSON.parse(s).items.length;"
+              "}"
+              "n"),
+      njs_str("100000"),
+      1 },
+
+    { "JSON.parse escaped strings 1M",
+      njs_str("var t = '\"Lorem \\\\\"ipsum\\\\\" dolor sit amet,'"
+              "        + '\\\\n\\\\u00e9 consectetur\"';"
+              "var s = '[' + Array(20000).fill(t).join(',') + ']', n = 0;"
+              "for (var i = 0; i < 5; i++) {"
+              "    n += JSON.parse(s)[7].length;"
+              "}"
+              "n"),
+      njs_str("215"),
+      1 },
+
     { "for loop 100M",
       njs_str("var i; for (i = 0; i < 100000000; i++); i"),
       njs_str("100000000"),
@@ -387,6 +591,42 @@ static njs_benchmark_test_t  njs_test[] =
       njs_str("3524578"),
       1 },
 
+    { "deep calls 100K",
+      njs_str("function d(n) { return n ? d(n - 1) + 1 : 0 }"
+              "var s = 0;"
+              "for (var i = 0; i < 100000; i++) { s += d(64); }"
+              "s"),
+      njs_str("6400000"),
+      1 },
+
+    { "block scoped locals 10M",
+      njs_str("var s = 0;"
+              "for (var i = 0; i < 10000000; i++) {"
+              "    let a = i; const b = a & 7; s += b;"
+              "}"
+              "s"),
+      njs_str("35000000"),
+      1 },
+
+    { "array map callbacks 100K",
+      njs_str("var a = [1, 2, 3, 4, 5, 6, 7, 8], s = 0;"
+              "for (var i = 0; i < 100000; i++) {"
+              "    s += a.map(v => v + 1).length;"
+              "}"
+              "s"),
+      njs_str("800000"),
+      1 },
+
+    { "int array indexOf/join/sort 10K",
+      njs_str("var a = [], s = 0;"
+              "for (var i = 0; i < 10000; i++) { a.push((i * 7919) % 10007); }"
+              "for (var i = 0; i < 100; i++) {"
+              "    s += a.indexOf(i) + a.join().length + a.slice().sort()[0];"
+              "}"
+              "s"),
+      njs_str("5395655"),
+      1 },
+
     { "array 64k keys",
       njs_str("var arr = new Array(2**16);"
               "arr.fill(1);"
@@ -433,6 +673,70 @@ static njs_benchmark_test_t  njs_test[] =
       njs_str("undefined"),
       1 },
 
+    { "int32 hash 10M",
+      njs_str("var h = 0;"
+              "for (var i = 0; i < 10000000; i++) { h = (h * 31 + i) | 0; }"
+              "h"),
+      njs_str("823511872"),
+      1 },
+
+    { "int32 xorshift 10M",
+      njs_str("var x = 2463534242 | 0;"
+              "for (var i = 0; i < 10000000; i++) {"
+              "    x ^= x << 13; x ^= x >>> 17; x ^= x << 5;"
+              "}"
+              "x >>> 0"),
+      njs_str("3882214040"),
+      1 },
+
+    { "int32 array buckets 10M",
+      njs_str("var b = new Array(256).fill(0);"
+              "for (var i = 0; i < 10000000; i++) { b[(i * 7) & 255] += 1; }"
+              "b[3]"),
+      njs_str("39063"),
+      1 },
+
+    { "int32 compare 10M",
+      njs_str("var n = 0;"
+              "for (var i = 0; i < 10000000; i++) {"
+              "    n = ((i & 7) < 3) ? n + 1 : n - 1;"
+              "}"
+              "n"),
+      njs_str("-2500000"),
+      1 },
+
+    { "object literal 1M",
+      njs_str("var o;"
+              "for (var i = 0; i < 1000000; i++) {"
+              "    o = {a: i, b: 'b', c: null, d: true, e: 0, f: 1};"
+              "}"
+              "o.a"),
+      njs_str("999999"),
+      1 },
+
+    { "property get/set 10M",
+      njs_str("var o = {a: 0, b: 1, c: 2};"
+              "for (var i = 0; i < 10000000; i++) { o.a = o.b + o.c; }"
+              "o.a"),
+      njs_str("3"),
+      1 },
+
+    { "polymorphic property get 10M",
+      njs_str("var objs = [{x: 1}, {y: 0, x: 1}, {z: 0, y: 0, x: 1}];"
+              "var sum = 0;"
+              "for (var i = 0; i < 10000000; i++) { sum += objs[i % 3].x; }"
+              "sum"),
+      njs_str("10000000"),
+      1 },
+
+    { "prototype method lookup 1M",
+      njs_str("function P() {} P.prototype.get = function() { return 1 };"
+              "var p = new P(), sum = 0;"
+              "for (var i = 0; i < 1000000; i++) { sum += p.get(); }"
+              "sum"),
+      njs_str("1000000"),
+      1 },
+
     { "regexp split",
       njs_str("var s = Array(26).fill(0).map((v,i)=> {"
               "    var u = String.fromCodePoint(65+i), l = u.toLowerCase(); return u+l+l;}).join('');"
@@ -502,7 +806,9 @@ static njs_str_t  code = njs_str(
     "    test = current[t];"
     "    prev = find(prev_report, test.name);"
     "    diff = (test.usec - prev.usec) / prev.usec * 100;"
-    "    result.push(`    ${test.name}: ${diff.toFixed(2)}%`);"
+    "    result.push(`    ${test.name}: ${diff.toFixed(2)}%`"
+    "                + (prev.code ? `, code ${prev.code} -> ${test.code} bytes`"
+    "                             : ''));"
     "  }"
     "  return result.join('\\n') + '\\n';"
     "}"
@@ -2496,6 +2496,21 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("NaN = 1"),
       njs_str("TypeError: Cannot assign to read-only property \"NaN\" of object") },
 
+    { njs_str("var x = NaN, y = 1;"
+              "[x < y, x > y, x <= y, x >= y, y <= x, y >= x, x < x]"),
+      njs_str("false,false,false,false,false,false,false") },
+
+    { njs_str("var z = -0, y = 0; [z < y, z <= y, z >= y, z > y]"),
+      njs_str("false,true,true,false") },
+
+    { njs_str("var i = 2147483647, j = -2147483648;"
+              "[i + 1, j - 1, i + i, (i + 1) | 0, (j - 1) | 0, i * 2 >> 0]"),
+      njs_str("2147483648,-2147483649,4294967294,-2147483648,2147483647,-2") },
+
+    { njs_str("var i = 4294967295, j = 2 ** 53;"
+              "[i & 1, i >>> 0, j | 0, (j + 2) | 0, -i ^ 0, 1.9 << 1]"),
+      njs_str("1,4294967295,0,2,1,2") },
+
     /**/
 
     { njs_str("null < 0"),
@@ -5114,6 +5129,22 @@ static njs_unit_test_t  njs_test[] =
                  "var a = [1,2]; a[1.5] = 5; '' + (n in a) + (delete a[n])"),
       njs_str("truetrue") },
 
+    { njs_str("var a = [1,2,3], i = 1, z = -0, h = 0.5, n = NaN;"
+              "a[z] = 'z'; a[i + h] = 'h'; a[n] = 'n'; a[-1] = 'm';"
+              "[a[0], a[i], a[i + h], a[n], a[-1], a[3], a.length]"),
+      njs_str("z,2,h,n,m,,3") },
+
+    { njs_str("Array.prototype[1] = 'p'; var a = [0,,2], i = 1;"
+              "var r = a[i]; a[i] = 1; [r, a[i], a.hasOwnProperty(i)]"),
+      njs_str("p,1,true") },
+
+    { njs_str("var a = [1,2], i = 2; a[i] = 3; a[i + 2] = 5;"
+              "[a.length, a[i], a[i + 1], a[i + 2]]"),
+      njs_str("5,3,,5") },
+
+    { njs_str("var a = Object.freeze([1,2]), i = 0; a[i] = 3"),
+      njs_str("TypeError: Cannot assign to read-only property \"0\" of array") },
+
     { njs_str("var o = {},  v = o;"
               "v[{toString: () => { v = 'V'; return 'a';}}] = 1;"
               "[v, o.a]"),
@@ -5753,6 +5784,15 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("'/A/B/C/D/'.split('/').toSpliced(1,1).join('/')"),
       njs_str("/B/C/D/") },
 
+    { njs_str("('ab,'.repeat(40) + 'жж,').split(',').length"),
+      njs_str("42") },
+
+    { njs_str("var s = ('Привет, мир! ' + 'ж'.repeat(20)).repeat(50);"
+              "s.replaceAll('мир', 'njs').indexOf('мир') + ':'"
+              "+ s.replaceAll('мир', (m, p) => p).split('ж'.repeat(20))"
+              "   .slice(0, 3).join('|')"),
+      njs_str("-1:Привет, 8! |Привет, 41! |Привет, 74! ") },
+
     { njs_str("let r, arr = new Array(4);"
               "Object.defineProperty(arr, 0, { get: () => { throw 'Oops'; } });"
               "try { r = arr.toSpliced(0, 0); } catch (e) { }"
@@ -6034,6 +6074,27 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("[1,2,3,4,5].includes(NaN)"),
       njs_str("false") },
 
+    { njs_str("[1,NaN,3].indexOf(NaN)"),
+      njs_str("-1") },
+
+    { njs_str("[-0, 0].indexOf(0) + [0].indexOf(-0) + [-0].includes(0)"),
+      njs_str("1") },
+
+    { njs_str("[1,,3].indexOf(2) + [1,,3].includes(2)"),
+      njs_str("-1") },
+
+    { njs_str("Array.prototype[1] = 2;"
+              "var r = [1,,3].indexOf(2) + ':' + [1,,3].includes(2);"
+              "delete Array.prototype[1]; r"),
+      njs_str("1:true") },
+
+    { njs_str("var a = [1,2,3];"
+              "a.indexOf(3, {valueOf() {a.length = 1; return 0}})"),
+      njs_str("-1") },
+
+    { njs_str("[1,'3',3].indexOf(3) + [1,'3',{}].includes(3)"),
+      njs_str("2") },
+
     { njs_str("[].includes.bind(0)(0, 0)"),
       njs_str("false") },
 
@@ -6381,6 +6442,23 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("Object.getPrototypeOf(Uint8Array)()"),
       njs_str("TypeError: Abstract class TypedArray not directly constructable") },
 
+    { njs_str("var TypedArray = Object.getPrototypeOf(Float64Array);"
+              "[Object.getPrototypeOf(TypedArray) === Function.prototype,"
+              " Object.getPrototypeOf(TypedArray.prototype) === Object.prototype,"
+              " Object.getPrototypeOf(Buffer.prototype) === Uint8Array.prototype]"),
+      njs_str("true,true,true") },
+
+    { njs_str("[Object.getPrototypeOf(URIError) === Error,"
+              " Object.getPrototypeOf(URIError.prototype) === Error.prototype,"
+              " Object.getPrototypeOf(Error) === Function.prototype,"
+              " Object.getPrototypeOf(Error.prototype) === Object.prototype]"),
+      njs_str("true,true,true,true") },
+
+    { njs_str("[(1).constructor === Number, Object(1) instanceof Number,"
+              " Object.getPrototypeOf(Object.getPrototypeOf(async function(){}))"
+              " === Function.prototype]"),
+      njs_str("true,true,true") },
+
     { njs_str("var TypedArray = Object.getPrototypeOf(Uint8Array);"
               NJS_TYPED_ARRAY_LIST
               ".every(v=>Object.getPrototypeOf(v) === TypedArray)"),
@@ -7898,9 +7976,52 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("var a = ['1','2','3','4','5','6']; a.sort()"),
       njs_str("1,2,3,4,5,6") },
 
+    { njs_str("var s = '';"
+              "for (var i = 0; i < 10000; i++) { s += i + ','; }"
+              "[s.length, s.slice(0, 4), s.slice(-6)].join('|')"),
+      njs_str("48890|0,1,|,9999,") },
+
+    { njs_str("var s = '';"
+              "for (var i = 0; i < 1000; i++) {"
+              "    s = 'α'.repeat(70) + s + 'β';"
+              "}"
+              "s.length + s[70] + s.charAt(70000) + s.indexOf('β')"),
+      njs_str("71000αβ70000") },
+
+    { njs_str("var a = 'x'.repeat(300), b = a + 'y', c = a + 'z';"
+              "[b.length, b.slice(-1), c.slice(-1), b == a + 'y', b < c]"
+              ".join()"),
+      njs_str("301,y,z,true,true") },
+
+    { njs_str("var r = () => 'a'.repeat(200) + 'b'.repeat(200),"
+              "    l = () => 'a'.repeat(100) + r() + 'b'.repeat(100),"
+              "    a = [r(), l()];"
+              "[a.indexOf(r()), a.includes(l()), a.indexOf(r() + 'x'),"
+              " a.lastIndexOf('a'.repeat(300) + 'b'.repeat(300)),"
+              " a.some((x) => x === r()), JSON.stringify(r(), [r()]).length]"
+              ".join()"),
+      njs_str("0,true,-1,1,true,402") },
+
+    { njs_str("var k = 'k'.repeat(300), o = {}; o[k + 'k'.repeat(300)] = 1;"
+              "o['k'.repeat(600)] + Object.keys(o)[0].length"),
+      njs_str("601") },
+
     { njs_str("var a = [1,2,3,4,5,6]; a.sort()"),
       njs_str("1,2,3,4,5,6") },
 
+    { njs_str("[5,1,10,-3,-20,0,-0,2147483647,-2147483648,100,9,1].sort()"),
+      njs_str("-20,-2147483648,-3,0,0,1,1,10,100,2147483647,5,9") },
+
+    { njs_str("var a = [0,1,-0,-1]; a.sort(); a.map(v => 1 / v)"),
+      njs_str("-1,Infinity,-Infinity,1") },
+
+    { njs_str("[3,2.5,10,,1,undefined,'2'].sort()"),
+      njs_str("1,10,2,2.5,3,,") },
+
+    { njs_str("var a = [1,2,3]; a[1] = {toString() {a.length = 0; return 'x'}};"
+              "a.join() + ':' + a.length"),
+      njs_str("1,x,:0") },
+
     { njs_str("var a = {0:3,1:2,2:1}; Array.prototype.sort.call(a) === a"),
       njs_str("true") },
 
@@ -9260,6 +9381,17 @@ static njs_unit_test_t  njs_test[] =
                  "== JSON.stringify([].concat(Array(4).fill(0), Array(7).fill(4), Array(13).fill(11)))"),
       njs_str("true") },
 
+    { njs_str("var s = 'x'.repeat(100) + 'жabc' + 'x'.repeat(100) + 'abc';"
+              "[s.indexOf('abc'), s.indexOf('abc', 105), s.lastIndexOf('abc'),"
+              " s.lastIndexOf('abc', 200), s.includes('жabc', 101),"
+              " s.includes('жabc', 100)]"),
+      njs_str("101,204,204,101,false,true") },
+
+    { njs_str("var s = 'a'.repeat(20000), n = 'a'.repeat(300) + 'b';"
+              "[s.indexOf(n), (s + 'b').indexOf(n),"
+              " s.includes('b' + 'a'.repeat(300)), (s + n).lastIndexOf(n)]"),
+      njs_str("-1,19700,false,20000") },
+
     { njs_str("''.includes('')"),
       njs_str("true") },
 
@@ -9354,6 +9486,21 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("'\x00абвгдеёжз'.toUpperCase().length"),
       njs_str("10") },
 
+    { njs_str("var s = 'Content-Type: Text/HTML @[`{'.repeat(3);"
+              "[s.toLowerCase(), s.toUpperCase()]"),
+      njs_str("content-type: text/html @[`{content-type: text/html @[`{"
+              "content-type: text/html @[`{,"
+              "CONTENT-TYPE: TEXT/HTML @[`{CONTENT-TYPE: TEXT/HTML @[`{"
+              "CONTENT-TYPE: TEXT/HTML @[`{") },
+
+    { njs_str("('ABCDEFGHIJKLMNOPQRSTUVWXYZ' + 'АБВ' + 'QWERTY'.repeat(3))"
+              ".toLowerCase()"),
+      njs_str("abcdefghijklmnopqrstuvwxyzабвqwertyqwertyqwerty") },
+
+    { njs_str("('abcdefghijklmnopqrstuvwxyz' + 'αβγ' + 'qwerty'.repeat(3))"
+              ".toUpperCase()"),
+      njs_str("ABCDEFGHIJKLMNOPQRSTUVWXYZΑΒΓQWERTYQWERTYQWERTY") },
+
 #if (!NJS_HAVE_MEMORY_SANITIZER) /* very long tests under MSAN */
     { njs_str("var a = [], code;"
                  "for (code = 0; code <= 1114111; code++) {"
@@ -9401,6 +9548,19 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("'   абв  '.trimStart().trimEnd()"),
       njs_str("абв") },
 
+    { njs_str("var s = ' \\t\\n\\v\\f\\r'.repeat(5);"
+              "(s + 'a b' + s).trim().length"),
+      njs_str("3") },
+
+    { njs_str("var s = ' \\t\\n\\v\\f\\r'.repeat(5);"
+              "(s + '\\u3000' + s + 'абв' + s + '\\u00A0' + s)"
+              ".trim()"),
+      njs_str("абв") },
+
+    { njs_str("var s = '\\x00\\x08\\x0e\\x1f!'.repeat(5);"
+              "(s.trimStart() + s.trimEnd()).length"),
+      njs_str("50") },
+
     { njs_str("["
               " String.fromCodePoint(0x2028),"
               " String.fromCodePoint(0x20, 0x2028),"
@@ -13712,6 +13872,223 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("Object.prototype.__proto__.f()"),
       njs_str("TypeError: cannot get property \"f\" of null") },
 
+    /* Fused compare-and-jump and method frame instructions. */
+
+    { njs_str("var r = [];"
+              "[[1, 2], [2, 1], [1, 1], [NaN, 1], [1, NaN], ['a', 'b'],"
+              " ['10', 9], [null, 0], [undefined, 0]].forEach(v => {"
+              "    var a = v[0], b = v[1], s = '';"
+              "    if (a < b) s += 'l'; if (a > b) s += 'g';"
+              "    if (a <= b) s += 'L'; if (a >= b) s += 'G';"
+              "    if (!(a < b)) s += '1'; if (!(a > b)) s += '2';"
+              "    if (a === b) s += 'e'; if (a !== b) s += 'n';"
+              "    r.push(s + (a < b ? 'T' : 'F')) });"
+              "r"),
+      njs_str("lL2nT,gG1nF,LG12eF,12nF,12nF,lL2nT,gG1nF,LG12nF,12nF") },
+
+    { njs_str("var log = [];"
+              "var a = {valueOf() { log.push('a'); return 1 }};"
+              "var b = {valueOf() { log.push('b'); return 2 }};"
+              "if (a > b) {} if (a <= b) {} while (b < a) {}"
+              "log.join('')"),
+      njs_str("ababba") },
+
+    { njs_str("var s = Symbol(); if (s < 1) {}"),
+      njs_str("TypeError: Cannot convert a Symbol value to a number") },
+
+    { njs_str("var i = 0, j = 10, n = 0;"
+              "for (; i < j; i++) { n++ }"
+              "while (j >= 5) { j-- }"
+              "do { i-- } while (i !== 5);"
+              "[i, j, n]"),
+      njs_str("5,4,10") },
+
+    { njs_str("var o = {n: 0, inc(v) { return this.n += v || 1 }};"
+              "o.inc(); o.inc(2); o['inc'](); var f = o.inc; o.inc(o.inc())"),
+      njs_str("10") },
+
+    { njs_str("var o = {}; o.f()"),
+      njs_str("TypeError: undefined is not a function") },
+
+    { njs_str("var n = 0; var o = {get f() { n++; return () => n }};"
+              "o.f(); o.f() + o.f()"),
+      njs_str("5") },
+
+    { njs_str("var s = ''; function C(v) { this.v = v }"
+              "C.prototype.get = function () { return this.v };"
+              "var a = new C('a'), b = new C('b');"
+              "[a, b, a].forEach(o => { s += o.get() }); s"),
+      njs_str("aba") },
+
+    /* Object literal templates. */
+
+    { njs_str("var r = [];"
+              "for (var i = 0; i < 3; i++) { r.push({a:i, b:'x', a:i + 1}) }"
+              "r.map(o => Object.keys(o) + ':' + o.a + o.b).join()"),
+      njs_str("a,b:1x,a,b:2x,a,b:3x") },
+
+    { njs_str("var k = 'k';"
+              "function f(i) { return {a:i, [k]:1, b:2, get c() {return 3}, d:4} }"
+              "var o = f(1); f(2); o = f(3);"
+              "Object.keys(o).join() + ':' + o.a + o.c"),
+      njs_str("a,k,b,c,d:33") },
+
+    { njs_str("function f() { return {a:1, b:2, c:3} }"
+              "var o = f(); delete o.b; o.d = 4; o.e = 5; var p = f();"
+              "JSON.stringify([o, p])"),
+      njs_str("[{\"a\":1,\"c\":3,\"d\":4,\"e\":5},{\"a\":1,\"b\":2,\"c\":3}]") },
+
+    { njs_str("function f() { return {b:1, 2:2, '1':1, a:0} }"
+              "f(); Object.keys(f())"),
+      njs_str("1,2,b,a") },
+
+    { njs_str("function f(p) { return {__proto__:p, a:1} }"
+              "var o = f({b:2}); f(null); [o.a, o.b, Object.keys(o)]"),
+      njs_str("1,2,a") },
+
+    { njs_str("function f(v) { return {a:v(), b:2} }"
+              "f(() => 1); try { f(() => {throw 1}) } catch (e) {};"
+              "JSON.stringify(f(() => 3))"),
+      njs_str("{\"a\":3,\"b\":2}") },
+
+    /* Compact bytecode operands. */
+
+    { njs_str("var s = '';"
+              "for (var i = 0; i < 4; i++) {"
+              "    try { if (i == 1) continue; if (i == 3) break; s += i }"
+              "    finally { s += '.' } }"
+              "s"),
+      njs_str("0..2..") },
+
+    { njs_str("var a = [];"
+              "for (var i = 0; i < 3; i++) {"
+              "    try { try { throw i } finally { a.push('f' + i) } }"
+              "    catch (e) { a.push(e) } }"
+              "a.join()"),
+      njs_str("f0,0,f1,1,f2,2") },
+
+    { njs_str("var s = 'var v = 0;';"
+              "for (var i = 0; i < 2000; i++) { s += 'v += ' + i + ';' }"
+              "new Function(s + 'return v')()"),
+      njs_str("1999000") },
+
+    /* Constant folding. */
+
+    { njs_str("[1024 * 1024, 7 % -3, -7 % 3, 2 ** 10, (-1) ** Infinity,"
+              " 1 << 31, -1 >>> 0, -8 >> 1, ~5, 1 / (0 * -1)]"),
+      njs_str("1048576,1,-1,1024,NaN,-2147483648,4294967295,-4,-6,-Infinity") },
+
+    { njs_str("['prefix' + 'suffix', typeof 'a' === 'string', typeof null,"
+              " 'ab' === 'a' + 'b', null == null, 1 == '1', 0/0 === 0/0,"
+              " !'', null ?? 'd', 0 ?? 'd', '' || 'e', 1 && 'f']"),
+      njs_str("prefixsuffix,true,object,true,true,true,false,true,d,0,e,f") },
+
+    { njs_str("var o = {}; o[1 + 1] = 'two'; [o['2'], [10, 20, 30][0 + 2]]"),
+      njs_str("two,30") },
+
+    { njs_str("var a = true ? [1, 2] : [], o = false ? {} : {a: 3};"
+              "[a.length, o.a, (true && {q: 4})?.q]"),
+      njs_str("2,3,4") },
+
+    { njs_str("const K = 2, S = 'x';"
+              "function f() { return K }"
+              "[K * 3, S + 'y', typeof K, K === 2 ? 'y' : 'n', f()]"),
+      njs_str("6,xy,number,y,2") },
+
+    { njs_str("var s = '';"
+              "if (false) { s += 'a' } else { s += 'b' }"
+              "if (true) s += 'c';"
+              "if (false) s += 'd';"
+              "if (true) { s += 'e' } s"),
+      njs_str("bce") },
+
+    { njs_str("if (false) { function f() {} } typeof f"),
+      njs_str("undefined") },
+
+    { njs_str("L: if (true) { break L; }"),
+      njs_str("undefined") },
+
+    { njs_str("const Y = Y + 1"),
+      njs_str("ReferenceError: cannot access variable before initialization") },
+
+    { njs_str("f(); const X = 1; function f() { return X }"),
+      njs_str("ReferenceError: cannot access variable before initialization") },
+
+    { njs_str("const C = 1; C = 2"),
+      njs_str("TypeError: assignment to constant variable") },
+
+    /* Call argument temporaries reuse. */
+
+    { njs_str("function f(a, b, c) { return [a, b, c].join() }"
+              "f(f(1, 2, 3), f(4 + 1, f(6, 7, 8), 9), f(10, 11, 12))"),
+      njs_str("1,2,3,5,6,7,8,9,10,11,12") },
+
+    { njs_str("function f(a, b) { return a + b }"
+              "var r = 0;"
+              "for (var i = 0; i < 3; i++) { r += f(i * 2, f(i, 1)) + f(1, 1) }"
+              "r"),
+      njs_str("18") },
+
+    { njs_str("var o = {m(a, b) { return a * 10 + b }};"
+              "o.m(o.m(1, 2), o.m(3, 4)) + o.m(5, 6)"),
+      njs_str("210") },
+
+    { njs_str("var x = 1; function g() { x = 2; return 3 }"
+              "function f(a, b, c) { return [a, b, c].join() }"
+              "f(x, g(), x + 1)"),
+      njs_str("1,3,3") },
+
+    { njs_str("function t(s, a, b) { return s.join('|') + (a + b) }"
+              "t`a${1 + 1}b${t`c${3}d${4}`}e`"),
+      njs_str("a|b|e2c|d|7") },
+
+    /* Property access inline caches. */
+
+    { njs_str("function f(o) { return o.a }"
+              "[{a:1}, {b:0, a:2}, {c:0, b:0, a:3}, {a:4}, {d:0, a:5},"
+              " {e:0, a:6}, Object.create({a:7})].map(f)"),
+      njs_str("1,2,3,4,5,6,7") },
+
+    { njs_str("function f(o) { return o.a }"
+              "var p = {a:1}; var o = Object.create(p); var r = [f(o), f(o)];"
+              "o.a = 2; r.push(f(o)); delete o.a; r.push(f(o));"
+              "p.a = 3; r.push(f(o)); delete p.a; r.push(f(o)); r"),
+      njs_str("1,1,2,1,3,") },
+
+    { njs_str("function f(o) { return o.a }"
+              "var o = {a:1, b:2}; var r = [f(o), f(o)];"
+              "delete o.a; r.push(f(o)); o.a = 3; r.push(f(o));"
+              "Object.defineProperty(o, 'a', {get() {return 4}});"
+              "r.push(f(o)); r"),
+      njs_str("1,1,,3,4") },
+
+    { njs_str("function f(o, v) { o.a = v }"
+              "var o = {a:1}; f(o, 2); f(o, 3);"
+              "Object.freeze(o); try { f(o, 4) } catch (e) {}; o.a"),
+      njs_str("3") },
+
+    { njs_str("function f(o, v) { o.a = v }"
+              "var o = {a:1}; f(o, 2); f(o, 3);"
+              "Object.defineProperty(o, 'a', {writable:false}); f(o, 4)"),
+      njs_str("TypeError: Cannot assign to read-only property \"a\" of object") },
+
+    { njs_str("function f(o, v) { o.a = v }"
+              "var p = {a:1}; var o = Object.create(p);"
+              "f(o, 2); f(o, 3); [o.a, p.a]"),
+      njs_str("3,1") },
+
+    { njs_str("var s = 0; function f(o, v) { o.a = v }"
+              "var o = {set a(v) { s += v }}; f(o, 1); f(o, 2); f(o, 3); s"),
+      njs_str("6") },
+
+    { njs_str("function f(v) { return v.length }"
+              "[f('abc'), f([1,2]), f('abcd'), f({length:5}), f(f)]"),
+      njs_str("3,2,4,5,1") },
+
+    { njs_str("function f(a) { a.length = 1; return a }"
+              "var a = [1,2,3]; f(a); f([1,2]).length + a.length"),
+      njs_str("2") },
+
     { njs_str("var obj = Object.create(null); obj.one = 1;"
                  "var res = [];"
                  "for (var val in obj) res.push(val); res"),
@@ -19112,6 +19489,12 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("JSON.parse('[\"' + 'α'.repeat(33) + '\"]')[0][32]"),
       njs_str("α") },
 
+    { njs_str("var s = JSON.parse('\"' + 'x'.repeat(20) + '\\\\n'"
+              "                   + 'y'.repeat(20) + '\\\\u03B1\\\\\"'"
+              "                   + 'z'.repeat(17) + '\"');"
+              "[s.length, s[20] == '\\n', s.slice(40)]"),
+      njs_str("60,true,yα\"zzzzzzzzzzzzzzzzz") },
+
     { njs_str("JSON.parse('\"\\\\u03B1\"')"),
       njs_str("α") },
 
@@ -19133,6 +19516,17 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("JSON.parse('{   \"a\" :  \"b\"   }').a"),
       njs_str("b") },
 
+    { njs_str("JSON.parse('{' + ' \\n\\t\\r'.repeat(10) + '\"a\"'"
+              "           + ' '.repeat(40) + ':' + '\\n'.repeat(20)"
+              "           + '[1,' + ' '.repeat(33) + '2]}').a"),
+      njs_str("1,2") },
+
+    { njs_str("var o = JSON.parse('{\"length\":1,\"1\":2,\"01\":3,\"-1\":4,"
+              "                     \"é\":5,\"\":6,\"a\\\\u0062\":7}');"
+              "[o.length, o[1], o['01'], o[-1], o['é'], o[''], o.ab,"
+              " Object.keys(o)]"),
+      njs_str("1,2,3,4,5,6,7,1,length,01,-1,é,,ab") },
+
     { njs_str("JSON.parse('{\"a\":{\"b\":1}}').a.b"),
       njs_str("1") },
 
@@ -19316,6 +19710,15 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("JSON.parse('\"\\\\q\"')"),
       njs_str("SyntaxError: Unknown escape char at position 2") },
 
+    { njs_str("JSON.parse('\"' + 'a'.repeat(20) + '\\x01\"')"),
+      njs_str("SyntaxError: Forbidden source char at position 21") },
+
+    { njs_str("JSON.parse('\"' + 'a'.repeat(40))"),
+      njs_str("SyntaxError: Unexpected end of input at position 41") },
+
+    { njs_str("JSON.parse('\"' + 'a'.repeat(20) + '\\\\\"' + 'b'.repeat(20))"),
+      njs_str("SyntaxError: Unexpected end of input at position 43") },
+
     { njs_str("JSON.parse('\"\\\\uDC01\"')"),
       njs_str("�") },
 
@@ -20498,6 +20901,30 @@ static njs_unit_test_t  njs_test[] =
               "]"),
       njs_str("2,2,6,10,4,6,8,12,16,19") },
 
+    { njs_str("var arr = [];"
+              "for (var i = 0; i < 3; i++) {"
+              "    let x = i, y = x * 2;"
+              "    if (i > 0) { arr.push(() => x + y); }"
+              "}"
+              "arr.map(f => f())"),
+      njs_str("3,6") },
+
+    { njs_str("var r = [];"
+              "for (var i = 0; i < 3; i++) { let x; r.push(x); x = i; }"
+              "r.length + ':' + r"),
+      njs_str("3:,,") },
+
+    { njs_str("function f() {"
+              "    var r = [];"
+              "    for (var i = 0; i < 3; i++) {"
+              "        let x = i;"
+              "        r.push(function () { return () => x });"
+              "    }"
+              "    return r.map(g => g()());"
+              "}"
+              "f()"),
+      njs_str("0,1,2") },
+
     { njs_str("for (let i = 0; i < 1; i++) {"
               "    let i = i + 2;"
               "}"),
@@ -21975,6 +22402,12 @@ static njs_unit_test_t  njs_shared_test[] =
               "    at push (native)\n"
               "    at call (native)\n"
               "    at main (:1)\n") },
+
+    { njs_str("rope.length + rope.slice(298, 302) + rope.indexOf('b')"),
+      njs_str("600aabb300") },
+
+    { njs_str("var s = rope + 'c'.repeat(300); s.slice(598, 602) + s.length"),
+      njs_str("bbcc900") },
 };
 
 
@@ -22504,7 +22937,7 @@ static njs_unit_test_t  njs_backtraces_test[] =
 
     { njs_str("function log(v) {}\nlog({}\n.a\n.a)"),
       njs_str("TypeError: cannot get property \"a\" of undefined\n"
-              "    at main (:2)\n") },
+              "    at main (:4)\n") },
 
     { njs_str("\nfor (var i = 0;\n i < a;\n i++) { }\n"),
       njs_str("ReferenceError: \"a\" is not defined\n"
@@ -22533,6 +22966,7 @@ typedef struct {
     njs_bool_t  handler;
     njs_bool_t  async;
     njs_bool_t  preload;
+    njs_bool_t  gc;
     unsigned    seed;
 } njs_opts_t;
 
@@ -22713,6 +23147,29 @@ njs_unit_test_module_loader(njs_vm_t *vm, njs_external_ptr_t external,
 }
 
 
+static njs_int_t
+njs_process_gc(njs_external_state_t *state, njs_opts_t *opts)
+{
+    njs_int_t  ret;
+    njs_str_t  root;
+
+    if (!opts->gc) {
+        return NJS_OK;
+    }
+
+    root.start = (u_char *) state;
+    root.length = sizeof(njs_external_state_t);
+
+    ret = njs_vm_gc(state->vm, &root, 1);
+    if (ret != NJS_OK) {
+        njs_stderror("njs_vm_gc() failed\n");
+        return NJS_ERROR;
+    }
+
+    return NJS_OK;
+}
+
+
 static njs_int_t
 njs_process_test(njs_external_state_t *state, njs_opts_t *opts,
     njs_unit_test_t *expected)
@@ -22736,6 +23193,10 @@ njs_process_test(njs_external_state_t *state, njs_opts_t *opts,
             goto done;
         }
 
+        if (njs_process_gc(state, opts) != NJS_OK) {
+            return NJS_ERROR;
+        }
+
         if (opts->async) {
             return NJS_OK;
         }
@@ -22784,6 +23245,10 @@ njs_process_test(njs_external_state_t *state, njs_opts_t *opts,
                 return NJS_ERROR;
             }
 
+            if (njs_process_gc(state, opts) != NJS_OK) {
+                return NJS_ERROR;
+            }
+
             if (ret == NJS_OK) {
                 break;
             }
@@ -22798,6 +23263,10 @@ done:
 
     state->state = sw_done;
 
+    if (njs_process_gc(state, opts) != NJS_OK) {
+        return NJS_ERROR;
+    }
+
     if (njs_external_retval(state, ret, &s) != NJS_OK) {
         njs_stderror("njs_external_retval() failed\n");
         return NJS_ERROR;
@@ -22857,6 +23326,7 @@ njs_unit_test(njs_unit_test_t tests[], size_t num, njs_str_t *name,
                 "return v;"
             "}"
         ");"
+        "globalThis.rope = 'a'.repeat(300) + 'b'.repeat(300);"
     );
 
     vm = NULL;
@@ -22878,6 +23348,7 @@ njs_unit_test(njs_unit_test_t tests[], size_t num, njs_str_t *name,
         options.module = opts->module;
         options.unsafe = opts->unsafe;
         options.backtrace = opts->backtrace;
+        options.arena = !opts->gc;
         options.max_stack_size = 64 * 1024;
         options.addons = opts->externals ? njs_unit_test_addon_external_modules
                                          : njs_unit_test_addon_modules;
@@ -23494,96 +23965,1735 @@ done:
 }
 
 
-static njs_int_t
-njs_vm_object_alloc_test(njs_vm_t *vm, njs_opts_t *opts, njs_stat_t *stat)
-{
-    njs_int_t           ret;
-    njs_opaque_value_t  args[2], obj, num_key, bool_key;
-
-    njs_value_number_set(njs_value_arg(&args[0]), 1);
-    njs_value_boolean_set(njs_value_arg(&args[0]), 0);
+typedef struct {
+    njs_str_t   source;
+    njs_str_t   bytecode;
+} njs_unit_test_bytecode_t;
 
-    (void) njs_vm_value_string_create(vm, njs_value_arg(&num_key),
-                                     (u_char *) "num", 3);
-    (void) njs_vm_value_string_create(vm, njs_value_arg(&bool_key),
-                                     (u_char *) "bool", 4);
 
-    ret = njs_vm_object_alloc(vm, njs_value_arg(&obj), NULL);
-    if (ret != NJS_OK) {
-        return NJS_ERROR;
-    }
+static njs_mod_t *
+njs_unit_test_bytecode_loader(njs_vm_t *vm, njs_external_ptr_t external,
+    njs_str_t *name)
+{
+    njs_int_t                 ret;
+    njs_mod_t                 *module;
+    njs_unit_test_bytecode_t  *bc;
 
-    ret = njs_vm_object_alloc(vm, njs_value_arg(&obj), njs_value_arg(&num_key),
-                              NULL);
-    if (ret == NJS_OK) {
-        return NJS_ERROR;
-    }
+    bc = external;
 
-    ret = njs_vm_object_alloc(vm, njs_value_arg(&obj), njs_value_arg(&num_key),
-                              njs_value_arg(&args[0]), NULL);
+    ret = njs_vm_module_from_bytecode(vm, name, &bc->source, &bc->bytecode,
+                                      &module);
     if (ret != NJS_OK) {
-        return NJS_ERROR;
-    }
+        if (ret == NJS_DECLINED) {
+            njs_vm_error(vm, "bytecode of \"%V\" is declined", name);
+        }
 
-    ret = njs_vm_object_alloc(vm, njs_value_arg(&obj), njs_value_arg(&num_key),
-                              njs_value_arg(&args[0]), njs_value_arg(&bool_key),
-                              njs_value_arg(&args[1]), NULL);
-    if (ret != NJS_OK) {
-        stat->failed++;
-        return NJS_OK;
+        return NULL;
     }
 
-    stat->passed++;
-
-    return NJS_OK;
+    return module;
 }
 
 
 static njs_int_t
-njs_chb_test(njs_vm_t *vm, njs_opts_t *opts, njs_stat_t *stat)
+njs_vm_bytecode_test(njs_unit_test_t unused[], size_t num, njs_str_t *name,
+    njs_opts_t *opts, njs_stat_t *stat)
 {
-    u_char     *p;
-    njs_int_t  ret, i;
-    njs_chb_t  chain;
-    njs_str_t  string, arg;
+    u_char                    *start;
+    njs_vm_t                  *vm, *cvm;
+    njs_int_t                 ret;
+    njs_str_t                 s, *script, source;
+    njs_mod_t                 *module;
+    njs_uint_t                i;
+    njs_bool_t                success;
+    njs_stat_t                prev;
+    njs_vm_opt_t              options;
+    njs_opaque_value_t        retval;
+    njs_unit_test_bytecode_t  bc;
+
+    static const njs_str_t  mname = njs_str("m");
 
-    static const njs_str_t  expected = njs_str("arg: \"XYZ\" -5");
+    static struct {
+        njs_str_t   module;
+        njs_str_t   script;
+        njs_str_t   ret;
+    } tests[] = {
+        {
+          .module = njs_str("var re = /a(b+)c/g;"
+                            "export default function (s) {"
+                            "    return s.replace(re, '[$1]') }"),
+          .script = njs_str("import f from 'm'; f('abbc abc')"),
+          .ret = njs_str("[bb] [b]"),
+        },
 
-    NJS_CHB_MP_INIT(&chain, njs_vm_memory_pool(vm));
+        {
+          .module = njs_str("function mk(k) { var n = 0;"
+                            "    return function (x) { n++; return x * k + n }}"
+                            "export default mk(3)"),
+          .script = njs_str("import f from 'm'; [f(1), f(2)].join()"),
+          .ret = njs_str("4,8"),
+        },
 
-    p = njs_chb_reserve(&chain, 513);
-    if (p == NULL) {
-        ret = NJS_ERROR;
-        njs_printf("njs_chb_reserve() failed\n");
-        goto done;
-    }
+        {
+          .module = njs_str("export default function () {"
+                            "    return {a: 1, 'b c': 's', 7: null} }"),
+          .script = njs_str("import f from 'm'; JSON.stringify(f())"),
+          .ret = njs_str("{\"7\":null,\"a\":1,\"b c\":\"s\"}"),
+        },
 
-    njs_memset(p, 'Z', 256);
+        {
+          .module = njs_str("export default {s: 'h\\u00e9llo' + 1.5,"
+                            "                n: -0x10, b: undefined === void 0}"),
+          .script = njs_str("import m from 'm'; [m.s, m.n, m.b].join()"),
+          .ret = njs_str("héllo1.5,-16,true"),
+        },
 
-    njs_chb_written(&chain, 256);
+        {
+          .module = njs_str("export default function () {"
+                            "    try { nope } catch (e) { return e.message }}"),
+          .script = njs_str("import f from 'm'; f()"),
+          .ret = njs_str("\"nope\" is not defined"),
+        },
 
-    for (i = 0; i < 768; i++) {
-        njs_chb_append(&chain, "X", 1);
-    }
+        {
+          .module = njs_str("export default function (o) { var r = [];"
+                            "    for (var k in o) { r.push(`${k}=${o[k]}`) }"
+                            "    return r.join('&') }"),
+          .script = njs_str("import f from 'm'; f({x: 1, y: 'z'})"),
+          .ret = njs_str("x=1&y=z"),
+        },
+    };
 
-    ret = njs_chb_join(&chain, &string);
-    if (ret != NJS_OK) {
-        njs_printf("njs_chb_join() failed\n");
-        goto done;
-    }
+    vm = NULL;
+    cvm = NULL;
 
-    if (string.length != 1024 || njs_chb_size(&chain) != 1024) {
-        ret = NJS_ERROR;
-        njs_printf("njs_chb_join() corrupts "
-                   "string.length:%z njs_chb_size(&chain):%z != 1024\n",
-                   string.length, njs_chb_size(&chain));
-        goto done;
-    }
+    prev = *stat;
 
-    for (i = 0; i < 1024; i++) {
-        if (string.start[i] != ((i < 256) ? 'Z' : 'X')) {
-            ret = NJS_ERROR;
-            njs_printf("njs_chb_join() corrupts string[%i]:%c != '%c'\n",
+    ret = NJS_ERROR;
+
+    for (i = 0; i < njs_nitems(tests); i++) {
+
+        njs_vm_opt_init(&options);
+        options.init = 1;
+
+        cvm = njs_vm_create(&options);
+        if (cvm == NULL) {
+            njs_printf("njs_vm_create() failed\n");
+            goto done;
+        }
+
+        bc.source = tests[i].module;
+        start = bc.source.start;
+
+        module = njs_vm_compile_module(cvm, (njs_str_t *) &mname, &start,
+                                       start + bc.source.length);
+        if (module == NULL) {
+            njs_printf("njs_vm_compile_module() failed\n");
+            vm = cvm;
+            cvm = NULL;
+            goto done;
+        }
+
+        ret = njs_vm_module_bytecode(cvm, module, &bc.source, &bc.bytecode);
+        if (ret != NJS_OK) {
+            njs_printf("njs_vm_module_bytecode() failed\n");
+            vm = cvm;
+            cvm = NULL;
+            goto done;
+        }
+
+        vm = njs_vm_create(&options);
+        if (vm == NULL) {
+            njs_printf("njs_vm_create() failed\n");
+            goto done;
+        }
+
+        /* A cache of another source is declined. */
+
+        source = bc.source;
+        source.length--;
+
+        ret = njs_vm_module_from_bytecode(vm, (njs_str_t *) &mname, &source,
+                                          &bc.bytecode, &module);
+        if (ret != NJS_DECLINED) {
+            njs_printf("njs_vm_bytecode_test(\"%V\")\n"
+                       "stale bytecode is not declined\n", &bc.source);
+            stat->failed++;
+        }
+
+        njs_vm_set_module_loader(vm, njs_unit_test_bytecode_loader, &bc);
+
+        script = &tests[i].script;
+        start = script->start;
+
+        ret = njs_vm_compile(vm, &start, start + script->length);
+        if (ret != NJS_OK) {
+            njs_printf("njs_vm_compile() failed\n");
+            goto done;
+        }
+
+        ret = njs_vm_start(vm, njs_value_arg(&retval));
+        if (ret != NJS_OK) {
+            njs_printf("njs_vm_start() failed\n");
+            goto done;
+        }
+
+        if (njs_vm_value_string(vm, &s, njs_value_arg(&retval)) != NJS_OK) {
+            njs_printf("njs_vm_value_string() failed\n");
+            goto done;
+        }
+
+        success = njs_strstr_eq(&tests[i].ret, &s);
+
+        if (!success) {
+            njs_printf("njs_vm_bytecode_test(\"%V\")\n"
+                       "expected: \"%V\"\n     got: \"%V\"\n", &bc.source,
+                       &tests[i].ret, &s);
+
+            stat->failed++;
+
+        } else {
+            stat->passed++;
+        }
+
+        njs_vm_destroy(vm);
+        vm = NULL;
+
+        njs_vm_destroy(cvm);
+        cvm = NULL;
+    }
+
+    ret = NJS_OK;
+
+done:
+
+    if (ret != NJS_OK && vm != NULL) {
+        if (njs_vm_exception_string(vm, &s) != NJS_OK) {
+            njs_printf("njs_vm_exception_string() failed\n");
+
+        } else {
+            njs_printf("%V\n", &s);
+        }
+    }
+
+    njs_unit_test_report(name, &prev, stat);
+
+    if (vm != NULL) {
+        njs_vm_destroy(vm);
+    }
+
+    if (cvm != NULL) {
+        njs_vm_destroy(cvm);
+    }
+
+    return ret;
+}
+
+
+static njs_int_t
+njs_vm_globals_cache_test(njs_unit_test_t unused[], size_t num, njs_str_t *name,
+    njs_opts_t *opts, njs_stat_t *stat)
+{
+    u_char              *start;
+    njs_vm_t            *vm, *svm;
+    njs_int_t           ret;
+    njs_str_t           s, cache, *script;
+    njs_uint_t          i;
+    njs_bool_t          success;
+    njs_stat_t          prev;
+    njs_vm_opt_t        options;
+    njs_opaque_value_t  retval;
+
+    static const njs_str_t  heap = njs_str(
+        "globalThis.table = {a: [1, 'x', null, {b: true}], n: -0.5};"
+        "table.self = table;"
+        "globalThis.pair = [table.a, table.a];"
+        "Object.defineProperty(globalThis, 'hidden', {value: 42});"
+        "globalThis.frozen = Object.freeze({q: Object.freeze([1, 2, 3])});"
+        "globalThis.bare = Object.setPrototypeOf({z: 'αβγ'}, null);");
+
+    static struct {
+        njs_str_t   script;
+        njs_str_t   ret;
+    } tests[] = {
+        {
+          .script = njs_str("table.self === table && pair[0] === pair[1]"
+                            "&& pair[0] === table.a"),
+          .ret = njs_str("true"),
+        },
+
+        {
+          .script = njs_str("JSON.stringify([table.a, table.n])"),
+          .ret = njs_str("[[1,\"x\",null,{\"b\":true}],-0.5]"),
+        },
+
+        {
+          .script = njs_str("[hidden, Object.keys(globalThis).includes('hidden'),"
+                            " Object.getOwnPropertyDescriptor(globalThis,"
+                            "                                 'hidden').writable]"
+                            ".join()"),
+          .ret = njs_str("42,false,false"),
+        },
+
+        {
+          .script = njs_str("[Object.isFrozen(frozen), Object.isFrozen(frozen.q),"
+                            " frozen.q.length, frozen.q[2]].join()"),
+          .ret = njs_str("true,true,3,3"),
+        },
+
+        {
+          .script = njs_str("Object.getPrototypeOf(bare) === null && bare.z"),
+          .ret = njs_str("αβγ"),
+        },
+
+        {
+          .script = njs_str("table.a.push(5); table.a.length"),
+          .ret = njs_str("5"),
+        },
+    };
+
+    static const njs_str_t  function = njs_str("globalThis.f = {g() {}}");
+    static const njs_str_t  function_error =
+                      njs_str("TypeError: cannot cache a function value");
+
+    vm = NULL;
+    svm = NULL;
+
+    prev = *stat;
+
+    ret = NJS_ERROR;
+
+    njs_vm_opt_init(&options);
+    options.init = 1;
+
+    svm = njs_vm_create(&options);
+    if (svm == NULL) {
+        njs_printf("njs_vm_create() failed\n");
+        goto done;
+    }
+
+    start = heap.start;
+
+    ret = njs_vm_compile(svm, &start, start + heap.length);
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_compile() failed\n");
+        goto done;
+    }
+
+    ret = njs_vm_start(svm, njs_value_arg(&retval));
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_start() failed\n");
+        goto done;
+    }
+
+    ret = njs_vm_globals_cache(svm, &cache);
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_globals_cache() failed\n");
+        goto done;
+    }
+
+    for (i = 0; i < njs_nitems(tests); i++) {
+
+        vm = njs_vm_create(&options);
+        if (vm == NULL) {
+            njs_printf("njs_vm_create() failed\n");
+            goto done;
+        }
+
+        ret = njs_vm_globals_cache_restore(vm, &cache);
+        if (ret != NJS_OK) {
+            njs_printf("njs_vm_globals_cache_restore() failed\n");
+            goto done;
+        }
+
+        script = &tests[i].script;
+        start = script->start;
+
+        ret = njs_vm_compile(vm, &start, start + script->length);
+        if (ret != NJS_OK) {
+            njs_printf("njs_vm_compile() failed\n");
+            goto done;
+        }
+
+        ret = njs_vm_start(vm, njs_value_arg(&retval));
+        if (ret != NJS_OK) {
+            njs_printf("njs_vm_start() failed\n");
+            goto done;
+        }
+
+        if (njs_vm_value_string(vm, &s, njs_value_arg(&retval)) != NJS_OK) {
+            njs_printf("njs_vm_value_string() failed\n");
+            goto done;
+        }
+
+        success = njs_strstr_eq(&tests[i].ret, &s);
+
+        if (!success) {
+            njs_printf("njs_vm_globals_cache_test(\"%V\")\n"
+                       "expected: \"%V\"\n     got: \"%V\"\n", script,
+                       &tests[i].ret, &s);
+
+            stat->failed++;
+
+        } else {
+            stat->passed++;
+        }
+
+        njs_vm_destroy(vm);
+        vm = NULL;
+    }
+
+    /* A damaged cache is declined. */
+
+    cache.start[cache.length - 1] ^= 1;
+
+    vm = njs_vm_create(&options);
+    if (vm == NULL) {
+        njs_printf("njs_vm_create() failed\n");
+        goto done;
+    }
+
+    if (njs_vm_globals_cache_restore(vm, &cache) != NJS_DECLINED) {
+        njs_printf("njs_vm_globals_cache_test(): damaged cache is restored\n");
+        stat->failed++;
+
+    } else {
+        stat->passed++;
+    }
+
+    /* Functions are not stored. */
+
+    start = function.start;
+
+    ret = njs_vm_compile(vm, &start, start + function.length);
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_compile() failed\n");
+        goto done;
+    }
+
+    ret = njs_vm_start(vm, njs_value_arg(&retval));
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_start() failed\n");
+        goto done;
+    }
+
+    ret = njs_vm_globals_cache(vm, &cache);
+
+    if (ret != NJS_ERROR || njs_vm_exception_string(vm, &s) != NJS_OK
+        || !njs_strstr_eq(&function_error, &s))
+    {
+        njs_printf("njs_vm_globals_cache_test(\"%V\")\n"
+                   "expected: \"%V\"\n", &function, &function_error);
+        stat->failed++;
+
+    } else {
+        stat->passed++;
+    }
+
+    ret = NJS_OK;
+
+done:
+
+    if (ret != NJS_OK) {
+        if (njs_vm_exception_string(vm != NULL ? vm : svm, &s) != NJS_OK) {
+            njs_printf("njs_vm_exception_string() failed\n");
+
+        } else {
+            njs_printf("%V\n", &s);
+        }
+    }
+
+    njs_unit_test_report(name, &prev, stat);
+
+    if (vm != NULL) {
+        njs_vm_destroy(vm);
+    }
+
+    if (svm != NULL) {
+        njs_vm_destroy(svm);
+    }
+
+    return ret;
+}
+
+
+static njs_int_t
+njs_vm_profile_test_tick(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
+    njs_index_t unused, njs_value_t *retval)
+{
+    njs_profile_tick();
+
+    njs_value_undefined_set(retval);
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_vm_profile_test(njs_unit_test_t unused[], size_t num, njs_str_t *name,
+    njs_opts_t *opts, njs_stat_t *stat)
+{
+    u_char              *start;
+    njs_vm_t            *vm;
+    njs_int_t           ret;
+    njs_str_t           s, out;
+    njs_stat_t          prev;
+    njs_vm_opt_t        options;
+    njs_profile_t       *profile;
+    njs_function_t      *tick;
+    njs_opaque_value_t  retval, value;
+
+    static const njs_str_t  tick_name = njs_str("tick");
+
+    /* A sample is taken at the loop following each tick() call. */
+
+    static const njs_str_t  script = njs_str(
+        "function leaf() { tick(); for (var i = 0; i < 2; i++) {} }\n"
+        "function mid() { leaf(); [1].forEach(leaf) }\n"
+        "mid(); mid();");
+
+    static const njs_str_t  folded = njs_str(
+        "main (profile.js:3);mid (profile.js:2);leaf (profile.js:1) 2\n"
+        "main (profile.js:3);mid (profile.js:2);forEach (native);"
+        "leaf (profile.js:1) 2\n");
+
+    /* The samples and CPU time values of a sample. */
+
+    static const njs_str_t  sample_type = njs_str("\x0a\x04\x08\x01\x10\x02"
+                                                  "\x0a\x04\x08\x03\x10\x04");
+
+    vm = NULL;
+
+    prev = *stat;
+
+    ret = NJS_ERROR;
+
+    profile = njs_profile_create(10000);
+    if (profile == NULL) {
+        njs_printf("njs_profile_create() failed\n");
+        goto done;
+    }
+
+    njs_vm_opt_init(&options);
+    options.init = 1;
+    options.backtrace = 1;
+    options.file = njs_str_value("profile.js");
+
+    vm = njs_vm_create(&options);
+    if (vm == NULL) {
+        njs_printf("njs_vm_create() failed\n");
+        goto done;
+    }
+
+    njs_vm_profile(vm, profile);
+
+    tick = njs_vm_function_alloc(vm, njs_vm_profile_test_tick, 1, 0);
+    if (tick == NULL) {
+        njs_printf("njs_vm_function_alloc() failed\n");
+        goto done;
+    }
+
+    njs_value_function_set(njs_value_arg(&value), tick);
+
+    ret = njs_vm_bind(vm, &tick_name, njs_value_arg(&value), 1);
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_bind() failed\n");
+        goto done;
+    }
+
+    start = script.start;
+
+    ret = njs_vm_compile(vm, &start, start + script.length);
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_compile() failed\n");
+        goto done;
+    }
+
+    /* A tick which comes before the code runs is dropped. */
+
+    njs_profile_tick();
+
+    ret = njs_vm_start(vm, njs_value_arg(&retval));
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_start() failed\n");
+        goto done;
+    }
+
+    ret = njs_profile_dump(profile, NJS_PROFILE_FOLDED, &out);
+    if (ret != NJS_OK) {
+        njs_printf("njs_profile_dump() failed\n");
+        goto done;
+    }
+
+    if (njs_profile_samples(profile) != 4 || !njs_strstr_eq(&folded, &out)) {
+        njs_printf("njs_vm_profile_test(\"%V\")\n"
+                   "expected: \"%V\"\n     got: \"%V\"\n", &script,
+                   &folded, &out);
+        stat->failed++;
+
+    } else {
+        stat->passed++;
+    }
+
+    ret = njs_profile_dump(profile, NJS_PROFILE_PPROF, &out);
+    if (ret != NJS_OK) {
+        njs_printf("njs_profile_dump() failed\n");
+        goto done;
+    }
+
+    if (out.length < sample_type.length
+        || memcmp(out.start, sample_type.start, sample_type.length) != 0)
+    {
+        njs_printf("njs_vm_profile_test(): unexpected pprof sample types\n");
+        stat->failed++;
+
+    } else {
+        stat->passed++;
+    }
+
+    ret = NJS_OK;
+
+done:
+
+    if (ret != NJS_OK && vm != NULL) {
+        if (njs_vm_exception_string(vm, &s) != NJS_OK) {
+            njs_printf("njs_vm_exception_string() failed\n");
+
+        } else {
+            njs_printf("%V\n", &s);
+        }
+    }
+
+    njs_unit_test_report(name, &prev, stat);
+
+    if (vm != NULL) {
+        njs_vm_destroy(vm);
+    }
+
+    if (profile != NULL) {
+        njs_profile_destroy(profile);
+    }
+
+    return ret;
+}
+
+
+static njs_int_t
+njs_vm_gc_test_gc(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
+    njs_index_t unused, njs_value_t *retval)
+{
+    njs_value_number_set(retval, njs_vm_gc(vm, NULL, 0));
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_vm_gc_test(njs_unit_test_t unused[], size_t num, njs_str_t *name,
+    njs_opts_t *opts, njs_stat_t *stat)
+{
+    u_char              *start;
+    size_t              size;
+    njs_vm_t            *vm;
+    njs_int_t           ret;
+    njs_str_t           s, root;
+    njs_uint_t          i;
+    njs_stat_t          prev;
+    njs_vm_opt_t        options;
+    njs_function_t      *gc, *garbage, *check;
+    njs_opaque_value_t  retval, value;
+
+    static const njs_str_t  gc_name = njs_str("gc");
+    static const njs_str_t  garbage_name = njs_str("garbage");
+    static const njs_str_t  check_name = njs_str("check");
+
+    static const njs_str_t  script = njs_str(
+        "var live = [];"
+        "var declined = gc();"
+        "function garbage(n) {"
+        "    var a = [];"
+        "    for (var i = 0; i < 1000; i++) {"
+        "        a.push({i, s: 'x'.repeat(600) + i});"
+        "    }"
+        "    live.push({n, s: 'y'.repeat(600) + n});"
+        "    return a;"
+        "}"
+        "function check() {"
+        "    return [declined, live.length, live[99].n,"
+        "            live[99].s.slice(-3)].join();"
+        "}");
+
+    static const njs_str_t  expected = njs_str("-3,100,99,y99");
+
+    vm = NULL;
+
+    prev = *stat;
+
+    ret = NJS_ERROR;
+
+    njs_vm_opt_init(&options);
+    options.init = 1;
+
+    vm = njs_vm_create(&options);
+    if (vm == NULL) {
+        njs_printf("njs_vm_create() failed\n");
+        goto done;
+    }
+
+    gc = njs_vm_function_alloc(vm, njs_vm_gc_test_gc, 1, 0);
+    if (gc == NULL) {
+        njs_printf("njs_vm_function_alloc() failed\n");
+        goto done;
+    }
+
+    njs_value_function_set(njs_value_arg(&value), gc);
+
+    ret = njs_vm_bind(vm, &gc_name, njs_value_arg(&value), 1);
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_bind() failed\n");
+        goto done;
+    }
+
+    start = script.start;
+
+    ret = njs_vm_compile(vm, &start, start + script.length);
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_compile() failed\n");
+        goto done;
+    }
+
+    ret = njs_vm_start(vm, njs_value_arg(&retval));
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_start() failed\n");
+        goto done;
+    }
+
+    garbage = njs_vm_function(vm, &garbage_name);
+    check = njs_vm_function(vm, &check_name);
+
+    if (garbage == NULL || check == NULL) {
+        njs_printf("njs_vm_function() failed\n");
+        ret = NJS_ERROR;
+        goto done;
+    }
+
+    /* The value returned by a call is kept by the host until the next one. */
+
+    root.start = (u_char *) &retval;
+    root.length = sizeof(njs_opaque_value_t);
+
+    for (i = 0; i < 100; i++) {
+        njs_value_number_set(njs_value_arg(&value), i);
+
+        ret = njs_vm_invoke(vm, garbage, njs_value_arg(&value), 1,
+                            njs_value_arg(&retval));
+        if (ret != NJS_OK) {
+            njs_printf("njs_vm_invoke() failed\n");
+            goto done;
+        }
+
+        if (njs_vm_gc_pending(vm)) {
+            ret = njs_vm_gc(vm, &root, 1);
+            if (ret != NJS_OK) {
+                njs_printf("njs_vm_gc() failed\n");
+                goto done;
+            }
+        }
+    }
+
+    size = njs_mp_size(njs_vm_memory_pool(vm));
+
+    ret = njs_vm_invoke(vm, check, NULL, 0, njs_value_arg(&retval));
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_invoke() failed\n");
+        goto done;
+    }
+
+    ret = njs_vm_value_string(vm, &s, njs_value_arg(&retval));
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_value_string() failed\n");
+        goto done;
+    }
+
+    /* Without collection the calls take more than 100M. */
+
+    if (!njs_strstr_eq(&expected, &s) || size > 32 * 1024 * 1024) {
+        njs_printf("njs_vm_gc_test(\"%V\")\n"
+                   "expected: \"%V\" in less than 32M\n"
+                   "     got: \"%V\" in %uz\n", &script, &expected, &s, size);
+        stat->failed++;
+
+    } else {
+        stat->passed++;
+    }
+
+    ret = NJS_OK;
+
+done:
+
+    if (ret != NJS_OK && vm != NULL) {
+        if (njs_vm_exception_string(vm, &s) != NJS_OK) {
+            njs_printf("njs_vm_exception_string() failed\n");
+
+        } else {
+            njs_printf("%V\n", &s);
+        }
+    }
+
+    njs_unit_test_report(name, &prev, stat);
+
+    if (vm != NULL) {
+        njs_vm_destroy(vm);
+    }
+
+    return ret;
+}
+
+
+static njs_int_t
+njs_vm_gc_step_test(njs_unit_test_t unused[], size_t num, njs_str_t *name,
+    njs_opts_t *opts, njs_stat_t *stat)
+{
+    u_char              *start;
+    size_t              size;
+    njs_vm_t            *vm;
+    njs_int_t           ret;
+    njs_str_t           s, root;
+    njs_uint_t          i, steps;
+    njs_stat_t          prev;
+    njs_vm_opt_t        options;
+    njs_function_t      *garbage, *finish, *check;
+    njs_opaque_value_t  retval, value;
+
+    static const njs_str_t  garbage_name = njs_str("garbage");
+    static const njs_str_t  finish_name = njs_str("finish");
+    static const njs_str_t  check_name = njs_str("check");
+
+    static const njs_str_t  script = njs_str(
+        "var live = {}, resolve;"
+        "(function () {"
+        "    var n = 0;"
+        "    live.counter = () => ++n;"
+        "})();"
+        "live.re = /(\\d+)-(\\w+)/g;"
+        "live.rope = 'r'.repeat(300) + 's'.repeat(300);"
+        "new Promise(r => { resolve = r })"
+        ".then(v => { live.resolved = v + live.counter() });"
+        "Promise.resolve(1).then(v => { live.job = v });"
+        "function garbage(n) {"
+        "    var a = [];"
+        "    for (var i = 0; i < 1000; i++) {"
+        "        a.push({i, s: 'x'.repeat(600) + i,"
+        "                m: (i + '-ab').match(/(\\d+)-(\\w+)/)});"
+        "    }"
+        "    live.counter();"
+        "    return a;"
+        "}"
+        "function finish() { resolve(10) }"
+        "function check() {"
+        "    return [live.counter(), 'x 12-cd'.replace(live.re, '$2$1'),"
+        "            live.re.lastIndex, live.rope.length,"
+        "            live.rope[299] + live.rope[300], live.job,"
+        "            live.resolved].join();"
+        "}");
+
+    static const njs_str_t  expected = njs_str("102,x cd12,0,600,rs,1,111");
+
+    vm = NULL;
+
+    prev = *stat;
+
+    ret = NJS_ERROR;
+
+    njs_vm_opt_init(&options);
+    options.init = 1;
+
+    vm = njs_vm_create(&options);
+    if (vm == NULL) {
+        njs_printf("njs_vm_create() failed\n");
+        goto done;
+    }
+
+    start = script.start;
+
+    ret = njs_vm_compile(vm, &start, start + script.length);
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_compile() failed\n");
+        goto done;
+    }
+
+    ret = njs_vm_start(vm, njs_value_arg(&retval));
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_start() failed\n");
+        goto done;
+    }
+
+    garbage = njs_vm_function(vm, &garbage_name);
+    finish = njs_vm_function(vm, &finish_name);
+    check = njs_vm_function(vm, &check_name);
+
+    if (garbage == NULL || finish == NULL || check == NULL) {
+        njs_printf("njs_vm_function() failed\n");
+        ret = NJS_ERROR;
+        goto done;
+    }
+
+    root.start = (u_char *) &retval;
+    root.length = sizeof(njs_opaque_value_t);
+
+    /*
+     * The closure, the promise reactions, the pending job, the regexp and
+     * the rope live through the collections made in steps.  A collection
+     * abandoned by a call into the VM is finished by the next one at once.
+     */
+
+    steps = 0;
+
+    for (i = 0; i < 100; i++) {
+        njs_value_number_set(njs_value_arg(&value), i);
+
+        ret = njs_vm_invoke(vm, garbage, njs_value_arg(&value), 1,
+                            njs_value_arg(&retval));
+        if (ret != NJS_OK) {
+            njs_printf("njs_vm_invoke() failed\n");
+            goto done;
+        }
+
+        if (i % 10 == 5 || i % 10 == 6) {
+            ret = njs_vm_gc_step(vm, &root, 1, 1);
+
+            if (ret != ((i % 10 == 5) ? NJS_AGAIN : NJS_OK)) {
+                njs_printf("njs_vm_gc_step_test(\"%V\") call %ui: %i\n",
+                           &script, i, ret);
+                stat->failed++;
+                ret = NJS_OK;
+                goto done;
+            }
+
+            continue;
+        }
+
+        while (njs_vm_gc_pending(vm)) {
+            ret = njs_vm_gc_step(vm, &root, 1, 64 * 1024);
+            if (ret == NJS_ERROR) {
+                njs_printf("njs_vm_gc_step() failed\n");
+                goto done;
+            }
+
+            steps++;
+        }
+    }
+
+    size = njs_mp_size(njs_vm_memory_pool(vm));
+
+    ret = njs_vm_call(vm, finish, NULL, 0);
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_call() failed\n");
+        goto done;
+    }
+
+    do {
+        ret = njs_vm_execute_pending_job(vm);
+        if (ret == NJS_ERROR) {
+            njs_printf("njs_vm_execute_pending_job() failed\n");
+            goto done;
+        }
+
+    } while (ret > NJS_OK);
+
+    ret = njs_vm_invoke(vm, check, NULL, 0, njs_value_arg(&retval));
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_invoke() failed\n");
+        goto done;
+    }
+
+    ret = njs_vm_value_string(vm, &s, njs_value_arg(&retval));
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_value_string() failed\n");
+        goto done;
+    }
+
+    if (!njs_strstr_eq(&expected, &s) || size > 32 * 1024 * 1024
+        || steps < 20)
+    {
+        njs_printf("njs_vm_gc_step_test(\"%V\")\n"
+                   "expected: \"%V\" in less than 32M in steps\n"
+                   "     got: \"%V\" in %uz in %ui steps\n",
+                   &script, &expected, &s, size, steps);
+        stat->failed++;
+
+    } else {
+        stat->passed++;
+    }
+
+    ret = NJS_OK;
+
+done:
+
+    if (ret != NJS_OK && vm != NULL) {
+        if (njs_vm_exception_string(vm, &s) != NJS_OK) {
+            njs_printf("njs_vm_exception_string() failed\n");
+
+        } else {
+            njs_printf("%V\n", &s);
+        }
+    }
+
+    njs_unit_test_report(name, &prev, stat);
+
+    if (vm != NULL) {
+        njs_vm_destroy(vm);
+    }
+
+    return ret;
+}
+
+
+static njs_int_t
+njs_vm_arena_test(njs_unit_test_t unused[], size_t num, njs_str_t *name,
+    njs_opts_t *opts, njs_stat_t *stat)
+{
+    u_char              *start;
+    njs_vm_t            *vm, *nvm;
+    njs_int_t           ret;
+    njs_str_t           s;
+    njs_uint_t          i;
+    njs_stat_t          prev;
+    njs_mp_stat_t       mp_stat;
+    njs_vm_opt_t        options;
+    njs_opaque_value_t  retval;
+
+    static const njs_str_t  script = njs_str(
+        "var a = [];"
+        "for (var i = 0; i < 1000; i++) {"
+        "    a.push({i, s: 'x'.repeat(100) + i});"
+        "}"
+        "a[999].s.slice(-3)");
+
+    static const njs_str_t  expected = njs_str("999");
+
+    vm = NULL;
+    nvm = NULL;
+
+    prev = *stat;
+
+    ret = NJS_ERROR;
+
+    njs_vm_opt_init(&options);
+    options.arena = 1;
+
+    vm = njs_vm_create(&options);
+    if (vm == NULL) {
+        njs_printf("njs_vm_create() failed\n");
+        goto done;
+    }
+
+    start = script.start;
+
+    ret = njs_vm_compile(vm, &start, start + script.length);
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_compile() failed\n");
+        goto done;
+    }
+
+    /*
+     * The first clone grows its arena, the following ones start with
+     * an arena of the size used before.
+     */
+
+    for (i = 0; i < 3; i++) {
+        nvm = njs_vm_clone(vm, NULL);
+        if (nvm == NULL) {
+            njs_printf("njs_vm_clone() failed\n");
+            ret = NJS_ERROR;
+            goto done;
+        }
+
+        ret = njs_vm_start(nvm, njs_value_arg(&retval));
+        if (ret != NJS_OK) {
+            njs_printf("njs_vm_start() failed\n");
+            goto done;
+        }
+
+        ret = njs_vm_value_string(nvm, &s, njs_value_arg(&retval));
+        if (ret != NJS_OK) {
+            njs_printf("njs_vm_value_string() failed\n");
+            goto done;
+        }
+
+        njs_mp_stat(njs_vm_memory_pool(nvm), &mp_stat);
+
+        if (!njs_strstr_eq(&expected, &s)
+            || (i == 0 && mp_stat.nblocks == 1)
+            || (i != 0 && mp_stat.nblocks != 1)
+            || mp_stat.used > mp_stat.size
+            || njs_vm_gc(nvm, NULL, 0) != NJS_DECLINED)
+        {
+            njs_printf("njs_vm_arena_test(\"%V\") clone %ui\n"
+                       "expected: \"%V\"\n"
+                       "     got: \"%V\" in %uz blocks of %uz, used %uz\n",
+                       &script, i, &expected, &s, mp_stat.nblocks,
+                       mp_stat.size, mp_stat.used);
+            stat->failed++;
+
+        } else {
+            stat->passed++;
+        }
+
+        njs_vm_destroy(nvm);
+        nvm = NULL;
+    }
+
+    ret = NJS_OK;
+
+done:
+
+    njs_unit_test_report(name, &prev, stat);
+
+    if (nvm != NULL) {
+        njs_vm_destroy(nvm);
+    }
+
+    if (vm != NULL) {
+        njs_vm_destroy(vm);
+    }
+
+    return ret;
+}
+
+
+static njs_int_t
+njs_vm_prop_cache_test(njs_unit_test_t unused[], size_t num, njs_str_t *name,
+    njs_opts_t *opts, njs_stat_t *stat)
+{
+    u_char              *start;
+    njs_vm_t            *vm, *nvm[2];
+    njs_int_t           ret;
+    njs_uint_t          i, n;
+    njs_stat_t          prev;
+    njs_vm_opt_t        options;
+    njs_function_t      *run;
+    njs_opaque_value_t  arg, retval;
+
+    static const njs_str_t  script = njs_str(
+        "function get(o) { return o.x }"
+        "function run(k) {"
+        "    var s = 0;"
+        "    for (var i = 0; i < 10; i++) {"
+        "        s += get(k ? {x: 1, y: 2} : {y: 3, z: 0, x: 4});"
+        "    }"
+        "    return s;"
+        "}");
+
+    static const njs_str_t  run_name = njs_str("run");
+
+    vm = NULL;
+    nvm[0] = NULL;
+    nvm[1] = NULL;
+
+    prev = *stat;
+
+    ret = NJS_ERROR;
+
+    njs_vm_opt_init(&options);
+
+    vm = njs_vm_create(&options);
+    if (vm == NULL) {
+        njs_printf("njs_vm_create() failed\n");
+        goto done;
+    }
+
+    start = script.start;
+
+    ret = njs_vm_compile(vm, &start, start + script.length);
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_compile() failed\n");
+        goto done;
+    }
+
+    for (n = 0; n < 2; n++) {
+        nvm[n] = njs_vm_clone(vm, NULL);
+        if (nvm[n] == NULL) {
+            njs_printf("njs_vm_clone() failed\n");
+            ret = NJS_ERROR;
+            goto done;
+        }
+
+        ret = njs_vm_start(nvm[n], njs_value_arg(&retval));
+        if (ret != NJS_OK) {
+            njs_printf("njs_vm_start() failed\n");
+            goto done;
+        }
+    }
+
+    /*
+     * The clones share the bytecode and fill their own caches with
+     * different object layouts at the same access sites.
+     */
+
+    for (i = 0; i < 6; i++) {
+        n = i % 2;
+
+        run = njs_vm_function(nvm[n], &run_name);
+        if (run == NULL) {
+            njs_printf("njs_vm_function() failed\n");
+            ret = NJS_ERROR;
+            goto done;
+        }
+
+        njs_value_number_set(njs_value_arg(&arg), n);
+
+        ret = njs_vm_invoke(nvm[n], run, njs_value_arg(&arg), 1,
+                            njs_value_arg(&retval));
+        if (ret != NJS_OK) {
+            njs_printf("njs_vm_invoke() failed\n");
+            goto done;
+        }
+
+        if (njs_value_number(njs_value_arg(&retval)) != (n ? 10 : 40)) {
+            njs_printf("njs_vm_prop_cache_test(\"%V\") clone %ui\n",
+                       &script, n);
+            stat->failed++;
+
+        } else {
+            stat->passed++;
+        }
+    }
+
+    ret = NJS_OK;
+
+done:
+
+    njs_unit_test_report(name, &prev, stat);
+
+    for (n = 0; n < 2; n++) {
+        if (nvm[n] != NULL) {
+            njs_vm_destroy(nvm[n]);
+        }
+    }
+
+    if (vm != NULL) {
+        njs_vm_destroy(vm);
+    }
+
+    return ret;
+}
+
+
+static njs_int_t
+njs_vm_reset_test(njs_unit_test_t unused[], size_t num, njs_str_t *name,
+    njs_opts_t *opts, njs_stat_t *stat)
+{
+    u_char              *start;
+    njs_vm_t            *vm, *nvm;
+    njs_int_t           ret;
+    njs_uint_t          i;
+    njs_stat_t          prev;
+    njs_vm_opt_t        options;
+    njs_function_t      *inc, *later;
+    njs_opaque_value_t  retval;
+
+    static const njs_str_t  script = njs_str(
+        "var n = 0;"
+        "function inc() { return ++n; }"
+        "function later() { Promise.resolve().then(() => { n = 0; }); }");
+
+    static const njs_str_t  inc_name = njs_str("inc");
+    static const njs_str_t  later_name = njs_str("later");
+
+    vm = NULL;
+    nvm = NULL;
+
+    prev = *stat;
+
+    ret = NJS_ERROR;
+
+    njs_vm_opt_init(&options);
+
+    vm = njs_vm_create(&options);
+    if (vm == NULL) {
+        njs_printf("njs_vm_create() failed\n");
+        goto done;
+    }
+
+    start = script.start;
+
+    ret = njs_vm_compile(vm, &start, start + script.length);
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_compile() failed\n");
+        goto done;
+    }
+
+    nvm = njs_vm_clone(vm, NULL);
+    if (nvm == NULL) {
+        njs_printf("njs_vm_clone() failed\n");
+        ret = NJS_ERROR;
+        goto done;
+    }
+
+    ret = njs_vm_start(nvm, njs_value_arg(&retval));
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_start() failed\n");
+        goto done;
+    }
+
+    inc = njs_vm_function(nvm, &inc_name);
+    later = njs_vm_function(nvm, &later_name);
+
+    if (inc == NULL || later == NULL) {
+        njs_printf("njs_vm_function() failed\n");
+        ret = NJS_ERROR;
+        goto done;
+    }
+
+    /* The global state survives the reset, the external is replaced. */
+
+    for (i = 1; i <= 3; i++) {
+        ret = njs_vm_reset(nvm, (njs_external_ptr_t) (uintptr_t) i);
+        if (ret != NJS_OK) {
+            njs_printf("njs_vm_reset() failed\n");
+            goto done;
+        }
+
+        ret = njs_vm_invoke(nvm, inc, NULL, 0, njs_value_arg(&retval));
+        if (ret != NJS_OK) {
+            njs_printf("njs_vm_invoke() failed\n");
+            goto done;
+        }
+
+        if (njs_vm_external_ptr(nvm) != (njs_external_ptr_t) (uintptr_t) i
+            || njs_value_number(njs_value_arg(&retval)) != i)
+        {
+            njs_printf("njs_vm_reset_test(\"%V\") reset %ui\n",
+                       &script, i);
+            stat->failed++;
+
+        } else {
+            stat->passed++;
+        }
+    }
+
+    ret = njs_vm_call(nvm, later, NULL, 0);
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_call() failed\n");
+        goto done;
+    }
+
+    if (njs_vm_reset(nvm, NULL) != NJS_DECLINED) {
+        njs_printf("njs_vm_reset_test(\"%V\") pending jobs\n", &script);
+        stat->failed++;
+
+    } else {
+        stat->passed++;
+    }
+
+    ret = NJS_OK;
+
+done:
+
+    njs_unit_test_report(name, &prev, stat);
+
+    if (nvm != NULL) {
+        njs_vm_destroy(nvm);
+    }
+
+    if (vm != NULL) {
+        njs_vm_destroy(vm);
+    }
+
+    return ret;
+}
+
+
+static njs_int_t
+njs_vm_reset_externals_test(njs_unit_test_t unused[], size_t num,
+    njs_str_t *name, njs_opts_t *opts, njs_stat_t *stat)
+{
+    u_char              *start;
+    njs_vm_t            *vm, *nvm;
+    njs_int_t           ret;
+    njs_str_t           s;
+    njs_uint_t          i;
+    njs_stat_t          prev;
+    njs_vm_opt_t        options;
+    njs_function_t      *keep, *check;
+    njs_opaque_value_t  retval;
+
+    static const njs_str_t  script = njs_str(
+        "var g = {}, n = 0;"
+        "var mod = $shared.create('mod');"
+        "function keep() { g.r = $shared.create('req'); g.p = g.r.props }"
+        "function check() {"
+        "    var v = [$shared.uri, $shared.props.a, mod.uri, g.r.uri, g.p.a];"
+        "    if (n++) { v.push(typeof g.p.c.d) }"
+        "    return v.join();"
+        "}");
+
+    static const njs_str_t  keep_name = njs_str("keep");
+    static const njs_str_t  check_name = njs_str("check");
+
+    static const njs_str_t  expected[] = {
+        njs_str("shared,11,mod,req,0"),
+        njs_str("shared,11,mod,,,undefined"),
+        njs_str("shared,11,mod,,,undefined"),
+    };
+
+    vm = NULL;
+    nvm = NULL;
+
+    prev = *stat;
+
+    ret = NJS_ERROR;
+
+    njs_vm_opt_init(&options);
+
+    options.addons = njs_unit_test_addon_external_modules;
+
+    vm = njs_vm_create(&options);
+    if (vm == NULL) {
+        njs_printf("njs_vm_create() failed\n");
+        goto done;
+    }
+
+    start = script.start;
+
+    ret = njs_vm_compile(vm, &start, start + script.length);
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_compile() failed\n");
+        goto done;
+    }
+
+    nvm = njs_vm_clone(vm, NULL);
+    if (nvm == NULL) {
+        njs_printf("njs_vm_clone() failed\n");
+        ret = NJS_ERROR;
+        goto done;
+    }
+
+    /* The externals of the module code are created before the first reset. */
+
+    ret = njs_vm_start(nvm, njs_value_arg(&retval));
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_start() failed\n");
+        goto done;
+    }
+
+    keep = njs_vm_function(nvm, &keep_name);
+    check = njs_vm_function(nvm, &check_name);
+
+    if (keep == NULL || check == NULL) {
+        njs_printf("njs_vm_function() failed\n");
+        ret = NJS_ERROR;
+        goto done;
+    }
+
+    /*
+     * The externals created by the first request and the objects nested
+     * in them are stale for the next ones.
+     */
+
+    for (i = 0; i < njs_nitems(expected); i++) {
+        ret = njs_vm_reset(nvm, NULL);
+        if (ret != NJS_OK) {
+            njs_printf("njs_vm_reset() failed\n");
+            goto done;
+        }
+
+        if (i == 0) {
+            ret = njs_vm_invoke(nvm, keep, NULL, 0, njs_value_arg(&retval));
+            if (ret != NJS_OK) {
+                njs_printf("njs_vm_invoke() failed\n");
+                goto done;
+            }
+        }
+
+        ret = njs_vm_invoke(nvm, check, NULL, 0, njs_value_arg(&retval));
+        if (ret != NJS_OK) {
+            njs_printf("njs_vm_invoke() failed\n");
+            goto done;
+        }
+
+        ret = njs_vm_value_string(nvm, &s, njs_value_arg(&retval));
+        if (ret != NJS_OK) {
+            njs_printf("njs_vm_value_string() failed\n");
+            goto done;
+        }
+
+        if (!njs_strstr_eq(&expected[i], &s)) {
+            njs_printf("njs_vm_reset_externals_test(\"%V\") reset %ui\n"
+                       "expected: \"%V\"\n     got: \"%V\"\n",
+                       &script, i, &expected[i], &s);
+            stat->failed++;
+
+        } else {
+            stat->passed++;
+        }
+    }
+
+    ret = NJS_OK;
+
+done:
+
+    njs_unit_test_report(name, &prev, stat);
+
+    if (nvm != NULL) {
+        njs_vm_destroy(nvm);
+    }
+
+    if (vm != NULL) {
+        njs_vm_destroy(vm);
+    }
+
+    return ret;
+}
+
+
+static njs_int_t
+njs_vm_flat_ropes_test(njs_unit_test_t unused[], size_t num, njs_str_t *name,
+    njs_opts_t *opts, njs_stat_t *stat)
+{
+    u_char              *start;
+    njs_vm_t            *vm, *nvm[2];
+    njs_int_t           ret;
+    njs_str_t           s;
+    njs_uint_t          i, n;
+    njs_stat_t          prev;
+    njs_vm_opt_t        options;
+    njs_function_t      *mk, *run;
+    njs_opaque_value_t  retval;
+
+    static const njs_str_t  script = njs_str(
+        "function mk() { return 'a'.repeat(300) + 'b'.repeat(300) }"
+        "function run() {"
+        "    var t = 'a'.repeat(300) + 'b'.repeat(300);"
+        "    return [rope.length, rope.indexOf('b'), rope > 'a', rope == t,"
+        "            rope === t, [rope].join().length,"
+        "            JSON.stringify(rope).length, rope.slice(299, 301)]"
+        "           .join();"
+        "}");
+
+    static const njs_str_t  mk_name = njs_str("mk");
+    static const njs_str_t  run_name = njs_str("run");
+    static const njs_str_t  rope_name = njs_str("rope");
+    static const njs_str_t  expected =
+                          njs_str("600,300,true,true,true,600,602,ab");
+
+    vm = NULL;
+    nvm[0] = NULL;
+    nvm[1] = NULL;
+
+    prev = *stat;
+
+    ret = NJS_ERROR;
+
+    njs_vm_opt_init(&options);
+
+    vm = njs_vm_create(&options);
+    if (vm == NULL) {
+        njs_printf("njs_vm_create() failed\n");
+        goto done;
+    }
+
+    start = script.start;
+
+    ret = njs_vm_compile(vm, &start, start + script.length);
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_compile() failed\n");
+        goto done;
+    }
+
+    ret = njs_vm_start(vm, njs_value_arg(&retval));
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_start() failed\n");
+        goto done;
+    }
+
+    mk = njs_vm_function(vm, &mk_name);
+    if (mk == NULL) {
+        njs_printf("njs_vm_function() failed\n");
+        ret = NJS_ERROR;
+        goto done;
+    }
+
+    ret = njs_vm_invoke(vm, mk, NULL, 0, njs_value_arg(&retval));
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_invoke() failed\n");
+        goto done;
+    }
+
+    /* The rope is allocated by the parent and is shared with the clones. */
+
+    ret = njs_vm_bind(vm, &rope_name, njs_value_arg(&retval), 1);
+    if (ret != NJS_OK) {
+        njs_printf("njs_vm_bind() failed\n");
+        goto done;
+    }
+
+    for (n = 0; n < 2; n++) {
+        nvm[n] = njs_vm_clone(vm, NULL);
+        if (nvm[n] == NULL) {
+            njs_printf("njs_vm_clone() failed\n");
+            ret = NJS_ERROR;
+            goto done;
+        }
+
+        ret = njs_vm_start(nvm[n], njs_value_arg(&retval));
+        if (ret != NJS_OK) {
+            njs_printf("njs_vm_start() failed\n");
+            goto done;
+        }
+    }
+
+    /*
+     * Each clone flattens its own copy of the rope, the parent
+     * is checked last as it flattens the rope in place.
+     */
+
+    for (i = 0; i < 5; i++) {
+        n = i % 3;
+
+        run = njs_vm_function((n < 2) ? nvm[n] : vm, &run_name);
+        if (run == NULL) {
+            njs_printf("njs_vm_function() failed\n");
+            ret = NJS_ERROR;
+            goto done;
+        }
+
+        ret = njs_vm_invoke((n < 2) ? nvm[n] : vm, run, NULL, 0,
+                            njs_value_arg(&retval));
+        if (ret != NJS_OK) {
+            njs_printf("njs_vm_invoke() failed\n");
+            goto done;
+        }
+
+        ret = njs_vm_value_string((n < 2) ? nvm[n] : vm, &s,
+                                  njs_value_arg(&retval));
+        if (ret != NJS_OK) {
+            njs_printf("njs_vm_value_string() failed\n");
+            goto done;
+        }
+
+        if (!njs_strstr_eq(&expected, &s)) {
+            njs_printf("njs_vm_flat_ropes_test(\"%V\") vm %ui\n"
+                       "expected: \"%V\"\n     got: \"%V\"\n",
+                       &script, n, &expected, &s);
+            stat->failed++;
+
+        } else {
+            stat->passed++;
+        }
+    }
+
+    ret = NJS_OK;
+
+done:
+
+    njs_unit_test_report(name, &prev, stat);
+
+    for (n = 0; n < 2; n++) {
+        if (nvm[n] != NULL) {
+            njs_vm_destroy(nvm[n]);
+        }
+    }
+
+    if (vm != NULL) {
+        njs_vm_destroy(vm);
+    }
+
+    return ret;
+}
+
+
+static njs_int_t
+njs_vm_object_alloc_test(njs_vm_t *vm, njs_opts_t *opts, njs_stat_t *stat)
+{
+    njs_int_t           ret;
+    njs_opaque_value_t  args[2], obj, num_key, bool_key;
+
+    njs_value_number_set(njs_value_arg(&args[0]), 1);
+    njs_value_boolean_set(njs_value_arg(&args[0]), 0);
+
+    (void) njs_vm_value_string_create(vm, njs_value_arg(&num_key),
+                                     (u_char *) "num", 3);
+    (void) njs_vm_value_string_create(vm, njs_value_arg(&bool_key),
+                                     (u_char *) "bool", 4);
+
+    ret = njs_vm_object_alloc(vm, njs_value_arg(&obj), NULL);
+    if (ret != NJS_OK) {
+        return NJS_ERROR;
+    }
+
+    ret = njs_vm_object_alloc(vm, njs_value_arg(&obj), njs_value_arg(&num_key),
+                              NULL);
+    if (ret == NJS_OK) {
+        return NJS_ERROR;
+    }
+
+    ret = njs_vm_object_alloc(vm, njs_value_arg(&obj), njs_value_arg(&num_key),
+                              njs_value_arg(&args[0]), NULL);
+    if (ret != NJS_OK) {
+        return NJS_ERROR;
+    }
+
+    ret = njs_vm_object_alloc(vm, njs_value_arg(&obj), njs_value_arg(&num_key),
+                              njs_value_arg(&args[0]), njs_value_arg(&bool_key),
+                              njs_value_arg(&args[1]), NULL);
+    if (ret != NJS_OK) {
+        stat->failed++;
+        return NJS_OK;
+    }
+
+    stat->passed++;
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_chb_test(njs_vm_t *vm, njs_opts_t *opts, njs_stat_t *stat)
+{
+    u_char     *p;
+    njs_int_t  ret, i;
+    njs_chb_t  chain;
+    njs_str_t  string, arg;
+
+    static const njs_str_t  expected = njs_str("arg: \"XYZ\" -5");
+
+    NJS_CHB_MP_INIT(&chain, njs_vm_memory_pool(vm));
+
+    p = njs_chb_reserve(&chain, 513);
+    if (p == NULL) {
+        ret = NJS_ERROR;
+        njs_printf("njs_chb_reserve() failed\n");
+        goto done;
+    }
+
+    njs_memset(p, 'Z', 256);
+
+    njs_chb_written(&chain, 256);
+
+    for (i = 0; i < 768; i++) {
+        njs_chb_append(&chain, "X", 1);
+    }
+
+    ret = njs_chb_join(&chain, &string);
+    if (ret != NJS_OK) {
+        njs_printf("njs_chb_join() failed\n");
+        goto done;
+    }
+
+    if (string.length != 1024 || njs_chb_size(&chain) != 1024) {
+        ret = NJS_ERROR;
+        njs_printf("njs_chb_join() corrupts "
+                   "string.length:%z njs_chb_size(&chain):%z != 1024\n",
+                   string.length, njs_chb_size(&chain));
+        goto done;
+    }
+
+    for (i = 0; i < 1024; i++) {
+        if (string.start[i] != ((i < 256) ? 'Z' : 'X')) {
+            ret = NJS_ERROR;
+            njs_printf("njs_chb_join() corrupts string[%i]:%c != '%c'\n",
                        i, string.start[i], (i < 256) ? 'Z' : 'X');
             goto done;
         }
@@ -24191,6 +26301,12 @@ static njs_test_suite_t  njs_suites[] =
       njs_nitems(njs_test),
       njs_unit_test },
 
+    { njs_str("script gc"),
+      { .repeat = 1, .unsafe = 1, .preload = 1, .gc = 1 },
+      njs_test,
+      njs_nitems(njs_test),
+      njs_unit_test },
+
     { njs_str("safe script"),
       { .repeat = 1},
       njs_safe_test,
@@ -24216,19 +26332,19 @@ static njs_test_suite_t  njs_suites[] =
       njs_unit_test },
 
     { njs_str("externals"),
-      { .externals = 1, .repeat = 1, .unsafe = 1 },
+      { .externals = 1, .repeat = 1, .unsafe = 1, .gc = 1 },
       njs_externals_test,
       njs_nitems(njs_externals_test),
       njs_unit_test },
 
     { njs_str("async handler"),
-      { .async = 1, .externals = 1, .handler = 1, .repeat = 4, .seed = 2, .unsafe = 1 },
+      { .async = 1, .externals = 1, .handler = 1, .repeat = 4, .seed = 2, .unsafe = 1, .gc = 1 },
       njs_async_handler_test,
       njs_nitems(njs_async_handler_test),
       njs_unit_test },
 
     { njs_str("shared"),
-      { .externals = 1, .repeat = 128, .seed = 42, .unsafe = 1, .preload = 1, .backtrace = 1 },
+      { .externals = 1, .repeat = 128, .seed = 42, .unsafe = 1, .preload = 1, .backtrace = 1, .gc = 1 },
       njs_shared_test,
       njs_nitems(njs_shared_test),
       njs_unit_test },
@@ -24269,6 +26385,66 @@ static njs_test_suite_t  njs_suites[] =
       0,
       njs_vm_value_test },
 
+    { njs_str("vm_bytecode"),
+      { .repeat = 1, .unsafe = 1 },
+      NULL,
+      0,
+      njs_vm_bytecode_test },
+
+    { njs_str("vm_globals_cache"),
+      { .repeat = 1, .unsafe = 1 },
+      NULL,
+      0,
+      njs_vm_globals_cache_test },
+
+    { njs_str("vm_profile"),
+      { .repeat = 1, .unsafe = 1 },
+      NULL,
+      0,
+      njs_vm_profile_test },
+
+    { njs_str("vm_gc"),
+      { .repeat = 1, .unsafe = 1 },
+      NULL,
+      0,
+      njs_vm_gc_test },
+
+    { njs_str("vm_gc_step"),
+      { .repeat = 1, .unsafe = 1 },
+      NULL,
+      0,
+      njs_vm_gc_step_test },
+
+    { njs_str("vm_arena"),
+      { .repeat = 1, .unsafe = 1 },
+      NULL,
+      0,
+      njs_vm_arena_test },
+
+    { njs_str("vm_reset"),
+      { .repeat = 1, .unsafe = 1 },
+      NULL,
+      0,
+      njs_vm_reset_test },
+
+    { njs_str("vm_reset_externals"),
+      { .repeat = 1, .unsafe = 1 },
+      NULL,
+      0,
+      njs_vm_reset_externals_test },
+
+    { njs_str("vm_flat_ropes"),
+      { .repeat = 1, .unsafe = 1 },
+      NULL,
+      0,
+      njs_vm_flat_ropes_test },
+
+    { njs_str("vm_prop_cache"),
+      { .repeat = 1, .unsafe = 1 },
+      NULL,
+      0,
+      njs_vm_prop_cache_test },
+
     { njs_str("vm_internal_api"),
       { .repeat = 1, .unsafe = 1 },
       NULL,
@@ -33,6 +33,7 @@ let btoa_tsuite = {
         { value: "\x00\x01", expected: "AAE=" },
         { value: "\x00\x01\x02", expected: "AAEC" },
         { value: "\x00\xfe\xff", expected: "AP7/" },
+        { value: "\x00\xfe\xff".repeat(17), expected: "AP7/".repeat(17) },
         { value: String.fromCodePoint(0x100),
           exception: 'TypeError: invalid character (> U+00FF)' },
         { value: String.fromCodePoint(0x00, 0x100),
@@ -60,6 +61,9 @@ let atob_tsuite = {
         { value: "AAEC", expected: [0, 1, 2] },
         { value: "AP7/", expected: [0, 254, 255] },
         { value: "dW5kZWZpbmVk", expected: codePoints("undefined") },
+        { value: "QUJD".repeat(17), expected: codePoints("ABC".repeat(17)) },
+        { value: "AP7/".repeat(17) + "AA",
+          expected: codePoints("\x00\xfe\xff".repeat(17) + "\x00") },
 
         /* Forgiving-base64 ignores missing padding. */
 
@@ -82,6 +86,8 @@ let atob_tsuite = {
         { value: "CDRW\r", expected: [8, 52, 86] },
         { value: "CD\fRW", expected: [8, 52, 86] },
         { value: "\t\n\f\r CDRW \r\f\n\t", expected: [8, 52, 86] },
+        { value: "QUJD".repeat(8) + " " + "QUJD".repeat(8),
+          expected: codePoints("ABC".repeat(16)) },
         { value: "    ", expected: [] },
         { value: "\t\n\f\r ", expected: [] },
 
@@ -103,6 +109,14 @@ let atob_tsuite = {
           exception: 'TypeError: the string to be decoded is not correctly encoded' },
         { value: "A==A",
           exception: 'TypeError: the string to be decoded is not correctly encoded' },
+        { value: "QUJD".repeat(8) + "@QUJD",
+          exception: 'TypeError: the string to be decoded is not correctly encoded' },
+        { value: "QUJD".repeat(8) + "Q",
+          exception: 'TypeError: the string to be decoded is not correctly encoded' },
+        { value: "QUJD".repeat(8) + "=",
+          exception: 'TypeError: the string to be decoded is not correctly encoded' },
+        { value: "QUJD".repeat(8) + "QQ=",
+          exception: 'TypeError: the string to be decoded is not correctly encoded' },
 
         /* Only ASCII whitespace is stripped: VT and NBSP are not. */
 
@@ -495,6 +495,10 @@ let from_tsuite = {
         { args: ['deadBEEF##', 'hex'], fmt: "hex", expected: 'deadbeef' },
         { args: ['6576696c', 'hex'], expected: 'evil' },
         { args: ['f3', 'hex'], expected: '�' },
+        { args: ['0123456789aBcDeF'.repeat(5) + '#00', 'hex'], fmt: "hex",
+          expected: '0123456789abcdef'.repeat(5) },
+        { args: ['0123456789abcdef'.repeat(3) + '0g', 'hex'], fmt: "hex",
+          expected: '0123456789abcdef'.repeat(3) },
 
         { args: ['', "base64"], expected: '' },
         { args: ['#', "base64"], expected: '' },
@@ -506,6 +510,10 @@ let from_tsuite = {
         { args: ['QUI', "base64"], expected: 'AB' },
         { args: ['QUJD', "base64"], expected: 'ABC' },
         { args: ['QUJDRA==', "base64"], expected: 'ABCD' },
+        { args: ['QUJD'.repeat(10) + 'QQ==', "base64"], expected: 'ABC'.repeat(10) + 'A' },
+        { args: ['QUJD'.repeat(10) + '#QUJD', "base64"], expected: 'ABC'.repeat(10) },
+        { args: ['+/+/'.repeat(8) + '-_', "base64"], fmt: "hex",
+          expected: 'fbffbf'.repeat(8) },
 
         { args: ['', "base64url"], expected: '' },
         { args: ['QQ', "base64url"], expected: 'A' },
@@ -513,6 +521,8 @@ let from_tsuite = {
         { args: ['QUJD', "base64url"], expected: 'ABC' },
         { args: ['QUJDRA', "base64url"], expected: 'ABCD' },
         { args: ['QUJDRA#', "base64url"], expected: 'ABCD' },
+        { args: ['-_-_'.repeat(8) + '+/', "base64url"], fmt: "hex",
+          expected: 'fbffbf'.repeat(8) },
 ]};
 
 
@@ -976,6 +986,11 @@ let toString_tsuite = {
         { value: new Uint8Array([0xff, 0xde, 0xba]), fmt: "base64url", expected: '_966' },
         { value: "ABCD", fmt: "base64", expected: 'QUJDRA==' },
         { value: "ABCD", fmt: "base64url", expected: 'QUJDRA' },
+        { value: new Uint8Array(49).fill(0xfb), fmt: "hex", expected: 'fb'.repeat(49) },
+        { value: new Uint8Array(49).fill(0xfb), fmt: "base64",
+          expected: '+/v7'.repeat(16) + '+w==' },
+        { value: new Uint8Array(49).fill(0xfb), fmt: "base64url",
+          expected: '-_v7'.repeat(16) + '-w' },
         { value: '', fmt: "utf-128", exception: 'TypeError: "utf-128" encoding is not supported' },
         { value: "hello", fmt: "utf-8", start: 1, end: 4, expected: 'ell' },
         { value: "hello", fmt: "utf-8", start: 3, end: 3, expected: '' },
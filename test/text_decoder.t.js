@@ -58,6 +58,13 @@ let stream_tsuite = {
           expected: ['', '', '𠮷'] },
         { chunks: [new Uint8Array([0xF0, 0xA0]), new Uint8Array([])],
           expected: ['', '�'] },
+        { chunks: [new Uint8Array(Array(37).fill(0x61).concat([0xF0, 0x9F])),
+                   new Uint8Array([0x8C, 0x9F].concat(Array(20).fill(0x62)))],
+          expected: ['a'.repeat(37), '🌟' + 'b'.repeat(20)] },
+        { chunks: [new Uint8Array(Array(40).fill(0x61)
+                                  .concat([0xC0, 0x80, 0xED, 0xA0, 0x80,
+                                           0xD0, 0xB6]))],
+          expected: ['a'.repeat(40) + '�'.repeat(5) + 'ж'] },
         { chunks: [''],
           exception: 'TypeError: TypeError: not a TypedArray' },
     ],
@@ -102,6 +109,13 @@ let fatal_tsuite = {
           exception: 'Error: The encoded data was not valid' },
         { chunks: [new Uint8Array([0xF0])],
           exception: 'Error: The encoded data was not valid' },
+        { chunks: [new Uint8Array(Array(33).fill(0x61)
+                                  .concat([0xE2, 0x82, 0xAC],
+                                          Array(16).fill(0x62)))],
+          expected: ['a'.repeat(33) + '€' + 'b'.repeat(16)] },
+        { chunks: [new Uint8Array(Array(33).fill(0x61)
+                                  .concat([0xF4, 0x90, 0x80, 0x80]))],
+          exception: 'Error: The encoded data was not valid' },
     ],
 };
 
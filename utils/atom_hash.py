@@ -0,0 +1,355 @@
+import re, os, glob
+
+# Generates a perfect hash of the predefined string atoms, see njs_atom_find().
+#
+# A slot is found by mixing the djb hash of a string with the displacement
+# of its bucket.  The displacements are chosen so that all the predefined
+# strings occupy distinct slots, thus a lookup compares only one string.
+#
+# Also generates the layouts of the property hashes of the built-in objects,
+# see njs_builtin_hashes_create().  A property is hashed by its atom id,
+# and the atom ids of the predefined atoms are known here, so the hash cells
+# and the element chains are computed in advance.
+
+HASH_BITS = 10
+BUCKETS = 256
+
+
+def djb_hash(data):
+    h = 5381
+
+    for c in data:
+        h = (((h << 5) + h) & 0xffffffff) ^ c
+
+    return h
+
+
+def slot(h, d):
+    return (((h ^ d) * 0x9e3779b1) & 0xffffffff) >> (32 - HASH_BITS)
+
+
+def parse(fn):
+    atoms = []
+
+    with open(fn) as fh:
+        for line in fh:
+            m = re.match(r'NJS_DEF_STRING\((\w+), "((?:[^"\\]|\\.)*)"', line)
+            if not m:
+                continue
+
+            s = m.group(2).encode('latin-1').decode('unicode_escape')
+            atoms.append((m.group(1), s.encode('latin-1')))
+
+    return atoms
+
+
+def parse_ids(fn):
+    ids = {}
+
+    with open(fn) as fh:
+        for line in fh:
+            m = re.match(r'NJS_DEF_(STRING|SYMBOL)\((\w+),', line)
+            if m:
+                ids[m.group(1) + "_" + m.group(2)] = len(ids)
+
+    return ids
+
+
+PROP_ENTRY = re.compile(r'^#[ \t]*(\w+)[ \t]*(\w*)'
+                        r'|NJS_DECLARE_PROP_(?:VALUE|NATIVE|HANDLER|GETTER)'
+                        r'\(\s*(\w+)'
+                        r'|NJS_DECLARE_PROP_(NAME|LENGTH)\('
+                        r'|\.atom_id\s*=\s*NJS_ATOM_(\w+)', re.M)
+
+
+def parse_props(body):
+    entries = []
+    cond = None
+
+    body = re.sub(r'/\*.*?\*/', '', body, flags = re.S)
+
+    for m in PROP_ENTRY.finditer(body):
+        if m.group(1) == "ifdef" and cond is None:
+            cond = m.group(2)
+
+        elif m.group(1) == "endif" and cond is not None:
+            cond = None
+
+        elif m.group(1) is not None:
+            raise Exception("unsupported #{} in a property table"
+                            .format(m.group(1)))
+
+        elif m.group(4) is not None:
+            entries.append(("STRING_" + m.group(4).lower(), cond))
+
+        else:
+            entries.append((m.group(3) or m.group(5), cond))
+
+    return entries
+
+
+def parse_sources(src):
+    props, inits, types = {}, {}, {}
+
+    for fn in sorted(glob.glob(os.path.join(src, "*.c"))):
+        with open(fn) as fh:
+            text = fh.read()
+
+        for m in re.finditer(r'njs_object_prop_init_t\s+(\w+)\[\]\s*=\s*'
+                             r'\{(.*?)\n\};', text, re.S):
+            props[m.group(1)] = parse_props(m.group(2))
+
+        for m in re.finditer(r'njs_object_init_t\s+(\w+)\s*=\s*\{\s*(\w+),'
+                             r'\s*njs_nitems\((\w+)\)', text):
+            assert m.group(2) == m.group(3), m.group(1)
+            inits[m.group(1)] = m.group(2)
+
+        for m in re.finditer(r'njs_object_type_init_t\s+(\w+)\s*=\s*'
+                             r'\{(.*?)\n\};', text, re.S):
+            ctor = re.search(r'\.constructor_props\s*=\s*&(\w+)', m.group(2))
+            proto = re.search(r'\.prototype_props\s*=\s*&(\w+)', m.group(2))
+            types[m.group(1)] = (ctor.group(1) if ctor else None,
+                                 proto.group(1))
+
+    return props, inits, types
+
+
+def parse_list(text, name):
+    m = re.search(name + r'\[\w*\]\s*=\s*\{(.*?)\n\s*\};', text, re.S)
+
+    return re.findall(r'&(\w+_init)\b', m.group(1))
+
+
+def hash_layout(ids, atoms):
+    keys = [ids[a] for a in atoms]
+
+    assert len(set(keys)) == len(keys), atoms
+
+    size = 1
+
+    while size < len(keys):
+        size *= 2
+
+    cells = [0] * size
+    next_elt = []
+
+    # The same as njs_flathsh_add_elt() does for each element in turn.
+
+    for i, k in enumerate(keys):
+        next_elt.append(cells[k & (size - 1)])
+        cells[k & (size - 1)] = i + 1
+
+    # The cells are stored in memory in the reverse order.
+
+    return list(reversed(cells)), next_elt
+
+
+class Layouts:
+    def __init__(self, ids, props, inits):
+        self.ids = ids
+        self.props = props
+        self.inits = inits
+        self.cells = []
+        self.next_elt = []
+        self.done = {}
+
+    def variants(self, init):
+        if init is None:
+            return None, ["{ 0, 0, 0, 0 },"]
+
+        entries = self.props[self.inits[init]]
+        conds = set(c for _, c in entries if c is not None)
+
+        assert len(conds) <= 1, init
+
+        result = [self.entry(init, [a for a, _ in entries])]
+
+        if not conds:
+            return None, result
+
+        result.append(self.entry(init, [a for a, c in entries if c is None]))
+
+        return conds.pop(), result
+
+    def entry(self, init, atoms):
+        key = (init, len(atoms))
+
+        if key not in self.done:
+            cells, next_elt = hash_layout(self.ids, atoms)
+
+            self.done[key] = "{{ {}, {}, {}, {} }},".format(
+                len(cells), len(atoms), len(self.cells), len(self.next_elt))
+
+            self.cells += cells
+            self.next_elt += next_elt
+
+        return self.done[key]
+
+    def table(self, name, inits):
+        result = ["static const njs_builtin_layout_t  {}[{}] = {{\n"
+                  .format(name, len(inits))]
+
+        for init in inits:
+            cond, entries = self.variants(init)
+            lines = ["    {:<28}/* {} */\n".format(e, init or "none")
+                     for e in entries]
+
+            if cond is not None:
+                lines = (["#ifdef {}\n".format(cond), lines[0], "#else\n",
+                          lines[1], "#endif\n"])
+
+            result += lines
+
+        result.append("};\n")
+
+        return "".join(result)
+
+
+def build(atoms):
+    buckets = [[] for _ in range(BUCKETS)]
+
+    for name, s in atoms:
+        h = djb_hash(s)
+        buckets[h & (BUCKETS - 1)].append((name, h))
+
+    displace = [0] * BUCKETS
+    slots = [None] * (1 << HASH_BITS)
+
+    order = sorted(range(BUCKETS), key = lambda b: -len(buckets[b]))
+
+    for b in order:
+        if not buckets[b]:
+            continue
+
+        d = 0
+
+        while True:
+            idx = [slot(h, d) for _, h in buckets[b]]
+
+            if (len(set(idx)) == len(idx)
+                and all(slots[i] is None for i in idx)):
+                break
+
+            d += 1
+
+        displace[b] = d
+
+        for (name, _), i in zip(buckets[b], idx):
+            slots[i] = name
+
+    return displace, slots
+
+
+def table(header, values):
+    result = ["static const {}[{}] = {{\n".format(header, len(values))]
+    line = "   "
+
+    for v in values:
+        if len(line) + len(v) + 2 > 80:
+            result.append(line + "\n")
+            line = "   "
+
+        line += " " + v + ","
+
+    result.append(line + "\n};\n")
+
+    return "".join(result)
+
+
+if __name__ == "__main__":
+    src = os.path.join(os.path.dirname(__file__), "../src")
+
+    atoms = parse(os.path.join(src, "njs_atom_defs.h"))
+    displace, slots = build(atoms)
+
+    print("{} atoms in {} slots, max displacement {}"
+          .format(len(atoms), len(slots), max(displace)))
+
+    content = ["""
+/*
+ * Copyright (C) F5, Inc.
+ *
+ * Do not edit, generated by: utils/atom_hash.py.
+ */
+
+
+#ifndef _NJS_ATOM_HASH_H_INCLUDED_
+#define _NJS_ATOM_HASH_H_INCLUDED_
+
+
+#define NJS_ATOM_HASH_BITS     {}
+#define NJS_ATOM_HASH_BUCKETS  {}
+
+
+#define njs_atom_hash_slot(hash)                                              \\
+    ((uint32_t) (((hash)                                                      \\
+                  ^ njs_atom_hash_displace[(hash)                             \\
+                                           & (NJS_ATOM_HASH_BUCKETS - 1)])    \\
+                 * 0x9e3779b1) >> (32 - NJS_ATOM_HASH_BITS))
+
+
+""".format(HASH_BITS, BUCKETS),
+    table("uint16_t  njs_atom_hash_displace",
+          [str(d) for d in displace]),
+    "\n\n",
+    table("uint16_t  njs_atom_hash_slots",
+          ["NJS_ATOM_STRING_" + s if s is not None else "NJS_ATOM_SIZE"
+           for s in slots]),
+    "\n\n#endif /* _NJS_ATOM_HASH_H_INCLUDED_ */\n"]
+
+    fn = os.path.join(src, "njs_atom_hash.h")
+
+    with open(fn, 'w') as fh:
+        fh.write("".join(content))
+
+    ids = parse_ids(os.path.join(src, "njs_atom_defs.h"))
+    props, inits, types = parse_sources(src)
+
+    with open(os.path.join(src, "njs_builtin.c")) as fh:
+        builtin = fh.read()
+
+    type_inits = [types[t] for t in parse_list(builtin, "njs_object_type_init")]
+
+    layouts = Layouts(ids, props, inits)
+
+    tables = [
+        layouts.table("njs_builtin_instance_layouts",
+                      parse_list(builtin, "instances")),
+        layouts.table("njs_builtin_object_layouts",
+                      parse_list(builtin, "njs_object_init")),
+        layouts.table("njs_builtin_prototype_layouts",
+                      [proto for _, proto in type_inits]),
+        layouts.table("njs_builtin_constructor_layouts",
+                      [ctor for ctor, _ in type_inits]),
+    ]
+
+    print("{} property hashes, {} cells, {} elements"
+          .format(len(layouts.done), len(layouts.cells),
+                  len(layouts.next_elt)))
+
+    content = ["""
+/*
+ * Copyright (C) F5, Inc.
+ *
+ * Do not edit, generated by: utils/atom_hash.py.
+ */
+
+
+#ifndef _NJS_BUILTIN_HASH_H_INCLUDED_
+#define _NJS_BUILTIN_HASH_H_INCLUDED_
+
+
+""",
+    table("uint32_t  njs_builtin_hash_cells",
+          [str(c) for c in layouts.cells]),
+    "\n\n",
+    table("uint16_t  njs_builtin_hash_next",
+          [str(n) for n in layouts.next_elt]),
+    "\n\n",
+    "\n\n".join(tables),
+    "\n\n#endif /* _NJS_BUILTIN_HASH_H_INCLUDED_ */\n"]
+
+    fn = os.path.join(src, "njs_builtin_hash.h")
+
+    with open(fn, 'w') as fh:
+        fh.write("".join(content))